@@ -20,6 +20,25 @@
 #define DHT_PIN 4
 #define PUMP_RELAY_PIN 23
 #define DHT_TYPE 11 // DHT11
+// Kanal RMT RX untuk merekam frame DHT.
+#define DHT_RMT_CHANNEL 4
+
+// ---------------- ZONA RAK ------------------------------
+// Zona utama = DHT_PIN/PUMP_RELAY_PIN di atas dengan topik lama. Rak lain
+// didaftarkan lewat config_set {"zones": [...]}; zona ke-i memakai kanal RMT
+// ZONE_RMT_CHANNEL_BASE + i, jadi jumlahnya dibatasi kanal yang tersisa.
+#define ZONE_MAX 3
+#define ZONE_RMT_CHANNEL_BASE 5
+#define ZONE_NAME_SIZE 16
+#define ZONE_MAX_SCHEDULES 8
+// Siram otomatis zona saat kritis; setelah pompa mati zona menunggu jeda
+// rendam ini sebelum boleh disiram otomatis lagi.
+#define ZONE_PUMP_DEFAULT_S 30
+#define ZONE_SOAK_MS 60000UL
+// SDA/SCL LCD; bersama pin di atas, flash (6-11), UART (1, 3), strapping
+// (0, 2, 12, 15) dan input-only (34-39) tidak boleh dipakai zona.
+#define I2C_SDA_PIN 21
+#define I2C_SCL_PIN 22
 
 // ---------------- NETWORK CONFIG ------------------------
 char WIFI_SSID[33] = "";
@@ -35,6 +54,19 @@ const char* MQTT_PASSWORD = SECRET_MQTT_PASS;
 const char* MQTT_CLIENT_ID_PREFIX = "jamur-iot-";
 #define MQTT_CLIENT_ID_LENGTH 40
 #define MQTT_KEEP_ALIVE_SEC 10
+// Reconnect: DNS -> TLS -> CONNECT -> SUBSCRIBE, satu tahap per iterasi
+// network_task. Gagal = backoff eksponensial dengan jitter per perangkat.
+#define MQTT_BACKOFF_BASE_MS 2000UL
+#define MQTT_BACKOFF_MAX_MS 300000UL
+#define MQTT_TLS_HANDSHAKE_TIMEOUT_S 10
+
+// ---------------- TLS SESSION RESUMPTION ----------------
+// Sesi TLS (broker MQTT & Supabase) di-cache agar reconnect cukup handshake
+// singkat. TLS_SESSION_PERSIST 1 menyimpan sesi ke NVS supaya tetap berlaku
+// setelah restart; sesi memuat master secret, jadi set 0 bila flash tidak
+// terenkripsi. Sesi OTA hanya di RAM.
+#define TLS_SESSION_PERSIST 1
+#define TLS_SESSION_LIFETIME_SEC (12UL * 3600UL)
 
 // Sertifikat Root CA untuk HiveMQ Cloud (ISRG Root X1)
 const char* HIVE_MQ_ROOT_CA = R"EOF(
@@ -84,32 +116,140 @@ struct MqttTopics {
     const char* firmware_current = "jamur/firmware/current";
     const char* firmware_new = "jamur/firmware/new_available";
     const char* firmware_update = "jamur/firmware/update";
+    const char* rollout_report = "jamur/firmware/rollout/report";
+    const char* rollout_halt = "jamur/firmware/rollout/halt";
     const char* speedtest = "jamur/speedtest";
     const char* pump_countdown = "jamur/pump/countdown";
+    const char* telemetry_backlog = "jamur/telemetry/backlog";
+    const char* telemetry_batch = "jamur/telemetry/batch";
+    const char* metrics = "jamur/metrics";
+    // Topik paralel format biner (MessagePack), lihat lib/WireCodec.
+    const char* telemetry_bin = "jamur/bin/telemetry";
+    const char* notification_bin = "jamur/bin/notifications";
+    const char* speedtest_bin = "jamur/bin/speedtest";
+    const char* config_get_bin = "jamur/bin/config/get";
+    const char* config_set_bin = "jamur/bin/config/set";
+    // Pola snprintf, %s = nama zona rak (config_set {"zones": [...]}).
+    const char* zone_telemetry = "jamur/%s/telemetry";
+    const char* zone_telemetry_bin = "jamur/bin/%s/telemetry";
 };
 const MqttTopics TOPICS;
 
 // ---------------- TIME & SCHEDULING ---------------------
 const char* NTP_SERVER = "pool.ntp.org";
+// Server NTP di jaringan lokal (router/NAS), dicoba sebelum NTP_SERVER.
+// Kosong = hanya pool internet. Bisa diganti lewat config_set {"ntp": "..."}.
+const char* NTP_SERVER_LAN = "";
 const long GMT_OFFSET_SEC = 7 * 3600;
 const int DAYLIGHT_OFFSET_SEC = 0;
+// Sinkron ulang SNTP; di antaranya jam berjalan dari kristal.
+#define TIME_SYNC_INTERVAL_MS 3600000UL
+// Jadwal penyiraman hanya jalan bila perkiraan galat jam di bawah ini.
+#define TIME_MAX_ERROR_MS 60000UL
+// Drift kristal yang diasumsikan sebelum terukur (ESP32: +-40 ppm).
+#define TIME_DRIFT_ASSUMED_PPM 50.0f
+// Jarak minimum tulis waktu terakhir ke NVS (batas bawah setelah mati listrik).
+#define TIME_PERSIST_INTERVAL_S 21600UL
+// Slot jadwal yang terlewat (control_task tertahan) masih disiram bila
+// telatnya tidak lebih dari ini; lebih lama dari itu dilewati.
+#define SCHEDULE_CATCHUP_SEC 900UL
 
 // ---------------- INTERVAL & DURATION -------------------
 #define PUMP_DURATION_MS 30000
+// Profil siram default (bisa diganti lewat config_set {"pump": {...}}).
+// Default = perilaku lama: satu semburan PUMP_DURATION_MS tanpa batas harian.
+#define PUMP_PER_PCT_DEFAULT_S 0
+#define PUMP_MAX_DEFAULT_S 120
+#define PUMP_PULSE_DEFAULT_S 0
+#define PUMP_SOAK_DEFAULT_S 0
+// Batas atas max/pulse/soak (detik) yang diterima config_set.
+#define PUMP_PROFILE_MAX_S 1800
+#define PUMP_PER_PCT_MAX_S 60
+// Debit pompa terpasang, untuk konversi budget liter <-> detik on-time.
+#define PUMP_FLOW_ML_PER_MIN 1000.0f
+#define PUMP_MAX_BUDGET_L 1000
 #define LOGIC_CHECK_INTERVAL_MS 5000
+// Kontrol zona kelembapan (config_set {"control": {...}}): zona lebih baik
+// baru dimasuki setelah ambang + hysteresis, zona bertahan minimal dwell,
+// dan di zona warning pompa menyala lebih awal bila kelembapan turun lebih
+// cepat dari laju ini (%RH/menit, 0 = mati).
+#define CONTROL_HYSTERESIS_DEFAULT 2.0f
+#define CONTROL_DWELL_DEFAULT_S 60
+#define CONTROL_FALL_RATE_DEFAULT 0.5f
+#define CONTROL_HYSTERESIS_MAX 10.0f
+#define CONTROL_DWELL_MAX_S 3600
+#define CONTROL_FALL_RATE_MAX 20.0f
+// Mode prediktif (config_set {"predict": {...}}, default mati): model
+// peluruhan per ruang dari riwayat, pulsa pendek dijadwalkan sebelum
+// kelembapan keluar dari setpoint +- band. Ambang kritis tetap aktif.
+#define MIST_SETPOINT_DEFAULT 83.0f
+#define MIST_BAND_DEFAULT 3.0f
+#define MIST_HORIZON_DEFAULT_S 60
+#define MIST_MIN_PULSE_MS 3000
+#define MIST_BAND_MAX 10.0f
+#define MIST_HORIZON_MAX_S 3600
+// DHT dibaca tiap interval ini tanpa memblokir control_task; logika pompa
+// memakai keluaran filter (median 5 sampel + EMA), bukan sampel mentah.
+#define DHT_SAMPLE_INTERVAL_MS 2000
+#define DHT_EMA_ALPHA 0.5f
+// Sampel yang menyimpang lebih dari ini dari median ditolak, kecuali
+// berulang beberapa kali (perubahan nyata).
+#define DHT_MAX_JUMP_RH 8.0f
+#define DHT_MAX_JUMP_C 3.0f
+// Tanpa sampel diterima selama ini, kontrol otomatis berhenti dan notifikasi dikirim.
+#define DHT_STALE_MS 30000UL
+// Saat boot bus LCD dipindai: SHT4x, SHT3x (0x44/0x45) lalu BME280
+// (0x76/0x77). Sensor pertama yang menjawab menggantikan DHT zona utama
+// (filter dan ambang DHT_* di atas tetap dipakai); tanpa sensor I2C,
+// DHT_PIN dibaca seperti biasa. 0 = lewati pemindaian.
+#define SENSOR_I2C_AUTODETECT 1
+#define SENSOR_I2C_INTERVAL_MS 500
+// 100 kHz: batas backpack PCF8574 LCD yang berbagi bus.
+#define I2C_CLOCK_HZ 100000
+// Batas atas config_set {"sensor": {"sample_ms": ...}}; batas bawah
+// mengikuti sensor (DHT11 1 s, DHT22 2 s, I2C 200 ms).
+#define SENSOR_SAMPLE_MAX_MS 10000
 #define WIFI_SIGNAL_PUBLISH_INTERVAL_MS 60000
 #define DEBOUNCE_DELAY_MS 50
 #define LONG_PRESS_MS 1500
 #define NOTIF_PERIODIC_INTERVAL_MS 60000
 #define NOTIF_RETRY_COUNT 3
 #define NOTIF_RETRY_DELAY_MS 500
-#define MQTT_RETRY_INTERVAL 5000UL
 #define WIFI_RECONNECT_DELAY 10000UL
 #define WIFI_CONNECT_ATTEMPTS 20
 #define WIFI_CONNECT_DELAY 500
 #define NTP_RETRY_DELAY 1000
+
+// ---------------- WIFI ROAMING --------------------------
+// Connect terarah ke BSSID/channel terakhir yang berhasil; bila gagal, scan
+// lalu coba kandidat dari semua kredensial tersimpan, urut RSSI.
+#define WIFI_FAST_CONNECT_TIMEOUT_MS 1500
+#define WIFI_CANDIDATE_TIMEOUT_MS ((unsigned long)WIFI_CONNECT_ATTEMPTS * WIFI_CONNECT_DELAY)
 #define ERROR_RESTART_DELAY 5000
 
+// ---------------- PORTAL AP -----------------------------
+// Scan WiFi async dan uji koneksi dari portal, keduanya dipoll di loop().
+#define PORTAL_SCAN_MAX 16
+#define PORTAL_SCAN_MAX_AGE_MS 30000UL
+#define PORTAL_CONNECT_TIMEOUT_MS 15000UL
+// AP dibiarkan hidup sebentar setelah sukses agar browser sempat membaca /status.
+#define PORTAL_HANDOFF_MS 5000UL
+#define PORTAL_JSON_SIZE 1600
+
+// ---------------- TASK LAYOUT ---------------------------
+// Kontrol (sensor, pompa) di core 1 prioritas tinggi; jaringan (WiFi, MQTT,
+// OTA) di core 0. UI (tombol, LCD, portal AP) tetap di loop() Arduino.
+#define CONTROL_TASK_STACK 4096
+#define CONTROL_TASK_PRIORITY 5
+#define CONTROL_TASK_CORE 1
+#define CONTROL_TASK_PERIOD_MS 100
+#define NETWORK_TASK_STACK 12288
+#define NETWORK_TASK_PRIORITY 3
+#define NETWORK_TASK_CORE 0
+#define NETWORK_TASK_PERIOD_MS 50
+#define PUMP_COMMAND_QUEUE_LEN 4
+#define NET_EVENT_QUEUE_LEN 16
+
 // ---------------- SUPABASE CONFIG -----------------------
 const char* SUPABASE_URL = SECRET_SUPABASE_URL;
 const char* SUPABASE_KEY = SECRET_SUPABASE_KEY;
@@ -121,6 +261,94 @@ const char* SUPABASE_KEY = SECRET_SUPABASE_KEY;
 #define SPEEDTEST_UPLOAD_URL "http://httpbin.org/post"
 #define SPEEDTEST_UPLOAD_SIZE (1024 * 10)
 #define SPEEDTEST_RSSI_THRESHOLD -70
+#define SPEEDTEST_WEAK_RSSI_INTERVAL_MS 300000
+#define SPEEDTEST_BACKOFF_MAX_MS (60UL * 60 * 1000)
+#define SPEEDTEST_TIME_BUDGET_MS 20000
+#define SPEEDTEST_HTTP_TIMEOUT_MS 8000
+#define SPEEDTEST_DAILY_BYTE_BUDGET (20UL * 1024 * 1024)
+#define SPEEDTEST_YIELD_EVERY_BYTES 4096
+#define SPEEDTEST_YIELD_MS 5
+#define SPEEDTEST_POLL_MS 1000
+#define SPEEDTEST_TASK_STACK 6144
+#define SPEEDTEST_TASK_PRIORITY 1
+#define SPEEDTEST_TASK_CORE 0
+#define SPEEDTEST_RESULT_QUEUE_LEN 2
+
+// ---------------- TELEMETRY BUFFER (STORE & FORWARD) ----
+// Pembacaan yang tidak bisa dipublish (WiFi/MQTT putus) disimpan di ring
+// RAM; bila penuh, blok tertua dipindah ke NVS lalu direplay setelah
+// reconnect dalam batch yang dijeda agar keepalive MQTT tetap jalan.
+#define TELEMETRY_BUFFER_LEN 360
+#define TELEMETRY_SPILL_ENABLED 1
+#define TELEMETRY_SPILL_PAGE_LEN 32
+// Satu halaman = blob 384 byte, ~14 entri NVS (32 byte) termasuk header dan
+// indeks blob. Partisi nvs 20 KB hanya ~500 entri dan juga dipakai config,
+// zona, WiFi dan waktu, jadi spill dibatasi ~110 entri (256 pembacaan).
+#define TELEMETRY_SPILL_PAGES 8
+#define TELEMETRY_REPLAY_BATCH 10
+#define TELEMETRY_REPLAY_INTERVAL_MS 500
+#define TELEMETRY_BATCH_PAYLOAD_SIZE 768
+// Minimal CONFIG_BUFFER_SIZE + header: config_get dipublish utuh.
+#define MQTT_BUFFER_SIZE 3200
+
+// ---------------- TELEMETRY BATCH MODE ------------------
+// Jendela batch (detik) diatur lewat config_set "telemetry_batch"; 0 = mode
+// live (satu pesan per pembacaan). Dalam mode batch, wifi_signal, status
+// periodik dan countdown per detik ikut dilebur ke pesan batch.
+#define TELEMETRY_BATCH_DEFAULT_SEC 0
+#define TELEMETRY_BATCH_MIN_SEC 10
+#define TELEMETRY_BATCH_MAX_SEC 300
+#define TELEMETRY_BATCH_MAX_SAMPLES (TELEMETRY_BATCH_MAX_SEC * 1000 / LOGIC_CHECK_INTERVAL_MS)
+#define TELEMETRY_BATCH_PAYLOAD_SIZE_MAX 1000
+
+// ---------------- STAGE METRICS -------------------------
+// Histogram latency per tahap (lib/StageMetrics) dipublish ke jamur/metrics
+// lalu direset; ketik "metrics" di serial untuk dump jendela berjalan.
+#define METRICS_PUBLISH_INTERVAL_MS 300000
+#define METRICS_PAYLOAD_SIZE 960
+// Cycle counter 32-bit wrap tiap ~17.9 s pada 240 MHz; tahap yang lebih
+// lama dari ini diukur dengan millis().
+#define METRICS_CYCLE_WRAP_GUARD_MS 10000
+#define SERIAL_COMMAND_SIZE 112
+
+// ---------------- OTA UPDATE ----------------------------
+// Unduhan dan penulisan flash berjalan paralel lewat OTA_BUFFER_COUNT buffer:
+// network_task membaca stream, ota_writer menulis ke flash sekaligus
+// menghitung SHA-256. Percobaan ulang melanjutkan dari offset yang sudah
+// di-flash dengan header Range; OTA_MAX_RETRY = percobaan berturut-turut
+// tanpa byte baru.
+#define OTA_BUFFER_SIZE 4096
+#define OTA_BUFFER_COUNT 2
+#define OTA_MAX_RETRY 3
+#define OTA_RETRY_DELAY_MS 2000
+#define OTA_HTTP_TIMEOUT_MS 30000
+#define OTA_WRITER_TASK_STACK 4096
+#define OTA_WRITER_TASK_PRIORITY 4
+#define OTA_WRITER_TASK_CORE 1
+// 1 = tolak update tanpa "sha256" (hex) di perintah atau di
+// jamur/firmware/new_available; 0 = tetap jalan dengan peringatan.
+#define OTA_REQUIRE_SHA256 0
+// Patch delta (lib/DeltaPatch) dipakai bila perintah membawa "patch_url",
+// "sha256", dan "patch_from" sama dengan FIRMWARE_VERSION. Patch dibaca per
+// OTA_PATCH_READ_SIZE byte; gagal di mana pun = ulang dengan image penuh.
+#define OTA_DELTA_ENABLED 1
+#define OTA_PATCH_READ_SIZE 1024
+
+// ---------------- FIRMWARE ROLLOUT ----------------------
+// Update dari jamur/system/update (dan new_available yang membawa objek
+// "rollout") tidak langsung diunduh. Perangkat masuk cohort
+// FNV-1a(mqttClientId) % ROLLOUT_COHORTS; hanya cohort < "percent" yang
+// ikut, mulai setelah ramp_s * cohort / ROLLOUT_COHORTS detik ditambah jeda
+// acak dalam window_s. Backend memperluas rollout dengan menaikkan percent.
+// Laporan gagal di rollout_report menghentikan versi itu setelah
+// ROLLOUT_HALT_FAILURES perangkat (id) berbeda melapor; "force": true
+// melewati semua ini.
+#define ROLLOUT_COHORTS 100
+#define ROLLOUT_DEFAULT_WINDOW_S 600
+#define ROLLOUT_HALT_FAILURES 3
+// Percobaan per versi (di NVS); perangkat yang terus gagal berhenti sendiri.
+#define ROLLOUT_MAX_ATTEMPTS 2
+#define ROLLOUT_PAYLOAD_SIZE 256
 
 // ---------------- DEVICE LOCATION -----------------------
 #define DEVICE_LATITUDE  -7.797068
@@ -128,20 +356,38 @@ const char* SUPABASE_KEY = SECRET_SUPABASE_KEY;
 
 // ---------------- BUFFER & PAYLOAD SIZE -----------------
 #define LCD_LINE_LENGTH 17
-#define OTA_BUFFER_SIZE 2048
-#define OTA_MAX_RETRY 3
-#define OTA_HTTP_TIMEOUT_MS 30000
 #define PERIODIC_MSG_SIZE 128
 #define NOTIF_PAYLOAD_SIZE 256
 #define TELEMETRY_PAYLOAD_SIZE 100
-#define WIFI_SIGNAL_PAYLOAD_SIZE 50
-#define CONFIG_BUFFER_SIZE 256
+#define ZONE_TOPIC_SIZE 48
+#define BIN_PAYLOAD_SIZE 192
+#define WIFI_SIGNAL_PAYLOAD_SIZE 160
+// config_get dengan 32 entri jadwal lengkap (~36 byte per entri), profil
+// pompa dan ZONE_MAX zona rak dengan jadwalnya (~400 byte per zona).
+#define CONFIG_BUFFER_SIZE 3072
 #define VERSION_PAYLOAD_SIZE 50
 #define FIRMWARE_STATUS_PAYLOAD_SIZE 64
 #define FIRMWARE_UPDATE_PAYLOAD_SIZE 128
 #define SCHEDULE_MSG_SIZE 128
 #define PUMP_MSG_SIZE 128
+#define PUMP_REASON_SIZE 16
+#define NOTIF_TYPE_SIZE 16
 
 // ---------------- EMAIL NOTIF RATE LIMIT ----------------
 #define EMAIL_MIN_INTERVAL_FIRMWARE_MS (6UL * 60 * 60 * 1000)
 #define EMAIL_MIN_INTERVAL_ALERT_MS    (1UL * 60 * 60 * 1000) 
+
+// ---------------- EMAIL QUEUE (WORKER TASK) -------------
+#define EMAIL_QUEUE_LEN 4
+#define EMAIL_TYPE_SIZE 24
+#define EMAIL_MESSAGE_SIZE 96
+#define EMAIL_VERSION_SIZE 16
+#define EMAIL_NOTES_SIZE 256
+#define EMAIL_PAYLOAD_SIZE 512
+#define EMAIL_URL_SIZE 160
+#define EMAIL_MAX_ATTEMPTS 3
+#define EMAIL_RETRY_DELAY_MS 30000
+#define EMAIL_HTTP_TIMEOUT_MS 10000
+#define EMAIL_TASK_STACK 8192
+#define EMAIL_TASK_PRIORITY 1
+#define EMAIL_TASK_CORE 0
@@ -4,27 +4,70 @@
 // ==========================================================
 // ==    DEKLARASI OBJEK GLOBAL, STRUCT, ENUM, PROTOTYPE   ==
 // ==========================================================
+#include <atomic>
+#include <esp_timer.h>
 #include <ArduinoJson.h>
 #include <WiFiClientSecure.h>
 #include <PubSubClient.h>
 #include <LiquidCrystal_I2C.h>
 #include <Preferences.h>
-#include <DHT.h>
+#include <ClimateSensor.h>
+#include <DhtSampler.h>
+#include <SensorFilter.h>
+#include <WireCodec.h>
+#include <LatencyHistogram.h>
+#include <TlsSession.h>
+#include <WifiRoam.h>
+#include <TimeSync.h>
+#include <WaterSchedule.h>
+#include <PumpEngine.h>
+#include <HumidityControl.h>
+#include <MistPredictor.h>
 
 // ---------------- GLOBAL OBJECTS & VARIABLES -------------
 class WebServer;
 extern WebServer server;
-extern WiFiClientSecure espClient;
+extern TlsSessionClient espClient;
+extern WifiCredentialStore wifiCredentials;
+extern WifiRoamer wifiRoamer;
+extern TimeSync timeSync;
+extern WaterSchedule waterSchedule;
+extern PumpEngine pumpEngine;
 extern PubSubClient mqttClient;
 extern LiquidCrystal_I2C lcd;
 extern Preferences preferences;
-extern DHT dht;
+extern DhtSampler dhtSampler;
+extern I2cBus i2cBus;
+extern Sensor* primarySensor;
+
+// Satu zona rak selain zona utama. Pin dan tipe sensor dipasang saat zona
+// pertama kali aktif; ambang, lama siram dan jadwal berlaku langsung.
+struct ZoneConfig {
+    char name[ZONE_NAME_SIZE];     // segmen topik jamur/<name>/telemetry
+    uint8_t dht_pin;
+    uint8_t dht_type;              // 11 atau 22
+    uint8_t relay_pin;
+    float humidity_critical;
+    float humidity_warning;
+    uint16_t pump_s;               // lama siram otomatis saat kritis
+    ScheduleEntry schedules[ZONE_MAX_SCHEDULES];
+    uint8_t schedule_count;
+};
 
 struct DeviceConfig {
     float humidity_critical;
     float humidity_warning;
-    int schedule_hours[5];
-    int schedule_count;
+    ScheduleEntry schedules[WaterSchedule::kMaxEntries];
+    uint8_t schedule_count;
+    PumpProfile pump;
+    ControlTuning control;
+    MistTuning mist;
+    uint16_t telemetry_batch_sec;
+    WireFormat wire_format;
+    char ntp_server[TimeSync::kMaxServer];
+    uint16_t sample_ms;            // interval baca sensor utama, 0 = default sensor
+    ZoneConfig zones[ZONE_MAX];
+    uint8_t zone_count;
 };
 
 struct NotificationData {
@@ -36,10 +79,194 @@ struct NotificationData {
     String release_notes = "";
 };
 
+// Salinan NotificationData berukuran tetap untuk antrian email; tidak ada
+// String sehingga antrian tidak pernah mengalokasi heap.
+struct EmailJob {
+    char type[EMAIL_TYPE_SIZE];
+    char message[EMAIL_MESSAGE_SIZE];
+    float humidity;
+    float temperature;
+    char version[EMAIL_VERSION_SIZE];
+    char release_notes[EMAIL_NOTES_SIZE];
+};
+
+struct TelemetryRecord {
+    uint32_t timestamp;   // epoch UTC (detik)
+    float humidity;
+    float temperature;
+};
+
+struct TelemetryBufferStats {
+    uint32_t ram_depth;
+    uint32_t flash_depth;
+    uint32_t dropped;
+    uint32_t replayed;
+};
+
+struct SpeedtestResult {
+    float ping_ms;
+    float download_mbps;
+    float upload_mbps;
+    uint32_t duration_ms;
+    uint32_t bytes;
+    bool cancelled;             // dibatalkan dari luar, hasil dibuang
+    bool timed_out;             // SPEEDTEST_TIME_BUDGET_MS habis, hasil parsial
+};
+
+// Tahap yang diukur; urutan harus sama dengan METRIC_STAGE_NAMES di main.cpp.
+enum MetricStage : uint8_t {
+    STAGE_UI_LOOP,
+    STAGE_DISPLAY,
+    STAGE_CONTROL,
+    STAGE_MAIN_LOGIC,
+    STAGE_WIFI,
+    STAGE_MQTT_DNS,
+    STAGE_MQTT_TLS,
+    STAGE_MQTT_CONNACK,
+    STAGE_MQTT_SUBSCRIBE,
+    STAGE_MQTT_LOOP,
+    STAGE_NET_EVENT,
+    STAGE_NET_LOGIC,
+    STAGE_SPEEDTEST,
+    STAGE_EMAIL,
+    STAGE_COUNT
+};
+
+// Tahapan koneksi MQTT non-blocking, dijalankan oleh try_reconnect_mqtt().
+enum MqttLinkState : uint8_t {
+    LINK_IDLE,
+    LINK_BACKOFF,
+    LINK_DNS,
+    LINK_TLS,
+    LINK_CONNECT,
+    LINK_SUBSCRIBE,
+    LINK_UP
+};
+
+struct MqttLink {
+    MqttLinkState state;
+    uint8_t subscribeIndex;
+    uint32_t failures;          // gagal berturut-turut, dasar backoff
+    uint32_t attempts;
+    uint32_t connects;
+    unsigned long nextAttemptAt;
+    uint32_t jitterState;       // PRNG per perangkat, diturunkan dari mqttClientId
+    uint32_t phaseMs[LINK_UP];  // durasi tiap tahap pada percobaan terakhir
+};
+
+struct StageStamp {
+    uint32_t cycles;
+    uint32_t ms;
+};
+
+// Perintah ke control_task; satu-satunya jalur untuk menyalakan/mematikan pompa.
+enum PumpCommandType : uint8_t { PUMP_CMD_ON, PUMP_CMD_OFF };
+
+struct PumpCommand {
+    PumpCommandType type;
+    char reason[PUMP_REASON_SIZE];
+};
+
+// On-time relay aktual vs diminta; diisi control_task dan callback cutoff.
+struct PumpTiming {
+    uint32_t pulseStartUs;
+    uint32_t pulseRequestedMs;  // 0 = relay tidak sedang menyala
+    uint32_t requestedMs;       // per program
+    uint32_t actualMs;          // per program
+    uint32_t maxOverrunUs;      // per program
+    uint16_t timerCutoffs;      // per program: pulsa yang dijatuhkan esp_timer
+    uint32_t worstOverrunUs;    // sejak boot
+};
+
+// Keadaan runtime satu slot zona rak, dipasangkan ke config.zones lewat name.
+// Slot ke-i memakai kanal RMT ZONE_RMT_CHANNEL_BASE + i; sampler dan
+// timer dibuat ulang bila pin/tipe zona diganti. sampler, name dan schedule
+// dijaga configMutex seperti waterSchedule.
+struct ZoneRuntime {
+    DhtSampler* sampler = nullptr;
+    bool installed = false;     // begin() sampler berhasil
+    bool active = false;        // ikut rotasi pembacaan
+    uint8_t dhtPin = 0;
+    uint8_t dhtType = 0;
+    uint8_t relayPin = 0;
+    char name[ZONE_NAME_SIZE] = "";
+    SensorFilter humidity{0.0f, 100.0f, DHT_MAX_JUMP_RH, DHT_EMA_ALPHA};
+    SensorFilter temperature{-20.0f, 60.0f, DHT_MAX_JUMP_C, DHT_EMA_ALPHA};
+    HumidityControl control;
+    WaterSchedule schedule;
+    unsigned long lastAcceptTime = 0;
+    unsigned long lastLogicTime = 0;
+    bool healthy = true;
+    std::atomic<bool> pumpOn{false};
+    unsigned long pumpStoppedAt = 0;
+    uint32_t pulseStartUs = 0;
+    uint32_t pulseRequestedMs = 0;
+    esp_timer_handle_t cutoffTimer = nullptr;
+    std::atomic<uint32_t> cutoffUs{0};
+    uint32_t pumps = 0;         // sejak slot dipasang
+    uint32_t pumpMs = 0;
+};
+
+// Kejadian dari control_task yang harus dipublish oleh network_task
+// (PubSubClient hanya dipakai dari satu task).
+enum NetEventType : uint8_t {
+    NET_EVT_TELEMETRY, NET_EVT_NOTIFICATION, NET_EVT_PUMP_STARTED, NET_EVT_PUMP_STOPPED, NET_EVT_ZONE_TELEMETRY
+};
+
+struct NetEvent {
+    NetEventType type;
+    uint8_t zone;               // NET_EVT_ZONE_TELEMETRY: slot zoneRuntime, nama zona di text
+    TelemetryRecord record;
+    char kind[NOTIF_TYPE_SIZE];
+    char text[PERIODIC_MSG_SIZE];
+    uint32_t duration_ms;       // NET_EVT_PUMP_STARTED: sisa program termasuk jeda rendam
+};
+
 struct FirmwareInfo {
     String version = "";
     String release_notes = "";
     String url = "";
+    String sha256 = "";
+    String patch_url = "";
+    String patch_from = "";
+};
+
+// Update firmware yang menunggu giliran rollout bertahap (ROLLOUT_*).
+struct FirmwareRollout {
+    FirmwareInfo target;
+    bool pending = false;
+    unsigned long dueAt = 0;       // millis() saat unduhan boleh mulai
+    uint8_t cohort = 0;
+    String reportVersion = "";     // versi yang laporan gagalnya sedang dihitung
+    uint16_t failureReports = 0;   // perangkat berbeda, id-nya di reporters
+    char reporters[ROLLOUT_HALT_FAILURES][MQTT_CLIENT_ID_LENGTH] = {};
+    String haltedVersion = "";
+};
+
+// Satu buffer OTA yang sudah terisi, dikirim ke ota_writer.
+struct OtaChunk {
+    uint8_t index;
+    uint16_t length;
+};
+
+// Satu jaringan hasil scan untuk portal AP (SSID ganda digabung, RSSI terkuat).
+struct PortalNetwork {
+    char ssid[33];
+    int8_t rssi;
+    uint8_t channel;
+    uint8_t auth;                  // wifi_auth_mode_t, 0 = terbuka
+};
+
+enum PortalConnectState : uint8_t { PORTAL_CONNECT_IDLE, PORTAL_CONNECT_TESTING, PORTAL_CONNECT_OK, PORTAL_CONNECT_FAILED };
+
+// Uji koneksi dari portal; kredensial baru disimpan hanya bila berhasil.
+struct PortalConnect {
+    PortalConnectState state = PORTAL_CONNECT_IDLE;
+    bool begun = false;            // WiFi.begin() ditunda selama scan berjalan
+    char ssid[33] = "";
+    char pass[65] = "";
+    unsigned long startedAt = 0;
+    const char* message = "";
 };
 
 extern DeviceConfig config;
@@ -52,19 +279,20 @@ enum AppState {
     STATE_MENU_INFO,
     STATE_UPDATING
 };
-extern AppState currentState;
+extern std::atomic<AppState> currentState;
 
-extern float currentHumidity, currentTemperature;
-extern bool isPumpOn;
+extern std::atomic<float> currentHumidity, currentTemperature;
+extern std::atomic<bool> isPumpOn;
+extern std::atomic<bool> mqttConnected;
 extern char mqttClientId[40];
-extern int lastScheduledHour;
-extern unsigned long pumpStopTime;
+extern std::atomic<unsigned long> pumpStopTime;
 extern unsigned long btnOkPressTime;
 extern bool okButtonLongPress;
 
 // ---------------- FUNCTION PROTOTYPES --------------------
 // Initialization
 void init_hardware();
+void init_primary_sensor();
 void load_config();
 void save_config();
 void init_storage_and_wifi();
@@ -76,7 +304,6 @@ void loop();
 
 // State Management
 void handle_connecting_state();
-void handle_normal_operation();
 void start_ap_mode();
 void handle_web_root();
 void handle_web_save();
@@ -92,39 +319,107 @@ void display_menu_info();
 // Input
 void check_buttons();
 
+// Tasks
+void control_task(void* param);
+void network_task(void* param);
+void start_control_task();
+void start_network_task();
+bool request_pump(PumpCommandType type, const char* reason = "");
+bool post_net_event(const NetEvent& event);
+void handle_net_event(const NetEvent& event);
+void handle_network_logic();
+
+// Metrics
+StageStamp stage_begin();
+uint32_t stage_end(MetricStage stage, const StageStamp& start);
+void publish_metrics();
+void dump_metrics();
+void handle_wifi_command(const char* args);
+void check_serial_commands();
+
 // Control Logic
 void handle_main_logic();
+void handle_sensor_sample();
+void apply_sample_rate();
+void report_sensor_health(bool healthy);
 void run_humidity_control_logic(float humidity);
-void run_scheduled_control(float humidity);
-void turn_pump_on(const char* reason);
+void run_scheduled_control(float humidity, bool timeTrusted);
+bool parse_schedule_entry(JsonVariantConst value, ScheduleEntry& entry);
+void append_schedule_json(JsonArray out, const ScheduleEntry* entries, uint8_t count);
+uint32_t turn_pump_on(const char* reason, uint32_t durationMs);
 void turn_pump_off();
+void service_pump();
+void init_pump_cutoff_timer();
+void pump_cutoff_callback(void* arg);
+void pump_relay_on(uint32_t requestedMs);
+void pump_relay_off();
+float pump_budget_liters(const PumpProfile& profile);
+bool parse_pump_profile(JsonVariantConst value, PumpProfile& profile);
+bool parse_control_tuning(JsonVariantConst value, ControlTuning& tuning);
+bool parse_mist_tuning(JsonVariantConst value, MistTuning& tuning);
+void save_pump_usage();
 void publish_pump_countdown(int seconds);
 void update_pump_countdown();
 
+// Zones
+void sync_zones();
+void poll_zones();
+uint32_t zones_until_next(uint32_t nowMs);
+void handle_zone_sample(uint8_t index);
+void run_zone_logic(uint8_t index);
+bool zone_pump_on(uint8_t index, const char* reason, uint32_t durationMs);
+void zone_pump_off(uint8_t index);
+void zone_cutoff_callback(void* arg);
+bool zone_pin_usable(int pin);
+bool parse_zone_config(JsonVariantConst value, ZoneConfig& zone);
+bool zone_table_valid(const ZoneConfig* zones, uint8_t count);
+
 // Communication
+void check_and_reconnect_wifi();
+void log_wifi_roam();
+void log_time_sync();
 void try_reconnect_mqtt();
+void mqtt_link_init();
+void mqtt_link_fail(const char* phase);
+void mqtt_link_schedule_retry();
+void on_mqtt_connected();
 void mqtt_callback(char* topic, byte* payload, unsigned int length);
-void handle_config_update(byte* payload, unsigned int length);
+void handle_config_update(byte* payload, unsigned int length, WireFormat format);
 bool publish_with_retry(const char* topic, const char* payload, bool retained = false, int retry = 3, int delayMs = 500);
 void send_notification(const char* type, const char* message, float humidity = -1, float temperature = -1);
-void publish_telemetry();
+void publish_notification(const char* type, const char* message, float humidity = -1, float temperature = -1);
+void publish_telemetry(const TelemetryRecord& record);
+void publish_zone_telemetry(uint8_t index, const TelemetryRecord& record);
 void publish_wifi_signal();
 void publish_config();
 void publish_current_version();
 void publish_firmware_status(const char* status);
 void publish_firmware_update_progress(const char* stage, int progress, const char* message = nullptr);
-void trigger_email_notification(const NotificationData& data);
+void buffer_telemetry(const TelemetryRecord& record);
+void replay_telemetry_backlog();
+void add_telemetry_batch_sample(const TelemetryRecord& record);
+void publish_telemetry_batch();
+bool trigger_email_notification(const EmailJob& job);
+bool queue_email_notification(const NotificationData& data);
+void email_task(void* param);
+void start_email_task();
 void check_for_firmware_update();
 
 // OTA Update
-void perform_ota_update(String url);
+void perform_ota_update(String url, String sha256, String patchUrl, String patchFrom);
 void handle_ota_error(const char* lcdMsg, const char* logMsg, int code = 0);
 
-// Speedtest
+// Speedtest (background task)
 float speedtest_ping_ms(const char* host = "8.8.8.8", uint16_t port = 53, uint8_t count = 4);
 float speedtest_download_mbps(const char* url = SPEEDTEST_DOWNLOAD_URL, size_t test_size = SPEEDTEST_DOWNLOAD_SIZE);
 float speedtest_upload_mbps(const char* url = SPEEDTEST_UPLOAD_URL, size_t test_size = SPEEDTEST_UPLOAD_SIZE);
-void run_and_publish_speedtest();
+bool speedtest_cancelled();
+bool speedtest_should_abort();
+void run_speedtest(SpeedtestResult& result);
+void speedtest_task(void* param);
+void start_speedtest_task();
+void cancel_speedtest();
+void poll_speedtest_result();
 void publish_speedtest(float ping_ms, float download_mbps, float upload_mbps);
 
 // Utility
@@ -0,0 +1,226 @@
+// include/portal_assets.h
+// DIHASILKAN oleh tools/build_portal.py dari portal/*; jangan diedit manual.
+// Total 4830 B teks -> 2587 B deflate.
+#pragma once
+
+#include <GzipTemplate.h>
+
+enum PortalField : uint8_t {
+    PORTAL_FIELD_SSID,
+    PORTAL_FIELD_MESSAGE,
+    PORTAL_FIELD_COUNT
+};
+
+static const uint8_t PORTAL_INDEX_SEG0[] = {
+    0x3c, 0x51, 0xc1, 0x8e, 0xd3, 0x30, 0x10, 0xfd, 0x95, 0xc1, 0x5c, 0x40, 0xa2, 0x8d, 0x7a, 0x43,
+    0x28, 0xc9, 0x85, 0x65, 0xa5, 0x2e, 0x02, 0x2a, 0x75, 0x25, 0xc4, 0x71, 0x1a, 0x4f, 0x92, 0x21,
+    0x8e, 0x1d, 0xd9, 0xe3, 0x96, 0xde, 0x39, 0x72, 0xe4, 0xce, 0x37, 0xf0, 0x67, 0x7c, 0x02, 0x93,
+    0xa4, 0xbb, 0x17, 0xcb, 0x33, 0x7e, 0xef, 0xf9, 0xcd, 0x9b, 0xf2, 0xc5, 0xdd, 0x97, 0xf7, 0x8f,
+    0xdf, 0x0e, 0x1f, 0xa0, 0x97, 0xd1, 0xd5, 0xe5, 0xed, 0x24, 0xb4, 0x75, 0x39, 0x92, 0x20, 0x34,
+    0x3d, 0xc6, 0x44, 0x52, 0x99, 0x2c, 0xed, 0xe6, 0xad, 0xa9, 0x4b, 0x61, 0x71, 0x54, 0x3f, 0xe0,
+    0x98, 0x23, 0xec, 0xc3, 0x23, 0x1c, 0x49, 0xf2, 0x54, 0x16, 0x6b, 0x7b, 0xe5, 0x78, 0x1c, 0xa9,
+    0x32, 0x67, 0xa6, 0xcb, 0x14, 0xa2, 0x18, 0x68, 0x82, 0x17, 0xf2, 0xaa, 0x71, 0x61, 0x2b, 0x7d,
+    0x65, 0xe9, 0xcc, 0x0d, 0x6d, 0x96, 0xe2, 0x0d, 0xb0, 0x67, 0x61, 0x74, 0x9b, 0xd4, 0xa0, 0xa3,
+    0x6a, 0xa7, 0x3f, 0x38, 0xf6, 0x03, 0x44, 0x72, 0x95, 0x49, 0x72, 0x75, 0x94, 0x7a, 0x22, 0x15,
+    0xe9, 0x23, 0xb5, 0x95, 0x29, 0x66, 0x45, 0x74, 0xdb, 0x26, 0x25, 0x45, 0x16, 0xab, 0xd1, 0x53,
+    0xb0, 0xd7, 0xba, 0xb4, 0x7c, 0x56, 0xe7, 0xbb, 0xfa, 0xdf, 0x9f, 0x5f, 0x7f, 0xe1, 0x63, 0xf0,
+    0x2d, 0x77, 0x39, 0x62, 0x62, 0xf8, 0xca, 0xf7, 0x0c, 0xcf, 0x86, 0x95, 0xb4, 0x5b, 0xc0, 0xd0,
+    0x38, 0x4c, 0xa9, 0x32, 0xec, 0xdb, 0xa0, 0x5a, 0x49, 0x62, 0xf0, 0x5d, 0xbd, 0xd7, 0xea, 0x5d,
+    0x59, 0xdc, 0x2a, 0x38, 0x50, 0x44, 0xdf, 0x0d, 0x28, 0x20, 0x6c, 0x71, 0x00, 0x8b, 0xd3, 0x7c,
+    0xa7, 0xd8, 0xe7, 0x53, 0xf6, 0x1d, 0x0c, 0xb4, 0xca, 0x5f, 0x15, 0x35, 0xb7, 0x13, 0x8f, 0x13,
+    0xfa, 0x2d, 0x1c, 0xd8, 0x71, 0x0f, 0xdf, 0x31, 0xb2, 0xef, 0xd0, 0x83, 0x65, 0x38, 0xe1, 0x05,
+    0x7b, 0x40, 0xc1, 0xac, 0x24, 0xe1, 0x01, 0x8e, 0xc7, 0xfd, 0x1d, 0x24, 0x6a, 0x30, 0x22, 0x8c,
+    0xe8, 0xb3, 0x4e, 0x55, 0x16, 0xcb, 0x10, 0xb3, 0x39, 0xb6, 0x95, 0xf1, 0x24, 0xc9, 0x3c, 0xd9,
+    0x5c, 0x8a, 0xfa, 0x13, 0x8d, 0xec, 0x2d, 0xf2, 0xb3, 0xf4, 0x76, 0xfb, 0xc4, 0xc2, 0x5b, 0x44,
+    0x2f, 0xcd, 0x42, 0x8e, 0xa4, 0x89, 0x7a, 0xa3, 0x71, 0xfc, 0xfe, 0xa9, 0x76, 0x16, 0x52, 0x76,
+    0x6a, 0xb3, 0x2c, 0xb0, 0x2e, 0xdb, 0x10, 0xc7, 0x05, 0x36, 0x5f, 0x0c, 0x60, 0x23, 0x1c, 0xbc,
+    0xc6, 0x9b, 0xf0, 0x4c, 0x06, 0x74, 0x8b, 0x7d, 0xd0, 0xc7, 0x29, 0x24, 0xd1, 0x68, 0xd8, 0x4f,
+    0x59, 0x87, 0xbe, 0x4e, 0xba, 0x55, 0xa1, 0x1f, 0xba, 0x8c, 0x75, 0xc3, 0x29, 0xb1, 0x35, 0x30,
+    0x39, 0x6c, 0xa8, 0x0f, 0xce, 0x52, 0xac, 0xcc, 0x67, 0x1c, 0x71, 0x4d, 0xe4, 0xd5, 0x3c, 0xdf,
+    0x6b, 0x03, 0x67, 0x74, 0x59, 0xb1, 0xff, 0x01, 0x00, 0x00, 0xff, 0xff,
+};
+static const uint8_t PORTAL_INDEX_SEG1[] = {
+    0x4c, 0x8e, 0x3b, 0x52, 0xc3, 0x30, 0x10, 0x86, 0xaf, 0xb2, 0xa3, 0x82, 0x8a, 0x89, 0x67, 0x80,
+    0xa1, 0x20, 0xb6, 0x9b, 0xcc, 0xd0, 0xd0, 0x30, 0x93, 0x82, 0x7a, 0x6d, 0x29, 0xf6, 0x26, 0xd2,
+    0x4a, 0x48, 0x2b, 0x42, 0xae, 0xc1, 0x05, 0xb8, 0x09, 0x67, 0xe2, 0x08, 0x2c, 0xd8, 0x05, 0xcd,
+    0x4a, 0xda, 0xff, 0xa1, 0xcf, 0x40, 0xc0, 0x77, 0xef, 0x78, 0x92, 0xb9, 0x33, 0xb7, 0x37, 0x06,
+    0xb2, 0x7b, 0xad, 0x94, 0x9d, 0xed, 0xdb, 0x21, 0xf7, 0x2d, 0x71, 0xaa, 0x02, 0x72, 0x49, 0xae,
+    0x33, 0x09, 0x4b, 0x39, 0xc7, 0x6c, 0x0d, 0x30, 0x86, 0xf5, 0x6d, 0x20, 0x79, 0x1c, 0xdd, 0x1c,
+    0xbd, 0x75, 0xb9, 0x33, 0xcf, 0xab, 0x05, 0x5e, 0xe8, 0x91, 0xcc, 0xff, 0xea, 0xfb, 0x3b, 0xb3,
+    0x34, 0x0e, 0x55, 0x24, 0xf2, 0x5a, 0x59, 0xea, 0x10, 0x48, 0x4c, 0xff, 0xfd, 0xf9, 0xf1, 0x05,
+    0x7b, 0x0a, 0x09, 0x19, 0xae, 0x30, 0xa4, 0x2d, 0xec, 0x31, 0x0c, 0x95, 0xa7, 0x13, 0x72, 0xdb,
+    0x2c, 0x91, 0xbe, 0x6d, 0x0e, 0x31, 0x87, 0xbe, 0xb5, 0xf4, 0x06, 0x64, 0x35, 0x2c, 0x28, 0x55,
+    0x09, 0x66, 0xb2, 0xd6, 0xfd, 0xca, 0x2a, 0x2c, 0xea, 0xe8, 0x95, 0xa3, 0x33, 0x67, 0xcc, 0x4c,
+    0x3c, 0xe9, 0xc7, 0x45, 0x72, 0xe4, 0xa9, 0xdf, 0xa1, 0x46, 0x90, 0x1f, 0xda, 0x66, 0x5d, 0xc0,
+    0x53, 0x64, 0x77, 0x2a, 0x04, 0x96, 0xea, 0x51, 0x67, 0xf5, 0x15, 0x8a, 0x1b, 0x9c, 0xaf, 0x41,
+    0x57, 0xe5, 0x0f, 0x68, 0x0b, 0x03, 0x79, 0x84, 0x09, 0x27, 0xf4, 0xd7, 0x80, 0x5a, 0x8d, 0xcc,
+    0x17, 0x04, 0x51, 0x4e, 0xf2, 0x6a, 0x83, 0x42, 0xac, 0x59, 0x45, 0x4f, 0x31, 0x0b, 0x7a, 0x10,
+    0x27, 0x98, 0x00, 0x4f, 0x42, 0x87, 0xcd, 0x4a, 0xb5, 0xcc, 0x32, 0x66, 0x4a, 0x02, 0x25, 0x8f,
+    0x9d, 0x69, 0x16, 0xf3, 0xe6, 0x58, 0x94, 0xaf, 0x59, 0x14, 0xbd, 0x0c, 0xd1, 0x5e, 0xf4, 0x98,
+    0x25, 0xf8, 0xfe, 0x07, 0x00, 0x00, 0xff, 0xff,
+};
+static const GzipSegment PORTAL_INDEX_SEGMENTS[] = {
+    { PORTAL_INDEX_SEG0, 412, 617, 0xfcc502a0UL },
+    { PORTAL_INDEX_SEG1, 280, 412, 0x24e4e728UL },
+};
+static const uint8_t PORTAL_INDEX_FIELDS[] = { PORTAL_FIELD_SSID };
+static const GzipAsset PORTAL_INDEX = { PORTAL_INDEX_SEGMENTS, 2, PORTAL_INDEX_FIELDS, "text/html" };
+
+static const uint8_t PORTAL_ERROR_SEG0[] = {
+    0x2c, 0x4f, 0x4b, 0x6e, 0x02, 0x31, 0x0c, 0xbd, 0x8a, 0xc9, 0xba, 0xd3, 0xd1, 0xec, 0xaa, 0x2a,
+    0xc9, 0xa6, 0x45, 0x55, 0xd9, 0xb4, 0x0b, 0x36, 0x2c, 0xdd, 0xc4, 0x90, 0x08, 0x4f, 0x82, 0x12,
+    0x33, 0x88, 0x3b, 0xf4, 0x0a, 0x5c, 0x8e, 0x93, 0x10, 0x18, 0x36, 0x96, 0x9e, 0x9f, 0xdf, 0xc7,
+    0x7a, 0xf1, 0xf9, 0xf3, 0xb1, 0xde, 0xfc, 0x2e, 0x21, 0xc8, 0xc8, 0x56, 0x3f, 0x27, 0xa1, 0xb7,
+    0x7a, 0x24, 0x41, 0x70, 0x01, 0x4b, 0x25, 0x31, 0xea, 0x28, 0xdb, 0xee, 0x4d, 0x59, 0x2d, 0x51,
+    0x98, 0xec, 0xb2, 0x94, 0x5c, 0xa0, 0x83, 0x15, 0x8e, 0xc7, 0x02, 0xdf, 0x79, 0xad, 0xfb, 0x99,
+    0x98, 0x55, 0x09, 0x47, 0x32, 0x6a, 0x8a, 0x74, 0x3a, 0xe4, 0x22, 0x0a, 0x5c, 0x4e, 0x42, 0xa9,
+    0xb9, 0x9c, 0xa2, 0x97, 0x60, 0x3c, 0x4d, 0xd1, 0x51, 0xf7, 0x00, 0x2f, 0x10, 0x53, 0x94, 0x88,
+    0xdc, 0x55, 0x87, 0x4c, 0x66, 0x68, 0x19, 0x1c, 0xd3, 0x1e, 0x0a, 0xb1, 0x51, 0x55, 0xce, 0x4c,
+    0x35, 0x10, 0x35, 0x93, 0x50, 0x68, 0x6b, 0x54, 0x7f, 0x77, 0x44, 0x7e, 0x75, 0xb5, 0xb6, 0xcb,
+    0x7e, 0xae, 0xfa, 0x97, 0xfd, 0xd9, 0x6a, 0x1f, 0xa7, 0xd6, 0x7d, 0xb0, 0xd7, 0xcb, 0x3f, 0x7c,
+    0xe1, 0x0e, 0x79, 0xd1, 0xf8, 0xe1, 0xb1, 0x07, 0xc7, 0x58, 0xab, 0x51, 0x74, 0xef, 0xdd, 0x74,
+    0x55, 0x4a, 0x4e, 0xbb, 0xf9, 0x8d, 0x77, 0xdd, 0x3f, 0x21, 0xdc, 0x00, 0x00, 0x00, 0xff, 0xff,
+};
+static const uint8_t PORTAL_ERROR_SEG1[] = {
+    0xb2, 0xd1, 0x4f, 0xc9, 0x2c, 0xb3, 0xb3, 0x49, 0x2a, 0x2d, 0x29, 0xc9, 0xcf, 0x53, 0xc8, 0xcf,
+    0x4b, 0xce, 0xc9, 0x4c, 0xce, 0xb6, 0x55, 0xca, 0xc8, 0x2c, 0x2e, 0xc9, 0x2f, 0xaa, 0xd4, 0x4b,
+    0x4a, 0x4c, 0xce, 0xd6, 0xd0, 0x54, 0xb2, 0x7b, 0xd4, 0x36, 0x41, 0xc1, 0x3b, 0x35, 0x37, 0x29,
+    0x31, 0x27, 0xd3, 0x46, 0x1f, 0xa2, 0xd8, 0xce, 0x06, 0xa2, 0x55, 0x3f, 0x29, 0x3f, 0xa5, 0x12,
+    0x48, 0x65, 0x94, 0xe4, 0xe6, 0xd8, 0x01, 0x00, 0x00, 0x00, 0xff, 0xff,
+};
+static const GzipSegment PORTAL_ERROR_SEGMENTS[] = {
+    { PORTAL_ERROR_SEG0, 208, 271, 0xa3b866dbUL },
+    { PORTAL_ERROR_SEG1, 76, 79, 0x432152f1UL },
+};
+static const uint8_t PORTAL_ERROR_FIELDS[] = { PORTAL_FIELD_MESSAGE };
+static const GzipAsset PORTAL_ERROR = { PORTAL_ERROR_SEGMENTS, 2, PORTAL_ERROR_FIELDS, "text/html" };
+
+static const uint8_t PORTAL_SAVED_SEG0[] = {
+    0x44, 0x8f, 0xc1, 0x4e, 0xc3, 0x30, 0x0c, 0x86, 0x5f, 0xc5, 0xeb, 0x99, 0xae, 0xea, 0x01, 0x09,
+    0x4d, 0x69, 0x0e, 0x30, 0x90, 0x06, 0x07, 0x26, 0x6d, 0x12, 0xe2, 0xe8, 0x26, 0xde, 0x12, 0x35,
+    0x49, 0xab, 0xc4, 0xdd, 0xb4, 0x07, 0xe0, 0x2d, 0x78, 0x3a, 0x9e, 0x84, 0xac, 0x9d, 0xe0, 0x12,
+    0xc9, 0xf1, 0xef, 0xcf, 0x9f, 0xc5, 0x62, 0xfd, 0xfe, 0xb4, 0xff, 0xdc, 0x3e, 0x83, 0x61, 0xef,
+    0xa4, 0xb8, 0xbd, 0x84, 0x5a, 0x0a, 0x4f, 0x8c, 0xa0, 0x0c, 0xc6, 0x44, 0xdc, 0x14, 0x23, 0x1f,
+    0xca, 0x87, 0x42, 0x0a, 0xb6, 0xec, 0x48, 0x3e, 0x52, 0x34, 0x98, 0xac, 0x83, 0x12, 0x5e, 0xd1,
+    0x8f, 0x11, 0x36, 0xfd, 0x5e, 0x54, 0x73, 0x6f, 0x1e, 0x0c, 0xe8, 0xa9, 0x29, 0x4e, 0x96, 0xce,
+    0x43, 0x1f, 0xb9, 0x00, 0xd5, 0x07, 0xa6, 0x90, 0x41, 0x67, 0xab, 0xd9, 0x34, 0x9a, 0x4e, 0x56,
+    0x51, 0x39, 0x15, 0x77, 0x60, 0x83, 0x65, 0x8b, 0xae, 0x4c, 0x0a, 0x1d, 0x35, 0x75, 0x5e, 0xe3,
+    0x6c, 0xe8, 0x20, 0x92, 0x6b, 0x8a, 0xc4, 0x17, 0x47, 0xc9, 0x10, 0x65, 0x88, 0x89, 0x74, 0x68,
+    0x8a, 0xea, 0x4a, 0x44, 0xb7, 0x54, 0x29, 0xe5, 0x64, 0x35, 0xdb, 0xb6, 0xbd, 0xbe, 0x48, 0xa1,
+    0xed, 0x29, 0xeb, 0xd7, 0xf2, 0xe7, 0xfb, 0x0b, 0xd6, 0x98, 0x35, 0xf6, 0x14, 0x93, 0xf5, 0x03,
+    0x86, 0x45, 0x0e, 0xd6, 0x53, 0x00, 0x94, 0xc3, 0x94, 0x32, 0x78, 0x54, 0x8a, 0x26, 0x44, 0xe2,
+    0xd8, 0x87, 0xe3, 0xdf, 0x51, 0x2b, 0x51, 0xdd, 0x7e, 0xe0, 0x2d, 0x92, 0xa6, 0x90, 0xb2, 0x1b,
+    0x7c, 0xd8, 0x17, 0x0b, 0x2d, 0xc6, 0x11, 0x98, 0x1c, 0x1a, 0xd0, 0x76, 0x06, 0x2f, 0x45, 0x35,
+    0x6d, 0x1d, 0xe4, 0x96, 0x22, 0x86, 0x63, 0x87, 0x0c, 0xd8, 0x61, 0xc8, 0xf6, 0x89, 0x31, 0x32,
+    0x68, 0x74, 0xe8, 0xe1, 0x1e, 0x34, 0xb1, 0xed, 0x72, 0x15, 0xc0, 0x53, 0x50, 0x7d, 0x8b, 0x19,
+    0x14, 0xcd, 0xd8, 0x8e, 0xe1, 0x08, 0x1d, 0xfd, 0xf3, 0x33, 0x70, 0xb8, 0xe2, 0x44, 0xf2, 0xe8,
+    0x9c, 0xdc, 0xed, 0x36, 0xeb, 0x15, 0xfc, 0x02, 0x00, 0x00, 0xff, 0xff,
+};
+static const uint8_t PORTAL_SAVED_SEG1[] = {
+    0xb2, 0xd1, 0x2f, 0xce, 0x4d, 0xcc, 0xc9, 0xb1, 0xb3, 0xd1, 0x2f, 0x00, 0xe2, 0x94, 0xcc, 0x32,
+    0x20, 0x99, 0x94, 0x9f, 0x52, 0x09, 0xa4, 0x32, 0x4a, 0x72, 0x73, 0xec, 0x00, 0x00, 0x00, 0x00,
+    0xff, 0xff,
+};
+static const GzipSegment PORTAL_SAVED_SEGMENTS[] = {
+    { PORTAL_SAVED_SEG0, 300, 425, 0xc9b62577UL },
+    { PORTAL_SAVED_SEG1, 34, 32, 0x50dd84caUL },
+};
+static const uint8_t PORTAL_SAVED_FIELDS[] = { PORTAL_FIELD_SSID };
+static const GzipAsset PORTAL_SAVED = { PORTAL_SAVED_SEGMENTS, 2, PORTAL_SAVED_FIELDS, "text/html" };
+
+static const uint8_t PORTAL_STYLE_SEG0[] = {
+    0x84, 0x92, 0xdd, 0x8e, 0x83, 0x20, 0x10, 0x85, 0x5f, 0xc5, 0xa4, 0xd9, 0xa4, 0x4d, 0xd4, 0xa0,
+    0xb5, 0xb1, 0xc1, 0xab, 0x7d, 0x14, 0x64, 0xc0, 0x92, 0x52, 0x30, 0x80, 0xdb, 0x36, 0xc6, 0x77,
+    0x5f, 0xfc, 0xa9, 0x75, 0xa3, 0xcd, 0x86, 0x78, 0x21, 0xf0, 0xcd, 0x39, 0x67, 0x98, 0x52, 0xc3,
+    0xb3, 0xe5, 0x5a, 0xb9, 0x88, 0x93, 0x9b, 0x90, 0x4f, 0xfc, 0x6d, 0x04, 0x91, 0xa1, 0x25, 0xca,
+    0x46, 0x96, 0x19, 0xc1, 0x0b, 0xc7, 0x1e, 0x2e, 0x22, 0x52, 0x54, 0x0a, 0x53, 0xa6, 0x1c, 0x33,
+    0xc5, 0x8d, 0x98, 0x4a, 0x28, 0x9c, 0xa2, 0xfa, 0x51, 0x94, 0x84, 0x5e, 0x2b, 0xa3, 0x1b, 0x05,
+    0x11, 0xd5, 0x52, 0x1b, 0xbc, 0xe3, 0x59, 0xbf, 0x3a, 0x10, 0x3f, 0xed, 0xfb, 0x10, 0xdf, 0x2f,
+    0xc2, 0xb1, 0xa2, 0x26, 0x00, 0x42, 0x55, 0x13, 0xaa, 0x0d, 0x30, 0x13, 0x19, 0x02, 0xa2, 0xb1,
+    0xf8, 0x3c, 0xec, 0x3c, 0x22, 0x7b, 0x21, 0xa0, 0xef, 0x18, 0x05, 0x69, 0xfd, 0x08, 0x32, 0xff,
+    0x99, 0xaa, 0x24, 0x7b, 0x14, 0x0e, 0x2b, 0x4e, 0x0e, 0x93, 0x7a, 0x54, 0x6a, 0xe7, 0xf4, 0x6d,
+    0xa8, 0xd4, 0x09, 0x55, 0x37, 0xae, 0xbd, 0x0b, 0x70, 0x17, 0x4c, 0x89, 0xa4, 0xfb, 0x04, 0xa1,
+    0xaf, 0x20, 0x0a, 0x52, 0x5f, 0xe3, 0x30, 0x8b, 0x26, 0xbd, 0xe8, 0x5f, 0x3a, 0x59, 0xfb, 0xc8,
+    0xe6, 0x1d, 0x9c, 0x78, 0x75, 0xab, 0xa5, 0x80, 0x60, 0x47, 0x29, 0xed, 0xca, 0xc6, 0x33, 0xaa,
+    0x5d, 0x96, 0x0b, 0x3e, 0xf4, 0x00, 0xa1, 0xbc, 0xe4, 0xbc, 0x18, 0xff, 0xc6, 0xe8, 0x53, 0x4d,
+    0xa5, 0x15, 0xdb, 0x50, 0xa4, 0x8d, 0xb1, 0xfe, 0x6a, 0xad, 0xc5, 0xb2, 0xc3, 0x27, 0x9f, 0x2d,
+    0x16, 0x8a, 0xeb, 0x30, 0xbe, 0x13, 0xa3, 0xbc, 0x6a, 0x18, 0x33, 0x63, 0xb4, 0x09, 0x63, 0xdb,
+    0x50, 0xca, 0xac, 0x6d, 0x37, 0xc2, 0x8d, 0xce, 0xd0, 0xf2, 0xe1, 0x24, 0xe3, 0x6e, 0xac, 0xd4,
+    0xae, 0xcd, 0xb2, 0x9c, 0x1f, 0xbd, 0xd9, 0xc9, 0x54, 0x7f, 0xb5, 0xb7, 0xf4, 0x4a, 0x3e, 0x46,
+    0xe9, 0x5e, 0x06, 0x36, 0x78, 0xce, 0xf9, 0x91, 0xc2, 0x27, 0x9e, 0x73, 0x9a, 0xa0, 0xbc, 0x1b,
+    0x7d, 0x6f, 0xd1, 0x67, 0xc8, 0x81, 0x7c, 0xa2, 0x81, 0x1e, 0x4f, 0xd9, 0xa9, 0x9b, 0xe3, 0xae,
+    0x79, 0xc8, 0x18, 0x7c, 0xe6, 0xd3, 0x33, 0xc9, 0x7b, 0x5e, 0x31, 0xf7, 0xee, 0x15, 0x5a, 0x0e,
+    0xda, 0xf0, 0x20, 0xff, 0x34, 0xce, 0xd3, 0x2d, 0x08, 0x5b, 0x4b, 0xf2, 0xc4, 0xa5, 0xd4, 0xf4,
+    0x5a, 0x8c, 0xb3, 0xd6, 0x8f, 0xd9, 0x8b, 0xcd, 0x06, 0x74, 0xa3, 0xbb, 0x8c, 0x9f, 0xe6, 0x51,
+    0xd8, 0xa5, 0x69, 0xba, 0x2a, 0xff, 0x0b, 0x00, 0x00, 0xff, 0xff,
+};
+static const GzipSegment PORTAL_STYLE_SEGMENTS[] = {
+    { PORTAL_STYLE_SEG0, 379, 899, 0x5ebdcd9cUL },
+};
+static const uint8_t PORTAL_STYLE_FIELDS[] = { 0 };
+static const GzipAsset PORTAL_STYLE = { PORTAL_STYLE_SEGMENTS, 1, PORTAL_STYLE_FIELDS, "text/css" };
+
+static const uint8_t PORTAL_SCRIPT_SEG0[] = {
+    0x8c, 0x55, 0xcd, 0x6e, 0xdc, 0x36, 0x10, 0x7e, 0x15, 0x56, 0x27, 0x0a, 0x71, 0x19, 0x07, 0x85,
+    0x9b, 0x22, 0xc2, 0x36, 0x40, 0x93, 0x14, 0x08, 0xda, 0xa6, 0x46, 0xed, 0x3e, 0x00, 0x25, 0xce,
+    0x4a, 0xcc, 0x52, 0xa4, 0xca, 0x1f, 0x3b, 0x86, 0x93, 0x4b, 0x51, 0x14, 0x3d, 0x17, 0x85, 0xaf,
+    0x7d, 0x37, 0x3f, 0x41, 0x1f, 0xa1, 0x33, 0x94, 0xac, 0x95, 0x6a, 0x67, 0x53, 0xec, 0x85, 0xfc,
+    0x66, 0x34, 0xf3, 0xcd, 0x37, 0xc3, 0x59, 0xbe, 0x4d, 0xb6, 0x89, 0xda, 0x59, 0xc6, 0x4b, 0x76,
+    0x7d, 0x21, 0x3d, 0xdb, 0x3a, 0xdf, 0xb3, 0x0d, 0x53, 0xae, 0x49, 0x3d, 0xd8, 0x28, 0x5a, 0x88,
+    0xaf, 0x0c, 0xd0, 0xf1, 0x9b, 0xab, 0xd7, 0x8a, 0x17, 0x64, 0x2f, 0xca, 0x8a, 0x5c, 0x8d, 0x0e,
+    0xf1, 0x90, 0xab, 0x85, 0x18, 0x26, 0xd7, 0xda, 0xbd, 0x3b, 0xe4, 0x19, 0xa2, 0x8c, 0x69, 0xf6,
+    0x4d, 0x31, 0x22, 0xa1, 0x4d, 0xa6, 0x22, 0x7e, 0x49, 0xe0, 0xaf, 0xce, 0xc0, 0x40, 0x13, 0x9d,
+    0xe7, 0xc5, 0x68, 0x44, 0xcf, 0x99, 0x78, 0xe8, 0xdc, 0x25, 0x8f, 0xf0, 0x2e, 0x1e, 0xb1, 0xc6,
+    0x04, 0xac, 0x02, 0x73, 0x89, 0x4e, 0x2b, 0x05, 0x39, 0x86, 0x34, 0x01, 0x2a, 0x82, 0x1a, 0x23,
+    0x43, 0x78, 0x23, 0x7b, 0x40, 0x14, 0x1d, 0x33, 0x46, 0x9f, 0xbd, 0x70, 0x36, 0x22, 0x11, 0x44,
+    0xe9, 0x56, 0x7d, 0x98, 0x03, 0xd7, 0xd2, 0x07, 0xee, 0x43, 0xd0, 0x18, 0xd3, 0x43, 0x4c, 0xde,
+    0x32, 0xba, 0xb1, 0xaf, 0x37, 0xec, 0xf3, 0x93, 0x13, 0xf6, 0x9c, 0x15, 0xb7, 0x37, 0xbf, 0xde,
+    0xde, 0xfc, 0x76, 0x7b, 0xf3, 0xfb, 0xed, 0xcd, 0x1f, 0x05, 0x7b, 0xb6, 0x37, 0x7f, 0xf9, 0x74,
+    0x65, 0x5e, 0xd9, 0x9e, 0x7e, 0xb5, 0xb7, 0x91, 0x81, 0x8e, 0xc5, 0x22, 0xed, 0xdb, 0xe0, 0x2c,
+    0xf7, 0x8b, 0x9c, 0x22, 0x23, 0xe5, 0xc2, 0xc5, 0x83, 0x55, 0xe0, 0xb9, 0x92, 0x51, 0xa2, 0x1f,
+    0xb5, 0xe1, 0x3f, 0x95, 0x14, 0x45, 0x45, 0x46, 0x81, 0x1d, 0xb8, 0x74, 0x7e, 0x17, 0x04, 0x4a,
+    0xf9, 0x4a, 0x36, 0x1d, 0xdf, 0xb7, 0xdb, 0x4e, 0xfd, 0xae, 0x97, 0x7d, 0x69, 0x3c, 0xc8, 0x08,
+    0x53, 0x6b, 0x16, 0x62, 0xd7, 0x22, 0x5e, 0x0d, 0x24, 0xdc, 0x1d, 0x84, 0xc8, 0x52, 0x4f, 0x6a,
+    0x35, 0x61, 0x6b, 0x16, 0xdc, 0x0a, 0x99, 0x62, 0x47, 0xe5, 0xfe, 0xf3, 0xf7, 0x5f, 0x7f, 0xb2,
+    0x5c, 0x6d, 0x51, 0xb2, 0x47, 0xcc, 0x0a, 0x54, 0x43, 0xe1, 0xa1, 0xc0, 0xdf, 0xa3, 0x51, 0x69,
+    0x2b, 0x46, 0xad, 0x09, 0x6c, 0xba, 0x22, 0x7b, 0x35, 0x1d, 0x06, 0x75, 0xb6, 0x31, 0xba, 0xd9,
+    0x51, 0x33, 0x97, 0xc3, 0x9a, 0xa7, 0x83, 0xc2, 0x88, 0x0b, 0x69, 0x12, 0xb1, 0x18, 0xa3, 0x56,
+    0xd9, 0x30, 0x20, 0xb9, 0xd9, 0x80, 0x72, 0xec, 0xc1, 0x2d, 0x16, 0x1b, 0x48, 0xce, 0x2a, 0x0b,
+    0x27, 0x87, 0x01, 0xd5, 0x7c, 0xd1, 0x69, 0xa3, 0x78, 0x8d, 0x68, 0x59, 0xe9, 0x2d, 0xe3, 0x9f,
+    0xad, 0xe5, 0x33, 0x60, 0xdb, 0xd8, 0x3d, 0xac, 0x75, 0xf6, 0x0c, 0x8d, 0xb4, 0x56, 0xdb, 0x96,
+    0x6a, 0xfd, 0x01, 0x7a, 0x6d, 0x95, 0xd4, 0xec, 0xad, 0xf4, 0x08, 0x49, 0x2b, 0x84, 0xc8, 0xa5,
+    0x9f, 0x6b, 0x25, 0x77, 0x4c, 0x2a, 0x39, 0x5b, 0x98, 0xd2, 0x11, 0xfa, 0xb4, 0x43, 0x1f, 0x1c,
+    0x81, 0x7d, 0x83, 0x8d, 0x93, 0x8a, 0x7b, 0xd8, 0x7a, 0x08, 0x94, 0x75, 0x0b, 0x11, 0x7b, 0x37,
+    0xdd, 0x29, 0xc5, 0xe3, 0x3b, 0x66, 0xcf, 0x27, 0x70, 0xf3, 0x24, 0x67, 0x98, 0xf1, 0xa2, 0x14,
+    0xb1, 0x03, 0xcb, 0x69, 0x74, 0xa6, 0xe3, 0x5e, 0xbc, 0x69, 0x6e, 0x96, 0x53, 0x94, 0x8b, 0x5e,
+    0x55, 0x52, 0xb2, 0x00, 0xf1, 0x5c, 0xf7, 0xe0, 0x52, 0xe4, 0xc4, 0xe7, 0x88, 0x3d, 0x39, 0x39,
+    0x3e, 0x26, 0x85, 0x44, 0x23, 0xe3, 0x6a, 0x96, 0x30, 0xd8, 0x3d, 0xe7, 0x2f, 0x8e, 0x47, 0xe7,
+    0xc5, 0xd8, 0x0e, 0xce, 0x18, 0x3e, 0x97, 0x53, 0x3c, 0xbe, 0x7b, 0xf5, 0x07, 0xa8, 0xd2, 0x7b,
+    0x26, 0x6a, 0x41, 0x90, 0x33, 0xf6, 0x72, 0x83, 0xdd, 0x8c, 0x10, 0x22, 0x32, 0x2c, 0x28, 0x2d,
+    0x3d, 0x7e, 0x54, 0xdc, 0xb6, 0x5d, 0xaa, 0x93, 0x6d, 0x51, 0x49, 0xb6, 0x83, 0x3c, 0x54, 0x61,
+    0x9e, 0x31, 0xd2, 0xff, 0x88, 0x15, 0xda, 0x6e, 0x1d, 0xce, 0xf2, 0x82, 0x29, 0x11, 0xc2, 0xb2,
+    0x46, 0xa6, 0x0c, 0x70, 0x53, 0xb0, 0x7b, 0xc9, 0x1a, 0x67, 0x2d, 0xee, 0x1e, 0x50, 0xfb, 0x74,
+    0xe7, 0xe0, 0xc7, 0x6c, 0xf7, 0x53, 0x31, 0xfe, 0xfa, 0x74, 0x82, 0xf4, 0x40, 0x40, 0x29, 0xd8,
+    0xa9, 0xf3, 0x51, 0x1a, 0x94, 0xb3, 0x05, 0x2f, 0xa9, 0xe3, 0x29, 0xa6, 0x01, 0xc7, 0x06, 0x05,
+    0x41, 0x80, 0x38, 0x47, 0xd6, 0x27, 0x83, 0x03, 0x53, 0x83, 0x77, 0x84, 0x05, 0x9d, 0x09, 0x87,
+    0xd4, 0x34, 0x10, 0x68, 0x2d, 0x4e, 0xe4, 0xae, 0xc7, 0xd7, 0x27, 0x94, 0x0e, 0xb2, 0x36, 0xa0,
+    0xe6, 0xfd, 0x96, 0x79, 0x05, 0xd1, 0xa3, 0xb7, 0x6c, 0x81, 0xbd, 0x7f, 0xcf, 0x8a, 0xef, 0x9c,
+    0x85, 0x1d, 0xae, 0x9c, 0x56, 0xb6, 0xd2, 0xe4, 0x70, 0xe0, 0xbd, 0xf3, 0x14, 0xec, 0x93, 0x1d,
+    0x5c, 0xe9, 0x42, 0x1d, 0xa4, 0xc7, 0xe3, 0x6c, 0x48, 0x75, 0xaf, 0xe3, 0xea, 0x1d, 0x02, 0x7e,
+    0x08, 0x62, 0xf0, 0x70, 0x81, 0x8f, 0xe1, 0x25, 0x6c, 0x65, 0x32, 0x11, 0xdf, 0xd6, 0x7d, 0x9e,
+    0xd1, 0x27, 0xa8, 0xee, 0x1a, 0x3f, 0x69, 0x8a, 0xa4, 0xae, 0x59, 0x0f, 0xb1, 0x73, 0x0a, 0x67,
+    0xf7, 0xf4, 0xc7, 0xb3, 0x73, 0x44, 0x6a, 0xa7, 0xae, 0x9e, 0x31, 0x0b, 0x97, 0xec, 0xe7, 0x9f,
+    0xbe, 0x3f, 0x03, 0xe9, 0x9b, 0xee, 0x54, 0x7a, 0xd9, 0xe3, 0x82, 0x40, 0xec, 0x5b, 0x64, 0xf2,
+    0x12, 0xc7, 0x94, 0x13, 0xa5, 0xb2, 0x64, 0x1f, 0x0e, 0x0d, 0x0f, 0x3e, 0x8c, 0x69, 0x7c, 0xf0,
+    0x24, 0xdc, 0x0e, 0x2f, 0xe3, 0x08, 0xfe, 0x3f, 0x3d, 0xe9, 0xa3, 0x49, 0xd1, 0x4f, 0xab, 0x77,
+    0x30, 0x52, 0x31, 0x8d, 0x40, 0xcc, 0x0b, 0xa0, 0x07, 0x8c, 0x3c, 0xa0, 0x9c, 0xf8, 0x87, 0xe5,
+    0x6a, 0xc9, 0x8c, 0x6c, 0xf5, 0xba, 0x41, 0xb4, 0x9c, 0x3e, 0xfa, 0x5f, 0x89, 0x1f, 0xe3, 0x13,
+    0xc5, 0xc1, 0x7a, 0x68, 0x2f, 0x7e, 0xa4, 0x1f, 0x0f, 0xfd, 0x45, 0x3c, 0xb8, 0xa6, 0xaa, 0xbc,
+    0x79, 0xa8, 0x59, 0x79, 0x41, 0xd2, 0x25, 0xd7, 0x41, 0xa4, 0x30, 0xce, 0xbf, 0x00, 0x00, 0x00,
+    0xff, 0xff,
+};
+static const GzipSegment PORTAL_SCRIPT_SEGMENTS[] = {
+    { PORTAL_SCRIPT_SEG0, 898, 2095, 0xf21dfaf1UL },
+};
+static const uint8_t PORTAL_SCRIPT_FIELDS[] = { 0 };
+static const GzipAsset PORTAL_SCRIPT = { PORTAL_SCRIPT_SEGMENTS, 1, PORTAL_SCRIPT_FIELDS, "application/javascript" };
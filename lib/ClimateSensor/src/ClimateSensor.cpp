@@ -0,0 +1,259 @@
+// lib/ClimateSensor/src/ClimateSensor.cpp
+#include "ClimateSensor.h"
+
+// Alamat standar (pin ADDR/SDO ke GND) lalu alternatifnya.
+static const uint8_t SHT_ADDRESSES[] = { 0x44, 0x45 };
+static const uint8_t BME280_ADDRESSES[] = { 0x76, 0x77 };
+
+// Perintah Sensirion (datasheet SHT3x-DIS §4, SHT4x §4.5).
+static const uint8_t SHT3X_SOFT_RESET[] = { 0x30, 0xA2 };
+static const uint8_t SHT3X_READ_STATUS[] = { 0xF3, 0x2D };
+static const uint8_t SHT3X_MEASURE_HIGH[] = { 0x24, 0x00 };
+static const uint8_t SHT4X_READ_SERIAL = 0x89;
+static const uint8_t SHT4X_MEASURE_HIGH = 0xFD;
+
+// Register BME280 (datasheet §5.3).
+static const uint8_t BME280_REG_CALIB_TP = 0x88;
+static const uint8_t BME280_REG_CHIP_ID = 0xD0;
+static const uint8_t BME280_REG_RESET = 0xE0;
+static const uint8_t BME280_REG_CALIB_H = 0xE1;
+static const uint8_t BME280_REG_CTRL_HUM = 0xF2;
+static const uint8_t BME280_REG_CTRL_MEAS = 0xF4;
+static const uint8_t BME280_REG_CONFIG = 0xF5;
+static const uint8_t BME280_REG_DATA_T = 0xFA;
+static const uint8_t BME280_CHIP_ID = 0x60;        // BMP280 (0x58) tidak punya sensor RH
+// osrs_t x1, osrs_p dilewati, forced mode.
+static const uint8_t BME280_CTRL_MEAS_FORCED = (1 << 5) | (0 << 2) | 0x01;
+
+// ---------------- Sensor ----------------------------------
+
+void Sensor::set_interval(uint32_t ms) {
+    intervalMs_ = ms < min_interval() ? min_interval() : ms;
+}
+
+void Sensor::finish(SensorStatus status, float humidity, float temperature) {
+    last_ = { status, humidity, temperature };
+    if (status == SENSOR_OK) {
+        stats_.ok++;
+        stats_.consecutive = 0;
+        return;
+    }
+    if (status == SENSOR_TIMEOUT) stats_.timeouts++;
+    else stats_.checksum++;
+    if (stats_.consecutive < UINT16_MAX) stats_.consecutive++;
+    last_.humidity = last_.temperature = NAN;
+}
+
+// ---------------- I2cSensor -------------------------------
+
+I2cSensor* I2cSensor::detect(I2cBus& bus, uint32_t intervalMs) {
+    for (uint8_t address : SHT_ADDRESSES) {
+        I2cSensor* sensor = new Sht4xSensor(bus, address, intervalMs);
+        if (sensor->begin()) return sensor;
+        delete sensor;
+        sensor = new Sht3xSensor(bus, address, intervalMs);
+        if (sensor->begin()) return sensor;
+        delete sensor;
+    }
+    for (uint8_t address : BME280_ADDRESSES) {
+        I2cSensor* sensor = new Bme280Sensor(bus, address, intervalMs);
+        if (sensor->begin()) return sensor;
+        delete sensor;
+    }
+    return nullptr;
+}
+
+bool I2cSensor::begin() {
+    bus_.take(portMAX_DELAY);
+    ready_ = probe();
+    bus_.give();
+    phase_ = PHASE_IDLE;
+    dueMs_ = millis();
+    return ready_;
+}
+
+bool I2cSensor::poll(uint32_t nowMs) {
+    if (!ready_ || (int32_t)(nowMs - dueMs_) < 0) return false;
+    if (!bus_.take(0)) {
+        stats_.deferred++;
+        dueMs_ = nowMs + kBusRetryMs;
+        return false;
+    }
+
+    if (phase_ == PHASE_IDLE) {
+        bool started = start();
+        bus_.give();
+        if (!started) {
+            dueMs_ = nowMs + intervalMs_;
+            finish(SENSOR_TIMEOUT, NAN, NAN);
+            return true;
+        }
+        phase_ = PHASE_CONVERT;
+        startedMs_ = nowMs;
+        dueMs_ = nowMs + conversion_ms();
+        return false;
+    }
+
+    float humidity = NAN, temperature = NAN;
+    SensorStatus status = fetch(humidity, temperature);
+    bus_.give();
+    phase_ = PHASE_IDLE;
+    // Interval dihitung dari awal konversi agar bus yang sibuk tidak
+    // memperlambat laju sampel.
+    dueMs_ = startedMs_ + intervalMs_;
+    if ((int32_t)(dueMs_ - nowMs) < 0) dueMs_ = nowMs;
+    finish(status, humidity, temperature);
+    return true;
+}
+
+uint32_t I2cSensor::until_next(uint32_t nowMs) const {
+    if (!ready_) return UINT32_MAX;
+    int32_t left = (int32_t)(dueMs_ - nowMs);
+    return left > 0 ? (uint32_t)left : 0;
+}
+
+uint8_t I2cSensor::crc8(const uint8_t* data, size_t length) {
+    uint8_t crc = 0xFF;
+    for (size_t i = 0; i < length; i++) {
+        crc ^= data[i];
+        for (int b = 0; b < 8; b++) crc = crc & 0x80 ? (uint8_t)((crc << 1) ^ 0x31) : (uint8_t)(crc << 1);
+    }
+    return crc;
+}
+
+// Dua kata 16 bit + CRC masing-masing; false bila salah satu CRC salah.
+static bool sensirion_words(const uint8_t frame[6], uint16_t& first, uint16_t& second) {
+    if (I2cSensor::crc8(frame, 2) != frame[2] || I2cSensor::crc8(frame + 3, 2) != frame[5]) return false;
+    first = (frame[0] << 8) | frame[1];
+    second = (frame[3] << 8) | frame[4];
+    return true;
+}
+
+// ---------------- SHT3x -----------------------------------
+
+bool Sht3xSensor::probe() {
+    if (!bus_.write(address_, SHT3X_SOFT_RESET, sizeof(SHT3X_SOFT_RESET))) return false;
+    delay(2);
+    uint8_t status[3];
+    return bus_.write(address_, SHT3X_READ_STATUS, sizeof(SHT3X_READ_STATUS)) &&
+           bus_.read(address_, status, sizeof(status)) && crc8(status, 2) == status[2];
+}
+
+bool Sht3xSensor::start() {
+    return bus_.write(address_, SHT3X_MEASURE_HIGH, sizeof(SHT3X_MEASURE_HIGH));
+}
+
+SensorStatus Sht3xSensor::fetch(float& humidity, float& temperature) {
+    uint8_t frame[6];
+    if (!bus_.read(address_, frame, sizeof(frame))) return SENSOR_TIMEOUT;
+    return parse(frame, humidity, temperature);
+}
+
+SensorStatus Sht3xSensor::parse(const uint8_t frame[6], float& humidity, float& temperature) {
+    uint16_t rawT, rawH;
+    humidity = temperature = NAN;
+    if (!sensirion_words(frame, rawT, rawH)) return SENSOR_CHECKSUM;
+    temperature = -45.0f + 175.0f * rawT / 65535.0f;
+    humidity = 100.0f * rawH / 65535.0f;
+    return SENSOR_OK;
+}
+
+// ---------------- SHT4x -----------------------------------
+
+// SHT3x di alamat yang sama tidak mengenal perintah 1 byte ini dan
+// menolak pembacaannya, sehingga SHT4x dicoba lebih dulu.
+bool Sht4xSensor::probe() {
+    uint8_t serial[6];
+    uint16_t hi, lo;
+    if (!bus_.write(address_, &SHT4X_READ_SERIAL, 1)) return false;
+    delay(1);
+    return bus_.read(address_, serial, sizeof(serial)) && sensirion_words(serial, hi, lo);
+}
+
+bool Sht4xSensor::start() {
+    return bus_.write(address_, &SHT4X_MEASURE_HIGH, 1);
+}
+
+SensorStatus Sht4xSensor::fetch(float& humidity, float& temperature) {
+    uint8_t frame[6];
+    if (!bus_.read(address_, frame, sizeof(frame))) return SENSOR_TIMEOUT;
+    return parse(frame, humidity, temperature);
+}
+
+SensorStatus Sht4xSensor::parse(const uint8_t frame[6], float& humidity, float& temperature) {
+    uint16_t rawT, rawH;
+    humidity = temperature = NAN;
+    if (!sensirion_words(frame, rawT, rawH)) return SENSOR_CHECKSUM;
+    temperature = -45.0f + 175.0f * rawT / 65535.0f;
+    // Rumus datasheet bisa sedikit keluar dari 0-100 %RH.
+    float rh = -6.0f + 125.0f * rawH / 65535.0f;
+    humidity = constrain(rh, 0.0f, 100.0f);
+    return SENSOR_OK;
+}
+
+// ---------------- BME280 ----------------------------------
+
+bool Bme280Sensor::probe() {
+    uint8_t id = 0;
+    if (!bus_.read_register(address_, BME280_REG_CHIP_ID, &id, 1) || id != BME280_CHIP_ID) return false;
+    const uint8_t reset[] = { BME280_REG_RESET, 0xB6 };
+    if (!bus_.write(address_, reset, sizeof(reset))) return false;
+    delay(3);
+
+    uint8_t tp[26], h[7];
+    if (!bus_.read_register(address_, BME280_REG_CALIB_TP, tp, sizeof(tp)) ||
+        !bus_.read_register(address_, BME280_REG_CALIB_H, h, sizeof(h))) {
+        return false;
+    }
+    calib_ = parse_calib(tp, h);
+    // ctrl_hum baru berlaku setelah ctrl_meas ditulis (tiap start()).
+    const uint8_t ctrlHum[] = { BME280_REG_CTRL_HUM, 0x01 };
+    const uint8_t config[] = { BME280_REG_CONFIG, 0x00 };
+    return bus_.write(address_, ctrlHum, sizeof(ctrlHum)) && bus_.write(address_, config, sizeof(config));
+}
+
+bool Bme280Sensor::start() {
+    const uint8_t ctrlMeas[] = { BME280_REG_CTRL_MEAS, BME280_CTRL_MEAS_FORCED };
+    return bus_.write(address_, ctrlMeas, sizeof(ctrlMeas));
+}
+
+// Suhu 20 bit dan kelembapan 16 bit; nilai reset (0x80000 / 0x8000) berarti
+// konversi belum pernah selesai.
+SensorStatus Bme280Sensor::fetch(float& humidity, float& temperature) {
+    uint8_t data[5];
+    if (!bus_.read_register(address_, BME280_REG_DATA_T, data, sizeof(data))) return SENSOR_TIMEOUT;
+    int32_t adcT = ((int32_t)data[0] << 12) | ((int32_t)data[1] << 4) | (data[2] >> 4);
+    int32_t adcH = ((int32_t)data[3] << 8) | data[4];
+    if (adcT == 0x80000 || adcH == 0x8000) return SENSOR_TIMEOUT;
+    compensate(calib_, adcT, adcH, humidity, temperature);
+    return SENSOR_OK;
+}
+
+Bme280Calib Bme280Sensor::parse_calib(const uint8_t tp[26], const uint8_t h[7]) {
+    Bme280Calib c;
+    c.t1 = (uint16_t)(tp[0] | (tp[1] << 8));
+    c.t2 = (int16_t)(tp[2] | (tp[3] << 8));
+    c.t3 = (int16_t)(tp[4] | (tp[5] << 8));
+    c.h1 = tp[25];
+    c.h2 = (int16_t)(h[0] | (h[1] << 8));
+    c.h3 = h[2];
+    c.h4 = (int16_t)(((int8_t)h[3] * 16) | (h[4] & 0x0F));
+    c.h5 = (int16_t)(((int8_t)h[5] * 16) | (h[4] >> 4));
+    c.h6 = (int8_t)h[6];
+    return c;
+}
+
+void Bme280Sensor::compensate(const Bme280Calib& c, int32_t adcT, int32_t adcH, float& humidity, float& temperature) {
+    int32_t var1 = ((((adcT >> 3) - ((int32_t)c.t1 << 1))) * (int32_t)c.t2) >> 11;
+    int32_t var2 = (((((adcT >> 4) - (int32_t)c.t1) * ((adcT >> 4) - (int32_t)c.t1)) >> 12) * (int32_t)c.t3) >> 14;
+    int32_t tFine = var1 + var2;
+    temperature = ((tFine * 5 + 128) >> 8) / 100.0f;
+
+    int32_t v = tFine - 76800;
+    v = (((((adcH << 14) - ((int32_t)c.h4 << 20) - ((int32_t)c.h5 * v)) + 16384) >> 15) *
+         (((((((v * (int32_t)c.h6) >> 10) * (((v * (int32_t)c.h3) >> 11) + 32768)) >> 10) + 2097152) *
+           (int32_t)c.h2 + 8192) >> 14));
+    v = v - (((((v >> 15) * (v >> 15)) >> 7) * (int32_t)c.h1) >> 4);
+    v = v < 0 ? 0 : (v > 419430400 ? 419430400 : v);
+    humidity = (uint32_t)(v >> 12) / 1024.0f;
+}
@@ -0,0 +1,172 @@
+// lib/ClimateSensor/src/ClimateSensor.h
+#pragma once
+
+// ==========================================================
+// ==     SENSOR KELEMBAPAN: ANTARMUKA & DRIVER I2C         ==
+// ==========================================================
+// control_task memakai semua sensor lewat antarmuka yang sama: poll()
+// menjalankan tahap yang jatuh tempo, until_next() memberi tahu kapan
+// harus bangun, hasil di last(). DhtSampler adalah salah satu
+// implementasinya. Driver I2C memecah satu pembacaan menjadi dua
+// transaksi pendek:
+//
+//   start()  perintah konversi (beberapa byte, < 1 ms pada 100 kHz)
+//   fetch()  hasil dibaca setelah conversion_ms(), CRC/kompensasi dihitung
+//
+// Di antaranya bus bebas untuk LCD. Bus tidak pernah ditunggu: bila LCD
+// sedang memegangnya, tahap diulang kBusRetryMs kemudian.
+
+#include <Arduino.h>
+#include "I2cBus.h"
+
+enum SensorStatus : uint8_t { SENSOR_OK, SENSOR_TIMEOUT, SENSOR_CHECKSUM };
+
+struct SensorReading {
+    SensorStatus status;
+    float humidity;
+    float temperature;
+};
+
+struct SensorStats {
+    uint32_t ok;
+    uint32_t timeouts;             // tidak menjawab: frame DHT kurang / NACK I2C
+    uint32_t checksum;             // checksum DHT / CRC-8 Sensirion salah
+    uint32_t deferred;             // tahap I2C ditunda karena bus sedang dipakai
+    uint16_t consecutive;          // kegagalan beruntun sejak pembacaan valid terakhir
+};
+
+class Sensor {
+public:
+    virtual ~Sensor() {}
+
+    virtual const char* name() const = 0;
+    virtual bool begin() = 0;
+    // Menjalankan tahap yang jatuh tempo; true bila pembacaan baru selesai
+    // (berhasil atau gagal), hasilnya di last().
+    virtual bool poll(uint32_t nowMs) = 0;
+    // ms sampai tahap berikutnya (0 = sudah jatuh tempo).
+    virtual uint32_t until_next(uint32_t nowMs) const = 0;
+    // Interval terpendek menurut datasheet (DHT) atau batas self-heating (I2C).
+    virtual uint32_t min_interval() const = 0;
+
+    // Dibatasi ke min_interval(); berlaku mulai pembacaan berikutnya.
+    void set_interval(uint32_t ms);
+    uint32_t interval() const { return intervalMs_; }
+
+    const SensorReading& last() const { return last_; }
+    const SensorStats& stats() const { return stats_; }
+
+protected:
+    explicit Sensor(uint32_t intervalMs) : intervalMs_(intervalMs) {}
+
+    void finish(SensorStatus status, float humidity, float temperature);
+
+    uint32_t intervalMs_;
+    SensorReading last_ = { SENSOR_TIMEOUT, NAN, NAN };
+    SensorStats stats_ = {};
+};
+
+class I2cSensor : public Sensor {
+public:
+    static const uint32_t kMinIntervalMs = 200;
+    static const uint32_t kBusRetryMs = 2;
+
+    // Mencoba SHT4x, SHT3x (0x44/0x45) lalu BME280 (0x76/0x77); sensor
+    // pertama yang menjawab dikembalikan sudah di-begin(), nullptr bila tidak
+    // ada. Hanya untuk boot: probe memblokir beberapa ms per alamat.
+    static I2cSensor* detect(I2cBus& bus, uint32_t intervalMs);
+
+    bool begin() override;
+    bool poll(uint32_t nowMs) override;
+    uint32_t until_next(uint32_t nowMs) const override;
+    uint32_t min_interval() const override { return kMinIntervalMs; }
+
+    uint8_t address() const { return address_; }
+
+    // CRC-8 Sensirion (poly 0x31, init 0xFF) untuk tiap kata 16 bit.
+    static uint8_t crc8(const uint8_t* data, size_t length);
+
+protected:
+    I2cSensor(I2cBus& bus, uint8_t address, uint32_t intervalMs)
+        : Sensor(intervalMs), bus_(bus), address_(address) {}
+
+    // Identitas dan konfigurasi awal; bus sudah dipegang.
+    virtual bool probe() = 0;
+    virtual bool start() = 0;
+    virtual uint32_t conversion_ms() const = 0;
+    virtual SensorStatus fetch(float& humidity, float& temperature) = 0;
+
+    I2cBus& bus_;
+    uint8_t address_;
+
+private:
+    enum Phase : uint8_t { PHASE_IDLE, PHASE_CONVERT };
+
+    Phase phase_ = PHASE_IDLE;
+    uint32_t dueMs_ = 0;
+    uint32_t startedMs_ = 0;
+    bool ready_ = false;
+};
+
+// SHT30/31/35: single shot high repeatability tanpa clock stretching.
+class Sht3xSensor : public I2cSensor {
+public:
+    Sht3xSensor(I2cBus& bus, uint8_t address, uint32_t intervalMs) : I2cSensor(bus, address, intervalMs) {}
+    const char* name() const override { return "SHT3x"; }
+
+    // Frame 6 byte (T, CRC, RH, CRC) -> nilai.
+    static SensorStatus parse(const uint8_t frame[6], float& humidity, float& temperature);
+
+protected:
+    bool probe() override;
+    bool start() override;
+    uint32_t conversion_ms() const override { return 16; }
+    SensorStatus fetch(float& humidity, float& temperature) override;
+};
+
+// SHT40/41/45: pengukuran presisi tinggi, tanpa heater.
+class Sht4xSensor : public I2cSensor {
+public:
+    Sht4xSensor(I2cBus& bus, uint8_t address, uint32_t intervalMs) : I2cSensor(bus, address, intervalMs) {}
+    const char* name() const override { return "SHT4x"; }
+
+    static SensorStatus parse(const uint8_t frame[6], float& humidity, float& temperature);
+
+protected:
+    bool probe() override;
+    bool start() override;
+    uint32_t conversion_ms() const override { return 9; }
+    SensorStatus fetch(float& humidity, float& temperature) override;
+};
+
+struct Bme280Calib {
+    uint16_t t1;
+    int16_t t2, t3;
+    uint8_t h1;
+    int16_t h2;
+    uint8_t h3;
+    int16_t h4, h5;
+    int8_t h6;
+};
+
+// BME280 forced mode: suhu dan kelembapan oversampling x1, tekanan dilewati.
+class Bme280Sensor : public I2cSensor {
+public:
+    Bme280Sensor(I2cBus& bus, uint8_t address, uint32_t intervalMs) : I2cSensor(bus, address, intervalMs) {}
+    const char* name() const override { return "BME280"; }
+
+    // Register 0x88..0xA1 (26 byte) dan 0xE1..0xE7 (7 byte).
+    static Bme280Calib parse_calib(const uint8_t tp[26], const uint8_t h[7]);
+    // Kompensasi integer dari datasheet Bosch; dipisah agar bisa diuji
+    // (dan dibalik oleh simulator) tanpa hardware.
+    static void compensate(const Bme280Calib& calib, int32_t adcT, int32_t adcH, float& humidity, float& temperature);
+
+protected:
+    bool probe() override;
+    bool start() override;
+    uint32_t conversion_ms() const override { return 8; }
+    SensorStatus fetch(float& humidity, float& temperature) override;
+
+private:
+    Bme280Calib calib_ = {};
+};
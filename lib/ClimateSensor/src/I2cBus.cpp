@@ -0,0 +1,78 @@
+// lib/ClimateSensor/src/I2cBus.cpp
+#include "I2cBus.h"
+
+bool I2cBus::take(TickType_t ticks) {
+    if (xSemaphoreTake(mutex_, 0) == pdTRUE) return true;
+    contended_++;
+    return ticks > 0 && xSemaphoreTake(mutex_, ticks) == pdTRUE;
+}
+
+void I2cBus::give() {
+    xSemaphoreGive(mutex_);
+}
+
+#if defined(ESP32)
+
+#include <Wire.h>
+
+bool I2cBus::begin(int sda, int scl, uint32_t clockHz) {
+    if (!mutex_) mutex_ = xSemaphoreCreateMutex();
+    return Wire.begin(sda, scl, clockHz);
+}
+
+bool I2cBus::write(uint8_t address, const uint8_t* data, size_t length) {
+    Wire.beginTransmission(address);
+    Wire.write(data, length);
+    if (Wire.endTransmission() == 0) return true;
+    errors_++;
+    return false;
+}
+
+bool I2cBus::read(uint8_t address, uint8_t* data, size_t length) {
+    if (Wire.requestFrom(address, length) != length) {
+        errors_++;
+        return false;
+    }
+    return Wire.readBytes(data, length) == length;
+}
+
+bool I2cBus::read_register(uint8_t address, uint8_t reg, uint8_t* data, size_t length) {
+    Wire.beginTransmission(address);
+    Wire.write(reg);
+    if (Wire.endTransmission(false) != 0) {
+        errors_++;
+        return false;
+    }
+    return read(address, data, length);
+}
+
+#else
+
+// [env:native]: perangkat di bus dimodelkan NativeSim (JAMUR_SIM_I2C).
+#include "NativeSim.h"
+
+bool I2cBus::begin(int sda, int scl, uint32_t clockHz) {
+    (void)sda;
+    (void)scl;
+    (void)clockHz;
+    if (!mutex_) mutex_ = xSemaphoreCreateMutex();
+    return true;
+}
+
+bool I2cBus::write(uint8_t address, const uint8_t* data, size_t length) {
+    if (sim::i2c_write(address, data, length)) return true;
+    errors_++;
+    return false;
+}
+
+bool I2cBus::read(uint8_t address, uint8_t* data, size_t length) {
+    if (sim::i2c_read(address, data, length)) return true;
+    errors_++;
+    return false;
+}
+
+bool I2cBus::read_register(uint8_t address, uint8_t reg, uint8_t* data, size_t length) {
+    return write(address, &reg, 1) && read(address, data, length);
+}
+
+#endif
@@ -0,0 +1,42 @@
+// lib/ClimateSensor/src/I2cBus.h
+#pragma once
+
+// ==========================================================
+// ==        ARBITER BUS I2C (LCD + SENSOR)                 ==
+// ==========================================================
+// LCD (LiquidCrystal_I2C) dan sensor I2C berbagi satu Wire. Setiap pemakai
+// bus mengambil take() dulu dan give() sesudahnya, sehingga refresh LCD
+// (puluhan ms untuk dua baris) tidak pernah menyela transaksi sensor dan
+// sebaliknya. Sensor mengambil bus tanpa menunggu (take(0)) dan mengulang
+// tahapnya sebentar lagi; LCD boleh menunggu.
+
+#include <Arduino.h>
+#include <atomic>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+
+class I2cBus {
+public:
+    // Wire.begin() dengan pin dan clock sendiri. Harus sebelum lcd.init():
+    // LiquidCrystal_I2C memanggil Wire.begin() tanpa argumen, yang tidak
+    // mengubah bus yang sudah berjalan.
+    bool begin(int sda, int scl, uint32_t clockHz);
+
+    bool take(TickType_t ticks);
+    void give();
+
+    // Transaksi; pemanggil harus memegang bus. false = NACK atau error bus.
+    bool write(uint8_t address, const uint8_t* data, size_t length);
+    bool read(uint8_t address, uint8_t* data, size_t length);
+    // Pointer register lalu baca dengan repeated start (BME280).
+    bool read_register(uint8_t address, uint8_t reg, uint8_t* data, size_t length);
+
+    // take() yang tidak langsung mendapat bus (sensor menunda / LCD menunggu).
+    uint32_t contended() const { return contended_; }
+    uint32_t errors() const { return errors_; }
+
+private:
+    SemaphoreHandle_t mutex_ = nullptr;
+    std::atomic<uint32_t> contended_{0};
+    std::atomic<uint32_t> errors_{0};
+};
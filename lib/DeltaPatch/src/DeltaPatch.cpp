@@ -0,0 +1,145 @@
+// lib/DeltaPatch/src/DeltaPatch.cpp
+#include "DeltaPatch.h"
+
+#include <string.h>
+
+static const uint8_t OP_COPY = 0x01;
+static const uint8_t OP_DATA = 0x02;
+
+static uint32_t read_u32le(const uint8_t* p) {
+    return (uint32_t)p[0] | (uint32_t)p[1] << 8 | (uint32_t)p[2] << 16 | (uint32_t)p[3] << 24;
+}
+
+void DeltaPatcher::reset() {
+    state_ = HEADER;
+    error_ = nullptr;
+    headerLen_ = 0;
+    header_ = {};
+    value_ = 0;
+    shift_ = 0;
+    copyOffset_ = 0;
+    oldCursor_ = 0;
+    dataLeft_ = 0;
+    produced_ = 0;
+}
+
+bool DeltaPatcher::fail(const char* reason) {
+    state_ = FAILED;
+    error_ = reason;
+    return false;
+}
+
+bool DeltaPatcher::take_varint(uint8_t b) {
+    if (shift_ >= 35) {
+        fail("varint terlalu panjang");
+        return false;
+    }
+    value_ |= (uint32_t)(b & 0x7F) << shift_;
+    shift_ += 7;
+    if (b & 0x80) return false;
+    shift_ = 0;
+    return true;
+}
+
+void DeltaPatcher::parse_header() {
+    if (memcmp(headerBuf_, "JDP1", 4) != 0) {
+        fail("magic bukan JDP1");
+        return;
+    }
+    header_.old_size = read_u32le(headerBuf_ + 4);
+    header_.new_size = read_u32le(headerBuf_ + 8);
+    memcpy(header_.old_sha256, headerBuf_ + 12, sizeof(header_.old_sha256));
+    if (!sink_.begin(header_)) {
+        fail("base patch tidak cocok dengan firmware berjalan");
+        return;
+    }
+    state_ = header_.new_size == 0 ? DONE : OP;
+}
+
+bool DeltaPatcher::run_copy(uint32_t length) {
+    if (copyOffset_ < 0 || (uint64_t)copyOffset_ + length > header_.old_size) {
+        return fail("COPY di luar image lama");
+    }
+    if (length > header_.new_size - produced_) return fail("COPY melewati new_size");
+    uint32_t offset = (uint32_t)copyOffset_;
+    while (length > 0) {
+        size_t n = length < kCopyChunk ? length : kCopyChunk;
+        if (!sink_.read_old(offset, copyBuf_, n)) return fail("gagal membaca image lama");
+        if (!sink_.write(copyBuf_, n)) return fail("gagal menulis image baru");
+        offset += n;
+        length -= n;
+        produced_ += n;
+    }
+    oldCursor_ = offset;
+    return true;
+}
+
+bool DeltaPatcher::feed(const uint8_t* data, size_t len) {
+    size_t i = 0;
+    while (i < len) {
+        switch (state_) {
+            case DONE:
+                return fail("data sisa setelah akhir patch");
+            case FAILED:
+                return false;
+
+            case HEADER: {
+                size_t n = kHeaderSize - headerLen_;
+                if (n > len - i) n = len - i;
+                memcpy(headerBuf_ + headerLen_, data + i, n);
+                headerLen_ += n;
+                i += n;
+                if (headerLen_ == kHeaderSize) parse_header();
+                break;
+            }
+
+            case OP: {
+                uint8_t op = data[i++];
+                value_ = 0;
+                shift_ = 0;
+                if (op == OP_COPY) state_ = COPY_OFFSET;
+                else if (op == OP_DATA) state_ = DATA_LENGTH;
+                else return fail("op tidak dikenal");
+                break;
+            }
+
+            case COPY_OFFSET:
+                if (take_varint(data[i++])) {
+                    // zigzag: 0, -1, 1, -2, ... -> 0, 1, 2, 3, ...
+                    int64_t delta = (int64_t)(value_ >> 1) ^ -(int64_t)(value_ & 1);
+                    copyOffset_ = (int64_t)oldCursor_ + delta;
+                    value_ = 0;
+                    state_ = COPY_LENGTH;
+                }
+                break;
+
+            case COPY_LENGTH:
+                if (take_varint(data[i++])) {
+                    if (!run_copy(value_)) return false;
+                    state_ = produced_ == header_.new_size ? DONE : OP;
+                }
+                break;
+
+            case DATA_LENGTH:
+                if (take_varint(data[i++])) {
+                    if (value_ > header_.new_size - produced_) return fail("DATA melewati new_size");
+                    dataLeft_ = value_;
+                    state_ = dataLeft_ ? DATA_BYTES : OP;
+                }
+                break;
+
+            case DATA_BYTES: {
+                size_t n = dataLeft_;
+                if (n > len - i) n = len - i;
+                if (!sink_.write(data + i, n)) return fail("gagal menulis image baru");
+                i += n;
+                dataLeft_ -= n;
+                produced_ += n;
+                if (dataLeft_ == 0) state_ = produced_ == header_.new_size ? DONE : OP;
+                break;
+            }
+        }
+        if (state_ == FAILED) return false;
+    }
+    return true;
+}
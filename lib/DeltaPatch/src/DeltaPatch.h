@@ -0,0 +1,76 @@
+// lib/DeltaPatch/src/DeltaPatch.h
+#pragma once
+
+// ==========================================================
+// ==        PATCH FIRMWARE BINER (FORMAT JDP1)            ==
+// ==========================================================
+// Patch dibuat di host oleh tools/jamur_delta.py dan diterapkan sambil
+// di-stream: byte patch masuk lewat feed() dalam potongan berapa pun, hasil
+// keluar lewat DeltaSink::write() berurutan, tanpa menampung image utuh.
+//
+//   header  "JDP1" | old_size:u32le | new_size:u32le | old_sha256[32]
+//   op 0x01 COPY   zigzag-varint geser_offset_lama, varint panjang
+//   op 0x02 DATA   varint panjang, lalu byte literal sebanyak itu
+//
+// Offset COPY relatif terhadap akhir COPY sebelumnya (awal = 0), jadi blok
+// yang tidak berubah cukup satu byte geser. Patch selesai tepat saat
+// new_size byte sudah ditulis; byte sisa dianggap rusak.
+
+#include <stdint.h>
+#include <stddef.h>
+
+struct DeltaHeader {
+    uint32_t old_size;
+    uint32_t new_size;
+    uint8_t old_sha256[32];
+};
+
+class DeltaSink {
+public:
+    virtual ~DeltaSink() {}
+    // Dipanggil sekali setelah header terbaca; false = base tidak cocok.
+    virtual bool begin(const DeltaHeader& header) = 0;
+    virtual bool read_old(uint32_t offset, uint8_t* buf, size_t len) = 0;
+    virtual bool write(const uint8_t* data, size_t len) = 0;
+};
+
+class DeltaPatcher {
+public:
+    static const size_t kHeaderSize = 4 + 4 + 4 + 32;
+    static const size_t kCopyChunk = 256;
+
+    explicit DeltaPatcher(DeltaSink& sink) : sink_(sink) { reset(); }
+
+    void reset();
+    // false bila patch rusak atau sink menolak; alasannya di error().
+    bool feed(const uint8_t* data, size_t len);
+
+    bool finished() const { return state_ == DONE; }
+    bool failed() const { return state_ == FAILED; }
+    const char* error() const { return error_; }
+    uint32_t produced() const { return produced_; }
+    const DeltaHeader& header() const { return header_; }
+
+private:
+    enum State : uint8_t { HEADER, OP, COPY_OFFSET, COPY_LENGTH, DATA_LENGTH, DATA_BYTES, DONE, FAILED };
+
+    bool fail(const char* reason);
+    // Mengembalikan true saat varint lengkap di value_.
+    bool take_varint(uint8_t b);
+    bool run_copy(uint32_t length);
+    void parse_header();
+
+    DeltaSink& sink_;
+    State state_;
+    const char* error_;
+    uint8_t headerBuf_[kHeaderSize];
+    size_t headerLen_;
+    DeltaHeader header_;
+    uint32_t value_;
+    uint8_t shift_;
+    int64_t copyOffset_;
+    uint32_t oldCursor_;
+    uint32_t dataLeft_;
+    uint32_t produced_;
+    uint8_t copyBuf_[kCopyChunk];
+};
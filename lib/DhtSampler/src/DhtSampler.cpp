@@ -0,0 +1,181 @@
+// lib/DhtSampler/src/DhtSampler.cpp
+#include "DhtSampler.h"
+
+// Datasheet: sinyal start >= 18 ms (DHT11) / >= 1 ms (DHT22); frame
+// lengkap < 5.5 ms setelah pin dilepas; sensor butuh 1 detik setelah daya
+// masuk sebelum boleh dibaca.
+static const uint32_t DHT11_START_MS = 20;
+static const uint32_t DHT22_START_MS = 2;
+static const uint32_t CAPTURE_MS = 8;
+static const uint32_t POWER_UP_MS = 1000;
+// Bit 0 ~26-28 us HIGH, bit 1 ~70 us; ambang di tengahnya.
+static const uint16_t BIT_ONE_MIN_US = 48;
+
+DhtSampler::DhtSampler(uint8_t pin, uint8_t type, uint8_t channel, uint32_t intervalMs)
+    : Sensor(intervalMs), pin_(pin), type_(type), channel_(channel) {}
+
+DhtSampler::~DhtSampler() {
+    if (ready_) hw_end();
+}
+
+bool DhtSampler::begin() {
+    ready_ = hw_begin();
+    phase_ = PHASE_IDLE;
+    dueMs_ = millis() + POWER_UP_MS;
+    return ready_;
+}
+
+bool DhtSampler::poll(uint32_t nowMs) {
+    if (!ready_ || (int32_t)(nowMs - dueMs_) < 0) return false;
+    switch (phase_) {
+        case PHASE_IDLE:
+            hw_pull_low();
+            phase_ = PHASE_START;
+            dueMs_ = nowMs + (type_ == 11 ? DHT11_START_MS : DHT22_START_MS);
+            return false;
+
+        case PHASE_START:
+            hw_release();
+            phase_ = PHASE_CAPTURE;
+            dueMs_ = nowMs + CAPTURE_MS;
+            return false;
+
+        case PHASE_CAPTURE: {
+            phase_ = PHASE_IDLE;
+            dueMs_ = nowMs + intervalMs_;
+            uint8_t frame[5];
+            if (!hw_collect(frame)) {
+                finish(SENSOR_TIMEOUT, NAN, NAN);
+                return true;
+            }
+            float humidity, temperature;
+            SensorStatus status = parse(type_, frame, humidity, temperature);
+            finish(status, humidity, temperature);
+            return true;
+        }
+    }
+    return false;
+}
+
+uint32_t DhtSampler::until_next(uint32_t nowMs) const {
+    if (!ready_) return UINT32_MAX;
+    int32_t left = (int32_t)(dueMs_ - nowMs);
+    return left > 0 ? (uint32_t)left : 0;
+}
+
+SensorStatus DhtSampler::parse(uint8_t type, const uint8_t frame[5], float& humidity, float& temperature) {
+    humidity = temperature = NAN;
+    if ((uint8_t)(frame[0] + frame[1] + frame[2] + frame[3]) != frame[4]) return SENSOR_CHECKSUM;
+    if (type == 11) {
+        humidity = frame[0] + frame[1] * 0.1f;
+        temperature = frame[2] + (frame[3] & 0x0F) * 0.1f;
+        if (frame[3] & 0x80) temperature = -temperature;
+    } else {
+        humidity = ((frame[0] << 8) | frame[1]) * 0.1f;
+        temperature = (((frame[2] & 0x7F) << 8) | frame[3]) * 0.1f;
+        if (frame[2] & 0x80) temperature = -temperature;
+    }
+    return SENSOR_OK;
+}
+
+bool DhtSampler::decode_highs(const uint16_t* highUs, size_t count, uint8_t frame[5]) {
+    // Sebelum bit data ada HIGH pelepasan pin dan respons 80 us sensor;
+    // keduanya bisa tergabung atau terpotong, jadi dihitung dari belakang.
+    if (count < 40) return false;
+    const uint16_t* bits = highUs + count - 40;
+    for (int i = 0; i < 5; i++) {
+        uint8_t value = 0;
+        for (int b = 0; b < 8; b++) value = (value << 1) | (bits[i * 8 + b] >= BIT_ONE_MIN_US ? 1 : 0);
+        frame[i] = value;
+    }
+    return true;
+}
+
+#if defined(ESP32)
+
+#include <driver/gpio.h>
+#include <driver/rmt.h>
+
+// RMT dengan resolusi 1 us; frame berakhir bila pin HIGH lebih lama dari
+// idle_threshold (pulsa DHT terpanjang 80 us). Pin dibuat open-drain
+// input/output sehingga sinyal start dan capture memakai pin yang sama
+// tanpa memindah routing GPIO matrix.
+static const uint16_t RMT_IDLE_US = 150;
+static const uint8_t RMT_FILTER_TICKS = 100;   // ~1.25 us pada APB 80 MHz
+static const size_t RMT_RINGBUF_SIZE = 512;
+
+bool DhtSampler::hw_begin() {
+    rmt_config_t cfg = RMT_DEFAULT_CONFIG_RX((gpio_num_t)pin_, (rmt_channel_t)channel_);
+    cfg.clk_div = 80;
+    cfg.rx_config.filter_en = true;
+    cfg.rx_config.filter_ticks_thresh = RMT_FILTER_TICKS;
+    cfg.rx_config.idle_threshold = RMT_IDLE_US;
+    if (rmt_config(&cfg) != ESP_OK || rmt_driver_install(cfg.channel, RMT_RINGBUF_SIZE, 0) != ESP_OK) return false;
+    RingbufHandle_t ringbuf = nullptr;
+    if (rmt_get_ringbuf_handle(cfg.channel, &ringbuf) != ESP_OK) return false;
+    ringbuf_ = ringbuf;
+    gpio_set_direction((gpio_num_t)pin_, GPIO_MODE_INPUT_OUTPUT_OD);
+    gpio_set_pull_mode((gpio_num_t)pin_, GPIO_PULLUP_ONLY);
+    gpio_set_level((gpio_num_t)pin_, 1);
+    return true;
+}
+
+void DhtSampler::hw_end() {
+    rmt_rx_stop((rmt_channel_t)channel_);
+    rmt_driver_uninstall((rmt_channel_t)channel_);
+    ringbuf_ = nullptr;
+    gpio_set_direction((gpio_num_t)pin_, GPIO_MODE_INPUT);
+}
+
+void DhtSampler::hw_pull_low() {
+    gpio_set_level((gpio_num_t)pin_, 0);
+}
+
+// Sensor menjawab 20-40 us setelah pin dilepas; RX dinyalakan segera
+// sesudahnya dan sisa item lama dibuang lewat rx_idx_rst.
+void DhtSampler::hw_release() {
+    gpio_set_level((gpio_num_t)pin_, 1);
+    rmt_rx_start((rmt_channel_t)channel_, true);
+}
+
+bool DhtSampler::hw_collect(uint8_t frame[5]) {
+    RingbufHandle_t ringbuf = (RingbufHandle_t)ringbuf_;
+    size_t length = 0;
+    rmt_item32_t* items = (rmt_item32_t*)xRingbufferReceive(ringbuf, &length, 0);
+    rmt_rx_stop((rmt_channel_t)channel_);
+    if (!items) return false;
+
+    uint16_t highs[48];
+    size_t count = 0;
+    size_t itemCount = length / sizeof(rmt_item32_t);
+    for (size_t i = 0; i < itemCount; i++) {
+        const rmt_item32_t& item = items[i];
+        // Tiap item dua pulsa; durasi 0 menandai akhir frame.
+        uint16_t levels[2] = { (uint16_t)item.level0, (uint16_t)item.level1 };
+        uint16_t durations[2] = { (uint16_t)item.duration0, (uint16_t)item.duration1 };
+        for (int k = 0; k < 2; k++) {
+            if (durations[k] == 0 || !levels[k]) continue;
+            if (count == sizeof(highs) / sizeof(highs[0])) {
+                memmove(highs, highs + 1, sizeof(highs) - sizeof(highs[0]));
+                count--;
+            }
+            highs[count++] = durations[k];
+        }
+    }
+    vRingbufferReturnItem(ringbuf, items);
+    return decode_highs(highs, count, frame);
+}
+
+#else
+
+// [env:native]: frame dibangkitkan model ruang NativeSim (noise, kuantisasi
+// DHT11, frame hilang dan spike sesuai knob JAMUR_SIM_DHT_*).
+#include "NativeSim.h"
+
+bool DhtSampler::hw_begin() { return true; }
+void DhtSampler::hw_end() {}
+void DhtSampler::hw_pull_low() {}
+void DhtSampler::hw_release() {}
+bool DhtSampler::hw_collect(uint8_t frame[5]) { return sim::dht_frame(pin_, type_, frame); }
+
+#endif
@@ -0,0 +1,56 @@
+// lib/DhtSampler/src/DhtSampler.h
+#pragma once
+
+// ==========================================================
+// ==        PEMBACAAN DHT TANPA BLOKIR (RMT CAPTURE)       ==
+// ==========================================================
+// Pustaka DHT biasa men-bit-bang frame dengan interrupt mati ~23 ms per
+// baca. Di sini satu pembacaan dipecah menjadi tahap yang dijalankan poll():
+//
+//   START   pin open-drain ditarik LOW (18 ms DHT11, 1.1 ms DHT22)
+//   CAPTURE pin dilepas, periferal RMT merekam lebar pulsa frame 40 bit
+//   idle    frame didekode dari durasi HIGH, checksum diperiksa
+//
+// Di antara tahap CPU bebas; pemanggil cukup bangun sebelum until_next()
+// habis. [env:native] mengambil frame dari model ruang NativeSim.
+
+#include <ClimateSensor.h>
+
+class DhtSampler : public Sensor {
+public:
+    // type = 11 atau 22 (sama dengan DHT_TYPE); channel = kanal RMT RX.
+    DhtSampler(uint8_t pin, uint8_t type, uint8_t channel, uint32_t intervalMs);
+    // Melepas driver RMT kanal ini dan mengembalikan pin ke input, sehingga
+    // kanal dan pin bisa dipasang ulang dengan sampler lain.
+    ~DhtSampler() override;
+
+    const char* name() const override { return type_ == 11 ? "DHT11" : "DHT22"; }
+    bool begin() override;
+    bool poll(uint32_t nowMs) override;
+    uint32_t until_next(uint32_t nowMs) const override;
+    // Datasheet: DHT11 1 Hz, DHT22 0.5 Hz.
+    uint32_t min_interval() const override { return type_ == 11 ? 1000 : 2000; }
+
+    // Frame 5 byte -> nilai, dengan checksum. Dipisah agar bisa diuji tanpa hardware.
+    static SensorStatus parse(uint8_t type, const uint8_t frame[5], float& humidity, float& temperature);
+    // Durasi pulsa HIGH (us) berurutan -> frame; 40 pulsa terakhir adalah bit data.
+    static bool decode_highs(const uint16_t* highUs, size_t count, uint8_t frame[5]);
+
+private:
+    enum Phase : uint8_t { PHASE_IDLE, PHASE_START, PHASE_CAPTURE };
+
+    // Bagian yang bergantung platform (DhtSampler.cpp).
+    bool hw_begin();
+    void hw_end();
+    void hw_pull_low();
+    void hw_release();
+    bool hw_collect(uint8_t frame[5]);
+
+    uint8_t pin_;
+    uint8_t type_;
+    uint8_t channel_;
+    Phase phase_ = PHASE_IDLE;
+    uint32_t dueMs_ = 0;
+    bool ready_ = false;
+    void* ringbuf_ = nullptr;
+};
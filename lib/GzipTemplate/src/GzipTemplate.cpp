@@ -0,0 +1,171 @@
+// lib/GzipTemplate/src/GzipTemplate.cpp
+#include "GzipTemplate.h"
+
+#include <string.h>
+
+static const uint8_t GZIP_HEADER[10] = { 0x1f, 0x8b, 0x08, 0x00, 0, 0, 0, 0, 0x00, 0xff };
+// Blok stored final dengan panjang 0: menutup stream deflate.
+static const uint8_t DEFLATE_END[5] = { 0x01, 0x00, 0x00, 0xff, 0xff };
+static const size_t STORED_HEADER = 5;
+static const size_t GZIP_TRAILER = 8;
+
+namespace {
+
+// Mengumpulkan potongan kecil di stack agar socket tidak menerima write
+// beberapa byte; data besar dari flash diteruskan tanpa salinan.
+class ChunkWriter {
+public:
+    ChunkWriter(GzipWriteFn fn, void* ctx) : fn_(fn), ctx_(ctx), used_(0) {}
+
+    void put(const uint8_t* data, size_t len) {
+        if (len >= sizeof(buf_)) {
+            flush();
+            fn_(ctx_, data, len);
+            return;
+        }
+        if (used_ + len > sizeof(buf_)) flush();
+        memcpy(buf_ + used_, data, len);
+        used_ += len;
+    }
+    void put(uint8_t b) { put(&b, 1); }
+    void flush() {
+        if (used_ == 0) return;
+        fn_(ctx_, buf_, used_);
+        used_ = 0;
+    }
+
+private:
+    GzipWriteFn fn_;
+    void* ctx_;
+    uint8_t buf_[GzipTemplate::kBufferSize];
+    size_t used_;
+};
+
+const char* escape_of(char c) {
+    switch (c) {
+        case '&': return "&amp;";
+        case '<': return "&lt;";
+        case '>': return "&gt;";
+        case '"': return "&quot;";
+        case '\'': return "&#39;";
+        default: return nullptr;
+    }
+}
+
+uint32_t gf2_times(const uint32_t* mat, uint32_t vec) {
+    uint32_t sum = 0;
+    for (int i = 0; vec; i++, vec >>= 1) {
+        if (vec & 1) sum ^= mat[i];
+    }
+    return sum;
+}
+
+void gf2_square(uint32_t* square, const uint32_t* mat) {
+    for (int i = 0; i < 32; i++) square[i] = gf2_times(mat, mat[i]);
+}
+
+const char* value_of(const char* const values[], uint8_t field) {
+    const char* v = values ? values[field] : nullptr;
+    return v ? v : "";
+}
+
+} // namespace
+
+uint32_t GzipTemplate::crc32_update(uint32_t crc, const uint8_t* data, size_t len) {
+    crc = ~crc;
+    while (len--) {
+        crc ^= *data++;
+        for (int k = 0; k < 8; k++) crc = (crc >> 1) ^ (0xEDB88320UL & (0 - (crc & 1)));
+    }
+    return ~crc;
+}
+
+// Algoritme crc32_combine milik zlib: operator "geser n byte nol" dibangun
+// dengan kuadrat matriks GF(2), O(log n).
+uint32_t GzipTemplate::crc32_combine(uint32_t crcA, uint32_t crcB, uint32_t lengthB) {
+    if (lengthB == 0) return crcA;
+    uint32_t even[32];
+    uint32_t odd[32];
+    odd[0] = 0xEDB88320UL;
+    uint32_t row = 1;
+    for (int i = 1; i < 32; i++) {
+        odd[i] = row;
+        row <<= 1;
+    }
+    gf2_square(even, odd);
+    gf2_square(odd, even);
+    do {
+        gf2_square(even, odd);
+        if (lengthB & 1) crcA = gf2_times(even, crcA);
+        lengthB >>= 1;
+        if (lengthB == 0) break;
+        gf2_square(odd, even);
+        if (lengthB & 1) crcA = gf2_times(odd, crcA);
+        lengthB >>= 1;
+    } while (lengthB);
+    return crcA ^ crcB;
+}
+
+size_t GzipTemplate::escaped_length(const char* value) {
+    size_t n = 0;
+    for (const char* p = value; *p; p++) {
+        const char* e = escape_of(*p);
+        size_t step = e ? strlen(e) : 1;
+        if (n + step > kMaxField) break;
+        n += step;
+    }
+    return n;
+}
+
+size_t GzipTemplate::length(const GzipAsset& asset, const char* const values[]) {
+    size_t total = sizeof(GZIP_HEADER) + sizeof(DEFLATE_END) + GZIP_TRAILER;
+    for (uint8_t i = 0; i < asset.segmentCount; i++) {
+        total += asset.segments[i].length;
+        if (i + 1 < asset.segmentCount) {
+            size_t n = escaped_length(value_of(values, asset.fields[i]));
+            if (n > 0) total += STORED_HEADER + n;
+        }
+    }
+    return total;
+}
+
+void GzipTemplate::write(const GzipAsset& asset, const char* const values[], GzipWriteFn fn, void* ctx) {
+    ChunkWriter out(fn, ctx);
+    uint32_t crc = 0;
+    uint32_t size = 0;
+    out.put(GZIP_HEADER, sizeof(GZIP_HEADER));
+
+    for (uint8_t i = 0; i < asset.segmentCount; i++) {
+        const GzipSegment& seg = asset.segments[i];
+        if (seg.length > 0) out.put(seg.data, seg.length);
+        crc = crc32_combine(crc, seg.crc, seg.rawLength);
+        size += seg.rawLength;
+        if (i + 1 >= asset.segmentCount) break;
+
+        const char* value = value_of(values, asset.fields[i]);
+        size_t n = escaped_length(value);
+        if (n == 0) continue;
+        uint8_t header[STORED_HEADER] = { 0x00, (uint8_t)n, (uint8_t)(n >> 8),
+                                          (uint8_t)~n, (uint8_t)(~n >> 8) };
+        out.put(header, sizeof(header));
+        size_t written = 0;
+        for (const char* p = value; written < n; p++) {
+            const char* e = escape_of(*p);
+            const uint8_t* bytes = e ? (const uint8_t*)e : (const uint8_t*)p;
+            size_t len = e ? strlen(e) : 1;
+            out.put(bytes, len);
+            crc = crc32_update(crc, bytes, len);
+            written += len;
+        }
+        size += n;
+    }
+
+    out.put(DEFLATE_END, sizeof(DEFLATE_END));
+    uint8_t trailer[GZIP_TRAILER];
+    for (int i = 0; i < 4; i++) {
+        trailer[i] = (uint8_t)(crc >> (8 * i));
+        trailer[4 + i] = (uint8_t)(size >> (8 * i));
+    }
+    out.put(trailer, sizeof(trailer));
+    out.flush();
+}
@@ -0,0 +1,54 @@
+// lib/GzipTemplate/src/GzipTemplate.h
+#pragma once
+
+// ==========================================================
+// ==      HALAMAN GZIP DARI FLASH + FIELD DINAMIS         ==
+// ==========================================================
+// tools/build_portal.py memecah tiap file di portal/ pada penanda {{field}}
+// dan mengompres tiap potongan statis sebagai deflate mentah yang berakhir
+// di batas byte (sync flush, bukan blok final). Saat dikirim, nilai field
+// di-escape HTML lalu disisipkan sebagai blok "stored" (tanpa kompresi),
+// sehingga seluruh body tetap satu stream gzip yang sah:
+//
+//   header gzip | seg0 | stored(field0) | seg1 | ... | segN | blok final kosong | CRC32 | ISIZE
+//
+// CRC32 body asli digabung dari CRC tiap potongan (crc32_combine), jadi
+// teks statis tidak perlu didekompres di perangkat. Tidak ada alokasi heap:
+// potongan kecil dikumpulkan di buffer stack, potongan statis dikirim
+// langsung dari flash.
+
+#include <stdint.h>
+#include <stddef.h>
+
+struct GzipSegment {
+    const uint8_t* data;   // deflate mentah, byte-aligned, tanpa blok final
+    uint32_t length;
+    uint32_t rawLength;    // panjang teks sebelum kompresi
+    uint32_t crc;          // CRC32 teks sebelum kompresi
+};
+
+struct GzipAsset {
+    const GzipSegment* segments;
+    uint8_t segmentCount;
+    const uint8_t* fields;   // fields[i] disisipkan setelah segments[i]
+    const char* contentType;
+};
+
+typedef void (*GzipWriteFn)(void* ctx, const uint8_t* data, size_t len);
+
+class GzipTemplate {
+public:
+    // Nilai field terpanjang yang dikirim (sesudah escape); sisanya dipotong.
+    static const size_t kMaxField = 1024;
+    static const size_t kBufferSize = 256;
+
+    // Panjang body gzip untuk values[] tertentu, untuk header Content-Length.
+    static size_t length(const GzipAsset& asset, const char* const values[]);
+    // values[] diindeks dengan nomor field; nullptr = string kosong.
+    static void write(const GzipAsset& asset, const char* const values[], GzipWriteFn fn, void* ctx);
+
+    static uint32_t crc32_update(uint32_t crc, const uint8_t* data, size_t len);
+    // CRC32 dari A||B bila diketahui crc(A), crc(B) dan panjang B.
+    static uint32_t crc32_combine(uint32_t crcA, uint32_t crcB, uint32_t lengthB);
+    static size_t escaped_length(const char* value);
+};
@@ -0,0 +1,91 @@
+// lib/HumidityControl/src/HumidityControl.cpp
+#include "HumidityControl.h"
+
+HumidityZone HumidityControl::update(float humidity, uint32_t nowMs, float critical, float warning,
+                                     const ControlTuning& tuning) {
+    const Sample& newest = history_[(head_ + kHistory - 1) % kHistory];
+    if (count_ == 0 || nowMs - newest.ms >= kRateWindowMs / (kHistory - 1)) {
+        history_[head_] = { nowMs, humidity };
+        head_ = (head_ + 1) % kHistory;
+        if (count_ < kHistory) count_++;
+    }
+    rate_ = estimate_rate(nowMs, humidity);
+
+    changed_ = false;
+    state_ = classify(humidity, state_, critical, warning, tuning.hysteresis);
+    if (state_ == zone_) {
+        holding_ = false;
+    } else if (started_ && nowMs - enteredMs_ < (uint32_t)tuning.dwell_s * 1000UL) {
+        if (!holding_) stats_.held++;
+        holding_ = true;
+    } else {
+        zone_ = state_;
+        enteredMs_ = nowMs;
+        holding_ = false;
+        changed_ = true;
+        stats_.changes++;
+    }
+    // Zona awal setelah boot tidak menunggu dwell, sama seperti sebelumnya
+    // notifikasi pertama langsung terkirim.
+    if (!started_) {
+        started_ = true;
+        enteredMs_ = nowMs;
+    }
+
+    bool falling = tuning.fall_rate > 0 && !isnan(rate_) && rate_ <= -tuning.fall_rate;
+    bool early = falling && state_ == ZONE_WARNING;
+    if (early && !early_) stats_.early++;
+    early_ = early;
+    return zone_;
+}
+
+void HumidityControl::reset() {
+    count_ = 0;
+    head_ = 0;
+    state_ = ZONE_NORMAL;
+    zone_ = ZONE_NORMAL;
+    started_ = false;
+    holding_ = false;
+    changed_ = false;
+    early_ = false;
+    rate_ = NAN;
+}
+
+// Zona lebih buruk langsung dimasuki; zona lebih baik hanya bila
+// kelembapan sudah melewati ambangnya ditambah hysteresis.
+HumidityZone HumidityControl::classify(float humidity, HumidityZone current, float critical, float warning,
+                                       float hysteresis) {
+    HumidityZone raw = humidity < critical ? ZONE_CRITICAL : (humidity < warning ? ZONE_WARNING : ZONE_NORMAL);
+    if (raw >= current) return raw;
+    HumidityZone relaxed = humidity < critical + hysteresis
+        ? ZONE_CRITICAL
+        : (humidity < warning + hysteresis ? ZONE_WARNING : ZONE_NORMAL);
+    return relaxed < current ? relaxed : current;
+}
+
+// Kemiringan least-squares dari riwayat di dalam kRateWindowMs plus sampel
+// sekarang. Butuh rentang minimal separuh jendela agar kuantisasi DHT11
+// (1 %RH) tidak terbaca sebagai laju besar.
+float HumidityControl::estimate_rate(uint32_t nowMs, float humidity) const {
+    // Sampel sekarang ikut dihitung kecuali baru saja masuk riwayat.
+    bool fresh = count_ > 0 && history_[(head_ + kHistory - 1) % kHistory].ms == nowMs;
+    float sumT = 0, sumH = fresh ? 0 : humidity, sumTT = 0, sumTH = 0;
+    uint8_t n = fresh ? 0 : 1;
+    uint32_t span = 0;
+    for (uint8_t i = 0; i < count_; i++) {
+        const Sample& s = history_[(head_ + kHistory - 1 - i) % kHistory];
+        uint32_t age = nowMs - s.ms;
+        if (age > kRateWindowMs) break;
+        // Detik sebelum sekarang dibuat negatif agar kemiringan positif = naik.
+        float t = -(float)age / 1000.0f;
+        sumT += t;
+        sumH += s.humidity;
+        sumTT += t * t;
+        sumTH += t * s.humidity;
+        n++;
+        span = age;
+    }
+    if (span < kRateWindowMs / 2) return NAN;
+    float denom = n * sumTT - sumT * sumT;
+    return (n * sumTH - sumT * sumH) / denom * 60.0f;
+}
@@ -0,0 +1,79 @@
+// lib/HumidityControl/src/HumidityControl.h
+#pragma once
+
+// ==========================================================
+// ==    KONTROL KELEMBAPAN: HYSTERESIS, DWELL, LAJU TURUN  ==
+// ==========================================================
+// Menentukan zona NORMAL/WARNING/CRITICAL dari kelembapan terfilter.
+// - state(): masuk zona lebih buruk saat kelembapan < ambang, keluar baru
+//   setelah kelembapan >= ambang + hysteresis. Pompa mengikuti ini.
+// - zone(): state() yang sudah bertahan; zona yang dilaporkan baru boleh
+//   berganti lagi setelah dwell_s. Notifikasi mengikuti ini, sehingga
+//   ayunan singkat tidak terkirim tetapi pompa tidak ikut tertahan.
+// - early() benar bila state() WARNING dan kelembapan turun lebih cepat dari
+//   fall_rate %RH/menit (dihitung dari riwayat kRateWindowMs terakhir),
+//   sehingga pompa bisa menyala sebelum ambang kritis tercapai.
+// Tuning {0, 0, 0} = perbandingan ambang biasa seperti sebelumnya.
+
+#include <Arduino.h>
+
+enum HumidityZone : uint8_t { ZONE_NORMAL, ZONE_WARNING, ZONE_CRITICAL };
+
+struct ControlTuning {
+    float hysteresis;   // %RH
+    uint16_t dwell_s;
+    float fall_rate;    // %RH per menit, 0 = pemicu laju mati
+};
+
+struct ControlStats {
+    uint32_t changes;   // pergantian zona (= notifikasi)
+    uint32_t held;      // pergantian state yang belum dilaporkan karena dwell
+    uint32_t early;     // pemicu laju turun (tepi naik)
+};
+
+class HumidityControl {
+public:
+    // Riwayat disampling tiap kRateWindowMs / (kHistory - 1) ms sehingga
+    // kHistory sampel mencakup satu jendela laju penuh.
+    static const uint8_t kHistory = 16;
+    static const uint32_t kRateWindowMs = 300000;
+
+    // Dipanggil tiap siklus logika; mengembalikan zone() setelah sampel ini.
+    HumidityZone update(float humidity, uint32_t nowMs, float critical, float warning, const ControlTuning& tuning);
+    void reset();
+
+    HumidityZone zone() const { return zone_; }
+    HumidityZone state() const { return state_; }
+    // zone() berganti pada update() terakhir.
+    bool changed() const { return changed_; }
+    // Pompa perlu menyala karena kelembapan kritis.
+    bool demand() const { return state_ == ZONE_CRITICAL; }
+    bool early() const { return early_; }
+    // %RH per menit; NAN bila riwayat belum cukup.
+    float rate() const { return rate_; }
+    const ControlStats& stats() const { return stats_; }
+
+    // Zona baru dari zona sekarang; tanpa state sehingga bisa diuji terpisah.
+    static HumidityZone classify(float humidity, HumidityZone current, float critical, float warning, float hysteresis);
+
+private:
+    struct Sample {
+        uint32_t ms;
+        float humidity;
+    };
+
+    float estimate_rate(uint32_t nowMs, float humidity) const;
+
+    Sample history_[kHistory];
+    uint8_t count_ = 0;
+    uint8_t head_ = 0;
+    HumidityZone state_ = ZONE_NORMAL;
+    HumidityZone zone_ = ZONE_NORMAL;
+    uint32_t enteredMs_ = 0;
+    bool started_ = false;
+    bool holding_ = false;
+    bool changed_ = false;
+    bool early_ = false;
+    float rate_ = NAN;
+    ControlStats stats_ = {};
+};
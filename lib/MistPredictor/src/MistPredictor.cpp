@@ -0,0 +1,160 @@
+// lib/MistPredictor/src/MistPredictor.cpp
+#include "MistPredictor.h"
+
+// Titik tengah regresi; memusatkan data menjaga persamaan normal tetap
+// terkondisi baik dalam float.
+static const float kRefHumidity = 80.0f;
+static const float kRefTemperature = 27.0f;
+// Regularisasi kecil agar jendela dengan suhu atau kelembapan hampir
+// konstan tidak membuat matriks singular.
+static const float kRidge = 0.05f;
+// Bobot kejadian siram baru pada rata-rata gain.
+static const float kGainAlpha = 0.3f;
+
+void MistPredictor::observe(uint32_t nowMs, float humidity, float temperature) {
+    lastHumidity_ = humidity;
+    lastTemperature_ = temperature;
+    if (eventOpen_ && !pumpOn_ && nowMs - lastPumpMs_ >= kSettleMs) measure_gain(nowMs);
+
+    if (samples_ == 0 && slotPumpMs_ == 0) slotStartMs_ = nowMs;
+    sumH_ += humidity;
+    sumT_ += temperature;
+    samples_++;
+    uint32_t elapsed = nowMs - slotStartMs_;
+    if (elapsed < kSlotMs) return;
+
+    // Celah lebih dari dua slot (sensor mati, task tertahan) memutus
+    // deret; selisih antar slot tidak lagi bermakna.
+    if (elapsed > 2 * kSlotMs) count_ = 0;
+    uint32_t pump10 = slotPumpMs_ / 10;
+    history_[head_] = { sumH_ / samples_, sumT_ / samples_, (uint16_t)(pump10 > UINT16_MAX ? UINT16_MAX : pump10) };
+    head_ = (head_ + 1) % kHistory;
+    if (count_ < kHistory) count_++;
+    sumH_ = 0;
+    sumT_ = 0;
+    samples_ = 0;
+    // Relay yang masih menyala menandai slot berikutnya juga.
+    slotPumpMs_ = pumpOn_ ? 1 : 0;
+    slotStartMs_ = nowMs;
+    if (count_ >= kMinSlots) fit();
+}
+
+void MistPredictor::pump_started(uint32_t nowMs) {
+    pumpOn_ = true;
+    if (slotPumpMs_ == 0) slotPumpMs_ = 1;
+    // Pulsa berikutnya sebelum kejadian terukur digabung ke kejadian yang sama.
+    if (eventOpen_ || isnan(lastHumidity_)) return;
+    eventOpen_ = true;
+    eventStartHumidity_ = lastHumidity_;
+    eventStartMs_ = nowMs;
+    eventOnMs_ = 0;
+}
+
+void MistPredictor::pump_stopped(uint32_t onMs, uint32_t nowMs) {
+    pumpOn_ = false;
+    slotPumpMs_ += onMs;
+    eventOnMs_ += onMs;
+    lastPumpMs_ = nowMs;
+    pumped_ = true;
+}
+
+void MistPredictor::reset() {
+    count_ = 0;
+    head_ = 0;
+    sumH_ = 0;
+    sumT_ = 0;
+    samples_ = 0;
+    slotPumpMs_ = 0;
+    pumped_ = false;
+    pumpOn_ = false;
+    eventOpen_ = false;
+    lastHumidity_ = NAN;
+    lastTemperature_ = NAN;
+    fitted_ = false;
+    gain_ = NAN;
+}
+
+float MistPredictor::trend(float humidity, float temperature) const {
+    if (!fitted_) return NAN;
+    return coef_[0] + coef_[1] * (humidity - kRefHumidity) + coef_[2] * (temperature - kRefTemperature);
+}
+
+uint32_t MistPredictor::plan(uint32_t nowMs, float humidity, float temperature, const MistTuning& tuning,
+                             uint32_t minMs, uint32_t maxMs, uint32_t fallbackMs) {
+    if (!tuning.enabled || !fitted_ || pumpOn_) return 0;
+    if (pumped_ && nowMs - lastPumpMs_ < kSettleMs) return 0;
+    float predicted = humidity + trend(humidity, temperature) * tuning.horizon_s / 60.0f;
+    if (predicted >= tuning.setpoint - tuning.band) return 0;
+
+    uint32_t ms = fallbackMs;
+    if (!isnan(gain_)) ms = (uint32_t)((tuning.setpoint + tuning.band - humidity) / gain_ * 1000.0f);
+    if (ms < minMs) ms = minMs;
+    if (ms > maxMs) ms = maxMs;
+    stats_.plans++;
+    return ms;
+}
+
+// Kenaikan sejak sebelum pulsa pertama, dikoreksi peluruhan model selama
+// kejadian (rata-rata laju di awal dan akhir).
+void MistPredictor::measure_gain(uint32_t nowMs) {
+    eventOpen_ = false;
+    if (eventOnMs_ < 1000) return;
+    float rise = lastHumidity_ - eventStartHumidity_;
+    if (fitted_) {
+        float drift = (trend(eventStartHumidity_, lastTemperature_) + trend(lastHumidity_, lastTemperature_)) / 2;
+        rise -= drift * (nowMs - eventStartMs_) / 60000.0f;
+    }
+    float g = rise * 1000.0f / eventOnMs_;
+    if (g <= 0) return;
+    gain_ = isnan(gain_) ? g : gain_ + kGainAlpha * (g - gain_);
+    stats_.events++;
+}
+
+// Least squares atas pasangan slot berurutan tanpa pompa (termasuk slot
+// sebelumnya, karena respons sensor tertinggal): y = H[i+1] - H[i] (satu
+// slot = satu menit), x = [1, H[i] - 80, T[i] - 27].
+void MistPredictor::fit() {
+    float a[3][4] = {};
+    uint8_t pairs = 0;
+    uint8_t oldest = (head_ + kHistory - count_) % kHistory;
+    for (uint8_t i = 1; i + 1 < count_; i++) {
+        const Slot& prev = history_[(oldest + i - 1) % kHistory];
+        const Slot& s0 = history_[(oldest + i) % kHistory];
+        const Slot& s1 = history_[(oldest + i + 1) % kHistory];
+        if (prev.pumpMs10 || s0.pumpMs10 || s1.pumpMs10) continue;
+        float x[3] = { 1.0f, s0.humidity - kRefHumidity, s0.temperature - kRefTemperature };
+        float y = s1.humidity - s0.humidity;
+        for (uint8_t r = 0; r < 3; r++) {
+            for (uint8_t c = 0; c < 3; c++) a[r][c] += x[r] * x[c];
+            a[r][3] += x[r] * y;
+        }
+        pairs++;
+    }
+    if (pairs < kMinPairs) return;
+    a[1][1] += kRidge;
+    a[2][2] += kRidge;
+
+    // Eliminasi Gauss-Jordan dengan pivot parsial.
+    for (uint8_t col = 0; col < 3; col++) {
+        uint8_t pivot = col;
+        for (uint8_t r = col + 1; r < 3; r++) {
+            if (fabsf(a[r][col]) > fabsf(a[pivot][col])) pivot = r;
+        }
+        if (fabsf(a[pivot][col]) < 1e-6f) return;
+        if (pivot != col) {
+            for (uint8_t c = 0; c < 4; c++) {
+                float tmp = a[col][c];
+                a[col][c] = a[pivot][c];
+                a[pivot][c] = tmp;
+            }
+        }
+        for (uint8_t r = 0; r < 3; r++) {
+            if (r == col) continue;
+            float f = a[r][col] / a[col][col];
+            for (uint8_t c = col; c < 4; c++) a[r][c] -= f * a[col][c];
+        }
+    }
+    for (uint8_t r = 0; r < 3; r++) coef_[r] = a[r][3] / a[r][r];
+    fitted_ = true;
+    stats_.fits++;
+}
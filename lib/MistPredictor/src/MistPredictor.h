@@ -0,0 +1,98 @@
+// lib/MistPredictor/src/MistPredictor.h
+#pragma once
+
+// ==========================================================
+// ==     PREDIKSI KABUT: MODEL PELURUHAN KELEMBAPAN        ==
+// ==========================================================
+// Riwayat kHistory slot (kSlotMs per slot) berisi kelembapan, suhu dan
+// on-time pompa. Dari slot tanpa pompa di-fit model peluruhan per ruang:
+//
+//   dH/menit = b0 + b1*(H - 80) + b2*(T - 27)
+//
+// b1 < 0 adalah relaksasi ke kelembapan luar, b2 menangkap ruang yang
+// lebih cepat kering saat panas. Gain pompa (%RH per detik) diukur per
+// kejadian siram: kenaikan setelah kSettleMs dikurangi peluruhan model,
+// dibagi on-time. Slot berpompa tidak ikut fit peluruhan karena di loop
+// tertutup pompa selalu menyala saat kelembapan turun.
+//
+// plan() memproyeksikan kelembapan tanpa pompa sejauh horizon; bila
+// proyeksi jatuh di bawah setpoint - band, satu pulsa dijadwalkan sekarang
+// dengan durasi yang menaikkan kelembapan ke setpoint + band.
+
+#include <Arduino.h>
+
+struct MistTuning {
+    uint8_t enabled;
+    float setpoint;     // %RH
+    float band;         // %RH di sekitar setpoint
+    uint16_t horizon_s;
+};
+
+struct MistStats {
+    uint32_t fits;
+    uint32_t events;    // kejadian siram yang mengukur gain
+    uint32_t plans;     // pulsa yang dijadwalkan plan()
+};
+
+class MistPredictor {
+public:
+    static const uint8_t kHistory = 64;
+    static const uint32_t kSlotMs = 60000;
+    // Slot minimal sebelum fit, dan pasangan slot tanpa pompa minimal per fit.
+    static const uint8_t kMinSlots = 20;
+    static const uint8_t kMinPairs = 8;
+    // Jeda setelah pompa mati sebelum merencanakan lagi (respons sensor).
+    static const uint32_t kSettleMs = 90000;
+
+    // Dipanggil tiap siklus logika; satu slot riwayat ditutup tiap kSlotMs.
+    void observe(uint32_t nowMs, float humidity, float temperature);
+    // Relay menyala / mati; on-time aktual dicatat ke slot berjalan dan ke
+    // kejadian siram yang sedang diukur.
+    void pump_started(uint32_t nowMs);
+    void pump_stopped(uint32_t onMs, uint32_t nowMs);
+    void reset();
+
+    bool ready() const { return fitted_; }
+    // Perkiraan laju tanpa pompa (%RH per menit, negatif = mengering).
+    float trend(float humidity, float temperature) const;
+    // %RH per detik pompa; NAN bila belum pernah teramati.
+    float gain() const { return gain_; }
+    // On-time (ms) yang perlu dimulai sekarang; 0 = belum perlu. fallbackMs
+    // dipakai selama gain belum diketahui.
+    uint32_t plan(uint32_t nowMs, float humidity, float temperature, const MistTuning& tuning,
+                  uint32_t minMs, uint32_t maxMs, uint32_t fallbackMs);
+    const MistStats& stats() const { return stats_; }
+
+private:
+    struct Slot {
+        float humidity;
+        float temperature;
+        uint16_t pumpMs10;   // on-time slot dalam satuan 10 ms
+    };
+
+    void fit();
+    void measure_gain(uint32_t nowMs);
+
+    Slot history_[kHistory];
+    uint8_t count_ = 0;
+    uint8_t head_ = 0;
+    uint32_t slotStartMs_ = 0;
+    float sumH_ = 0;
+    float sumT_ = 0;
+    uint16_t samples_ = 0;
+    uint32_t slotPumpMs_ = 0;
+    uint32_t lastPumpMs_ = 0;
+    bool pumped_ = false;
+    bool pumpOn_ = false;
+    float lastHumidity_ = NAN;
+    float lastTemperature_ = NAN;
+    // Kejadian siram yang menunggu kSettleMs untuk diukur.
+    bool eventOpen_ = false;
+    float eventStartHumidity_ = 0;
+    uint32_t eventStartMs_ = 0;
+    uint32_t eventOnMs_ = 0;
+    bool fitted_ = false;
+    float coef_[3] = {0, 0, 0};
+    float gain_ = NAN;
+    MistStats stats_ = {};
+};
@@ -0,0 +1,126 @@
+// lib/NativeSim/src/Arduino.h
+#pragma once
+
+// ==========================================================
+// ==   ARDUINO-ESP32 CORE PENGGANTI UNTUK [env:native]    ==
+// ==========================================================
+// millis()/delay() berjalan di atas jam virtual milik simulator, sehingga
+// setiap delay() atau panggilan jaringan yang "memblokir" terlihat sebagai
+// stall pada loop tanpa benar-benar menunggu.
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdarg.h>
+#include <math.h>
+#include <time.h>
+#include <string.h>
+#include <stdlib.h>
+#include <algorithm>
+
+#include "WString.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+
+// newlib milik ESP32 menyediakan strlcpy; glibc lama belum.
+#if !defined(__GLIBC__) || !(__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 38))
+inline size_t strlcpy(char* dst, const char* src, size_t size) {
+    size_t len = strlen(src);
+    if (size) {
+        size_t n = len < size - 1 ? len : size - 1;
+        memcpy(dst, src, n);
+        dst[n] = 0;
+    }
+    return len;
+}
+#endif
+
+// Arduino-ESP32 juga memakai std::min/std::max untuk C++.
+using std::min;
+using std::max;
+
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+#define HIGH 0x1
+#define LOW  0x0
+
+#define INPUT        0x01
+#define OUTPUT       0x03
+#define INPUT_PULLUP 0x05
+
+#ifndef PI
+#define PI 3.1415926535897932384626433832795
+#endif
+
+// ---------------- WAKTU -----------------------------------
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+void yield();
+
+void configTime(long gmtOffset_sec, int daylightOffset_sec, const char* server1,
+                const char* server2 = nullptr, const char* server3 = nullptr);
+bool getLocalTime(struct tm* info, uint32_t ms = 5000);
+
+// ---------------- GPIO ------------------------------------
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t val);
+int digitalRead(uint8_t pin);
+
+// ---------------- RANDOM ----------------------------------
+long random(long howbig);
+long random(long howsmall, long howbig);
+void randomSeed(unsigned long seed);
+uint32_t esp_random();
+
+// ---------------- SERIAL ----------------------------------
+class HardwareSerial {
+public:
+    void begin(unsigned long baud) { (void)baud; }
+    size_t write(const char* s, size_t n);
+    size_t print(const char* s);
+    size_t print(const String& s) { return print(s.c_str()); }
+    size_t print(char c) { return write(&c, 1); }
+    size_t print(int v) { return printf("%d", v); }
+    size_t print(unsigned int v) { return printf("%u", v); }
+    size_t print(long v) { return printf("%ld", v); }
+    size_t print(unsigned long v) { return printf("%lu", v); }
+    size_t print(double v, int digits = 2) { return printf("%.*f", digits, v); }
+    size_t println() { return print("\n"); }
+    template <typename T> size_t println(const T& v) { size_t n = print(v); return n + println(); }
+    size_t printf(const char* fmt, ...) __attribute__((format(printf, 2, 3)));
+    int available() { return 0; }
+    int read() { return -1; }
+    void flush() {}
+};
+extern HardwareSerial Serial;
+
+// ---------------- ESP -------------------------------------
+class EspClass {
+public:
+    [[noreturn]] void restart();
+    uint32_t getFreeHeap();
+    uint32_t getMinFreeHeap();
+    uint32_t getFreeSketchSpace();
+    uint32_t getCycleCount();
+    uint32_t getCpuFreqMHz() { return 240; }
+};
+extern EspClass ESP;
+
+// ---------------- IP ADDRESS ------------------------------
+class IPAddress {
+public:
+    IPAddress() : a_{0, 0, 0, 0} {}
+    IPAddress(uint8_t a, uint8_t b, uint8_t c, uint8_t d) : a_{a, b, c, d} {}
+    String toString() const {
+        char buf[16];
+        snprintf(buf, sizeof(buf), "%u.%u.%u.%u", a_[0], a_[1], a_[2], a_[3]);
+        return String(buf);
+    }
+    uint8_t operator[](int i) const { return a_[i]; }
+private:
+    uint8_t a_[4];
+};
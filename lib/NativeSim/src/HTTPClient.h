@@ -0,0 +1,54 @@
+// lib/NativeSim/src/HTTPClient.h
+#pragma once
+
+#include <Arduino.h>
+#include <WiFiClient.h>
+
+#define HTTPC_ERROR_CONNECTION_REFUSED (-1)
+#define HTTPC_ERROR_READ_TIMEOUT       (-11)
+
+typedef enum {
+    HTTP_CODE_OK = 200,
+    HTTP_CODE_PARTIAL_CONTENT = 206,
+    HTTP_CODE_BAD_REQUEST = 400,
+    HTTP_CODE_NOT_FOUND = 404,
+    HTTP_CODE_RANGE_NOT_SATISFIABLE = 416,
+    HTTP_CODE_INTERNAL_SERVER_ERROR = 500
+} t_http_codes;
+
+// HTTP(S) tiruan. Setiap request memakan waktu virtual (handshake + RTT)
+// dan tercatat di laporan simulasi; kode balasan diatur lewat knob sim.
+// Dengan begin(client, url), handshake HTTPS dilakukan client tersebut
+// (mis. TlsSessionClient yang bisa resume); tanpa itu selalu handshake penuh.
+// GET dengan header "Range: bytes=N-" dijawab 206 bila knob http_range aktif.
+class HTTPClient {
+public:
+    bool begin(const String& url);
+    bool begin(WiFiClient& client, const String& url) { bool ok = begin(url); client_ = &client; return ok; }
+    void end();
+    void setTimeout(uint16_t ms) { timeoutMs_ = ms; }
+    void setConnectTimeout(int32_t ms) { (void)ms; }
+    void setReuse(bool reuse) { (void)reuse; }
+    void addHeader(const String& name, const String& value);
+    int GET();
+    int POST(uint8_t* payload, size_t size);
+    int POST(const String& payload) { return POST((uint8_t*)payload.c_str(), payload.length()); }
+    int getSize() { return size_; }
+    void collectHeaders(const char* headerKeys[], const size_t headerKeysCount) { (void)headerKeys; (void)headerKeysCount; }
+    String header(const char* name);
+    String getString();
+    WiFiClient& getStream() { return stream_; }
+    WiFiClient* getStreamPtr() { return &stream_; }
+    static String errorToString(int error);
+
+private:
+    int request(const char* method, size_t bodyBytes);
+
+    String url_;
+    WiFiClient* client_ = nullptr;
+    long rangeStart_ = -1;
+    String contentRange_;
+    WiFiClient stream_;
+    int size_ = -1;
+    uint16_t timeoutMs_ = 5000;
+};
@@ -0,0 +1,28 @@
+// lib/NativeSim/src/LiquidCrystal_I2C.h
+#pragma once
+
+#include <Arduino.h>
+
+// LCD 16x2 tiruan; isi layar disimpan agar bisa ditampilkan di laporan.
+// Tiap perintah/karakter memakan waktu bus seperti backpack PCF8574 pada
+// 100 kHz, sehingga sensor I2C bisa menemukan bus sedang dipakai.
+class LiquidCrystal_I2C {
+public:
+    LiquidCrystal_I2C(uint8_t addr, uint8_t cols, uint8_t rows) : addr_(addr), cols_(cols), rows_(rows) { clear(); }
+    void init() {}
+    void begin() {}
+    void backlight() {}
+    void noBacklight() {}
+    void clear();
+    void setCursor(uint8_t col, uint8_t row);
+    size_t print(const char* s);
+    size_t print(const String& s) { return print(s.c_str()); }
+    size_t print(int v) { return print(String(v)); }
+    size_t print(float v, int digits = 2) { return print(String(v, digits)); }
+    const char* line(uint8_t row) const { return text_[row < 2 ? row : 1]; }
+
+private:
+    uint8_t addr_, cols_, rows_;
+    uint8_t col_ = 0, row_ = 0;
+    char text_[2][41];
+};
@@ -0,0 +1,210 @@
+// lib/NativeSim/src/NativeSim.h
+#pragma once
+
+// ==========================================================
+// ==      KONTROL & STATISTIK SIMULATOR [env:native]      ==
+// ==========================================================
+// Semua knob dibaca dari environment variable JAMUR_SIM_* saat start
+// (lihat sim_main.cpp). Statistik dikumpulkan oleh perangkat tiruan dan
+// dicetak sebagai laporan di akhir replay.
+
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+
+namespace sim {
+
+struct Knobs {
+    double hours = 72.0;             // JAMUR_SIM_HOURS     durasi replay (jam virtual)
+    uint32_t step_ms = 50;           // JAMUR_SIM_STEP_MS   waktu virtual per iterasi loop()
+    uint32_t seed = 1;               // JAMUR_SIM_SEED
+    int64_t start_epoch = 1751760000; // JAMUR_SIM_START_EPOCH (6 Juli 2025 00:00 UTC)
+    long tz_offset_sec = 7 * 3600;   // JAMUR_SIM_TZ_SEC    dipakai model ruang sintetis
+    const char* trace_path = nullptr;  // JAMUR_SIM_TRACE  CSV "detik,kelembapan,suhu"
+    const char* events_path = nullptr; // JAMUR_SIM_EVENTS baris "jam topik payload" atau "jam GET|POST uri [form]"
+    const char* wifi_outages = nullptr; // JAMUR_SIM_WIFI_OUTAGES "10-10.5,30-31" (jam)
+    const char* mqtt_outages = nullptr; // JAMUR_SIM_MQTT_OUTAGES
+    bool serial_echo = false;        // JAMUR_SIM_SERIAL=1  cetak log Serial firmware
+    int rssi = -60;                  // JAMUR_SIM_RSSI
+    uint32_t wifi_assoc_ms = 1500;   // JAMUR_SIM_WIFI_ASSOC_MS
+    uint32_t wifi_fast_ms = 250;     // JAMUR_SIM_WIFI_FAST_MS asosiasi terarah (channel + BSSID)
+    const char* wifi_scan = nullptr; // JAMUR_SIM_WIFI_SCAN "ssid:rssi:ch:auth[:mati_dari-sampai_jam],..."; SSID lain tidak ditemukan
+    uint32_t wifi_scan_ms = 2200;    // JAMUR_SIM_WIFI_SCAN_MS durasi scan async
+    const char* wifi_drops = nullptr; // JAMUR_SIM_WIFI_DROPS "jam,..." link putus sesaat, AP tetap hidup
+    const char* wifi_pass = nullptr; // JAMUR_SIM_WIFI_PASS password yang benar (kosong = semua diterima)
+    uint32_t tls_ms = 1500;          // JAMUR_SIM_TLS_MS    biaya handshake TLS sukses
+    uint32_t tls_fail_ms = 5000;     // JAMUR_SIM_TLS_FAIL_MS biaya connect gagal (timeout)
+    uint32_t tls_resume_ms = 300;    // JAMUR_SIM_TLS_RESUME_MS biaya handshake singkat (resume sesi)
+    uint32_t rtt_ms = 40;            // JAMUR_SIM_RTT_MS
+    uint32_t ntp_ms = 60;            // JAMUR_SIM_NTP_MS    waktu jawab server NTP yang terjangkau
+    const char* ntp_outages = nullptr; // JAMUR_SIM_NTP_OUTAGES server NTP internet tidak menjawab (jam)
+    const char* ntp_lan = nullptr;   // JAMUR_SIM_NTP_LAN   nama server NTP LAN yang ada (tidak ikut outage)
+    float clock_ppm = 10.0f;         // JAMUR_SIM_CLOCK_PPM kristal perangkat lebih cepat dari NTP
+    uint32_t http_ms = 800;          // JAMUR_SIM_HTTP_MS   biaya request HTTP di luar transfer
+    int http_code = 200;             // JAMUR_SIM_HTTP_CODE
+    uint32_t http_body = 1048576;    // JAMUR_SIM_HTTP_BODY ukuran body GET (byte)
+    uint32_t bandwidth_kBps = 200;   // JAMUR_SIM_KBPS      kB/detik untuk transfer HTTP
+    bool http_range = true;          // JAMUR_SIM_HTTP_RANGE server melayani header Range (206)
+    uint32_t http_drop_kb = 0;       // JAMUR_SIM_HTTP_DROP_KB koneksi putus tiap N kB per respons (0 = tidak)
+    uint32_t flash_kBps = 150;       // JAMUR_SIM_FLASH_KBPS kB/detik erase+tulis flash OTA
+    const char* http_files = nullptr; // JAMUR_SIM_HTTP_FILES "akhiran-url=path,..." body GET dari file
+    const char* ota_running = nullptr; // JAMUR_SIM_OTA_RUNNING isi partisi app yang berjalan
+    float dht_noise = 0.6f;          // JAMUR_SIM_DHT_NOISE deviasi standar noise %RH
+    float dht_nan_rate = 0.002f;     // JAMUR_SIM_DHT_NAN   peluang frame gagal (separuh timeout, separuh checksum)
+    float dht_spike_rate = 0.0f;     // JAMUR_SIM_DHT_SPIKE peluang frame valid berisi kelembapan acak
+    uint8_t relay_pin = 23;          // JAMUR_SIM_RELAY_PIN pin yang dianggap pompa oleh model ruang
+    const char* bench = nullptr;     // JAMUR_SIM_BENCH     "wire" | "delta" | "portal" | "control": jalankan benchmark, bukan replay
+    uint32_t bench_iterations = 200000; // JAMUR_SIM_BENCH_ITER
+    const char* delta_old = nullptr;   // JAMUR_SIM_DELTA_OLD   image lama untuk bench delta
+    const char* delta_patch = nullptr; // JAMUR_SIM_DELTA_PATCH patch JDP1 dari tools/jamur_delta.py
+    const char* delta_new = nullptr;   // JAMUR_SIM_DELTA_NEW   image baru yang diharapkan
+    const char* portal_out = nullptr;  // JAMUR_SIM_PORTAL_OUT  folder hasil bench portal (*.gz)
+    const char* control = nullptr;     // JAMUR_SIM_CONTROL     "hyst,dwell,fall_rate" strategi tambahan bench kontrol
+    float setpoint = 0.0f;             // JAMUR_SIM_SETPOINT    %RH acuan galat (bench kontrol, laporan replay)
+    const char* zones = nullptr;       // JAMUR_SIM_ZONES       rak tambahan "pin_dht:pin_relay:selisih_RH,..."
+    const char* i2c_sensor = nullptr;  // JAMUR_SIM_I2C         "sht3x" | "sht4x" | "bme280" di bus LCD (default tidak ada)
+};
+
+Knobs& knobs();
+
+// Jam virtual (ms sejak boot simulasi). Dari loop(), advance memajukan jam
+// (loop dianggap memblokir); dari task FreeRTOS, advance berarti task tidur
+// sampai jam virtual mencapai target sementara loop() tetap berjalan.
+uint64_t now_ms();
+uint64_t now_us();
+void advance_us(uint64_t us);
+inline void advance_ms(uint64_t ms) { advance_us(ms * 1000ULL); }
+
+// ---------------- PENJADWAL LOCKSTEP ----------------------
+// Runner memegang giliran eksekusi sejak sched_begin(); task hanya berjalan
+// ketika pemegang giliran menunggu di wait_until().
+void sched_begin();
+bool in_task();
+// Menunggu sampai pred(ctx) benar atau jam virtual mencapai deadline_us.
+// Mengembalikan hasil pred terakhir (pred boleh nullptr = hanya menunggu waktu).
+bool wait_until(bool (*pred)(void*), void* ctx, uint64_t deadline_us);
+// Dipanggil setelah state bersama berubah (queue, semaphore, notifikasi).
+void wake_waiters();
+
+// Kondisi lingkungan.
+bool wifi_up();
+bool broker_up();
+bool ntp_up(const char* server);
+float room_humidity();
+float room_temperature();
+// Frame DHT berikutnya (5 byte termasuk checksum); false = sensor tidak menjawab.
+// Pin rak dari JAMUR_SIM_ZONES membaca ruang raknya, pin lain ruang utama.
+bool dht_frame(uint8_t pin, uint8_t type, uint8_t frame[5]);
+// Transaksi I2C ke sensor JAMUR_SIM_I2C; false = NACK (alamat lain, perintah
+// tidak dikenal, atau hasil konversi belum siap).
+bool i2c_write(uint8_t address, const uint8_t* data, size_t length);
+bool i2c_read(uint8_t address, uint8_t* data, size_t length);
+void room_step(uint64_t dt_us);
+// Satu langkah model ruang dari kelembapan tertentu (tanpa state global).
+double room_model_step(double humidity, uint64_t ms, double dt, bool pump);
+double room_model_temperature(uint64_t ms);
+bool load_trace(const char* path);
+double trace_hours();
+
+// Event MQTT masuk (dibaca dari JAMUR_SIM_EVENTS).
+bool load_events(const char* path);
+// Mengembalikan event berikutnya yang sudah jatuh tempo, atau false.
+bool next_due_event(const char** topic, const char** payload);
+// Request HTTP ke portal AP dari file event yang sama ("GET"/"POST"),
+// dilayani WebServer::handleClient(). request = "uri [body form]".
+bool next_due_http(const char** method, const char** request);
+
+// GPIO.
+int pin_level(uint8_t pin);
+
+struct TopicStats {
+    char topic[64];
+    uint32_t count;
+    uint32_t failed;
+    uint64_t bytes;
+};
+
+// Satu rak JAMUR_SIM_ZONES: relay dan kelembapan berbobot waktu.
+struct RackStats {
+    uint8_t dht_pin;
+    uint8_t relay_pin;
+    uint32_t relay_on_count;
+    double relay_on_s;
+    double h_sum;
+    double below_s;                  // detik di bawah knobs().setpoint
+};
+
+struct Stats {
+    // MQTT
+    TopicStats topics[48];
+    int topic_count = 0;
+    uint32_t mqtt_connect_attempts = 0;
+    uint32_t mqtt_connect_ok = 0;
+    uint64_t mqtt_connect_ms = 0;
+    // TLS
+    uint32_t tls_full = 0;
+    uint32_t tls_resumed = 0;
+    uint64_t tls_full_ms = 0;
+    uint64_t tls_resumed_ms = 0;
+    uint32_t mqtt_publish_dropped = 0;   // publish saat tidak terhubung
+    uint32_t mqtt_publish_oversize = 0;  // publish melebihi buffer PubSubClient
+    uint32_t mqtt_received = 0;
+    // HTTP
+    uint32_t http_requests = 0;
+    uint64_t http_ms = 0;
+    uint64_t http_bytes = 0;
+    // WiFi
+    uint32_t wifi_begin = 0;
+    // Sensor & aktuator
+    uint32_t dht_reads = 0;
+    uint32_t dht_nan = 0;
+    uint32_t dht_spikes = 0;
+    uint32_t i2c_samples = 0;        // hasil konversi yang dibaca firmware
+    uint32_t i2c_nack = 0;
+    uint32_t i2c_crc = 0;
+    uint32_t relay_on_count = 0;
+    uint64_t relay_on_ms = 0;
+    uint64_t relay_max_on_ms = 0;
+    uint64_t relay_on_since_ms = 0;
+    bool relay_on = false;
+    // Kelembapan ruang berbobot waktu; galat terhadap knobs().setpoint.
+    double room_seconds = 0;
+    double room_h_sum = 0;
+    double room_err_sq = 0;
+    double room_deficit_sq = 0;
+    std::vector<RackStats> racks;
+    uint32_t lcd_writes = 0;
+    uint64_t lcd_bus_us = 0;         // waktu LCD memakai bus I2C
+    // Serial
+    uint64_t serial_bytes = 0;
+    // Heap (hanya alokasi di dalam setup()/loop() firmware)
+    uint64_t heap_allocs = 0;
+    uint64_t heap_frees = 0;
+    uint64_t heap_bytes = 0;
+    int64_t heap_live = 0;
+    int64_t heap_peak = 0;
+    // OTA
+    uint64_t ota_bytes = 0;
+    uint64_t ota_flash_ms = 0;
+    uint32_t http_range_requests = 0;
+};
+
+Stats& stats();
+void record_publish(const char* topic, size_t bytes, bool ok);
+
+// Pelacakan heap diaktifkan runner hanya selama kode firmware berjalan.
+void set_heap_tracking(bool on);
+
+// Benchmark mandiri (JAMUR_SIM_BENCH); mengembalikan exit code.
+int run_wire_bench(uint32_t iterations);
+int run_delta_bench(uint32_t iterations);
+int run_portal_bench(uint32_t iterations);
+int run_control_bench();
+
+// Membaca seluruh file ke out; false bila gagal.
+bool read_file(const char* path, std::vector<uint8_t>& out);
+
+// Dipanggil ESP.restart(): cetak laporan lalu keluar.
+[[noreturn]] void finish(const char* reason);
+
+} // namespace sim
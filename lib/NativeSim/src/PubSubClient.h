@@ -0,0 +1,57 @@
+// lib/NativeSim/src/PubSubClient.h
+#pragma once
+
+#include <Arduino.h>
+#include <WiFiClient.h>
+#include <functional>
+
+#define MQTT_MAX_PACKET_SIZE 256
+
+#define MQTT_CONNECTION_TIMEOUT     -4
+#define MQTT_CONNECTION_LOST        -3
+#define MQTT_CONNECT_FAILED         -2
+#define MQTT_DISCONNECTED           -1
+#define MQTT_CONNECTED               0
+
+#define MQTT_CALLBACK_SIGNATURE std::function<void(char*, uint8_t*, unsigned int)> callback
+
+// Klien MQTT tiruan. Publish dicatat per topik (jumlah & byte) untuk laporan,
+// batas ukuran paket meniru PubSubClient asli (publish gagal bila melebihi
+// buffer), dan pesan masuk berasal dari berkas event simulator.
+class PubSubClient {
+public:
+    explicit PubSubClient(WiFiClient& client) : client_(&client) {}
+
+    PubSubClient& setServer(const char* domain, uint16_t port) { domain_ = domain; port_ = port; return *this; }
+    PubSubClient& setCallback(MQTT_CALLBACK_SIGNATURE) { callback_ = callback; return *this; }
+    PubSubClient& setKeepAlive(uint16_t keepAlive) { keepAlive_ = keepAlive; return *this; }
+    PubSubClient& setSocketTimeout(uint16_t timeout) { (void)timeout; return *this; }
+    bool setBufferSize(uint16_t size) { bufferSize_ = size; return true; }
+    uint16_t getBufferSize() { return bufferSize_; }
+
+    bool connect(const char* id);
+    bool connect(const char* id, const char* user, const char* pass);
+    bool connect(const char* id, const char* user, const char* pass,
+                 const char* willTopic, uint8_t willQos, bool willRetain, const char* willMessage);
+    void disconnect();
+
+    bool publish(const char* topic, const char* payload);
+    bool publish(const char* topic, const char* payload, bool retained);
+    bool publish(const char* topic, const uint8_t* payload, unsigned int plength);
+    bool publish(const char* topic, const uint8_t* payload, unsigned int plength, bool retained);
+
+    bool subscribe(const char* topic, uint8_t qos = 0);
+    bool unsubscribe(const char* topic);
+    bool loop();
+    bool connected();
+    int state() { return state_; }
+
+private:
+    WiFiClient* client_;
+    const char* domain_ = nullptr;
+    uint16_t port_ = 0;
+    std::function<void(char*, uint8_t*, unsigned int)> callback_;
+    uint16_t keepAlive_ = 15;
+    uint16_t bufferSize_ = MQTT_MAX_PACKET_SIZE;
+    int state_ = MQTT_DISCONNECTED;
+};
@@ -0,0 +1,25 @@
+// lib/NativeSim/src/Update.h
+#pragma once
+
+#include <Arduino.h>
+
+#define UPDATE_SIZE_UNKNOWN 0xFFFFFFFF
+
+// Penulis partisi OTA tiruan: hanya menghitung byte, tidak menyimpan image.
+class UpdateClass {
+public:
+    bool begin(size_t size = UPDATE_SIZE_UNKNOWN, int command = 0);
+    size_t write(uint8_t* data, size_t len);
+    bool end(bool evenIfRemaining = false);
+    void abort();
+    bool isFinished() { return size_ != UPDATE_SIZE_UNKNOWN && progress_ == size_; }
+    bool hasError() { return false; }
+    size_t progress() { return progress_; }
+    size_t remaining() { return size_ - progress_; }
+
+private:
+    size_t size_ = 0;
+    size_t progress_ = 0;
+    bool active_ = false;
+};
+extern UpdateClass Update;
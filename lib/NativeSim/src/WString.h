@@ -0,0 +1,112 @@
+// lib/NativeSim/src/WString.h
+#pragma once
+
+// ==========================================================
+// ==   ARDUINO STRING UNTUK BUILD NATIVE (std::string)    ==
+// ==========================================================
+// Cukup untuk API yang dipakai firmware dan ArduinoJson. Alokasi tetap lewat
+// operator new global sehingga ikut terhitung di laporan heap churn.
+
+#include <string>
+#include <cstring>
+#include <cstdlib>
+#include <cstdio>
+
+class String {
+public:
+    String() {}
+    String(const char* s) { if (s) str_ = s; }
+    String(const std::string& s) : str_(s) {}
+    String(char c) : str_(1, c) {}
+    String(int v) : str_(std::to_string(v)) {}
+    String(unsigned int v) : str_(std::to_string(v)) {}
+    String(long v) : str_(std::to_string(v)) {}
+    String(unsigned long v) : str_(std::to_string(v)) {}
+    String(long long v) : str_(std::to_string(v)) {}
+    String(unsigned long long v) : str_(std::to_string(v)) {}
+    String(double v, unsigned int decimals = 2) {
+        char buf[48];
+        snprintf(buf, sizeof(buf), "%.*f", (int)decimals, v);
+        str_ = buf;
+    }
+    String(float v, unsigned int decimals = 2) : String((double)v, decimals) {}
+
+    String& operator=(const char* s) { if (s) str_ = s; else str_.clear(); return *this; }
+
+    unsigned int length() const { return (unsigned int)str_.size(); }
+    bool isEmpty() const { return str_.empty(); }
+    const char* c_str() const { return str_.c_str(); }
+    void reserve(unsigned int n) { str_.reserve(n); }
+
+    bool concat(const char* s) { if (s) str_ += s; return true; }
+    bool concat(const char* s, unsigned int n) { if (s) str_.append(s, n); return true; }
+    bool concat(const String& s) { str_ += s.str_; return true; }
+    bool concat(char c) { str_ += c; return true; }
+
+    String& operator+=(const String& s) { str_ += s.str_; return *this; }
+    String& operator+=(const char* s) { if (s) str_ += s; return *this; }
+    String& operator+=(char c) { str_ += c; return *this; }
+    String& operator+=(int v) { str_ += std::to_string(v); return *this; }
+    String& operator+=(long v) { str_ += std::to_string(v); return *this; }
+    String& operator+=(unsigned long v) { str_ += std::to_string(v); return *this; }
+
+    friend String operator+(const String& a, const String& b) { String r(a); r += b; return r; }
+    friend String operator+(const String& a, const char* b) { String r(a); r += b; return r; }
+    friend String operator+(const char* a, const String& b) { String r(a); r += b; return r; }
+    friend String operator+(const String& a, char b) { String r(a); r += b; return r; }
+    friend String operator+(const String& a, int b) { String r(a); r += b; return r; }
+    friend String operator+(const String& a, long b) { String r(a); r += b; return r; }
+    friend String operator+(const String& a, unsigned long b) { String r(a); r += b; return r; }
+
+    bool equals(const String& s) const { return str_ == s.str_; }
+    bool operator==(const String& s) const { return str_ == s.str_; }
+    bool operator==(const char* s) const { return s ? str_ == s : str_.empty(); }
+    bool operator!=(const String& s) const { return !(*this == s); }
+    bool operator!=(const char* s) const { return !(*this == s); }
+    bool operator<(const String& s) const { return str_ < s.str_; }
+
+    char charAt(unsigned int i) const { return i < str_.size() ? str_[i] : 0; }
+    char operator[](unsigned int i) const { return charAt(i); }
+    char& operator[](unsigned int i) { return str_[i]; }
+
+    int indexOf(char c, unsigned int from = 0) const {
+        size_t p = str_.find(c, from);
+        return p == std::string::npos ? -1 : (int)p;
+    }
+    int indexOf(const String& s, unsigned int from = 0) const {
+        size_t p = str_.find(s.str_, from);
+        return p == std::string::npos ? -1 : (int)p;
+    }
+    bool startsWith(const String& s) const { return str_.compare(0, s.str_.size(), s.str_) == 0; }
+    bool endsWith(const String& s) const {
+        return str_.size() >= s.str_.size() && str_.compare(str_.size() - s.str_.size(), s.str_.size(), s.str_) == 0;
+    }
+
+    String substring(unsigned int from) const { return from >= str_.size() ? String() : String(str_.substr(from)); }
+    String substring(unsigned int from, unsigned int to) const {
+        if (from > to) { unsigned int t = from; from = to; to = t; }
+        if (from >= str_.size()) return String();
+        return String(str_.substr(from, to - from));
+    }
+
+    void replace(const String& find, const String& repl) {
+        if (find.str_.empty()) return;
+        size_t pos = 0;
+        while ((pos = str_.find(find.str_, pos)) != std::string::npos) {
+            str_.replace(pos, find.str_.size(), repl.str_);
+            pos += repl.str_.size();
+        }
+    }
+    void trim() {
+        size_t b = str_.find_first_not_of(" \t\r\n");
+        size_t e = str_.find_last_not_of(" \t\r\n");
+        str_ = (b == std::string::npos) ? std::string() : str_.substr(b, e - b + 1);
+    }
+    void toUpperCase() { for (auto& c : str_) c = (char)toupper((unsigned char)c); }
+    void toLowerCase() { for (auto& c : str_) c = (char)tolower((unsigned char)c); }
+    long toInt() const { return strtol(str_.c_str(), nullptr, 10); }
+    float toFloat() const { return strtof(str_.c_str(), nullptr); }
+
+private:
+    std::string str_;
+};
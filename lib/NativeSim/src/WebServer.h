@@ -0,0 +1,56 @@
+// lib/NativeSim/src/WebServer.h
+#pragma once
+
+#include <Arduino.h>
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+typedef enum { HTTP_ANY, HTTP_GET, HTTP_HEAD, HTTP_POST, HTTP_PUT, HTTP_PATCH, HTTP_DELETE, HTTP_OPTIONS } HTTPMethod;
+
+#define CONTENT_LENGTH_UNKNOWN ((size_t)-1)
+
+// Web server portal tiruan: handleClient() melayani request "GET"/"POST"
+// yang jatuh tempo di file event simulator. Respons dicetak bersama log
+// Serial (JAMUR_SIM_SERIAL=1); body gzip hanya dihitung panjangnya.
+class WebServer {
+public:
+    typedef std::function<void(void)> THandlerFunction;
+
+    explicit WebServer(int port = 80) : port_(port) {}
+    void begin() { running_ = true; }
+    void stop() { running_ = false; }
+    void handleClient();
+    void on(const String& uri, HTTPMethod method, THandlerFunction fn) { routes_.push_back({uri.c_str(), method, fn}); }
+    void on(const String& uri, THandlerFunction fn) { on(uri, HTTP_ANY, fn); }
+    void onNotFound(THandlerFunction fn) { notFound_ = fn; }
+    String arg(const String& name);
+    bool hasArg(const String& name) { return args_.count(name.c_str()) > 0; }
+    void send(int code, const char* contentType = nullptr, const String& content = String());
+    void send_P(int code, const char* contentType, const char* content, size_t len);
+    void sendHeader(const String& name, const String& value, bool first = false);
+    void setContentLength(size_t len) { (void)len; }
+    void sendContent(const char* content, size_t len);
+    void sendContent(const String& content) { sendContent(content.c_str(), content.length()); }
+
+private:
+    struct Route {
+        std::string uri;
+        HTTPMethod method;
+        THandlerFunction fn;
+    };
+
+    void parse_args(const std::string& form);
+    void finish_response();
+
+    int port_;
+    bool running_ = false;
+    std::vector<Route> routes_;
+    THandlerFunction notFound_;
+    std::map<std::string, std::string> args_;
+    std::string request_;
+    bool gzip_ = false;
+    bool responded_ = false;
+    size_t bodyBytes_ = 0;
+};
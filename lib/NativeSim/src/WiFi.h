@@ -0,0 +1,69 @@
+// lib/NativeSim/src/WiFi.h
+#pragma once
+
+#include <Arduino.h>
+#include <WiFiClient.h>
+
+typedef enum {
+    WL_NO_SHIELD = 255,
+    WL_IDLE_STATUS = 0,
+    WL_NO_SSID_AVAIL = 1,
+    WL_SCAN_COMPLETED = 2,
+    WL_CONNECTED = 3,
+    WL_CONNECT_FAILED = 4,
+    WL_CONNECTION_LOST = 5,
+    WL_DISCONNECTED = 6
+} wl_status_t;
+
+typedef enum { WIFI_OFF = 0, WIFI_STA = 1, WIFI_AP = 2, WIFI_AP_STA = 3 } wifi_mode_t;
+
+typedef enum {
+    WIFI_AUTH_OPEN = 0,
+    WIFI_AUTH_WEP,
+    WIFI_AUTH_WPA_PSK,
+    WIFI_AUTH_WPA2_PSK,
+    WIFI_AUTH_WPA_WPA2_PSK,
+    WIFI_AUTH_WPA2_ENTERPRISE,
+    WIFI_AUTH_WPA3_PSK,
+    WIFI_AUTH_WPA2_WPA3_PSK
+} wifi_auth_mode_t;
+
+#define WIFI_SCAN_RUNNING (-1)
+#define WIFI_SCAN_FAILED  (-2)
+
+// Station + soft-AP tiruan. Status mengikuti jadwal gangguan WiFi di
+// simulator; begin() baru terhubung setelah waktu asosiasi virtual. Daftar
+// hasil scan dan password yang benar diatur lewat knob JAMUR_SIM_WIFI_*.
+class WiFiClass {
+public:
+    wl_status_t begin(const char* ssid, const char* passphrase = nullptr,
+                      int32_t channel = 0, const uint8_t* bssid = nullptr, bool connect = true);
+    bool disconnect(bool wifioff = false, bool eraseap = false);
+    bool mode(wifi_mode_t m) { mode_ = m; return true; }
+    wifi_mode_t getMode() { return mode_; }
+    wl_status_t status();
+    int8_t RSSI();
+    String SSID();
+    uint8_t* BSSID();
+    int32_t channel();
+    String macAddress();
+    IPAddress localIP();
+    bool softAP(const char* ssid, const char* passphrase = nullptr);
+    bool softAPdisconnect(bool wifioff = false);
+    IPAddress softAPIP() { return IPAddress(192, 168, 4, 1); }
+    bool setAutoReconnect(bool on);
+    int hostByName(const char* host, IPAddress& result);
+
+    int16_t scanNetworks(bool async = false, bool show_hidden = false);
+    int16_t scanComplete();
+    void scanDelete();
+    String SSID(uint8_t i);
+    int32_t RSSI(uint8_t i);
+    int32_t channel(uint8_t i);
+    uint8_t* BSSID(uint8_t i);
+    wifi_auth_mode_t encryptionType(uint8_t i);
+
+private:
+    wifi_mode_t mode_ = WIFI_OFF;
+};
+extern WiFiClass WiFi;
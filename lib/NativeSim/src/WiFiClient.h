@@ -0,0 +1,43 @@
+// lib/NativeSim/src/WiFiClient.h
+#pragma once
+
+#include <Arduino.h>
+
+// Socket TCP tiruan. connect() memakan RTT virtual; read() menghasilkan
+// body HTTP yang sedang "diunduh" (isi file dari knob http_files, atau byte
+// nol) dengan biaya bandwidth.
+class WiFiClient {
+public:
+    virtual ~WiFiClient() {}
+    virtual int connect(const char* host, uint16_t port);
+    virtual int connect(IPAddress ip, uint16_t port) { return connect(ip.toString().c_str(), port); }
+    virtual void stop();
+    virtual uint8_t connected() { return connected_; }
+    virtual int available();
+    virtual int read();
+    virtual int read(uint8_t* buf, size_t size);
+    size_t readBytes(uint8_t* buf, size_t size);
+    size_t readBytes(char* buf, size_t size) { return readBytes((uint8_t*)buf, size); }
+    virtual size_t write(const uint8_t* buf, size_t size);
+    void setTimeout(unsigned long ms) { timeoutMs_ = ms; }
+    operator bool() { return connected_; }
+
+    // Dipakai HTTPClient tiruan untuk menyiapkan body respons; dropAfter > 0
+    // memutus koneksi setelah sekian byte (link tidak stabil). data boleh
+    // nullptr (body berisi nol).
+    void sim_set_body(size_t bytes, size_t dropAfter = 0, const uint8_t* data = nullptr) {
+        bodyRemaining_ = bytes;
+        bodyData_ = data;
+        dropLeft_ = dropAfter;
+        dropArmed_ = dropAfter > 0;
+        connected_ = bytes > 0;
+    }
+
+protected:
+    bool connected_ = false;
+    size_t bodyRemaining_ = 0;
+    const uint8_t* bodyData_ = nullptr;
+    size_t dropLeft_ = 0;
+    bool dropArmed_ = false;
+    unsigned long timeoutMs_ = 1000;
+};
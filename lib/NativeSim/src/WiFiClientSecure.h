@@ -0,0 +1,20 @@
+// lib/NativeSim/src/WiFiClientSecure.h
+#pragma once
+
+#include <WiFiClient.h>
+
+class WiFiClientSecure : public WiFiClient {
+public:
+    int connect(const char* host, uint16_t port) override;
+    void setCACert(const char* rootCA) { rootCA_ = rootCA; }
+    void setInsecure() { rootCA_ = nullptr; }
+    void setHandshakeTimeout(unsigned long seconds) { (void)seconds; }
+    int lastError(char* buf, const size_t size);
+
+protected:
+    // Dipakai TlsSessionClient: resume=true memakai biaya handshake singkat.
+    int sim_handshake(const char* host, uint16_t port, bool resume);
+
+private:
+    const char* rootCA_ = nullptr;
+};
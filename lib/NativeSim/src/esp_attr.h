@@ -0,0 +1,7 @@
+// lib/NativeSim/src/esp_attr.h
+#pragma once
+
+// Atribut section ESP-IDF. Simulator tidak punya soft reset, jadi variabel
+// RTC_NOINIT_ATTR cukup memori biasa (nol saat start, sama dengan power-on tanpa penanda).
+
+#define RTC_NOINIT_ATTR
@@ -0,0 +1,22 @@
+// lib/NativeSim/src/esp_ota_ops.h
+#pragma once
+
+// Partisi app tiruan. Isi partisi yang sedang berjalan dibaca dari file
+// JAMUR_SIM_OTA_RUNNING (mis. firmware.bin versi lama untuk uji patch
+// delta); tanpa knob itu isinya byte nol sebesar partisi.
+
+#include <stdint.h>
+#include <stddef.h>
+
+typedef int esp_err_t;
+#define ESP_OK 0
+#define ESP_FAIL -1
+
+typedef struct {
+    uint32_t address;
+    uint32_t size;
+    char label[17];
+} esp_partition_t;
+
+const esp_partition_t* esp_ota_get_running_partition();
+esp_err_t esp_partition_read(const esp_partition_t* partition, size_t src_offset, void* dst, size_t size);
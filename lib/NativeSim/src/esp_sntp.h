@@ -0,0 +1,25 @@
+// lib/NativeSim/src/esp_sntp.h
+#pragma once
+
+// SNTP tiruan (subset esp_sntp.h ESP-IDF). Setelah configTime() server
+// dicoba berurutan di atas jam virtual: yang terjangkau menjawab setelah
+// JAMUR_SIM_NTP_MS, yang tidak memakan timeout 15 detik lalu server
+// berikutnya dicoba. Hasilnya menyetel jam sistem lalu memanggil callback.
+// Kristal perangkat berjalan JAMUR_SIM_CLOCK_PPM lebih cepat dari waktu NTP.
+
+#include <stdint.h>
+#include <sys/time.h>
+
+typedef void (*sntp_sync_time_cb_t)(struct timeval* tv);
+
+typedef enum {
+    SNTP_SYNC_STATUS_RESET,
+    SNTP_SYNC_STATUS_COMPLETED,
+    SNTP_SYNC_STATUS_IN_PROGRESS,
+} sntp_sync_status_t;
+
+void sntp_set_time_sync_notification_cb(sntp_sync_time_cb_t callback);
+void sntp_set_sync_interval(uint32_t interval_ms);
+uint32_t sntp_get_sync_interval();
+sntp_sync_status_t sntp_get_sync_status();
+void sntp_stop();
@@ -0,0 +1,52 @@
+// lib/NativeSim/src/freertos/FreeRTOS.h
+#pragma once
+
+// ==========================================================
+// ==        FREERTOS PENGGANTI UNTUK [env:native]          ==
+// ==========================================================
+// Task berjalan sebagai thread host, tetapi dijadwalkan lockstep di atas jam
+// virtual: hanya satu thread (loop() atau satu task) yang jalan pada satu
+// waktu, dan task hanya berjalan ketika loop() sedang menunggu/menunda.
+// Tick 1 ms, sama dengan konfigurasi Arduino-ESP32.
+
+#include <stdint.h>
+#include <stddef.h>
+
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+typedef uint32_t TickType_t;
+
+#define pdFALSE  ((BaseType_t)0)
+#define pdTRUE   ((BaseType_t)1)
+#define pdPASS   pdTRUE
+#define pdFAIL   pdFALSE
+#define errQUEUE_FULL  ((BaseType_t)0)
+#define errQUEUE_EMPTY ((BaseType_t)0)
+
+#define portMAX_DELAY ((TickType_t)0xffffffffUL)
+#define portTICK_PERIOD_MS ((TickType_t)1)
+#define pdMS_TO_TICKS(ms) ((TickType_t)(ms))
+#define configTICK_RATE_HZ 1000
+#define configMAX_PRIORITIES 25
+#define tskIDLE_PRIORITY ((UBaseType_t)0)
+#define tskNO_AFFINITY 0x7FFFFFFF
+
+typedef struct {
+    int unused;
+} portMUX_TYPE;
+#define portMUX_INITIALIZER_UNLOCKED {0}
+// Penjadwalan lockstep sudah menjamin tidak ada dua thread berjalan bersamaan.
+#define portENTER_CRITICAL(mux) ((void)(mux))
+#define portEXIT_CRITICAL(mux) ((void)(mux))
+#define portENTER_CRITICAL_ISR(mux) ((void)(mux))
+#define portEXIT_CRITICAL_ISR(mux) ((void)(mux))
+#define portYIELD_FROM_ISR(x) ((void)(x))
+
+struct SimTask;
+struct SimQueue;
+typedef struct SimTask* TaskHandle_t;
+typedef struct SimQueue* QueueHandle_t;
+typedef void (*TaskFunction_t)(void*);
+
+#include "task.h"
+#include "queue.h"
@@ -0,0 +1,16 @@
+// lib/NativeSim/src/freertos/semphr.h
+#pragma once
+
+#include "queue.h"
+
+// Seperti FreeRTOS asli, semaphore adalah queue dengan item berukuran nol.
+typedef QueueHandle_t SemaphoreHandle_t;
+
+SemaphoreHandle_t xSemaphoreCreateMutex();
+SemaphoreHandle_t xSemaphoreCreateBinary();
+SemaphoreHandle_t xSemaphoreCreateCounting(UBaseType_t maxCount, UBaseType_t initialCount);
+BaseType_t xSemaphoreTake(SemaphoreHandle_t sem, TickType_t ticks);
+BaseType_t xSemaphoreGive(SemaphoreHandle_t sem);
+#define xSemaphoreGiveFromISR(sem, woken) xSemaphoreGive(sem)
+#define vSemaphoreDelete(sem) vQueueDelete(sem)
+#define uxSemaphoreGetCount(sem) uxQueueMessagesWaiting(sem)
@@ -0,0 +1,150 @@
+// lib/NativeSim/src/sim_bench_control.cpp
+// Benchmark strategi kontrol kelembapan (JAMUR_SIM_BENCH=control): model
+// ruang loop tertutup (sintetis, atau JAMUR_SIM_TRACE sebagai kelembapan
+// tanpa pompa) dibaca lewat DHT11 tiruan dan SensorFilter, lalu tiap
+// strategi HumidityControl (dan MistPredictor untuk mode prediktif)
+// dijalankan dengan noise yang sama. Parameter di bawah mengikuti default
+// config.h (ambang 80/85, siram 30 s, MIST_*); baris "default" = CONTROL_*.
+
+#include <Arduino.h>
+#include <HumidityControl.h>
+#include <MistPredictor.h>
+#include <SensorFilter.h>
+#include <cstdio>
+#include <random>
+
+#include "NativeSim.h"
+
+namespace sim {
+
+namespace {
+
+const float kCritical = 80.0f;
+const float kWarning = 85.0f;
+const uint32_t kSampleMs = 2000;
+const uint32_t kLogicMs = 5000;
+const uint32_t kPumpMs = 30000;
+const float kSetpoint = 83.0f;
+const float kMistBand = 3.0f;
+const uint16_t kMistHorizonS = 60;
+const uint32_t kMistMinMs = 3000;
+
+struct Result {
+    uint32_t relayOn;
+    uint32_t early;
+    uint32_t predicted;
+    uint32_t onSec;
+    uint32_t notifications;
+    uint32_t belowSec;
+    double sumHumidity;
+    double sumSquaredError;
+    double sumSquaredDeficit;
+    uint32_t seconds;
+};
+
+Result run_strategy(const ControlTuning& tuning, const MistTuning& mist, float setpoint) {
+    std::mt19937 rng(knobs().seed * 7919u + 17u);
+    std::normal_distribution<float> noise(0.0f, knobs().dht_noise);
+    SensorFilter humidityFilter(0.0f, 100.0f, 8.0f, 0.5f);
+    HumidityControl control;
+    MistPredictor predictor;
+    Result r = {};
+
+    uint64_t endMs = (uint64_t)(knobs().hours * 3600000.0);
+    double room = room_model_step(82.0, 0, 0.0, false);
+    uint64_t pumpUntil = 0;
+    uint32_t pumpStartMs = 0;
+    bool pump = false;
+    for (uint64_t ms = 0; ms < endMs; ms += 1000) {
+        room = room_model_step(room, ms, 1.0, pump);
+        if (pump) {
+            r.onSec++;
+            if (ms + 1000 >= pumpUntil) {
+                pump = false;
+                predictor.pump_stopped((uint32_t)(ms + 1000 - pumpStartMs), (uint32_t)ms);
+            }
+        }
+        if (room < kCritical) r.belowSec++;
+        r.sumHumidity += room;
+        r.sumSquaredError += (room - setpoint) * (room - setpoint);
+        if (room < setpoint) r.sumSquaredDeficit += (setpoint - room) * (setpoint - room);
+        r.seconds++;
+
+        // DHT11: resolusi 1 %RH.
+        if (ms % kSampleMs == 0) humidityFilter.push(roundf((float)room + noise(rng)));
+        if (ms % kLogicMs != 0 || !humidityFilter.ready()) continue;
+        float humidity = humidityFilter.value();
+        float temperature = (float)room_model_temperature(ms);
+        control.update(humidity, (uint32_t)ms, kCritical, kWarning, tuning);
+        predictor.observe((uint32_t)ms, humidity, temperature);
+        if (control.changed()) r.notifications++;
+        if (pump) continue;
+
+        uint32_t durationMs = 0;
+        if (control.demand()) {
+            durationMs = kPumpMs;
+        } else if (mist.enabled) {
+            durationMs = predictor.plan((uint32_t)ms, humidity, temperature, mist, kMistMinMs, kPumpMs * 4, kPumpMs);
+            if (durationMs) r.predicted++;
+        } else if (control.early()) {
+            durationMs = kPumpMs;
+            r.early++;
+        }
+        if (durationMs) {
+            pump = true;
+            pumpStartMs = (uint32_t)ms;
+            pumpUntil = ms + durationMs;
+            predictor.pump_started((uint32_t)ms);
+            r.relayOn++;
+        }
+    }
+    return r;
+}
+
+void print_result(const char* name, const Result& r) {
+    double mean = r.seconds ? r.sumHumidity / r.seconds : 0.0;
+    double rms = r.seconds ? sqrt(r.sumSquaredError / r.seconds) : 0.0;
+    double deficit = r.seconds ? sqrt(r.sumSquaredDeficit / r.seconds) : 0.0;
+    printf("  %-18s %6u %5u %6u %7.1f %6u %8.1f %7.1f %7.2f %7.2f\n", name, r.relayOn, r.early, r.predicted,
+           r.onSec / 60.0, r.notifications, r.belowSec / 60.0, mean, rms, deficit);
+}
+
+} // namespace
+
+int run_control_bench() {
+    static const struct {
+        const char* name;
+        ControlTuning tuning;
+        bool predict;
+    } strategies[] = {
+        { "ambang (lama)", { 0.0f, 0, 0.0f }, false },
+        { "hysteresis", { 2.0f, 0, 0.0f }, false },
+        { "hyst+dwell", { 2.0f, 60, 0.0f }, false },
+        { "default", { 2.0f, 60, 0.5f }, false },
+        { "prediktif", { 2.0f, 60, 0.5f }, true },
+    };
+    float setpoint = knobs().setpoint > 0 ? knobs().setpoint : kSetpoint;
+    MistTuning mist = { 1, setpoint, kMistBand, kMistHorizonS };
+    MistTuning off = {};
+
+    printf("\n=== BENCHMARK KONTROL KELEMBAPAN (%.1f jam, %s, noise %.1f %%RH, setpoint %.1f) ===\n",
+           knobs().hours, knobs().trace_path ? knobs().trace_path : "model sintetis", knobs().dht_noise, setpoint);
+    printf("  strategi           relay  laju  predik  on_mnt  notif  <kritis  rata_RH  rms_sp  kurang\n");
+    for (const auto& s : strategies) {
+        print_result(s.name, run_strategy(s.tuning, s.predict ? mist : off, setpoint));
+    }
+
+    if (knobs().control) {
+        ControlTuning custom = {};
+        unsigned dwell = 0;
+        if (sscanf(knobs().control, "%f,%u,%f", &custom.hysteresis, &dwell, &custom.fall_rate) != 3) {
+            fprintf(stderr, "JAMUR_SIM_CONTROL harus \"hyst,dwell,fall_rate\": %s\n", knobs().control);
+            return 1;
+        }
+        custom.dwell_s = (uint16_t)dwell;
+        print_result(knobs().control, run_strategy(custom, off, setpoint));
+    }
+    return 0;
+}
+
+} // namespace sim
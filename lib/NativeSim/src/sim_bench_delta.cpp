@@ -0,0 +1,105 @@
+// lib/NativeSim/src/sim_bench_delta.cpp
+// Uji bolak-balik patch firmware (JAMUR_SIM_BENCH=delta): patch JDP1 dari
+// tools/jamur_delta.py diterapkan lewat DeltaPatcher dengan potongan acak
+// (meniru pembacaan HTTP), hasilnya dibandingkan byte-per-byte dengan image
+// baru. Exit code bukan nol bila ada perbedaan.
+//
+//   python3 tools/jamur_delta.py diff lama.bin baru.bin patch.jdp
+//   JAMUR_SIM_BENCH=delta JAMUR_SIM_DELTA_OLD=lama.bin JAMUR_SIM_DELTA_PATCH=patch.jdp
+//   JAMUR_SIM_DELTA_NEW=baru.bin .pio/build/native/program
+
+#include <Arduino.h>
+#include <DeltaPatch.h>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "NativeSim.h"
+
+namespace sim {
+
+namespace {
+
+class VectorSink : public DeltaSink {
+public:
+    explicit VectorSink(const std::vector<uint8_t>& old) : old_(old) {}
+
+    bool begin(const DeltaHeader& header) override {
+        if (header.old_size != old_.size()) return false;
+        out.clear();
+        out.reserve(header.new_size);
+        return true;
+    }
+    bool read_old(uint32_t offset, uint8_t* buf, size_t len) override {
+        if ((size_t)offset + len > old_.size()) return false;
+        memcpy(buf, old_.data() + offset, len);
+        return true;
+    }
+    bool write(const uint8_t* data, size_t len) override {
+        out.insert(out.end(), data, data + len);
+        return true;
+    }
+
+    std::vector<uint8_t> out;
+
+private:
+    const std::vector<uint8_t>& old_;
+};
+
+} // namespace
+
+int run_delta_bench(uint32_t iterations) {
+    const Knobs& k = knobs();
+    std::vector<uint8_t> oldImage, patch, newImage;
+    if (!k.delta_old || !k.delta_patch || !k.delta_new) {
+        fprintf(stderr, "Bench delta butuh JAMUR_SIM_DELTA_OLD, JAMUR_SIM_DELTA_PATCH dan JAMUR_SIM_DELTA_NEW.\n");
+        return 1;
+    }
+    if (!read_file(k.delta_old, oldImage) || !read_file(k.delta_patch, patch) || !read_file(k.delta_new, newImage)) {
+        fprintf(stderr, "Gagal membaca file bench delta.\n");
+        return 1;
+    }
+
+    // Iterasi pertama satu potongan utuh, sisanya potongan acak 1..4096 byte.
+    uint32_t rounds = iterations < 1 ? 1 : (iterations > 50 ? 50 : iterations);
+    std::mt19937 rng(12345);
+    VectorSink sink(oldImage);
+    DeltaPatcher patcher(sink);
+    double totalMs = 0;
+
+    printf("\n=== BENCHMARK PATCH DELTA (%u putaran) ===\n", rounds);
+    printf("  image lama  %8zu B\n", oldImage.size());
+    printf("  image baru  %8zu B\n", newImage.size());
+    printf("  patch       %8zu B (%.1f%% dari image baru)\n", patch.size(),
+           100.0 * patch.size() / (newImage.empty() ? 1 : newImage.size()));
+
+    for (uint32_t r = 0; r < rounds; r++) {
+        patcher.reset();
+        auto t0 = std::chrono::steady_clock::now();
+        size_t pos = 0;
+        while (pos < patch.size()) {
+            size_t n = r == 0 ? patch.size() : 1 + rng() % 4096;
+            if (n > patch.size() - pos) n = patch.size() - pos;
+            if (!patcher.feed(patch.data() + pos, n)) break;
+            pos += n;
+        }
+        totalMs += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+
+        if (patcher.failed() || !patcher.finished()) {
+            printf("  GAGAL putaran %u: %s\n", r, patcher.failed() ? patcher.error() : "patch terpotong");
+            return 1;
+        }
+        if (sink.out != newImage) {
+            size_t at = 0;
+            while (at < sink.out.size() && at < newImage.size() && sink.out[at] == newImage[at]) at++;
+            printf("  GAGAL putaran %u: hasil berbeda mulai byte %zu\n", r, at);
+            return 1;
+        }
+    }
+
+    printf("  hasil identik di semua putaran, %.2f ms/apply (host)\n", totalMs / rounds);
+    return 0;
+}
+
+} // namespace sim
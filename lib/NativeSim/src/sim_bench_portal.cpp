@@ -0,0 +1,100 @@
+// lib/NativeSim/src/sim_bench_portal.cpp
+// Benchmark portal AP (JAMUR_SIM_BENCH=portal): merender halaman gzip dari
+// include/portal_assets.h lewat GzipTemplate, mencatat ukuran body, waktu
+// render dan jumlah alokasi heap per request. Dengan JAMUR_SIM_PORTAL_OUT
+// tiap halaman ditulis sebagai <dir>/<nama>.gz untuk dicek dengan gunzip.
+
+#include <Arduino.h>
+#include <GzipTemplate.h>
+#include <chrono>
+#include <cstdio>
+
+#include "NativeSim.h"
+#include "portal_assets.h"
+
+namespace sim {
+
+namespace {
+
+struct RenderBuffer {
+    uint8_t data[16384];
+    size_t used;
+    uint32_t writes;
+};
+
+void collect(void* ctx, const uint8_t* data, size_t len) {
+    RenderBuffer* out = (RenderBuffer*)ctx;
+    if (out->used + len <= sizeof(out->data)) memcpy(out->data + out->used, data, len);
+    out->used += len;
+    out->writes++;
+}
+
+size_t raw_length(const GzipAsset& asset, const char* const values[]) {
+    size_t n = 0;
+    for (uint8_t i = 0; i < asset.segmentCount; i++) {
+        n += asset.segments[i].rawLength;
+        if (i + 1 < asset.segmentCount) {
+            const char* v = values[asset.fields[i]];
+            n += GzipTemplate::escaped_length(v ? v : "");
+        }
+    }
+    return n;
+}
+
+} // namespace
+
+int run_portal_bench(uint32_t iterations) {
+    static const struct {
+        const char* name;
+        const GzipAsset* asset;
+    } pages[] = {
+        { "index", &PORTAL_INDEX },
+        { "error", &PORTAL_ERROR },
+        { "saved", &PORTAL_SAVED },
+        { "style", &PORTAL_STYLE },
+        { "script", &PORTAL_SCRIPT },
+    };
+    const char* values[PORTAL_FIELD_COUNT] = {};
+    values[PORTAL_FIELD_SSID] = "Kumbung <Jamur> & \"Tiram\"";
+    values[PORTAL_FIELD_MESSAGE] = "SSID terlalu panjang (maks 32 karakter).";
+    const char* outDir = knobs().portal_out;
+    static RenderBuffer buf;
+    int rc = 0;
+
+    printf("\n=== BENCHMARK PORTAL GZIP (%u iterasi) ===\n", iterations);
+    for (const auto& page : pages) {
+        size_t expected = GzipTemplate::length(*page.asset, values);
+        Stats& s = stats();
+        uint64_t allocsBefore = s.heap_allocs;
+        set_heap_tracking(true);
+        auto t0 = std::chrono::steady_clock::now();
+        for (uint32_t i = 0; i < iterations; i++) {
+            buf.used = 0;
+            buf.writes = 0;
+            GzipTemplate::write(*page.asset, values, collect, &buf);
+        }
+        auto t1 = std::chrono::steady_clock::now();
+        set_heap_tracking(false);
+        double us = std::chrono::duration<double, std::micro>(t1 - t0).count() / iterations;
+        uint64_t allocs = s.heap_allocs - allocsBefore;
+
+        printf("  %-6s %5zu B teks -> %5zu B gzip, %2u write, %7.2f us/render, %llu alokasi\n", page.name,
+               raw_length(*page.asset, values), buf.used, buf.writes, us, (unsigned long long)allocs);
+        if (buf.used != expected) {
+            printf("  GAGAL %s: Content-Length %zu != body %zu\n", page.name, expected, buf.used);
+            rc = 1;
+        }
+        if (outDir && buf.used <= sizeof(buf.data)) {
+            char path[256];
+            snprintf(path, sizeof(path), "%s/%s.gz", outDir, page.name);
+            FILE* f = fopen(path, "wb");
+            if (f) {
+                fwrite(buf.data, 1, buf.used, f);
+                fclose(f);
+            }
+        }
+    }
+    return rc;
+}
+
+} // namespace sim
@@ -0,0 +1,125 @@
+// lib/NativeSim/src/sim_bench_wire.cpp
+// Benchmark format wire (JAMUR_SIM_BENCH=wire): waktu encode/decode dan
+// byte di jalur untuk payload JSON yang dibangun firmware dibandingkan
+// dengan skema MessagePack di lib/WireCodec.
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <WireCodec.h>
+#include <chrono>
+#include <cstdio>
+
+#include "NativeSim.h"
+
+namespace sim {
+
+// Header tetap PUBLISH QoS 0 (2 byte untuk payload < 128, 3 byte di atasnya)
+// + panjang topik 2 byte. Overhead record TLS (~29 byte AES-GCM) sama untuk
+// kedua format sehingga tidak dihitung.
+static size_t mqtt_frame_bytes(const char* topic, size_t payload) {
+    size_t remaining = 2 + strlen(topic) + payload;
+    return 1 + (remaining < 128 ? 1 : 2) + remaining;
+}
+
+static volatile size_t g_sink;
+
+template <typename Fn>
+static double ns_per_op(uint32_t iterations, Fn fn) {
+    auto t0 = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < iterations; i++) g_sink = g_sink + fn(i);
+    auto t1 = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(t1 - t0).count() / iterations;
+}
+
+static void row(const char* name, const char* topic, size_t bytes, double ns) {
+    printf("  %-24s %6zu B payload %6zu B MQTT %10.1f ns/op\n", name, bytes, mqtt_frame_bytes(topic, bytes), ns);
+}
+
+int run_wire_bench(uint32_t iterations) {
+    char json[256];
+    uint8_t bin[256];
+    printf("\n=== BENCHMARK FORMAT WIRE (%u iterasi) ===\n", iterations);
+
+    // Format JSON di bawah sama persis dengan publish_telemetry(),
+    // publish_speedtest() dan send_notification() di src/main.cpp.
+    printf("\n-- Encode telemetri --\n");
+    size_t jlen = 0, blen = 0;
+    double jns = ns_per_op(iterations, [&](uint32_t i) {
+        float t = 27.0f + (i % 50) * 0.1f, h = 80.0f + (i % 100) * 0.1f;
+        return jlen = snprintf(json, sizeof(json), "{\"temperature\":%.2f, \"humidity\":%.2f}", t, h);
+    });
+    double bns = ns_per_op(iterations, [&](uint32_t i) {
+        float t = 27.0f + (i % 50) * 0.1f, h = 80.0f + (i % 100) * 0.1f;
+        return blen = wire_encode_telemetry(bin, sizeof(bin), 1751760000u + i, t, h);
+    });
+    row("JSON  jamur/telemetry", "jamur/telemetry", jlen, jns);
+    row("MsgPack jamur/bin/...", "jamur/bin/telemetry", blen, bns);
+
+    printf("\n-- Encode speedtest --\n");
+    jns = ns_per_op(iterations, [&](uint32_t i) {
+        float ping = 40.0f + (i % 30);
+        return jlen = snprintf(json, sizeof(json),
+            "{\"ping_ms\":%.2f,\"download_mbps\":%.2f,\"upload_mbps\":%.2f,\"lat\":%.6f,\"lon\":%.6f}",
+            ping, 12.34, 3.21, -7.797068, 110.370529);
+    });
+    bns = ns_per_op(iterations, [&](uint32_t i) {
+        float ping = 40.0f + (i % 30);
+        return blen = wire_encode_speedtest(bin, sizeof(bin), ping, 12.34f, 3.21f, -7.797068f, 110.370529f);
+    });
+    row("JSON  jamur/speedtest", "jamur/speedtest", jlen, jns);
+    row("MsgPack jamur/bin/...", "jamur/bin/speedtest", blen, bns);
+
+    printf("\n-- Encode notifikasi --\n");
+    const char* msg = "Humidity below critical threshold! Pump turned ON.";
+    jns = ns_per_op(iterations, [&](uint32_t i) {
+        float h = 70.0f + (i % 100) * 0.1f;
+        return jlen = snprintf(json, sizeof(json),
+            "{\"type\":\"%s\", \"message\":\"%s\", \"humidity\":%.1f, \"temperature\":%.1f}", "warning", msg, h, 28.5);
+    });
+    bns = ns_per_op(iterations, [&](uint32_t i) {
+        float h = 70.0f + (i % 100) * 0.1f;
+        return blen = wire_encode_notification(bin, sizeof(bin), "warning", msg, h, 28.5f);
+    });
+    row("JSON  jamur/notifications", "jamur/notifications", jlen, jns);
+    row("MsgPack jamur/bin/...", "jamur/bin/notifications", blen, bns);
+
+    // Config: dokumen sama, diserialisasi dua cara, lalu di-decode seperti
+    // handle_config_update().
+    printf("\n-- Decode config_set --\n");
+    JsonDocument src;
+    src["h_crit"] = 80.0;
+    src["h_warn"] = 85.5;
+    JsonArray schedules = src["schedules"].to<JsonArray>();
+    schedules.add(7);
+    schedules.add(12);
+    schedules.add(17);
+    src["telemetry_batch"] = 60;
+    src["wire_format"] = "msgpack";
+    jlen = serializeJson(src, json, sizeof(json));
+    blen = serializeMsgPack(src, bin, sizeof(bin));
+
+    auto apply = [](JsonDocument& doc) {
+        float crit = doc["h_crit"] | 0.0f;
+        int first = doc["schedules"][0] | 0;
+        int batch = doc["telemetry_batch"] | 0;
+        return (size_t)(crit + first + batch);
+    };
+    jns = ns_per_op(iterations, [&](uint32_t) {
+        JsonDocument doc;
+        if (deserializeJson(doc, json, jlen)) return (size_t)0;
+        return apply(doc);
+    });
+    bns = ns_per_op(iterations, [&](uint32_t) {
+        JsonDocument doc;
+        if (deserializeMsgPack(doc, bin, blen)) return (size_t)0;
+        return apply(doc);
+    });
+    row("JSON  jamur/config/set", "jamur/config/set", jlen, jns);
+    row("MsgPack jamur/bin/...", "jamur/bin/config/set", blen, bns);
+
+    printf("\nCatatan: ns/op diukur di CPU host; rasio antar format yang relevan untuk ESP32.\n");
+    fflush(stdout);
+    return 0;
+}
+
+} // namespace sim
@@ -0,0 +1,331 @@
+// lib/NativeSim/src/sim_core.cpp
+// Jam virtual, GPIO, Serial, ESP, waktu NTP dan penghitung heap.
+
+#include <Arduino.h>
+#include <WiFi.h>
+#include <esp_sntp.h>
+#include <chrono>
+#include <cstdio>
+#include <new>
+#include <random>
+#include <string>
+
+#include "NativeSim.h"
+
+HardwareSerial Serial;
+EspClass ESP;
+
+namespace sim {
+
+static uint8_t g_pin_mode[64];
+static uint8_t g_pin_level[64];
+static bool g_heap_tracking = false;
+
+Stats& stats() {
+    static Stats s;
+    return s;
+}
+
+int pin_level(uint8_t pin) { return pin < 64 ? g_pin_level[pin] : LOW; }
+
+void set_heap_tracking(bool on) { g_heap_tracking = on; }
+
+void record_publish(const char* topic, size_t bytes, bool ok) {
+    Stats& s = stats();
+    TopicStats* t = nullptr;
+    for (int i = 0; i < s.topic_count; i++) {
+        if (strcmp(s.topics[i].topic, topic) == 0) { t = &s.topics[i]; break; }
+    }
+    if (!t && s.topic_count < (int)(sizeof(s.topics) / sizeof(s.topics[0]))) {
+        t = &s.topics[s.topic_count++];
+        snprintf(t->topic, sizeof(t->topic), "%s", topic);
+        t->count = t->failed = 0;
+        t->bytes = 0;
+    }
+    if (!t) return;
+    if (ok) {
+        t->count++;
+        t->bytes += bytes;
+    } else {
+        t->failed++;
+    }
+}
+
+} // namespace sim
+
+// ---------------- WAKTU -----------------------------------
+
+unsigned long millis() { return (unsigned long)sim::now_ms(); }
+unsigned long micros() { return (unsigned long)sim::now_us(); }
+void delay(unsigned long ms) { sim::advance_ms(ms); }
+void delayMicroseconds(unsigned int us) { sim::advance_us(us); }
+void yield() {}
+
+// Jam sistem perangkat = nilai terakhir yang diset + waktu virtual sejak itu
+// (kristal perangkat). Waktu NTP "sebenarnya" berjalan clock_ppm lebih lambat,
+// sehingga selisih antar sinkron terlihat sebagai drift.
+static int64_t sys_base_us = 0;
+static uint64_t sys_ref_us = 0;
+
+static int64_t sys_now_us() { return sys_base_us + (int64_t)(sim::now_us() - sys_ref_us); }
+
+static int64_t ntp_now_us() {
+    int64_t elapsed = (int64_t)sim::now_us();
+    return sim::knobs().start_epoch * 1000000LL + elapsed - (int64_t)((double)elapsed * sim::knobs().clock_ppm * 1e-6);
+}
+
+static void set_sys_us(int64_t us) {
+    sys_base_us = us;
+    sys_ref_us = sim::now_us();
+}
+
+// lwIP: timeout per server, lalu jeda retry yang berlipat sampai 10x.
+static const uint64_t SNTP_TIMEOUT_MS = 15000;
+static const uint64_t SNTP_RETRY_MAX_MS = 150000;
+
+static struct {
+    bool running;
+    std::string servers[3];
+    int server_count;
+    uint64_t due_ms;               // putaran request berikutnya
+    uint64_t reply_ms;             // 0 = tidak ada request berjalan
+    bool reply_ok;
+    uint64_t retry_ms;
+    uint32_t interval_ms = 3600000;
+    sntp_sync_time_cb_t cb;
+    sntp_sync_status_t status;
+} sntp;
+
+// Dipanggil malas dari time()/getLocalTime(): firmware memanggil salah
+// satunya tiap iterasi, jadi sinkron terjadi paling lambat satu iterasi
+// setelah jatuh tempo.
+static void sntp_service() {
+    if (!sntp.running) return;
+    uint64_t now = sim::now_ms();
+    if (sntp.reply_ms == 0) {
+        if (now < sntp.due_ms) return;
+        uint64_t cost = 0;
+        sntp.reply_ok = false;
+        bool linked = WiFi.status() == WL_CONNECTED;
+        for (int i = 0; i < sntp.server_count && !sntp.reply_ok; i++) {
+            if (linked && sim::ntp_up(sntp.servers[i].c_str())) {
+                cost += sim::knobs().ntp_ms;
+                sntp.reply_ok = true;
+            } else {
+                cost += SNTP_TIMEOUT_MS;
+            }
+        }
+        sntp.reply_ms = now + (cost ? cost : 1);
+        sntp.status = SNTP_SYNC_STATUS_IN_PROGRESS;
+        return;
+    }
+    if (now < sntp.reply_ms) return;
+    sntp.reply_ms = 0;
+    if (!sntp.reply_ok) {
+        sntp.status = SNTP_SYNC_STATUS_RESET;
+        sntp.due_ms = now + sntp.retry_ms;
+        sntp.retry_ms = std::min<uint64_t>(sntp.retry_ms * 2, SNTP_RETRY_MAX_MS);
+        return;
+    }
+    set_sys_us(ntp_now_us());
+    sntp.status = SNTP_SYNC_STATUS_COMPLETED;
+    sntp.due_ms = now + sntp.interval_ms;
+    sntp.retry_ms = SNTP_TIMEOUT_MS;
+    if (sntp.cb) {
+        struct timeval tv = { (time_t)(sys_base_us / 1000000), (suseconds_t)(sys_base_us % 1000000) };
+        sntp.cb(&tv);
+    }
+}
+
+void configTime(long gmtOffset_sec, int daylightOffset_sec, const char* server1,
+                const char* server2, const char* server3) {
+    // Seperti setTimeZone() Arduino-ESP32: TZ POSIX bertanda terbalik, jadi
+    // localtime_r() milik host menghasilkan jam lokal perangkat.
+    long off = -(gmtOffset_sec + daylightOffset_sec);
+    char tz[24];
+    snprintf(tz, sizeof(tz), "UTC%c%ld:%02ld", off < 0 ? '-' : '+', labs(off) / 3600, (labs(off) % 3600) / 60);
+    setenv("TZ", tz, 1);
+    tzset();
+
+    const char* servers[] = { server1, server2, server3 };
+    sntp.server_count = 0;
+    for (const char* server : servers) {
+        if (server && *server) sntp.servers[sntp.server_count++] = server;
+    }
+    sntp.running = true;
+    sntp.due_ms = sim::now_ms();
+    sntp.reply_ms = 0;
+    sntp.retry_ms = SNTP_TIMEOUT_MS;
+    sntp.status = SNTP_SYNC_STATUS_RESET;
+}
+
+void sntp_set_time_sync_notification_cb(sntp_sync_time_cb_t callback) { sntp.cb = callback; }
+void sntp_set_sync_interval(uint32_t interval_ms) { sntp.interval_ms = std::max<uint32_t>(interval_ms, 15000); }
+uint32_t sntp_get_sync_interval() { return sntp.interval_ms; }
+void sntp_stop() { sntp.running = false; sntp.reply_ms = 0; }
+
+sntp_sync_status_t sntp_get_sync_status() {
+    sntp_service();
+    sntp_sync_status_t status = sntp.status;
+    if (status == SNTP_SYNC_STATUS_COMPLETED) sntp.status = SNTP_SYNC_STATUS_RESET;
+    return status;
+}
+
+// Seperti aslinya: menunggu (delay 10 ms) sampai jam lewat 2016 atau ms habis.
+bool getLocalTime(struct tm* info, uint32_t ms) {
+    uint64_t start = sim::now_ms();
+    for (;;) {
+        time_t now = time(nullptr);
+        localtime_r(&now, info);
+        if (info->tm_year > (2016 - 1900)) return true;
+        if (sim::now_ms() - start >= ms) return false;
+        delay(10);
+    }
+}
+
+// time() dan settimeofday() milik firmware harus mengikuti jam virtual,
+// bukan jam host. Sebelum sinkron pertama jam ESP32 mulai dari epoch 0.
+extern "C" time_t time(time_t* out) {
+    sntp_service();
+    time_t t = (time_t)(sys_now_us() / 1000000);
+    if (out) *out = t;
+    return t;
+}
+
+extern "C" int settimeofday(const struct timeval* tv, const struct timezone* tz) {
+    (void)tz;
+    if (tv) set_sys_us((int64_t)tv->tv_sec * 1000000LL + tv->tv_usec);
+    return 0;
+}
+
+// ---------------- GPIO ------------------------------------
+
+void pinMode(uint8_t pin, uint8_t mode) {
+    if (pin >= 64) return;
+    sim::g_pin_mode[pin] = mode;
+    sim::g_pin_level[pin] = (mode == INPUT_PULLUP) ? HIGH : LOW;
+}
+
+void digitalWrite(uint8_t pin, uint8_t val) {
+    if (pin >= 64) return;
+    uint8_t prev = sim::g_pin_level[pin];
+    sim::g_pin_level[pin] = val ? HIGH : LOW;
+    if (pin != sim::knobs().relay_pin || prev == sim::g_pin_level[pin]) return;
+
+    sim::Stats& s = sim::stats();
+    if (val) {
+        s.relay_on = true;
+        s.relay_on_count++;
+        s.relay_on_since_ms = sim::now_ms();
+    } else if (s.relay_on) {
+        uint64_t on = sim::now_ms() - s.relay_on_since_ms;
+        s.relay_on = false;
+        s.relay_on_ms += on;
+        if (on > s.relay_max_on_ms) s.relay_max_on_ms = on;
+    }
+}
+
+int digitalRead(uint8_t pin) { return pin < 64 ? sim::g_pin_level[pin] : LOW; }
+
+// ---------------- RANDOM ----------------------------------
+
+static std::mt19937& rng() {
+    static std::mt19937 r(sim::knobs().seed);
+    return r;
+}
+
+long random(long howbig) { return howbig <= 0 ? 0 : (long)(rng()() % (uint32_t)howbig); }
+long random(long howsmall, long howbig) { return howsmall >= howbig ? howsmall : howsmall + random(howbig - howsmall); }
+void randomSeed(unsigned long seed) { rng().seed((uint32_t)seed); }
+uint32_t esp_random() { return rng()(); }
+
+// ---------------- SERIAL ----------------------------------
+
+size_t HardwareSerial::write(const char* s, size_t n) {
+    sim::stats().serial_bytes += n;
+    if (sim::knobs().serial_echo) fwrite(s, 1, n, stdout);
+    return n;
+}
+
+size_t HardwareSerial::print(const char* s) { return s ? write(s, strlen(s)) : 0; }
+
+size_t HardwareSerial::printf(const char* fmt, ...) {
+    char buf[512];
+    va_list args;
+    va_start(args, fmt);
+    int n = vsnprintf(buf, sizeof(buf), fmt, args);
+    va_end(args);
+    if (n <= 0) return 0;
+    if ((size_t)n >= sizeof(buf)) n = sizeof(buf) - 1;
+    return write(buf, (size_t)n);
+}
+
+// ---------------- ESP -------------------------------------
+
+#define SIM_HEAP_SIZE (320 * 1024)
+
+void EspClass::restart() { sim::finish("ESP.restart()"); }
+
+uint32_t EspClass::getFreeHeap() {
+    int64_t free = SIM_HEAP_SIZE - sim::stats().heap_live;
+    return free > 0 ? (uint32_t)free : 0;
+}
+
+uint32_t EspClass::getMinFreeHeap() {
+    int64_t free = SIM_HEAP_SIZE - sim::stats().heap_peak;
+    return free > 0 ? (uint32_t)free : 0;
+}
+
+uint32_t EspClass::getFreeSketchSpace() { return 1310720; }
+
+// Siklus CPU 240 MHz: waktu virtual (blocking tiruan) ditambah waktu CPU host
+// yang benar-benar terpakai, agar instrumentasi berbasis cycle tetap bermakna.
+uint32_t EspClass::getCycleCount() {
+    static const auto t0 = std::chrono::steady_clock::now();
+    uint64_t host_ns = (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - t0).count();
+    return (uint32_t)(sim::now_us() * 240ULL + host_ns * 240ULL / 1000ULL);
+}
+
+// ---------------- HEAP CHURN ------------------------------
+// Header 16 byte menyimpan ukuran blok dan apakah blok dialokasikan oleh
+// firmware, agar live/peak hanya menghitung alokasi milik firmware.
+
+static void* sim_alloc(size_t size) {
+    void* p = malloc(size + 16);
+    if (!p) throw std::bad_alloc();
+    ((size_t*)p)[0] = size;
+    ((size_t*)p)[1] = sim::g_heap_tracking;
+    if (sim::g_heap_tracking) {
+        sim::Stats& s = sim::stats();
+        s.heap_allocs++;
+        s.heap_bytes += size;
+        s.heap_live += (int64_t)size;
+        if (s.heap_live > s.heap_peak) s.heap_peak = s.heap_live;
+    }
+    return (char*)p + 16;
+}
+
+static void sim_free(void* ptr) {
+    if (!ptr) return;
+    void* p = (char*)ptr - 16;
+    if (((size_t*)p)[1]) {
+        sim::Stats& s = sim::stats();
+        s.heap_frees++;
+        s.heap_live -= (int64_t)((size_t*)p)[0];
+    }
+    free(p);
+}
+
+void* operator new(size_t size) { return sim_alloc(size); }
+void* operator new[](size_t size) { return sim_alloc(size); }
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+    try { return sim_alloc(size); } catch (...) { return nullptr; }
+}
+void* operator new[](size_t size, const std::nothrow_t&) noexcept {
+    try { return sim_alloc(size); } catch (...) { return nullptr; }
+}
+void operator delete(void* p) noexcept { sim_free(p); }
+void operator delete[](void* p) noexcept { sim_free(p); }
+void operator delete(void* p, size_t) noexcept { sim_free(p); }
+void operator delete[](void* p, size_t) noexcept { sim_free(p); }
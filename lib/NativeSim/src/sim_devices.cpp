@@ -0,0 +1,629 @@
+// lib/NativeSim/src/sim_devices.cpp
+// Model ruang (sintetis atau trace CSV), DHT, sensor I2C, LCD, NVS, jadwal
+// gangguan jaringan dan event MQTT masuk.
+
+#include <Arduino.h>
+#include <ClimateSensor.h>
+#include <LiquidCrystal_I2C.h>
+#include <Preferences.h>
+#include <cstdio>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "NativeSim.h"
+
+namespace sim {
+
+// ---------------- MODEL RUANG -----------------------------
+// Tanpa trace: kelembapan ruang relaksasi ke kelembapan luar (siklus harian
+// 70-90 %RH) dengan tau 45 menit, dan naik selama relay pompa menyala.
+
+#define ROOM_TAU_SEC 2700.0
+#define ROOM_PUMP_GAIN_PER_SEC 0.3
+
+struct TracePoint {
+    double t;
+    float h;
+    float c;
+};
+
+static std::vector<TracePoint> g_trace;
+static double g_room_h = 82.0;
+
+// Rak tambahan (JAMUR_SIM_ZONES): model yang sama dengan target kelembapan
+// digeser selisih_RH dan relay sendiri; statistiknya di stats().racks.
+struct Rack {
+    uint8_t dht_pin;
+    uint8_t relay_pin;
+    double offset;
+    double h;
+    bool relay;
+};
+
+static std::vector<Rack>& racks() {
+    static std::vector<Rack> list;
+    static bool parsed = false;
+    if (parsed) return list;
+    parsed = true;
+    const char* p = knobs().zones;
+    while (p && *p) {
+        unsigned dht = 0, relay = 0;
+        double offset = 0;
+        if (sscanf(p, "%u:%u:%lf", &dht, &relay, &offset) >= 2) {
+            list.push_back({ (uint8_t)dht, (uint8_t)relay, offset, g_room_h + offset, false });
+            stats().racks.push_back({ (uint8_t)dht, (uint8_t)relay, 0, 0, 0, 0 });
+        }
+        p = strchr(p, ',');
+        if (p) p++;
+    }
+    return list;
+}
+
+static double local_hour(uint64_t ms) {
+    int64_t t = knobs().start_epoch + knobs().tz_offset_sec + (int64_t)(ms / 1000ULL);
+    return (double)(t % 86400) / 3600.0;
+}
+
+static double ambient_humidity(uint64_t ms) {
+    return 80.0 + 10.0 * cos(2.0 * PI * (local_hour(ms) - 4.0) / 24.0);
+}
+
+static double ambient_temperature(uint64_t ms) {
+    return 27.0 + 4.0 * cos(2.0 * PI * (local_hour(ms) - 15.0) / 24.0);
+}
+
+static const TracePoint* trace_at(double t, TracePoint* out) {
+    if (g_trace.empty()) return nullptr;
+    if (t <= g_trace.front().t) return &g_trace.front();
+    if (t >= g_trace.back().t) return &g_trace.back();
+    size_t lo = 0, hi = g_trace.size() - 1;
+    while (hi - lo > 1) {
+        size_t mid = (lo + hi) / 2;
+        if (g_trace[mid].t <= t) lo = mid; else hi = mid;
+    }
+    const TracePoint& a = g_trace[lo];
+    const TracePoint& b = g_trace[hi];
+    double f = (b.t > a.t) ? (t - a.t) / (b.t - a.t) : 0.0;
+    out->t = t;
+    out->h = (float)(a.h + (b.h - a.h) * f);
+    out->c = (float)(a.c + (b.c - a.c) * f);
+    return out;
+}
+
+// Dengan trace, kelembapan trace menjadi target relaksasi (dipakai bench
+// kontrol yang butuh loop tertutup di atas rekaman).
+double room_model_step(double humidity, uint64_t ms, double dt, bool pump) {
+    TracePoint tmp;
+    const TracePoint* p = trace_at((double)ms / 1000.0, &tmp);
+    double target = p ? p->h : ambient_humidity(ms);
+    humidity += (target - humidity) * (1.0 - exp(-dt / ROOM_TAU_SEC));
+    if (pump) humidity += ROOM_PUMP_GAIN_PER_SEC * dt;
+    return humidity > 99.0 ? 99.0 : humidity;
+}
+
+double room_model_temperature(uint64_t ms) {
+    TracePoint tmp;
+    const TracePoint* p = trace_at((double)ms / 1000.0, &tmp);
+    return p ? p->c : ambient_temperature(ms);
+}
+
+void room_step(uint64_t dt_us) {
+    double dt = (double)dt_us / 1e6;
+    if (g_trace.empty()) g_room_h = room_model_step(g_room_h, now_ms(), dt, pin_level(knobs().relay_pin) == HIGH);
+
+    Stats& s = stats();
+    double h = room_humidity();
+    double err = h - knobs().setpoint;
+    s.room_seconds += dt;
+    s.room_h_sum += h * dt;
+    s.room_err_sq += err * err * dt;
+    if (err < 0) s.room_deficit_sq += err * err * dt;
+
+    std::vector<Rack>& list = racks();
+    for (size_t i = 0; i < list.size(); i++) {
+        Rack& r = list[i];
+        RackStats& rs = s.racks[i];
+        bool relay = pin_level(r.relay_pin) == HIGH;
+        if (relay && !r.relay) rs.relay_on_count++;
+        r.relay = relay;
+        if (relay) rs.relay_on_s += dt;
+        r.h = room_model_step(r.h - r.offset, now_ms(), dt, relay) + r.offset;
+        if (r.h > 99.0) r.h = 99.0;
+        rs.h_sum += r.h * dt;
+        if (r.h < knobs().setpoint) rs.below_s += dt;
+    }
+}
+
+float room_humidity() {
+    TracePoint tmp;
+    const TracePoint* p = trace_at((double)now_ms() / 1000.0, &tmp);
+    return p ? p->h : (float)g_room_h;
+}
+
+float room_temperature() {
+    TracePoint tmp;
+    const TracePoint* p = trace_at((double)now_ms() / 1000.0, &tmp);
+    return p ? p->c : (float)ambient_temperature(now_ms());
+}
+
+bool load_trace(const char* path) {
+    FILE* f = fopen(path, "r");
+    if (!f) return false;
+    char line[256];
+    while (fgets(line, sizeof(line), f)) {
+        TracePoint p;
+        if (sscanf(line, "%lf,%f,%f", &p.t, &p.h, &p.c) == 3) g_trace.push_back(p);
+    }
+    fclose(f);
+    return !g_trace.empty();
+}
+
+double trace_hours() { return g_trace.empty() ? 0.0 : g_trace.back().t / 3600.0; }
+
+// ---------------- GANGGUAN JARINGAN -----------------------
+
+struct Window {
+    double from_h;
+    double to_h;
+};
+
+static std::vector<Window> parse_windows(const char* spec) {
+    std::vector<Window> out;
+    if (!spec) return out;
+    const char* p = spec;
+    while (*p) {
+        Window w;
+        int used = 0;
+        if (sscanf(p, "%lf-%lf%n", &w.from_h, &w.to_h, &used) != 2) break;
+        out.push_back(w);
+        p += used;
+        if (*p == ',') p++;
+    }
+    return out;
+}
+
+static bool in_window(const std::vector<Window>& ws) {
+    double h = (double)now_ms() / 3600000.0;
+    for (const Window& w : ws) {
+        if (h >= w.from_h && h < w.to_h) return true;
+    }
+    return false;
+}
+
+bool wifi_up() {
+    static std::vector<Window> ws = parse_windows(knobs().wifi_outages);
+    return !in_window(ws);
+}
+
+bool broker_up() {
+    static std::vector<Window> ws = parse_windows(knobs().mqtt_outages);
+    return !in_window(ws);
+}
+
+// Server LAN (JAMUR_SIM_NTP_LAN) tidak ikut outage internet; nama lain
+// dianggap server internet.
+bool ntp_up(const char* server) {
+    if (knobs().ntp_lan && strcmp(server, knobs().ntp_lan) == 0) return true;
+    static std::vector<Window> ws = parse_windows(knobs().ntp_outages);
+    return !in_window(ws);
+}
+
+// ---------------- EVENT MQTT ------------------------------
+
+struct Event {
+    double at_h;
+    std::string topic;
+    std::string payload;
+};
+
+static std::vector<Event> g_events;
+static size_t g_next_event = 0;
+static std::vector<Event> g_http_events;
+static size_t g_next_http = 0;
+
+bool load_events(const char* path) {
+    FILE* f = fopen(path, "r");
+    if (!f) return false;
+    char line[1200];
+    while (fgets(line, sizeof(line), f)) {
+        if (line[0] == '#' || line[0] == '\n') continue;
+        line[strcspn(line, "\r\n")] = 0;
+        char topic[128];
+        double at;
+        int used = 0;
+        if (sscanf(line, "%lf %127s %n", &at, topic, &used) < 2) continue;
+        bool http = strcmp(topic, "GET") == 0 || strcmp(topic, "POST") == 0;
+        (http ? g_http_events : g_events).push_back({at, topic, line + used});
+    }
+    fclose(f);
+    return true;
+}
+
+bool next_due_event(const char** topic, const char** payload) {
+    if (g_next_event >= g_events.size()) return false;
+    const Event& e = g_events[g_next_event];
+    if ((double)now_ms() / 3600000.0 < e.at_h) return false;
+    g_next_event++;
+    *topic = e.topic.c_str();
+    *payload = e.payload.c_str();
+    return true;
+}
+
+bool next_due_http(const char** method, const char** request) {
+    if (g_next_http >= g_http_events.size()) return false;
+    const Event& e = g_http_events[g_next_http];
+    if ((double)now_ms() / 3600000.0 < e.at_h) return false;
+    g_next_http++;
+    *method = e.topic.c_str();
+    *request = e.payload.c_str();
+    return true;
+}
+
+} // namespace sim
+
+// ---------------- DHT -------------------------------------
+// Frame 40 bit yang akan direkam RMT: nilai ruang + noise, dikodekan seperti
+// sensor asli (DHT11 per 1 %RH / 1 C). Frame bisa hilang (timeout), rusak
+// satu bit (checksum salah) atau berisi spike dengan checksum benar.
+
+namespace sim {
+
+bool dht_frame(uint8_t pin, uint8_t type, uint8_t frame[5]) {
+    static std::mt19937 rng(knobs().seed * 7919u + 17u);
+    std::normal_distribution<float> noise(0.0f, knobs().dht_noise);
+    std::uniform_real_distribution<float> uni(0.0f, 1.0f);
+
+    Stats& s = stats();
+    s.dht_reads++;
+    float failure = uni(rng);
+    if (failure < knobs().dht_nan_rate / 2) {
+        s.dht_nan++;
+        return false;
+    }
+    float h = room_humidity() + noise(rng);
+    for (const Rack& r : racks()) {
+        if (r.dht_pin == pin) h = (float)r.h + noise(rng);
+    }
+    float t = room_temperature() + noise(rng) * 0.5f;
+    if (uni(rng) < knobs().dht_spike_rate) {
+        s.dht_spikes++;
+        h = uni(rng) * 99.0f;
+    }
+    h = h < 0 ? 0 : (h > 99 ? 99 : h);
+    if (type == 11) {
+        int ti = (int)roundf(fabsf(t));
+        frame[0] = (uint8_t)roundf(h);
+        frame[1] = 0;
+        frame[2] = (uint8_t)ti;
+        frame[3] = t < 0 ? 0x80 : 0;
+    } else {
+        uint16_t hi = (uint16_t)roundf(h * 10.0f);
+        uint16_t ti = (uint16_t)roundf(fabsf(t) * 10.0f);
+        frame[0] = hi >> 8;
+        frame[1] = hi & 0xFF;
+        frame[2] = ((ti >> 8) & 0x7F) | (t < 0 ? 0x80 : 0);
+        frame[3] = ti & 0xFF;
+    }
+    frame[4] = frame[0] + frame[1] + frame[2] + frame[3];
+    if (failure < knobs().dht_nan_rate) {
+        s.dht_nan++;
+        frame[(int)(uni(rng) * 4.99f)] ^= 1 << (int)(uni(rng) * 7.99f);
+    }
+    return true;
+}
+
+} // namespace sim
+
+// ---------------- SENSOR I2C ------------------------------
+// Satu sensor di alamat standarnya sesuai JAMUR_SIM_I2C. Nilai dari model
+// ruang dengan noise sepertiga DHT_NOISE; JAMUR_SIM_DHT_NAN berlaku sebagai
+// NACK (separuh) dan satu bit rusak (separuh, CRC salah pada SHT). Hasil baru
+// siap setelah waktu konversi datasheet; dibaca lebih awal = NACK.
+
+namespace sim {
+
+enum I2cKind { I2C_NONE, I2C_SHT3X, I2C_SHT4X, I2C_BME280 };
+
+struct I2cDevice {
+    I2cKind kind = I2C_NONE;
+    uint8_t address = 0;
+    uint8_t pending[6];            // jawaban SHT untuk read() berikutnya
+    size_t pendingLen = 0;
+    uint64_t readyUs = 0;
+    bool converting = false;
+    uint8_t reg = 0;               // pointer register BME280
+    uint8_t regs[256];
+};
+
+// Kalibrasi BME280 contoh: T1 28485, T2 26735, T3 50, H1 75, H2 353, H3 0,
+// H4 340, H5 0, H6 30.
+static const uint8_t BME280_CALIB_TP[26] = {
+    0x45, 0x6F, 0x6F, 0x68, 0x32, 0x00, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 75
+};
+static const uint8_t BME280_CALIB_H[7] = { 0x61, 0x01, 0x00, 0x15, 0x04, 0x00, 0x1E };
+
+static I2cDevice& i2c_device() {
+    static I2cDevice dev;
+    static bool init = false;
+    if (init) return dev;
+    init = true;
+    const char* kind = knobs().i2c_sensor;
+    if (!kind) return dev;
+    if (strcmp(kind, "sht3x") == 0) dev.kind = I2C_SHT3X;
+    else if (strcmp(kind, "sht4x") == 0) dev.kind = I2C_SHT4X;
+    else if (strcmp(kind, "bme280") == 0) dev.kind = I2C_BME280;
+    else fprintf(stderr, "JAMUR_SIM_I2C tidak dikenal: %s\n", kind);
+    dev.address = dev.kind == I2C_BME280 ? 0x76 : 0x44;
+    memset(dev.regs, 0, sizeof(dev.regs));
+    dev.regs[0xD0] = 0x60;
+    memcpy(dev.regs + 0x88, BME280_CALIB_TP, sizeof(BME280_CALIB_TP));
+    memcpy(dev.regs + 0xE1, BME280_CALIB_H, sizeof(BME280_CALIB_H));
+    dev.regs[0xFA] = 0x80;
+    dev.regs[0xFD] = 0x80;
+    return dev;
+}
+
+static void sensirion_word(uint8_t* out, float value) {
+    uint16_t raw = (uint16_t)(value < 0 ? 0 : (value > 65535 ? 65535 : lroundf(value)));
+    out[0] = raw >> 8;
+    out[1] = raw & 0xFF;
+    out[2] = I2cSensor::crc8(out, 2);
+}
+
+// ADC terkecil yang hasil kompensasinya >= target (kompensasi monoton naik).
+static int32_t bme280_invert(const Bme280Calib& calib, bool humidity, int32_t adcT, float target, int32_t hi) {
+    int32_t lo = 0;
+    while (lo < hi) {
+        int32_t mid = lo + (hi - lo) / 2;
+        float h, t;
+        if (humidity) Bme280Sensor::compensate(calib, adcT, mid, h, t);
+        else Bme280Sensor::compensate(calib, mid, 0, h, t);
+        if ((humidity ? h : t) < target) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo;
+}
+
+// Konversi selesai: nilai ruang saat ini, dengan noise dan kegagalan.
+static void i2c_convert(I2cDevice& dev) {
+    static std::mt19937 rng(knobs().seed * 104729u + 3u);
+    std::normal_distribution<float> noise(0.0f, knobs().dht_noise / 3.0f);
+    std::uniform_real_distribution<float> uni(0.0f, 1.0f);
+
+    float h = room_humidity() + noise(rng);
+    float t = room_temperature() + noise(rng) * 0.3f;
+    if (uni(rng) < knobs().dht_spike_rate) {
+        stats().dht_spikes++;
+        h = uni(rng) * 99.0f;
+    }
+    h = h < 0 ? 0 : (h > 100 ? 100 : h);
+    float failure = uni(rng);
+    dev.converting = false;
+    if (failure < knobs().dht_nan_rate / 2) return;   // tidak ada hasil: read() NACK
+
+    if (dev.kind == I2C_BME280) {
+        Bme280Calib calib = Bme280Sensor::parse_calib(BME280_CALIB_TP, BME280_CALIB_H);
+        int32_t adcT = bme280_invert(calib, false, 0, t, 0xFFFFF);
+        int32_t adcH = bme280_invert(calib, true, adcT, h, 0xFFFF);
+        dev.regs[0xFA] = (adcT >> 12) & 0xFF;
+        dev.regs[0xFB] = (adcT >> 4) & 0xFF;
+        dev.regs[0xFC] = (adcT & 0x0F) << 4;
+        dev.regs[0xFD] = adcH >> 8;
+        dev.regs[0xFE] = adcH & 0xFF;
+        return;
+    }
+    float rawH = dev.kind == I2C_SHT4X ? (h + 6.0f) * 65535.0f / 125.0f : h * 65535.0f / 100.0f;
+    sensirion_word(dev.pending, (t + 45.0f) * 65535.0f / 175.0f);
+    sensirion_word(dev.pending + 3, rawH);
+    dev.pendingLen = 6;
+    if (failure < knobs().dht_nan_rate) dev.pending[(int)(uni(rng) * 5.99f)] ^= 1 << (int)(uni(rng) * 7.99f);
+}
+
+bool i2c_write(uint8_t address, const uint8_t* data, size_t length) {
+    I2cDevice& dev = i2c_device();
+    if (dev.kind == I2C_NONE || address != dev.address || length == 0) return false;
+    uint64_t now = now_us();
+    dev.pendingLen = 0;
+    switch (dev.kind) {
+        case I2C_SHT3X:
+            if (length != 2) return false;
+            if (data[0] == 0x30 && data[1] == 0xA2) return true;
+            if (data[0] == 0xF3 && data[1] == 0x2D) {
+                dev.pending[0] = dev.pending[1] = 0;
+                dev.pending[2] = I2cSensor::crc8(dev.pending, 2);
+                dev.pendingLen = 3;
+                return true;
+            }
+            if (data[0] == 0x24 && data[1] == 0x00) {
+                dev.converting = true;
+                dev.readyUs = now + 15500;
+                return true;
+            }
+            return false;
+        case I2C_SHT4X:
+            if (length != 1) return false;
+            if (data[0] == 0x89) {
+                sensirion_word(dev.pending, 0x1234);
+                sensirion_word(dev.pending + 3, 0x5678);
+                dev.pendingLen = 6;
+                return true;
+            }
+            if (data[0] == 0xFD) {
+                dev.converting = true;
+                dev.readyUs = now + 8300;
+                return true;
+            }
+            return false;
+        case I2C_BME280:
+            dev.reg = data[0];
+            for (size_t i = 1; i < length; i++) dev.regs[(uint8_t)(data[0] + i - 1)] = data[i];
+            // ctrl_meas forced: T + H x1, tekanan dilewati (datasheet maks. ~6.4 ms).
+            if (length >= 2 && data[0] == 0xF4 && (data[1] & 0x03) == 0x01) {
+                dev.converting = true;
+                dev.readyUs = now + 6400;
+            }
+            return true;
+        default:
+            return false;
+    }
+}
+
+bool i2c_read(uint8_t address, uint8_t* data, size_t length) {
+    I2cDevice& dev = i2c_device();
+    if (dev.kind == I2C_NONE || address != dev.address) return false;
+    bool measurement = dev.converting;
+    if (dev.converting && now_us() >= dev.readyUs) i2c_convert(dev);
+    if (dev.kind == I2C_BME280) {
+        if (measurement && dev.reg == 0xFA) stats().i2c_samples++;
+        for (size_t i = 0; i < length; i++) data[i] = dev.regs[(uint8_t)(dev.reg + i)];
+        return true;
+    }
+    if (dev.converting || dev.pendingLen == 0 || length > dev.pendingLen) {
+        if (measurement) stats().i2c_nack++;
+        return false;
+    }
+    if (measurement) {
+        stats().i2c_samples++;
+        if (I2cSensor::crc8(dev.pending, 2) != dev.pending[2] || I2cSensor::crc8(dev.pending + 3, 2) != dev.pending[5]) {
+            stats().i2c_crc++;
+        }
+    }
+    memcpy(data, dev.pending, length);
+    dev.pendingLen = 0;
+    return true;
+}
+
+} // namespace sim
+
+// ---------------- LCD -------------------------------------
+// Satu byte ke HD44780 lewat PCF8574 = dua nibble x tiga tulisan expander
+// (~200 us masing-masing pada 100 kHz); clear() menunggu 2 ms lagi.
+
+static const uint32_t LCD_BYTE_US = 1300;
+static const uint32_t LCD_CLEAR_US = 2000;
+
+static void lcd_bus(uint64_t us) {
+    sim::stats().lcd_bus_us += us;
+    sim::advance_us(us);
+}
+
+void LiquidCrystal_I2C::clear() {
+    for (int r = 0; r < 2; r++) {
+        memset(text_[r], ' ', cols_);
+        text_[r][cols_] = 0;
+    }
+    col_ = row_ = 0;
+    sim::stats().lcd_writes++;
+    lcd_bus(LCD_BYTE_US + LCD_CLEAR_US);
+}
+
+void LiquidCrystal_I2C::setCursor(uint8_t col, uint8_t row) {
+    col_ = col;
+    row_ = row < 2 ? row : 1;
+    lcd_bus(LCD_BYTE_US);
+}
+
+size_t LiquidCrystal_I2C::print(const char* s) {
+    size_t n = 0;
+    while (s && *s && col_ < cols_) {
+        text_[row_][col_++] = *s++;
+        n++;
+    }
+    sim::stats().lcd_writes++;
+    lcd_bus((uint64_t)n * LCD_BYTE_US);
+    return n;
+}
+
+// ---------------- PREFERENCES -----------------------------
+
+typedef std::map<std::string, std::string> NvsNamespace;
+
+static std::map<std::string, NvsNamespace>& nvs() {
+    static std::map<std::string, NvsNamespace> store;
+    return store;
+}
+
+bool Preferences::begin(const char* name, bool readOnly, const char* partition) {
+    (void)partition;
+    ns_ = name;
+    open_ = true;
+    readOnly_ = readOnly;
+    return true;
+}
+
+void Preferences::end() { open_ = false; }
+
+bool Preferences::clear() {
+    if (!open_ || readOnly_) return false;
+    nvs()[ns_.c_str()].clear();
+    return true;
+}
+
+bool Preferences::remove(const char* key) {
+    if (!open_ || readOnly_) return false;
+    return nvs()[ns_.c_str()].erase(key) > 0;
+}
+
+bool Preferences::isKey(const char* key) {
+    return open_ && nvs()[ns_.c_str()].count(key) > 0;
+}
+
+size_t Preferences::putBytes(const char* key, const void* value, size_t len) {
+    if (!open_ || readOnly_) return 0;
+    nvs()[ns_.c_str()][key] = std::string((const char*)value, len);
+    return len;
+}
+
+size_t Preferences::getBytesLength(const char* key) {
+    if (!open_) return 0;
+    NvsNamespace& n = nvs()[ns_.c_str()];
+    auto it = n.find(key);
+    return it == n.end() ? 0 : it->second.size();
+}
+
+size_t Preferences::getBytes(const char* key, void* buf, size_t maxLen) {
+    if (!open_) return 0;
+    NvsNamespace& n = nvs()[ns_.c_str()];
+    auto it = n.find(key);
+    if (it == n.end() || it->second.size() > maxLen) return 0;
+    memcpy(buf, it->second.data(), it->second.size());
+    return it->second.size();
+}
+
+template <typename T>
+static size_t nvs_put(Preferences& p, const char* key, T v) { return p.putBytes(key, &v, sizeof(v)); }
+
+template <typename T>
+static T nvs_get(Preferences& p, const char* key, T def) {
+    T v;
+    return p.getBytes(key, &v, sizeof(v)) == sizeof(v) ? v : def;
+}
+
+size_t Preferences::putBool(const char* key, bool value) { return nvs_put<uint8_t>(*this, key, value ? 1 : 0); }
+size_t Preferences::putUChar(const char* key, uint8_t value) { return nvs_put(*this, key, value); }
+size_t Preferences::putInt(const char* key, int32_t value) { return nvs_put(*this, key, value); }
+size_t Preferences::putUInt(const char* key, uint32_t value) { return nvs_put(*this, key, value); }
+size_t Preferences::putULong64(const char* key, uint64_t value) { return nvs_put(*this, key, value); }
+size_t Preferences::putFloat(const char* key, float value) { return nvs_put(*this, key, value); }
+
+size_t Preferences::putString(const char* key, const char* value) {
+    return value ? putBytes(key, value, strlen(value) + 1) : 0;
+}
+
+bool Preferences::getBool(const char* key, bool defaultValue) {
+    return nvs_get<uint8_t>(*this, key, defaultValue ? 1 : 0) != 0;
+}
+uint8_t Preferences::getUChar(const char* key, uint8_t defaultValue) { return nvs_get(*this, key, defaultValue); }
+int32_t Preferences::getInt(const char* key, int32_t defaultValue) { return nvs_get(*this, key, defaultValue); }
+uint32_t Preferences::getUInt(const char* key, uint32_t defaultValue) { return nvs_get(*this, key, defaultValue); }
+uint64_t Preferences::getULong64(const char* key, uint64_t defaultValue) { return nvs_get(*this, key, defaultValue); }
+float Preferences::getFloat(const char* key, float defaultValue) { return nvs_get(*this, key, defaultValue); }
+
+String Preferences::getString(const char* key, const String& defaultValue) {
+    size_t len = getBytesLength(key);
+    if (len == 0) return defaultValue;
+    std::string& v = nvs()[ns_.c_str()][key];
+    return String(v.c_str());
+}
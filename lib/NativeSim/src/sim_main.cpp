@@ -0,0 +1,297 @@
+// lib/NativeSim/src/sim_main.cpp
+// Runner replay: setup() sekali, lalu loop() berulang di atas jam virtual
+// sampai durasi habis, kemudian mencetak laporan latency, volume publish,
+// heap churn dan waktu nyala pompa.
+
+#include <Arduino.h>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <unistd.h>
+
+#include "NativeSim.h"
+
+// `pio test -e native` menautkan library ini tanpa src/ dan dengan main()
+// milik Unity: runner replay (dan pembacaan knob dari env) hanya dibangun
+// untuk firmware, tes memakai knob default.
+#ifndef PIO_UNIT_TESTING
+void setup();
+void loop();
+#endif
+
+namespace sim {
+
+Knobs& knobs() {
+    static Knobs k;
+    return k;
+}
+
+#ifndef PIO_UNIT_TESTING
+static const char* env_str(const char* name) {
+    const char* v = getenv(name);
+    return (v && *v) ? v : nullptr;
+}
+
+template <typename T>
+static void env_num(const char* name, T& out) {
+    const char* v = env_str(name);
+    if (v) out = (T)strtod(v, nullptr);
+}
+
+static void load_knobs() {
+    Knobs& k = knobs();
+    env_num("JAMUR_SIM_HOURS", k.hours);
+    env_num("JAMUR_SIM_STEP_MS", k.step_ms);
+    env_num("JAMUR_SIM_SEED", k.seed);
+    env_num("JAMUR_SIM_START_EPOCH", k.start_epoch);
+    env_num("JAMUR_SIM_TZ_SEC", k.tz_offset_sec);
+    k.trace_path = env_str("JAMUR_SIM_TRACE");
+    k.events_path = env_str("JAMUR_SIM_EVENTS");
+    k.wifi_outages = env_str("JAMUR_SIM_WIFI_OUTAGES");
+    k.mqtt_outages = env_str("JAMUR_SIM_MQTT_OUTAGES");
+    k.serial_echo = env_str("JAMUR_SIM_SERIAL") && atoi(env_str("JAMUR_SIM_SERIAL")) != 0;
+    env_num("JAMUR_SIM_RSSI", k.rssi);
+    env_num("JAMUR_SIM_WIFI_ASSOC_MS", k.wifi_assoc_ms);
+    env_num("JAMUR_SIM_WIFI_FAST_MS", k.wifi_fast_ms);
+    k.wifi_scan = env_str("JAMUR_SIM_WIFI_SCAN");
+    env_num("JAMUR_SIM_WIFI_SCAN_MS", k.wifi_scan_ms);
+    k.wifi_drops = env_str("JAMUR_SIM_WIFI_DROPS");
+    k.wifi_pass = env_str("JAMUR_SIM_WIFI_PASS");
+    env_num("JAMUR_SIM_TLS_MS", k.tls_ms);
+    env_num("JAMUR_SIM_TLS_FAIL_MS", k.tls_fail_ms);
+    env_num("JAMUR_SIM_TLS_RESUME_MS", k.tls_resume_ms);
+    env_num("JAMUR_SIM_RTT_MS", k.rtt_ms);
+    env_num("JAMUR_SIM_NTP_MS", k.ntp_ms);
+    k.ntp_outages = env_str("JAMUR_SIM_NTP_OUTAGES");
+    k.ntp_lan = env_str("JAMUR_SIM_NTP_LAN");
+    env_num("JAMUR_SIM_CLOCK_PPM", k.clock_ppm);
+    env_num("JAMUR_SIM_HTTP_MS", k.http_ms);
+    env_num("JAMUR_SIM_HTTP_CODE", k.http_code);
+    env_num("JAMUR_SIM_HTTP_BODY", k.http_body);
+    env_num("JAMUR_SIM_KBPS", k.bandwidth_kBps);
+    env_num("JAMUR_SIM_HTTP_RANGE", k.http_range);
+    env_num("JAMUR_SIM_HTTP_DROP_KB", k.http_drop_kb);
+    env_num("JAMUR_SIM_FLASH_KBPS", k.flash_kBps);
+    k.http_files = env_str("JAMUR_SIM_HTTP_FILES");
+    k.ota_running = env_str("JAMUR_SIM_OTA_RUNNING");
+    env_num("JAMUR_SIM_DHT_NOISE", k.dht_noise);
+    env_num("JAMUR_SIM_DHT_NAN", k.dht_nan_rate);
+    env_num("JAMUR_SIM_DHT_SPIKE", k.dht_spike_rate);
+    env_num("JAMUR_SIM_RELAY_PIN", k.relay_pin);
+    k.bench = env_str("JAMUR_SIM_BENCH");
+    env_num("JAMUR_SIM_BENCH_ITER", k.bench_iterations);
+    k.delta_old = env_str("JAMUR_SIM_DELTA_OLD");
+    k.delta_patch = env_str("JAMUR_SIM_DELTA_PATCH");
+    k.delta_new = env_str("JAMUR_SIM_DELTA_NEW");
+    k.portal_out = env_str("JAMUR_SIM_PORTAL_OUT");
+    k.control = env_str("JAMUR_SIM_CONTROL");
+    env_num("JAMUR_SIM_SETPOINT", k.setpoint);
+    k.zones = env_str("JAMUR_SIM_ZONES");
+    k.i2c_sensor = env_str("JAMUR_SIM_I2C");
+    if (k.bench_iterations == 0) k.bench_iterations = 1;
+    if (k.step_ms == 0) k.step_ms = 1;
+}
+#endif
+
+// ---------------- HISTOGRAM LATENCY -----------------------
+// Log-linear: 8 sub-bucket per oktaf, resolusi relatif ~12%.
+
+class Histogram {
+public:
+    void add(uint64_t v) {
+        buckets_[index(v)]++;
+        count_++;
+        if (v > max_) max_ = v;
+        sum_ += v;
+    }
+    uint64_t count() const { return count_; }
+    uint64_t max() const { return max_; }
+    double mean() const { return count_ ? (double)sum_ / (double)count_ : 0.0; }
+    uint64_t percentile(double p) const {
+        if (!count_) return 0;
+        uint64_t target = (uint64_t)(p / 100.0 * (double)count_);
+        if (target >= count_) target = count_ - 1;
+        uint64_t seen = 0;
+        for (int i = 0; i < kBuckets; i++) {
+            seen += buckets_[i];
+            if (seen > target) return upper(i) < max_ ? upper(i) : max_;
+        }
+        return max_;
+    }
+
+private:
+    static const int kSub = 8;
+    static const int kBuckets = 64 * kSub;
+    static int index(uint64_t v) {
+        if (v < kSub) return (int)v;
+        int msb = 63 - __builtin_clzll(v);
+        int sub = (int)((v >> (msb - 3)) & (kSub - 1));
+        int i = (msb - 2) * kSub + sub;
+        return i < kBuckets ? i : kBuckets - 1;
+    }
+    static uint64_t upper(int i) {
+        if (i < kSub) return (uint64_t)i;
+        int msb = i / kSub + 2;
+        uint64_t sub = (uint64_t)(i % kSub);
+        return ((kSub + sub + 1) << (msb - 3)) - 1;
+    }
+    uint64_t buckets_[kBuckets] = {0};
+    uint64_t count_ = 0;
+    uint64_t max_ = 0;
+    uint64_t sum_ = 0;
+};
+
+static Histogram g_loop_host_ns;
+static Histogram g_loop_virtual_ms;
+static uint64_t g_loops = 0;
+static std::chrono::steady_clock::time_point g_wall_start;
+
+static void print_report(const char* reason) {
+    Stats& s = stats();
+    double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - g_wall_start).count();
+    double hours = (double)now_ms() / 3600000.0;
+
+    if (s.relay_on) {
+        uint64_t on = now_ms() - s.relay_on_since_ms;
+        s.relay_on_ms += on;
+        if (on > s.relay_max_on_ms) s.relay_max_on_ms = on;
+    }
+
+    printf("\n=== LAPORAN SIMULASI JAMUR IOT (native) ===\n");
+    printf("Selesai         : %s\n", reason);
+    printf("Waktu virtual   : %.2f jam (%.1f detik wall, %.0fx)\n", hours, wall, wall > 0 ? hours * 3600.0 / wall : 0.0);
+    printf("Iterasi loop()  : %llu\n", (unsigned long long)g_loops);
+
+    printf("\n-- Latency loop() --\n");
+    printf("CPU host  (us)  : p50=%.2f p99=%.2f max=%.2f mean=%.2f\n",
+           g_loop_host_ns.percentile(50) / 1000.0, g_loop_host_ns.percentile(99) / 1000.0,
+           g_loop_host_ns.max() / 1000.0, g_loop_host_ns.mean() / 1000.0);
+    printf("Blocking  (ms)  : p50=%llu p99=%llu p99.9=%llu max=%llu (waktu virtual habis di dalam satu loop)\n",
+           (unsigned long long)g_loop_virtual_ms.percentile(50), (unsigned long long)g_loop_virtual_ms.percentile(99),
+           (unsigned long long)g_loop_virtual_ms.percentile(99.9), (unsigned long long)g_loop_virtual_ms.max());
+
+    printf("\n-- MQTT --\n");
+    printf("Connect         : %u percobaan, %u sukses, %llu ms blocking\n", s.mqtt_connect_attempts, s.mqtt_connect_ok,
+           (unsigned long long)s.mqtt_connect_ms);
+    uint64_t total = 0, bytes = 0;
+    for (int i = 0; i < s.topic_count; i++) {
+        const TopicStats& t = s.topics[i];
+        printf("  %-32s %8u msg %10llu B %6u gagal\n", t.topic, t.count, (unsigned long long)t.bytes, t.failed);
+        total += t.count;
+        bytes += t.bytes;
+    }
+    printf("Total publish   : %llu msg, %llu B (%.1f msg/jam)\n", (unsigned long long)total, (unsigned long long)bytes,
+           hours > 0 ? (double)total / hours : 0.0);
+    printf("Gagal publish   : %u saat terputus, %u melebihi buffer\n", s.mqtt_publish_dropped, s.mqtt_publish_oversize);
+    printf("Pesan diterima  : %u\n", s.mqtt_received);
+    printf("Handshake TLS   : %u penuh (%llu ms), %u resume (%llu ms)\n", s.tls_full,
+           (unsigned long long)s.tls_full_ms, s.tls_resumed, (unsigned long long)s.tls_resumed_ms);
+
+    printf("\n-- HTTP / WiFi --\n");
+    printf("HTTP request    : %u, %llu ms blocking, %llu B diunduh\n", s.http_requests, (unsigned long long)s.http_ms,
+           (unsigned long long)s.http_bytes);
+    printf("WiFi.begin()    : %u\n", s.wifi_begin);
+    printf("OTA ditulis     : %llu B, %llu ms menulis flash, %u request Range\n", (unsigned long long)s.ota_bytes,
+           (unsigned long long)s.ota_flash_ms, s.http_range_requests);
+
+    printf("\n-- Sensor & Pompa --\n");
+    printf("Frame DHT       : %u (%u gagal, %u spike)\n", s.dht_reads, s.dht_nan, s.dht_spikes);
+    if (knobs().i2c_sensor) {
+        printf("Sensor I2C      : %s, %u sampel (%u NACK, %u CRC salah)\n", knobs().i2c_sensor, s.i2c_samples,
+               s.i2c_nack, s.i2c_crc);
+    }
+    printf("Relay pompa     : %u kali ON, total %.1f menit, terlama %.1f detik\n", s.relay_on_count,
+           s.relay_on_ms / 60000.0, s.relay_max_on_ms / 1000.0);
+    if (s.room_seconds > 0) {
+        printf("Kelembapan ruang: rata-rata %.1f %%RH", s.room_h_sum / s.room_seconds);
+        if (knobs().setpoint > 0) {
+            printf(", galat ke %.1f: RMS %.2f, di bawah %.2f", knobs().setpoint, sqrt(s.room_err_sq / s.room_seconds),
+                   sqrt(s.room_deficit_sq / s.room_seconds));
+        }
+        printf("\n");
+    }
+    for (const RackStats& r : s.racks) {
+        printf("Rak DHT %-2u      : relay %u kali ON, total %.1f menit, rata-rata %.1f %%RH", r.dht_pin,
+               r.relay_on_count, r.relay_on_s / 60.0, s.room_seconds > 0 ? r.h_sum / s.room_seconds : 0.0);
+        if (knobs().setpoint > 0) printf(", %.1f menit di bawah %.1f", r.below_s / 60.0, knobs().setpoint);
+        printf("\n");
+    }
+    printf("Penulisan LCD   : %u (%.1f detik memegang bus I2C)\n", s.lcd_writes, s.lcd_bus_us / 1e6);
+
+    printf("\n-- Heap (alokasi firmware) --\n");
+    printf("Alokasi         : %llu (%.1f/loop), %llu B total\n", (unsigned long long)s.heap_allocs,
+           g_loops ? (double)s.heap_allocs / (double)g_loops : 0.0, (unsigned long long)s.heap_bytes);
+    printf("Live / puncak   : %lld B / %lld B\n", (long long)s.heap_live, (long long)s.heap_peak);
+    printf("Serial          : %llu B\n", (unsigned long long)s.serial_bytes);
+    fflush(stdout);
+}
+
+bool read_file(const char* path, std::vector<uint8_t>& out) {
+    FILE* f = fopen(path, "rb");
+    if (!f) return false;
+    out.clear();
+    uint8_t buf[4096];
+    size_t n;
+    while ((n = fread(buf, 1, sizeof(buf), f)) > 0) out.insert(out.end(), buf, buf + n);
+    fclose(f);
+    return true;
+}
+
+void finish(const char* reason) {
+    set_heap_tracking(false);
+    print_report(reason);
+    // _exit: thread task masih menunggu di condition variable milik penjadwal.
+    _exit(0);
+}
+
+} // namespace sim
+
+#ifndef PIO_UNIT_TESTING
+int main() {
+    using namespace sim;
+    load_knobs();
+    Knobs& k = knobs();
+
+    if (k.trace_path) {
+        if (!load_trace(k.trace_path)) {
+            fprintf(stderr, "Gagal membaca trace: %s\n", k.trace_path);
+            return 1;
+        }
+        if (!getenv("JAMUR_SIM_HOURS")) k.hours = trace_hours();
+    }
+
+    if (k.bench) {
+        if (strcmp(k.bench, "wire") == 0) return run_wire_bench(k.bench_iterations);
+        if (strcmp(k.bench, "delta") == 0) return run_delta_bench(k.bench_iterations);
+        if (strcmp(k.bench, "portal") == 0) return run_portal_bench(k.bench_iterations);
+        if (strcmp(k.bench, "control") == 0) return run_control_bench();
+        fprintf(stderr, "Benchmark tidak dikenal: %s\n", k.bench);
+        return 1;
+    }
+
+    if (k.events_path && !load_events(k.events_path)) {
+        fprintf(stderr, "Gagal membaca event: %s\n", k.events_path);
+        return 1;
+    }
+
+    uint64_t end_ms = (uint64_t)(k.hours * 3600000.0);
+    g_wall_start = std::chrono::steady_clock::now();
+
+    sched_begin();
+    set_heap_tracking(true);
+    setup();
+    while (now_ms() < end_ms) {
+        uint64_t v0 = now_ms();
+        auto t0 = std::chrono::steady_clock::now();
+        loop();
+        auto t1 = std::chrono::steady_clock::now();
+        g_loop_host_ns.add((uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count());
+        g_loop_virtual_ms.add(now_ms() - v0);
+        g_loops++;
+        set_heap_tracking(false);
+        advance_ms(k.step_ms);
+        set_heap_tracking(true);
+    }
+    finish("durasi replay habis");
+}
+#endif
@@ -0,0 +1,768 @@
+// lib/NativeSim/src/sim_net.cpp
+// WiFi, socket, TLS, HTTP, MQTT, web server dan OTA tiruan.
+
+#include <Arduino.h>
+#include <WiFi.h>
+#include <WiFiClient.h>
+#include <WiFiClientSecure.h>
+#include <WebServer.h>
+#include <HTTPClient.h>
+#include <Update.h>
+#include <PubSubClient.h>
+#include <esp_ota_ops.h>
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "NativeSim.h"
+
+WiFiClass WiFi;
+UpdateClass Update;
+
+// Biaya transfer n byte pada bandwidth knob, dalam mikrodetik virtual.
+static uint64_t transfer_us(size_t bytes) {
+    uint32_t kBps = sim::knobs().bandwidth_kBps ? sim::knobs().bandwidth_kBps : 1;
+    return (uint64_t)bytes * 1000000ULL / ((uint64_t)kBps * 1024ULL);
+}
+
+// ---------------- WIFI ------------------------------------
+
+struct SimAp {
+    std::string ssid;
+    int rssi;
+    int channel;
+    int auth;
+    uint8_t bssid[6];
+    double down_from_h;            // AP ini mati pada [from, to) jam, selain outage global
+    double down_to_h;
+};
+
+static bool g_wifi_begun = false;
+static uint64_t g_wifi_ready_ms = 0;
+static wl_status_t g_wifi_result = WL_CONNECTED;  // status setelah waktu asosiasi
+static int g_wifi_ap = -1;                        // AP tujuan begin() terakhir
+static bool g_wifi_linked = false;                // sudah pernah WL_CONNECTED sejak begin()
+static uint64_t g_wifi_linked_ms = 0;
+static bool g_wifi_lost = false;                  // putus tanpa auto-reconnect
+static bool g_auto_reconnect = true;
+static uint64_t g_scan_done_ms = 0;
+static bool g_scan_running = false;
+static std::vector<int> g_scan_list;              // AP yang terlihat saat scan selesai
+static bool g_scan_ready = false;
+
+// Tanpa JAMUR_SIM_WIFI_SCAN hanya ada satu AP yang menerima SSID apa pun.
+static const std::vector<SimAp>& sim_aps() {
+    static std::vector<SimAp> aps;
+    static bool parsed = false;
+    if (parsed) return aps;
+    parsed = true;
+    const char* spec = sim::knobs().wifi_scan;
+    if (!spec) {
+        aps.push_back({"sim-ap", sim::knobs().rssi, 6, WIFI_AUTH_WPA2_PSK, {0x24, 0x0A, 0xC4, 0, 0, 1}, 0, 0});
+        return aps;
+    }
+    std::string all(spec);
+    size_t pos = 0;
+    while (pos <= all.size()) {
+        size_t end = all.find(',', pos);
+        if (end == std::string::npos) end = all.size();
+        std::string item = all.substr(pos, end - pos);
+        char ssid[33] = "";
+        int rssi = -70, channel = 1, auth = WIFI_AUTH_WPA2_PSK;
+        double from = 0, to = 0;
+        if (sscanf(item.c_str(), "%32[^:]:%d:%d:%d:%lf-%lf", ssid, &rssi, &channel, &auth, &from, &to) >= 1) {
+            uint8_t n = (uint8_t)(aps.size() + 1);
+            aps.push_back({ssid, rssi, channel, auth, {0x24, 0x0A, 0xC4, 0, 0, n}, from, to});
+        }
+        pos = end + 1;
+    }
+    return aps;
+}
+
+// JAMUR_SIM_WIFI_DROPS "jam,jam,...": link putus (deauth/beacon hilang)
+// sementara AP tetap hidup.
+static bool link_dropped_since(uint64_t from_ms) {
+    static std::vector<double> drops;
+    static bool parsed = false;
+    if (!parsed) {
+        parsed = true;
+        const char* p = sim::knobs().wifi_drops;
+        while (p && *p) {
+            drops.push_back(atof(p));
+            p = strchr(p, ',');
+            if (p) p++;
+        }
+    }
+    double from_h = (double)from_ms / 3600000.0;
+    double now_h = (double)sim::now_ms() / 3600000.0;
+    for (double h : drops) {
+        if (h > from_h && h <= now_h) return true;
+    }
+    return false;
+}
+
+static bool ap_up(const SimAp& ap) {
+    double h = (double)sim::now_ms() / 3600000.0;
+    return sim::wifi_up() && !(h >= ap.down_from_h && h < ap.down_to_h);
+}
+
+static bool ap_matches(const SimAp& ap, const char* ssid) {
+    return !sim::knobs().wifi_scan || ap.ssid == (ssid ? ssid : "");
+}
+
+// Seperti ESP32: SSID yang tidak ada -> WL_NO_SSID_AVAIL, password salah
+// tidak pernah tersambung (tetap WL_DISCONNECTED sampai penelepon menyerah).
+// Dengan channel + BSSID, asosiasi langsung ke AP itu tanpa scan penuh.
+wl_status_t WiFiClass::begin(const char* ssid, const char* passphrase, int32_t channel,
+                             const uint8_t* bssid, bool connect) {
+    (void)connect;
+    sim::stats().wifi_begin++;
+    const std::vector<SimAp>& aps = sim_aps();
+    bool directed = channel != 0 && bssid != nullptr;
+    g_wifi_begun = true;
+    g_wifi_linked = false;
+    g_wifi_lost = false;
+    g_wifi_ap = -1;
+    g_wifi_ready_ms = sim::now_ms() + (directed ? sim::knobs().wifi_fast_ms : sim::knobs().wifi_assoc_ms);
+    for (size_t i = 0; i < aps.size(); i++) {
+        const SimAp& ap = aps[i];
+        if (!ap_matches(ap, ssid) || !ap_up(ap)) continue;
+        if (directed && (ap.channel != channel || memcmp(ap.bssid, bssid, 6) != 0)) continue;
+        if (g_wifi_ap < 0 || ap.rssi > aps[g_wifi_ap].rssi) g_wifi_ap = (int)i;
+    }
+
+    g_wifi_result = WL_CONNECTED;
+    // Outage global tetap ditangani status() seperti sebelumnya.
+    if (g_wifi_ap < 0 && (sim::knobs().wifi_scan || directed)) g_wifi_result = WL_NO_SSID_AVAIL;
+    if (g_wifi_ap < 0 && g_wifi_result == WL_CONNECTED) g_wifi_ap = 0;
+    const char* expected = sim::knobs().wifi_pass;
+    if (g_wifi_result == WL_CONNECTED && expected && strcmp(expected, passphrase ? passphrase : "") != 0) {
+        g_wifi_result = WL_DISCONNECTED;
+    }
+    return WL_DISCONNECTED;
+}
+
+bool WiFiClass::disconnect(bool wifioff, bool eraseap) {
+    (void)wifioff; (void)eraseap;
+    g_wifi_begun = false;
+    return true;
+}
+
+wl_status_t WiFiClass::status() {
+    if (!g_wifi_begun) return WL_IDLE_STATUS;
+    if (sim::now_ms() < g_wifi_ready_ms) return WL_DISCONNECTED;
+    if (g_wifi_result != WL_CONNECTED) return g_wifi_result;
+    // Auto-reconnect milik driver menyambung lagi ke AP yang sama begitu
+    // kembali; tanpa itu putus sekali berarti putus sampai begin() berikutnya.
+    if (g_wifi_linked && link_dropped_since(g_wifi_linked_ms)) {
+        g_wifi_linked_ms = sim::now_ms();
+        if (!g_auto_reconnect) g_wifi_lost = true;
+        else g_wifi_ready_ms = sim::now_ms() + sim::knobs().wifi_assoc_ms;
+        return WL_DISCONNECTED;
+    }
+    if (g_wifi_lost || !ap_up(sim_aps()[g_wifi_ap])) {
+        if (g_wifi_linked && !g_auto_reconnect) g_wifi_lost = true;
+        return WL_DISCONNECTED;
+    }
+    if (!g_wifi_linked) g_wifi_linked_ms = sim::now_ms();
+    g_wifi_linked = true;
+    return WL_CONNECTED;
+}
+
+int8_t WiFiClass::RSSI() {
+    if (status() != WL_CONNECTED) return 0;
+    return (int8_t)(sim_aps()[g_wifi_ap].rssi + random(-3, 4));
+}
+
+String WiFiClass::SSID() {
+    return status() == WL_CONNECTED ? String(sim_aps()[g_wifi_ap].ssid.c_str()) : String();
+}
+
+uint8_t* WiFiClass::BSSID() {
+    static uint8_t none[6] = {0};
+    return status() == WL_CONNECTED ? (uint8_t*)sim_aps()[g_wifi_ap].bssid : none;
+}
+
+int32_t WiFiClass::channel() {
+    return status() == WL_CONNECTED ? sim_aps()[g_wifi_ap].channel : 0;
+}
+
+String WiFiClass::macAddress() { return String("24:6F:28:2B:20:34"); }
+
+IPAddress WiFiClass::localIP() {
+    return status() == WL_CONNECTED ? IPAddress(192, 168, 1, 100) : IPAddress();
+}
+
+int WiFiClass::hostByName(const char* host, IPAddress& result) {
+    (void)host;
+    if (status() != WL_CONNECTED) {
+        sim::advance_ms(sim::knobs().tls_fail_ms);
+        return 0;
+    }
+    sim::advance_ms(sim::knobs().rtt_ms);
+    result = IPAddress(10, 0, 0, 1);
+    return 1;
+}
+
+bool WiFiClass::softAP(const char* ssid, const char* passphrase) {
+    (void)ssid; (void)passphrase;
+    return true;
+}
+
+bool WiFiClass::softAPdisconnect(bool wifioff) {
+    if (wifioff && mode_ == WIFI_AP_STA) mode_ = WIFI_STA;
+    return true;
+}
+
+bool WiFiClass::setAutoReconnect(bool on) {
+    g_auto_reconnect = on;
+    return true;
+}
+
+static void scan_finish() {
+    g_scan_running = false;
+    g_scan_ready = true;
+    g_scan_list.clear();
+    const std::vector<SimAp>& aps = sim_aps();
+    for (size_t i = 0; i < aps.size(); i++) {
+        if (ap_up(aps[i])) g_scan_list.push_back((int)i);
+    }
+}
+
+int16_t WiFiClass::scanNetworks(bool async, bool show_hidden) {
+    (void)show_hidden;
+    if (g_scan_running) return WIFI_SCAN_RUNNING;
+    g_scan_ready = false;
+    g_scan_done_ms = sim::now_ms() + sim::knobs().wifi_scan_ms;
+    g_scan_running = true;
+    if (async) return WIFI_SCAN_RUNNING;
+    sim::advance_ms(sim::knobs().wifi_scan_ms);
+    scan_finish();
+    return (int16_t)g_scan_list.size();
+}
+
+int16_t WiFiClass::scanComplete() {
+    if (g_scan_running && sim::now_ms() >= g_scan_done_ms) scan_finish();
+    if (g_scan_running) return WIFI_SCAN_RUNNING;
+    return g_scan_ready ? (int16_t)g_scan_list.size() : WIFI_SCAN_FAILED;
+}
+
+void WiFiClass::scanDelete() {
+    g_scan_ready = false;
+    g_scan_list.clear();
+}
+
+static const SimAp* scan_item(uint8_t i) {
+    return g_scan_ready && i < g_scan_list.size() ? &sim_aps()[g_scan_list[i]] : nullptr;
+}
+
+String WiFiClass::SSID(uint8_t i) { return scan_item(i) ? String(scan_item(i)->ssid.c_str()) : String(); }
+int32_t WiFiClass::RSSI(uint8_t i) { return scan_item(i) ? scan_item(i)->rssi : 0; }
+int32_t WiFiClass::channel(uint8_t i) { return scan_item(i) ? scan_item(i)->channel : 0; }
+
+uint8_t* WiFiClass::BSSID(uint8_t i) {
+    static uint8_t none[6] = {0};
+    return scan_item(i) ? (uint8_t*)scan_item(i)->bssid : none;
+}
+
+wifi_auth_mode_t WiFiClass::encryptionType(uint8_t i) {
+    return scan_item(i) ? (wifi_auth_mode_t)scan_item(i)->auth : WIFI_AUTH_OPEN;
+}
+
+// ---------------- WIFI CLIENT -----------------------------
+
+int WiFiClient::connect(const char* host, uint16_t port) {
+    (void)host; (void)port;
+    if (!sim::wifi_up()) {
+        sim::advance_ms(timeoutMs_);
+        return 0;
+    }
+    sim::advance_ms(sim::knobs().rtt_ms);
+    connected_ = true;
+    return 1;
+}
+
+void WiFiClient::stop() {
+    connected_ = false;
+    bodyRemaining_ = 0;
+    dropArmed_ = false;
+}
+
+int WiFiClient::available() { return (int)(bodyRemaining_ > 0x7fffffff ? 0x7fffffff : bodyRemaining_); }
+
+int WiFiClient::read() {
+    uint8_t b;
+    return read(&b, 1) == 1 ? b : -1;
+}
+
+int WiFiClient::read(uint8_t* buf, size_t size) {
+    if (!connected_ || bodyRemaining_ == 0) return -1;
+    if (!sim::wifi_up()) {
+        sim::advance_ms(timeoutMs_);
+        connected_ = false;
+        return -1;
+    }
+    if (dropArmed_ && dropLeft_ == 0) {
+        // Link macet: pembaca baru menyerah setelah timeout.
+        sim::advance_ms(timeoutMs_);
+        connected_ = false;
+        bodyRemaining_ = 0;
+        return -1;
+    }
+    size_t n = size < bodyRemaining_ ? size : bodyRemaining_;
+    if (dropArmed_ && n > dropLeft_) n = dropLeft_;
+    if (dropArmed_) dropLeft_ -= n;
+    if (bodyData_) {
+        memcpy(buf, bodyData_, n);
+        bodyData_ += n;
+    } else {
+        memset(buf, 0, n);
+    }
+    bodyRemaining_ -= n;
+    sim::advance_us(transfer_us(n));
+    sim::stats().http_bytes += n;
+    return (int)n;
+}
+
+size_t WiFiClient::readBytes(uint8_t* buf, size_t size) {
+    int n = read(buf, size);
+    return n > 0 ? (size_t)n : 0;
+}
+
+size_t WiFiClient::write(const uint8_t* buf, size_t size) {
+    (void)buf;
+    if (!connected_) return 0;
+    sim::advance_us(transfer_us(size));
+    return size;
+}
+
+int WiFiClientSecure::connect(const char* host, uint16_t port) { return sim_handshake(host, port, false); }
+
+// Koneksi ke port broker ikut gagal saat gangguan broker dan waktunya
+// dihitung sebagai waktu connect MQTT di laporan; HTTPS hanya butuh WiFi.
+int WiFiClientSecure::sim_handshake(const char* host, uint16_t port, bool resume) {
+    (void)host;
+    sim::Stats& s = sim::stats();
+    bool broker = port == 8883;
+    if (broker) s.mqtt_connect_attempts++;
+    uint64_t start = sim::now_ms();
+    bool ok = sim::wifi_up() && (!broker || sim::broker_up());
+    const sim::Knobs& k = sim::knobs();
+    sim::advance_ms(!ok ? k.tls_fail_ms : resume ? k.tls_resume_ms : k.tls_ms);
+    uint64_t elapsed = sim::now_ms() - start;
+    if (broker) s.mqtt_connect_ms += elapsed;
+    if (ok && resume) {
+        s.tls_resumed++;
+        s.tls_resumed_ms += elapsed;
+    } else if (ok) {
+        s.tls_full++;
+        s.tls_full_ms += elapsed;
+    }
+    connected_ = ok;
+    return ok ? 1 : 0;
+}
+
+int WiFiClientSecure::lastError(char* buf, const size_t size) {
+    snprintf(buf, size, "%s", sim::wifi_up() ? "SSL - Connection timeout (sim)" : "WiFi down (sim)");
+    return -1;
+}
+
+// ---------------- HTTP CLIENT -----------------------------
+
+bool HTTPClient::begin(const String& url) {
+    url_ = url;
+    client_ = nullptr;
+    rangeStart_ = -1;
+    contentRange_ = String();
+    size_ = -1;
+    return true;
+}
+
+void HTTPClient::end() {
+    stream_.stop();
+    if (client_) client_->stop();
+}
+
+void HTTPClient::addHeader(const String& name, const String& value) {
+    if (name == "Range" && value.startsWith("bytes=")) rangeStart_ = atol(value.c_str() + 6);
+}
+
+String HTTPClient::header(const char* name) {
+    return strcmp(name, "Content-Range") == 0 ? contentRange_ : String();
+}
+
+int HTTPClient::request(const char* method, size_t bodyBytes) {
+    (void)method;
+    sim::Stats& s = sim::stats();
+    s.http_requests++;
+    uint64_t start = sim::now_ms();
+
+    if (!sim::wifi_up()) {
+        sim::advance_ms(timeoutMs_);
+        s.http_ms += sim::now_ms() - start;
+        return HTTPC_ERROR_CONNECTION_REFUSED;
+    }
+    if (url_.startsWith("https://")) {
+        if (client_) {
+            int hostEnd = url_.indexOf('/', 8);
+            String host = url_.substring(8, hostEnd < 0 ? url_.length() : (unsigned int)hostEnd);
+            if (!client_->connected() && !client_->connect(host.c_str(), 443)) {
+                s.http_ms += sim::now_ms() - start;
+                return HTTPC_ERROR_CONNECTION_REFUSED;
+            }
+        } else {
+            sim::advance_ms(sim::knobs().tls_ms);
+            s.tls_full++;
+            s.tls_full_ms += sim::knobs().tls_ms;
+        }
+    }
+    sim::advance_ms(sim::knobs().http_ms);
+    sim::advance_us(transfer_us(bodyBytes));
+    s.http_ms += sim::now_ms() - start;
+    return sim::knobs().http_code;
+}
+
+// Body untuk URL yang berakhiran salah satu entri knob http_files
+// ("akhiran=path,..."); file dibaca sekali lalu disimpan selama simulasi.
+static const std::vector<uint8_t>* http_file_for(const String& url) {
+    static std::map<std::string, std::vector<uint8_t>> cache;
+    const char* list = sim::knobs().http_files;
+    if (!list) return nullptr;
+    std::string entries(list);
+    size_t pos = 0;
+    while (pos < entries.size()) {
+        size_t end = entries.find(',', pos);
+        if (end == std::string::npos) end = entries.size();
+        std::string entry = entries.substr(pos, end - pos);
+        pos = end + 1;
+        size_t eq = entry.find('=');
+        if (eq == std::string::npos) continue;
+        std::string suffix = entry.substr(0, eq);
+        if (!url.endsWith(String(suffix.c_str()))) continue;
+        auto it = cache.find(entry);
+        if (it == cache.end()) {
+            std::vector<uint8_t> data;
+            if (!sim::read_file(entry.c_str() + eq + 1, data)) return nullptr;
+            it = cache.emplace(entry, std::move(data)).first;
+        }
+        return &it->second;
+    }
+    return nullptr;
+}
+
+int HTTPClient::GET() {
+    int code = request("GET", 0);
+    if (code != HTTP_CODE_OK) return code;
+    const sim::Knobs& k = sim::knobs();
+    const std::vector<uint8_t>* file = http_file_for(url_);
+    size_t total = file ? file->size() : k.http_body;
+    size_t start = 0;
+    if (rangeStart_ >= 0 && k.http_range) {
+        sim::stats().http_range_requests++;
+        if ((size_t)rangeStart_ >= total) return HTTP_CODE_RANGE_NOT_SATISFIABLE;
+        start = (size_t)rangeStart_;
+        char buf[80];
+        snprintf(buf, sizeof(buf), "bytes %zu-%zu/%zu", start, total - 1, total);
+        contentRange_ = String(buf);
+        code = HTTP_CODE_PARTIAL_CONTENT;
+    }
+    size_ = (int)(total - start);
+    stream_.sim_set_body(total - start, (size_t)k.http_drop_kb * 1024, file ? file->data() + start : nullptr);
+    return code;
+}
+
+int HTTPClient::POST(uint8_t* payload, size_t size) {
+    (void)payload;
+    size_ = 2;
+    return request("POST", size);
+}
+
+String HTTPClient::getString() { return String("{}"); }
+
+String HTTPClient::errorToString(int error) {
+    switch (error) {
+        case HTTPC_ERROR_CONNECTION_REFUSED: return String("connection refused");
+        case HTTPC_ERROR_READ_TIMEOUT: return String("read Timeout");
+        default: return String("HTTP ") + String(error);
+    }
+}
+
+// ---------------- UPDATE ----------------------------------
+
+bool UpdateClass::begin(size_t size, int command) {
+    (void)command;
+    size_ = size;
+    progress_ = 0;
+    active_ = true;
+    return true;
+}
+
+size_t UpdateClass::write(uint8_t* data, size_t len) {
+    (void)data;
+    if (!active_) return 0;
+    if (progress_ + len > size_) return 0;
+    uint64_t start = sim::now_ms();
+    uint32_t kBps = sim::knobs().flash_kBps ? sim::knobs().flash_kBps : 1;
+    sim::advance_us((uint64_t)len * 1000000ULL / ((uint64_t)kBps * 1024ULL));
+    progress_ += len;
+    sim::stats().ota_bytes += len;
+    sim::stats().ota_flash_ms += sim::now_ms() - start;
+    return len;
+}
+
+bool UpdateClass::end(bool evenIfRemaining) {
+    if (!active_) return false;
+    active_ = false;
+    return evenIfRemaining || progress_ == size_;
+}
+
+void UpdateClass::abort() { active_ = false; }
+
+// Partisi app aktif: isi file knob ota_running, sisanya nol sampai 1,25 MB
+// (ukuran slot app pada tabel partisi default).
+static std::vector<uint8_t>& running_image() {
+    static std::vector<uint8_t> image;
+    static bool loaded = false;
+    if (!loaded) {
+        loaded = true;
+        if (sim::knobs().ota_running) sim::read_file(sim::knobs().ota_running, image);
+        if (image.size() < 0x140000) image.resize(0x140000, 0);
+    }
+    return image;
+}
+
+const esp_partition_t* esp_ota_get_running_partition() {
+    static esp_partition_t part = { 0x10000, 0, "app0" };
+    part.size = (uint32_t)running_image().size();
+    return &part;
+}
+
+esp_err_t esp_partition_read(const esp_partition_t* partition, size_t src_offset, void* dst, size_t size) {
+    const std::vector<uint8_t>& image = running_image();
+    if (!partition || src_offset + size > image.size()) return ESP_FAIL;
+    memcpy(dst, image.data() + src_offset, size);
+    return ESP_OK;
+}
+
+// ---------------- WEB SERVER ------------------------------
+
+static int hex_digit(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+// application/x-www-form-urlencoded: '+' = spasi, %XX = byte.
+static std::string url_decode(const std::string& in) {
+    std::string out;
+    for (size_t i = 0; i < in.size(); i++) {
+        if (in[i] == '+') {
+            out += ' ';
+        } else if (in[i] == '%' && i + 2 < in.size() && hex_digit(in[i + 1]) >= 0 && hex_digit(in[i + 2]) >= 0) {
+            out += (char)(hex_digit(in[i + 1]) * 16 + hex_digit(in[i + 2]));
+            i += 2;
+        } else {
+            out += in[i];
+        }
+    }
+    return out;
+}
+
+void WebServer::parse_args(const std::string& form) {
+    size_t pos = 0;
+    while (pos < form.size()) {
+        size_t end = form.find('&', pos);
+        if (end == std::string::npos) end = form.size();
+        std::string pair = form.substr(pos, end - pos);
+        size_t eq = pair.find('=');
+        if (!pair.empty()) {
+            args_[url_decode(pair.substr(0, eq))] = eq == std::string::npos ? "" : url_decode(pair.substr(eq + 1));
+        }
+        pos = end + 1;
+    }
+}
+
+void WebServer::handleClient() {
+    const char* method;
+    const char* line;
+    while (running_ && sim::next_due_http(&method, &line)) {
+        std::string request(line);
+        std::string body;
+        size_t space = request.find(' ');
+        if (space != std::string::npos) {
+            body = request.substr(space + 1);
+            request.resize(space);
+        }
+        args_.clear();
+        size_t query = request.find('?');
+        if (query != std::string::npos) {
+            parse_args(request.substr(query + 1));
+            request.resize(query);
+        }
+        if (strcmp(method, "POST") == 0) parse_args(body);
+
+        HTTPMethod m = strcmp(method, "POST") == 0 ? HTTP_POST : HTTP_GET;
+        request_ = std::string(method) + " " + request;
+        gzip_ = false;
+        responded_ = false;
+        bodyBytes_ = 0;
+        THandlerFunction fn = notFound_;
+        for (const Route& r : routes_) {
+            if (r.uri == request && (r.method == HTTP_ANY || r.method == m)) {
+                fn = r.fn;
+                break;
+            }
+        }
+        if (fn) {
+            fn();
+        } else {
+            send(404, "text/plain", "Not found");
+        }
+        finish_response();
+    }
+}
+
+String WebServer::arg(const String& name) {
+    auto it = args_.find(name.c_str());
+    return it == args_.end() ? String() : String(it->second.c_str());
+}
+
+void WebServer::sendHeader(const String& name, const String& value, bool first) {
+    (void)first;
+    if (strcmp(name.c_str(), "Content-Encoding") == 0 && strcmp(value.c_str(), "gzip") == 0) gzip_ = true;
+}
+
+void WebServer::send(int code, const char* contentType, const String& content) {
+    responded_ = true;
+    bodyBytes_ = content.length();
+    if (!sim::knobs().serial_echo) return;
+    printf("[http] %s -> %d %s%s", request_.c_str(), code, contentType ? contentType : "", gzip_ ? " (gzip)" : "");
+    if (content.length() > 0 && !gzip_) printf(" %s", content.c_str());
+    printf("\n");
+}
+
+void WebServer::send_P(int code, const char* contentType, const char* content, size_t len) {
+    send(code, contentType, String());
+    (void)content;
+    bodyBytes_ = len;
+}
+
+void WebServer::sendContent(const char* content, size_t len) {
+    (void)content;
+    bodyBytes_ += len;
+}
+
+void WebServer::finish_response() {
+    if (!sim::knobs().serial_echo) return;
+    if (!responded_) printf("[http] %s -> tanpa respons\n", request_.c_str());
+    else if (gzip_) printf("[http] %s body %zu B\n", request_.c_str(), bodyBytes_);
+}
+
+// ---------------- MQTT ------------------------------------
+
+bool PubSubClient::connect(const char* id) { return connect(id, nullptr, nullptr, nullptr, 0, false, nullptr); }
+
+bool PubSubClient::connect(const char* id, const char* user, const char* pass) {
+    return connect(id, user, pass, nullptr, 0, false, nullptr);
+}
+
+bool PubSubClient::connect(const char* id, const char* user, const char* pass,
+                           const char* willTopic, uint8_t willQos, bool willRetain, const char* willMessage) {
+    (void)id; (void)user; (void)pass; (void)willTopic; (void)willQos; (void)willRetain; (void)willMessage;
+    sim::Stats& s = sim::stats();
+
+    // Seperti PubSubClient asli: socket yang sudah tersambung dipakai ulang,
+    // sisanya hanya CONNECT/CONNACK satu RTT.
+    if (!client_->connected() && !client_->connect(domain_ ? domain_ : "", port_)) {
+        state_ = MQTT_CONNECT_FAILED;
+        return false;
+    }
+    uint64_t start = sim::now_ms();
+    bool ok = sim::wifi_up() && sim::broker_up();
+    sim::advance_ms(ok ? sim::knobs().rtt_ms : sim::knobs().tls_fail_ms);
+    s.mqtt_connect_ms += sim::now_ms() - start;
+
+    if (!ok) {
+        client_->stop();
+        state_ = MQTT_CONNECT_FAILED;
+        return false;
+    }
+    s.mqtt_connect_ok++;
+    state_ = MQTT_CONNECTED;
+    return true;
+}
+
+void PubSubClient::disconnect() {
+    client_->stop();
+    state_ = MQTT_DISCONNECTED;
+}
+
+bool PubSubClient::publish(const char* topic, const char* payload) {
+    return publish(topic, (const uint8_t*)payload, payload ? strlen(payload) : 0, false);
+}
+
+bool PubSubClient::publish(const char* topic, const char* payload, bool retained) {
+    return publish(topic, (const uint8_t*)payload, payload ? strlen(payload) : 0, retained);
+}
+
+bool PubSubClient::publish(const char* topic, const uint8_t* payload, unsigned int plength) {
+    return publish(topic, payload, plength, false);
+}
+
+bool PubSubClient::publish(const char* topic, const uint8_t* payload, unsigned int plength, bool retained) {
+    (void)payload; (void)retained;
+    if (!connected()) {
+        sim::stats().mqtt_publish_dropped++;
+        sim::record_publish(topic, plength, false);
+        return false;
+    }
+    // Header tetap 5 byte + panjang topik 2 byte, sama seperti PubSubClient asli.
+    if (5 + 2 + strlen(topic) + plength > bufferSize_) {
+        sim::stats().mqtt_publish_oversize++;
+        sim::record_publish(topic, plength, false);
+        return false;
+    }
+    sim::record_publish(topic, plength, true);
+    return true;
+}
+
+bool PubSubClient::subscribe(const char* topic, uint8_t qos) {
+    (void)topic; (void)qos;
+    return connected();
+}
+
+bool PubSubClient::unsubscribe(const char* topic) {
+    (void)topic;
+    return connected();
+}
+
+bool PubSubClient::connected() {
+    if (state_ == MQTT_CONNECTED && (!sim::wifi_up() || !sim::broker_up())) {
+        client_->stop();
+        state_ = MQTT_CONNECTION_LOST;
+    }
+    return state_ == MQTT_CONNECTED;
+}
+
+bool PubSubClient::loop() {
+    if (!connected()) return false;
+    const char* topic;
+    const char* payload;
+    while (sim::next_due_event(&topic, &payload)) {
+        sim::stats().mqtt_received++;
+        if (!callback_) continue;
+        // PubSubClient asli memberi buffer internal yang masih punya ruang
+        // setelah payload; firmware menulis terminator di payload[length].
+        char topicBuf[128];
+        uint8_t payloadBuf[1024];
+        unsigned int len = (unsigned int)strlen(payload);
+        if (len >= sizeof(payloadBuf)) len = sizeof(payloadBuf) - 1;
+        snprintf(topicBuf, sizeof(topicBuf), "%s", topic);
+        memcpy(payloadBuf, payload, len);
+        payloadBuf[len] = 0;
+        callback_(topicBuf, payloadBuf, len);
+    }
+    return true;
+}
@@ -0,0 +1,416 @@
+// lib/NativeSim/src/sim_rtos.cpp
+// Jam virtual dan penjadwal lockstep untuk FreeRTOS tiruan.
+//
+// Satu mutex global (g_turn) adalah "CPU": thread yang memegangnya adalah
+// satu-satunya yang menjalankan kode firmware. Menunggu (vTaskDelay, queue,
+// semaphore, delay() di task) berarti melepas giliran lewat condition
+// variable. Runner memajukan jam hanya setelah semua task yang siap jalan
+// kembali menunggu, sehingga hasil replay deterministik.
+
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <esp_timer.h>
+#include <condition_variable>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "NativeSim.h"
+
+struct SimTask {
+    TaskFunction_t fn;
+    void* param;
+    char name[16];
+    uint32_t stackDepth;
+    UBaseType_t priority;
+    uint32_t notifyValue;
+    bool notifyPending;
+    bool deleted;
+};
+
+struct SimEspTimer {
+    esp_timer_cb_t callback;
+    void* arg;
+    uint64_t due_us;
+    bool armed;
+};
+
+struct SimQueue {
+    UBaseType_t length;
+    UBaseType_t itemSize;
+    UBaseType_t count;
+    UBaseType_t head;
+    uint8_t* storage;
+};
+
+namespace sim {
+
+struct Waiter {
+    bool (*pred)(void*);
+    void* ctx;
+    uint64_t deadline_us;
+    bool woken;
+    SimTask* task;
+};
+
+struct TaskExit {};
+
+static uint64_t g_now_us = 0;
+static std::vector<SimEspTimer*> g_timers;
+static std::mutex g_turn;
+static std::condition_variable g_cv;
+static std::vector<Waiter*> g_waiters;
+static int g_runnable = 0;
+
+static thread_local std::unique_lock<std::mutex>* t_lock = nullptr;
+static thread_local SimTask* t_task = nullptr;
+
+uint64_t now_ms() { return g_now_us / 1000ULL; }
+uint64_t now_us() { return g_now_us; }
+bool in_task() { return t_task != nullptr; }
+
+void sched_begin() {
+    static std::unique_lock<std::mutex> mainLock(g_turn);
+    t_lock = &mainLock;
+}
+
+void wake_waiters() {
+    bool any = false;
+    for (Waiter* w : g_waiters) {
+        if (w->woken) continue;
+        if ((w->pred && w->pred(w->ctx)) || g_now_us >= w->deadline_us) {
+            w->woken = true;
+            g_runnable++;
+            any = true;
+        }
+    }
+    if (any) g_cv.notify_all();
+}
+
+// Runner: beri giliran ke semua task yang siap sampai semuanya menunggu lagi.
+static void settle() {
+    while (g_runnable > 0) g_cv.wait(*t_lock);
+}
+
+static uint64_t next_deadline() {
+    uint64_t next = UINT64_MAX;
+    for (Waiter* w : g_waiters) {
+        if (!w->woken && w->deadline_us < next) next = w->deadline_us;
+    }
+    for (SimEspTimer* t : g_timers) {
+        if (t->armed && t->due_us < next) next = t->due_us;
+    }
+    return next;
+}
+
+// Callback esp_timer jalan di thread runner sebelum task dibangunkan.
+static void fire_timers() {
+    for (size_t i = 0; i < g_timers.size(); i++) {
+        SimEspTimer* t = g_timers[i];
+        if (!t->armed || t->due_us > g_now_us) continue;
+        t->armed = false;
+        t->callback(t->arg);
+    }
+}
+
+// Majukan jam dari sisi loop(), berhenti di setiap deadline task di antaranya.
+static void advance_clock_to(uint64_t target) {
+    settle();
+    while (g_now_us < target) {
+        uint64_t next = next_deadline();
+        if (next > target) next = target;
+        if (next <= g_now_us) next = g_now_us + 1;
+        room_step(next - g_now_us);
+        g_now_us = next;
+        fire_timers();
+        wake_waiters();
+        settle();
+    }
+}
+
+void advance_us(uint64_t us) {
+    if (in_task()) {
+        wait_until(nullptr, nullptr, g_now_us + us);
+        return;
+    }
+    advance_clock_to(g_now_us + us);
+}
+
+bool wait_until(bool (*pred)(void*), void* ctx, uint64_t deadline_us) {
+    if (pred && pred(ctx)) return true;
+    if (!in_task()) {
+        // loop() yang menunggu = loop() memblokir; jam maju 1 ms per langkah.
+        while (g_now_us < deadline_us) {
+            uint64_t step = deadline_us - g_now_us;
+            advance_clock_to(g_now_us + (step < 1000 ? step : 1000));
+            if (pred && pred(ctx)) return true;
+        }
+        return pred ? pred(ctx) : false;
+    }
+
+    // Task lain bisa lebih dulu mengambil item yang membangunkan kita, jadi
+    // ulangi sampai pred benar atau deadline lewat, seperti FreeRTOS asli.
+    for (;;) {
+        Waiter w = {pred, ctx, deadline_us, false, t_task};
+        g_waiters.push_back(&w);
+        g_runnable--;
+        g_cv.notify_all();
+        while (!w.woken) g_cv.wait(*t_lock);
+        for (size_t i = 0; i < g_waiters.size(); i++) {
+            if (g_waiters[i] == &w) {
+                g_waiters.erase(g_waiters.begin() + i);
+                break;
+            }
+        }
+        if (t_task->deleted) throw TaskExit();
+        if (pred && pred(ctx)) return true;
+        if (g_now_us >= deadline_us) return false;
+    }
+}
+
+static uint64_t deadline_after(TickType_t ticks) {
+    return ticks == portMAX_DELAY ? UINT64_MAX : g_now_us + (uint64_t)ticks * 1000ULL;
+}
+
+static void task_main(SimTask* task) {
+    std::unique_lock<std::mutex> lock(g_turn);
+    t_lock = &lock;
+    t_task = task;
+    try {
+        task->fn(task->param);
+    } catch (const TaskExit&) {
+    }
+    g_runnable--;
+    g_cv.notify_all();
+}
+
+} // namespace sim
+
+// ---------------- TASK ------------------------------------
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t fn, const char* name, uint32_t stackDepth, void* param,
+                                   UBaseType_t priority, TaskHandle_t* handle, BaseType_t coreId) {
+    (void)coreId;
+    SimTask* task = new SimTask();
+    task->fn = fn;
+    task->param = param;
+    snprintf(task->name, sizeof(task->name), "%s", name ? name : "");
+    task->stackDepth = stackDepth;
+    task->priority = priority;
+    if (handle) *handle = task;
+    sim::g_runnable++;
+    std::thread(sim::task_main, task).detach();
+    return pdPASS;
+}
+
+BaseType_t xTaskCreate(TaskFunction_t fn, const char* name, uint32_t stackDepth, void* param,
+                       UBaseType_t priority, TaskHandle_t* handle) {
+    return xTaskCreatePinnedToCore(fn, name, stackDepth, param, priority, handle, tskNO_AFFINITY);
+}
+
+void vTaskDelete(TaskHandle_t task) {
+    if (!task || task == sim::t_task) throw sim::TaskExit();
+    task->deleted = true;
+    for (sim::Waiter* w : sim::g_waiters) {
+        if (w->task == task && !w->woken) {
+            w->woken = true;
+            sim::g_runnable++;
+        }
+    }
+    sim::g_cv.notify_all();
+}
+
+void vTaskDelay(TickType_t ticks) { sim::advance_us((uint64_t)ticks * 1000ULL); }
+
+void vTaskDelayUntil(TickType_t* previousWake, TickType_t increment) {
+    *previousWake += increment;
+    uint64_t target = (uint64_t)*previousWake * 1000ULL;
+    if (target > sim::g_now_us) sim::advance_us(target - sim::g_now_us);
+}
+
+TickType_t xTaskGetTickCount() { return (TickType_t)sim::now_ms(); }
+TaskHandle_t xTaskGetCurrentTaskHandle() { return sim::t_task; }
+UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t task) { return task ? task->stackDepth : 8192; }
+UBaseType_t uxTaskPriorityGet(TaskHandle_t task) { return task ? task->priority : 1; }
+const char* pcTaskGetName(TaskHandle_t task) { return task ? task->name : "loopTask"; }
+BaseType_t xPortGetCoreID() { return sim::in_task() ? 0 : 1; }
+
+static bool notify_pending(void* ctx) { return ((SimTask*)ctx)->notifyPending; }
+
+BaseType_t xTaskNotify(TaskHandle_t task, uint32_t value, eNotifyAction action) {
+    if (!task) return pdFAIL;
+    switch (action) {
+        case eSetBits: task->notifyValue |= value; break;
+        case eIncrement: task->notifyValue++; break;
+        case eSetValueWithOverwrite: task->notifyValue = value; break;
+        case eSetValueWithoutOverwrite:
+            if (task->notifyPending) return pdFAIL;
+            task->notifyValue = value;
+            break;
+        case eNoAction: break;
+    }
+    task->notifyPending = true;
+    sim::wake_waiters();
+    return pdPASS;
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t task) { return xTaskNotify(task, 0, eIncrement); }
+
+uint32_t ulTaskNotifyTake(BaseType_t clearOnExit, TickType_t ticks) {
+    SimTask* self = sim::t_task;
+    if (!self) return 0;
+    if (!sim::wait_until(notify_pending, self, sim::deadline_after(ticks))) return 0;
+    uint32_t value = self->notifyValue;
+    if (clearOnExit) self->notifyValue = 0;
+    else if (self->notifyValue > 0) self->notifyValue--;
+    self->notifyPending = self->notifyValue > 0;
+    return value;
+}
+
+BaseType_t xTaskNotifyWait(uint32_t clearOnEntry, uint32_t clearOnExit, uint32_t* value, TickType_t ticks) {
+    SimTask* self = sim::t_task;
+    if (!self) return pdFAIL;
+    if (!self->notifyPending) self->notifyValue &= ~clearOnEntry;
+    if (!sim::wait_until(notify_pending, self, sim::deadline_after(ticks))) return pdFAIL;
+    if (value) *value = self->notifyValue;
+    self->notifyValue &= ~clearOnExit;
+    self->notifyPending = false;
+    return pdPASS;
+}
+
+// ---------------- ESP_TIMER -------------------------------
+
+esp_err_t esp_timer_create(const esp_timer_create_args_t* args, esp_timer_handle_t* out) {
+    if (!args || !args->callback || !out) return ESP_ERR_INVALID_ARG;
+    SimEspTimer* t = new SimEspTimer{args->callback, args->arg, 0, false};
+    sim::g_timers.push_back(t);
+    *out = t;
+    return ESP_OK;
+}
+
+esp_err_t esp_timer_start_once(esp_timer_handle_t timer, uint64_t timeout_us) {
+    if (!timer) return ESP_ERR_INVALID_ARG;
+    if (timer->armed) return ESP_ERR_INVALID_STATE;
+    timer->due_us = sim::g_now_us + timeout_us;
+    timer->armed = true;
+    return ESP_OK;
+}
+
+esp_err_t esp_timer_stop(esp_timer_handle_t timer) {
+    if (!timer) return ESP_ERR_INVALID_ARG;
+    if (!timer->armed) return ESP_ERR_INVALID_STATE;
+    timer->armed = false;
+    return ESP_OK;
+}
+
+esp_err_t esp_timer_delete(esp_timer_handle_t timer) {
+    if (!timer) return ESP_ERR_INVALID_ARG;
+    if (timer->armed) return ESP_ERR_INVALID_STATE;
+    for (size_t i = 0; i < sim::g_timers.size(); i++) {
+        if (sim::g_timers[i] == timer) {
+            sim::g_timers.erase(sim::g_timers.begin() + i);
+            break;
+        }
+    }
+    delete timer;
+    return ESP_OK;
+}
+
+bool esp_timer_is_active(esp_timer_handle_t timer) { return timer && timer->armed; }
+int64_t esp_timer_get_time() { return (int64_t)sim::g_now_us; }
+
+// ---------------- QUEUE -----------------------------------
+
+static bool queue_has_item(void* ctx) { return ((SimQueue*)ctx)->count > 0; }
+static bool queue_has_space(void* ctx) {
+    SimQueue* q = (SimQueue*)ctx;
+    return q->count < q->length;
+}
+
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t itemSize) {
+    SimQueue* q = new SimQueue();
+    q->length = length;
+    q->itemSize = itemSize;
+    q->storage = itemSize ? new uint8_t[length * itemSize] : nullptr;
+    return q;
+}
+
+void vQueueDelete(QueueHandle_t queue) {
+    if (!queue) return;
+    delete[] queue->storage;
+    delete queue;
+}
+
+static BaseType_t queue_push(QueueHandle_t q, const void* item, TickType_t ticks, bool front) {
+    if (!q) return errQUEUE_FULL;
+    if (!sim::wait_until(queue_has_space, q, sim::deadline_after(ticks))) return errQUEUE_FULL;
+    UBaseType_t slot;
+    if (front) {
+        q->head = (q->head + q->length - 1) % q->length;
+        slot = q->head;
+    } else {
+        slot = (q->head + q->count) % q->length;
+    }
+    if (item && q->itemSize) memcpy(q->storage + slot * q->itemSize, item, q->itemSize);
+    q->count++;
+    sim::wake_waiters();
+    return pdPASS;
+}
+
+BaseType_t xQueueSend(QueueHandle_t queue, const void* item, TickType_t ticks) { return queue_push(queue, item, ticks, false); }
+BaseType_t xQueueSendToBack(QueueHandle_t queue, const void* item, TickType_t ticks) { return queue_push(queue, item, ticks, false); }
+BaseType_t xQueueSendToFront(QueueHandle_t queue, const void* item, TickType_t ticks) { return queue_push(queue, item, ticks, true); }
+
+BaseType_t xQueueOverwrite(QueueHandle_t queue, const void* item) {
+    if (!queue) return pdFAIL;
+    queue->count = 0;
+    queue->head = 0;
+    return queue_push(queue, item, 0, false);
+}
+
+static BaseType_t queue_pop(QueueHandle_t q, void* buffer, TickType_t ticks, bool remove) {
+    if (!q) return errQUEUE_EMPTY;
+    if (!sim::wait_until(queue_has_item, q, sim::deadline_after(ticks))) return errQUEUE_EMPTY;
+    if (q->itemSize && buffer) memcpy(buffer, q->storage + q->head * q->itemSize, q->itemSize);
+    if (remove) {
+        q->head = (q->head + 1) % q->length;
+        q->count--;
+        sim::wake_waiters();
+    }
+    return pdPASS;
+}
+
+BaseType_t xQueueReceive(QueueHandle_t queue, void* buffer, TickType_t ticks) { return queue_pop(queue, buffer, ticks, true); }
+BaseType_t xQueuePeek(QueueHandle_t queue, void* buffer, TickType_t ticks) { return queue_pop(queue, buffer, ticks, false); }
+
+BaseType_t xQueueReset(QueueHandle_t queue) {
+    if (!queue) return pdFAIL;
+    queue->count = 0;
+    queue->head = 0;
+    sim::wake_waiters();
+    return pdPASS;
+}
+
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t queue) { return queue ? queue->count : 0; }
+UBaseType_t uxQueueSpacesAvailable(QueueHandle_t queue) { return queue ? queue->length - queue->count : 0; }
+
+// ---------------- SEMAPHORE -------------------------------
+
+SemaphoreHandle_t xSemaphoreCreateMutex() {
+    SemaphoreHandle_t s = xQueueCreate(1, 0);
+    s->count = 1;
+    return s;
+}
+
+SemaphoreHandle_t xSemaphoreCreateBinary() { return xQueueCreate(1, 0); }
+
+SemaphoreHandle_t xSemaphoreCreateCounting(UBaseType_t maxCount, UBaseType_t initialCount) {
+    SemaphoreHandle_t s = xQueueCreate(maxCount, 0);
+    s->count = initialCount;
+    return s;
+}
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t sem, TickType_t ticks) { return queue_pop(sem, nullptr, ticks, true); }
+BaseType_t xSemaphoreGive(SemaphoreHandle_t sem) { return queue_push(sem, nullptr, 0, false); }
@@ -0,0 +1,94 @@
+// lib/PumpEngine/src/PumpEngine.cpp
+#include "PumpEngine.h"
+
+uint32_t PumpEngine::plan_ms(const PumpProfile& profile, float deficitPct) {
+    float seconds = profile.base_s;
+    if (deficitPct > 0) seconds += deficitPct * profile.per_pct_s;
+    if (profile.max_s && seconds > profile.max_s) seconds = profile.max_s;
+    return (uint32_t)(seconds * 1000.0f);
+}
+
+uint32_t PumpEngine::start(const PumpProfile& profile, uint32_t totalMs, uint32_t nowMs) {
+    if (phase_ != PUMP_IDLE || totalMs == 0) return 0;
+    if (profile.budget_ms) {
+        uint32_t left = usedMs_ < profile.budget_ms ? profile.budget_ms - usedMs_ : 0;
+        if (left == 0) {
+            stats_.denied++;
+            return 0;
+        }
+        if (totalMs > left) {
+            totalMs = left;
+            stats_.trimmed++;
+        }
+    }
+    // Pulsa tanpa jeda rendam sama dengan satu semburan kontinu.
+    soakMs_ = (uint32_t)profile.soak_s * 1000UL;
+    pulseMs_ = soakMs_ ? (uint32_t)profile.pulse_s * 1000UL : 0;
+    if (pulseMs_ == 0) soakMs_ = 0;
+    pendingOnMs_ = totalMs;
+    stats_.programs++;
+    begin_run(nowMs);
+    return totalMs;
+}
+
+void PumpEngine::begin_run(uint32_t nowMs) {
+    uint32_t on = pulseMs_ && pulseMs_ < pendingOnMs_ ? pulseMs_ : pendingOnMs_;
+    pendingOnMs_ -= on;
+    phase_ = PUMP_RUN;
+    phaseStart_ = nowMs;
+    phaseEnd_ = nowMs + on;
+    stats_.pulses++;
+}
+
+void PumpEngine::stop(uint32_t nowMs) {
+    if (phase_ == PUMP_RUN) usedMs_ += nowMs - phaseStart_;
+    phase_ = PUMP_IDLE;
+    pendingOnMs_ = 0;
+}
+
+bool PumpEngine::update(uint32_t nowMs) {
+    if (phase_ == PUMP_IDLE || (int32_t)(nowMs - phaseEnd_) < 0) return false;
+    if (phase_ == PUMP_SOAK) {
+        begin_run(nowMs);
+        return true;
+    }
+    // Pemakaian dihitung dari waktu aktual, termasuk bila update() telat.
+    usedMs_ += nowMs - phaseStart_;
+    if (pendingOnMs_ == 0) {
+        phase_ = PUMP_IDLE;
+        return true;
+    }
+    phase_ = PUMP_SOAK;
+    phaseStart_ = nowMs;
+    phaseEnd_ = nowMs + soakMs_;
+    return true;
+}
+
+uint32_t PumpEngine::until_next(uint32_t nowMs) const {
+    if (phase_ == PUMP_IDLE) return UINT32_MAX;
+    int32_t left = (int32_t)(phaseEnd_ - nowMs);
+    return left > 0 ? (uint32_t)left : 0;
+}
+
+uint32_t PumpEngine::remaining_ms(uint32_t nowMs) const {
+    if (phase_ == PUMP_IDLE) return 0;
+    uint32_t total = until_next(nowMs) + pendingOnMs_;
+    if (pendingOnMs_ && soakMs_) {
+        // Jeda rendam di antara pulsa yang tersisa.
+        uint32_t pulsesLeft = (pendingOnMs_ + pulseMs_ - 1) / pulseMs_;
+        total += (phase_ == PUMP_RUN ? pulsesLeft : pulsesLeft - 1) * soakMs_;
+    }
+    return total;
+}
+
+bool PumpEngine::roll_day(int32_t day) {
+    if (day == day_) return false;
+    day_ = day;
+    usedMs_ = 0;
+    return true;
+}
+
+void PumpEngine::restore(int32_t day, uint32_t usedMs) {
+    day_ = day;
+    usedMs_ = usedMs;
+}
@@ -0,0 +1,78 @@
+// lib/PumpEngine/src/PumpEngine.h
+#pragma once
+
+// ==========================================================
+// ==      PROGRAM SIRAM: DURASI, PULSA/RENDAM, BUDGET      ==
+// ==========================================================
+// Satu siraman = total on-time yang dipecah menjadi pulsa (on pulse_s,
+// rendam soak_s, ulang) agar air sempat meresap ke baglog alih-alih
+// menetes ke lantai. Durasi auto dihitung dari defisit kelembapan, dan
+// total on-time per hari dibatasi budget.
+//
+// Tidak menyentuh GPIO dan tidak menunggu: pemilik relay memanggil update()
+// ketika until_next() habis lalu menyalin relay() ke pin. Semua perbandingan
+// waktu aman terhadap wraparound millis().
+
+#include <Arduino.h>
+
+struct PumpProfile {
+    uint16_t base_s;               // durasi manual, dan auto pada defisit 0
+    uint16_t per_pct_s;            // tambahan detik per 1 %RH di bawah ambang kritis
+    uint16_t max_s;                // batas total on-time satu siraman
+    uint16_t pulse_s;              // 0 = satu semburan kontinu
+    uint16_t soak_s;               // jeda rendam antar pulsa; 0 = kontinu juga
+    uint32_t budget_ms;            // on-time maksimum per hari, 0 = tanpa batas
+};
+
+enum PumpPhase : uint8_t { PUMP_IDLE, PUMP_RUN, PUMP_SOAK };
+
+struct PumpStats {
+    uint32_t programs;             // siraman yang dimulai
+    uint32_t pulses;
+    uint32_t trimmed;              // dipangkas karena sisa budget
+    uint32_t denied;               // ditolak karena budget habis
+};
+
+class PumpEngine {
+public:
+    // Total on-time untuk defisit (ambang kritis - kelembapan, %RH).
+    static uint32_t plan_ms(const PumpProfile& profile, float deficitPct);
+
+    // Mulai program totalMs on-time. Mengembalikan on-time yang disetujui:
+    // bisa lebih kecil (sisa budget) atau 0 (sedang jalan / budget habis).
+    uint32_t start(const PumpProfile& profile, uint32_t totalMs, uint32_t nowMs);
+    void stop(uint32_t nowMs);
+    // Menjalankan transisi yang sudah jatuh tempo; true bila relay() berubah.
+    // Tiap fase RUN selalu diikuti SOAK atau IDLE, sehingga setiap pulsa
+    // baru berarti relay() berubah dari false ke true.
+    bool update(uint32_t nowMs);
+
+    PumpPhase phase() const { return phase_; }
+    bool active() const { return phase_ != PUMP_IDLE; }
+    bool relay() const { return phase_ == PUMP_RUN; }
+    // ms sampai transisi berikutnya (0 = sudah jatuh tempo); UINT32_MAX bila idle.
+    uint32_t until_next(uint32_t nowMs) const;
+    // ms sampai program selesai, termasuk jeda rendam yang tersisa.
+    uint32_t remaining_ms(uint32_t nowMs) const;
+
+    // Budget harian. day = indeks hari lokal; true bila hari berganti dan
+    // pemakaian direset.
+    bool roll_day(int32_t day);
+    void restore(int32_t day, uint32_t usedMs);
+    int32_t day() const { return day_; }
+    uint32_t used_ms() const { return usedMs_; }
+    const PumpStats& stats() const { return stats_; }
+
+private:
+    void begin_run(uint32_t nowMs);
+
+    PumpPhase phase_ = PUMP_IDLE;
+    uint32_t phaseStart_ = 0;
+    uint32_t phaseEnd_ = 0;
+    uint32_t pendingOnMs_ = 0;     // on-time yang belum dijalankan
+    uint32_t pulseMs_ = 0;
+    uint32_t soakMs_ = 0;
+    int32_t day_ = -1;
+    uint32_t usedMs_ = 0;          // on-time aktual hari ini (pulsa yang sudah selesai)
+    PumpStats stats_ = {};
+};
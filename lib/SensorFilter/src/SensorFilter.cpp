@@ -0,0 +1,53 @@
+// lib/SensorFilter/src/SensorFilter.cpp
+#include "SensorFilter.h"
+
+SensorFilter::SensorFilter(float minValid, float maxValid, float maxJump, float emaAlpha)
+    : minValid_(minValid), maxValid_(maxValid), maxJump_(maxJump), alpha_(emaAlpha) {}
+
+bool SensorFilter::push(float value) {
+    if (isnan(value) || value < minValid_ || value > maxValid_) {
+        rejected_++;
+        return false;
+    }
+    // Butuh beberapa sampel sebelum median cukup kuat untuk menolak.
+    if (count_ >= 3 && fabsf(value - median()) > maxJump_) {
+        if (++outlierRun_ < kStepConfirm) {
+            rejected_++;
+            return false;
+        }
+        count_ = 0;
+        head_ = 0;
+        ema_ = NAN;
+    }
+    outlierRun_ = 0;
+    accept(value);
+    return true;
+}
+
+void SensorFilter::reset() {
+    count_ = 0;
+    head_ = 0;
+    outlierRun_ = 0;
+    ema_ = NAN;
+}
+
+void SensorFilter::accept(float value) {
+    window_[head_] = value;
+    head_ = (head_ + 1) % kWindow;
+    if (count_ < kWindow) count_++;
+    float m = median();
+    ema_ = isnan(ema_) ? m : ema_ + alpha_ * (m - ema_);
+}
+
+float SensorFilter::median() const {
+    if (count_ == 0) return NAN;
+    float sorted[kWindow];
+    memcpy(sorted, window_, sizeof(float) * count_);
+    for (uint8_t i = 1; i < count_; i++) {
+        float v = sorted[i];
+        uint8_t j = i;
+        for (; j > 0 && sorted[j - 1] > v; j--) sorted[j] = sorted[j - 1];
+        sorted[j] = v;
+    }
+    return count_ % 2 ? sorted[count_ / 2] : (sorted[count_ / 2 - 1] + sorted[count_ / 2]) / 2;
+}
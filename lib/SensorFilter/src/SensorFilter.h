@@ -0,0 +1,45 @@
+// lib/SensorFilter/src/SensorFilter.h
+#pragma once
+
+// ==========================================================
+// ==      FILTER SENSOR: MEDIAN + EMA, TOLAK OUTLIER       ==
+// ==========================================================
+// Sampel di luar rentang fisik ditolak. Sampel yang menyimpang lebih dari
+// maxJump dari median jendela juga ditolak, kecuali kStepConfirm sampel
+// berturut-turut menyimpang: itu dianggap perubahan nyata (pintu kumbung
+// dibuka, pompa menyala) dan jendela diisi ulang dari sampel baru.
+// Keluaran = EMA dari median jendela, sehingga satu spike DHT11 tidak
+// pernah sampai ke logika pompa atau notifikasi.
+
+#include <Arduino.h>
+
+class SensorFilter {
+public:
+    static const uint8_t kWindow = 5;
+    static const uint8_t kStepConfirm = 3;
+
+    SensorFilter(float minValid, float maxValid, float maxJump, float emaAlpha);
+
+    // false bila sampel ditolak (tidak mengubah keluaran).
+    bool push(float value);
+    void reset();
+
+    bool ready() const { return count_ > 0; }
+    float value() const { return ema_; }
+    float median() const;
+    uint32_t rejected() const { return rejected_; }
+
+private:
+    void accept(float value);
+
+    float minValid_;
+    float maxValid_;
+    float maxJump_;
+    float alpha_;
+    float window_[kWindow];
+    uint8_t count_ = 0;
+    uint8_t head_ = 0;
+    uint8_t outlierRun_ = 0;
+    float ema_ = NAN;
+    uint32_t rejected_ = 0;
+};
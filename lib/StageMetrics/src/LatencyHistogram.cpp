@@ -0,0 +1,45 @@
+// lib/StageMetrics/src/LatencyHistogram.cpp
+#include "LatencyHistogram.h"
+
+#include <string.h>
+
+uint8_t LatencyHistogram::index(uint32_t v) {
+    if (v < kSub) return (uint8_t)v;
+    uint8_t msb = 31 - __builtin_clz(v);
+    if (msb > kMaxBit) return kBuckets - 1;
+    uint8_t sub = (uint8_t)((v >> (msb - kSubBits)) & (kSub - 1));
+    return (uint8_t)((msb - kSubBits + 1) * kSub + sub);
+}
+
+uint32_t LatencyHistogram::upper(uint8_t i) {
+    if (i < kSub) return i;
+    uint8_t msb = i / kSub + kSubBits - 1;
+    uint32_t sub = i % kSub;
+    return ((kSub + sub + 1) << (msb - kSubBits)) - 1;
+}
+
+void LatencyHistogram::record(uint32_t us) {
+    buckets_[index(us)]++;
+    count_++;
+    sum_ += us;
+    if (us > max_) max_ = us;
+}
+
+void LatencyHistogram::reset() {
+    memset(buckets_, 0, sizeof(buckets_));
+    count_ = 0;
+    max_ = 0;
+    sum_ = 0;
+}
+
+uint32_t LatencyHistogram::percentile(float p) const {
+    if (!count_) return 0;
+    uint32_t target = (uint32_t)(p / 100.0f * (float)count_);
+    if (target >= count_) target = count_ - 1;
+    uint32_t seen = 0;
+    for (uint8_t i = 0; i < kBuckets; i++) {
+        seen += buckets_[i];
+        if (seen > target) return upper(i) < max_ ? upper(i) : max_;
+    }
+    return max_;
+}
@@ -0,0 +1,38 @@
+// lib/StageMetrics/src/LatencyHistogram.h
+#pragma once
+
+// ==========================================================
+// ==     HISTOGRAM LATENCY (GAYA HDR) DI MEMORI STATIS     ==
+// ==========================================================
+// Log-linear: 4 sub-bucket per oktaf (2 bit signifikan, resolusi relatif
+// <= 25%), nilai dalam mikrodetik sampai ~67 detik. Di atas itu masuk
+// bucket terakhir, tetapi max tetap tercatat tepat. Ukuran tetap ~430 B,
+// tanpa heap. Tidak thread-safe: pemanggil yang mengunci.
+
+#include <stdint.h>
+
+class LatencyHistogram {
+public:
+    static const uint8_t kSubBits = 2;
+    static const uint8_t kSub = 1 << kSubBits;
+    static const uint8_t kMaxBit = 26;
+    static const uint8_t kBuckets = (kMaxBit - kSubBits + 2) * kSub;
+
+    void record(uint32_t us);
+    void reset();
+
+    uint32_t count() const { return count_; }
+    uint32_t max() const { return max_; }
+    uint32_t mean() const { return count_ ? (uint32_t)(sum_ / count_) : 0; }
+    // Batas atas bucket yang memuat persentil p (0-100), dibatasi max().
+    uint32_t percentile(float p) const;
+
+private:
+    static uint8_t index(uint32_t v);
+    static uint32_t upper(uint8_t i);
+
+    uint32_t buckets_[kBuckets] = {0};
+    uint32_t count_ = 0;
+    uint32_t max_ = 0;
+    uint64_t sum_ = 0;
+};
@@ -0,0 +1,195 @@
+// lib/TimeSync/src/TimeSync.cpp
+#include "TimeSync.h"
+
+#include <Preferences.h>
+#include <esp_attr.h>
+#include <esp_sntp.h>
+#include <sys/time.h>
+
+static const char* TIME_NVS_NAMESPACE = "jamur-time";
+
+// Drift baru diukur dari selang >= 10 menit agar jitter respons NTP (puluhan
+// ms) tidak mendominasi, dan paling lama 30 hari karena millis() 32-bit.
+static const uint32_t DRIFT_MIN_SPAN_MS = 10UL * 60UL * 1000UL;
+static const uint32_t DRIFT_MAX_SPAN_MS = 30UL * 24UL * 3600UL * 1000UL;
+// Kristal ESP32 di kisaran +-40 ppm; lebih dari ini berarti server NTP
+// sendiri yang melompat, bukan drift.
+static const float DRIFT_MAX_PPM = 500.0f;
+static const float DRIFT_ALPHA = 0.25f;
+// EWMA drift belum tentu konvergen; galat dihitung sedikit lebih pesimis.
+static const float DRIFT_MARGIN_PPM = 2.0f;
+// Ketidakpastian satu sinkron SNTP (setengah RTT plus resolusi).
+static const uint32_t SYNC_BASE_ERROR_MS = 100;
+
+// RTC slow memory tidak diinisialisasi ulang saat soft reset tetapi acak
+// setelah power-on; magic di sini menandai jam sistem sudah disinkron NTP
+// sejak daya masuk, bukan hanya dipulihkan dari NVS.
+static const uint32_t RTC_SYNCED_MAGIC = 0x4A4E5450;   // "JNTP"
+static RTC_NOINIT_ATTR uint32_t rtcSyncedMagic;
+
+// Callback SNTP berjalan di task tcpip; hasilnya dititipkan ke loop().
+static portMUX_TYPE syncMux = portMUX_INITIALIZER_UNLOCKED;
+static bool syncPending = false;
+static int64_t syncEpochMs = 0;
+static uint32_t syncAtMs = 0;
+
+void TimeSync::begin(long gmtOffsetSec, int dstOffsetSec, const char* lanServer, const char* poolServer) {
+    gmtOffsetSec_ = gmtOffsetSec;
+    dstOffsetSec_ = dstOffsetSec;
+    strlcpy(lan_, lanServer ? lanServer : "", sizeof(lan_));
+    strlcpy(pool_, poolServer ? poolServer : "", sizeof(pool_));
+
+    uint32_t known = 0;
+    Preferences prefs;
+    if (prefs.begin(TIME_NVS_NAMESPACE, true)) {
+        known = prefs.getUInt("known", 0);
+        lastSyncEpoch_ = prefs.getUInt("sync", 0);
+        driftPpm_ = prefs.getFloat("ppm", 0.0f);
+        driftSamples_ = (uint16_t)prefs.getUInt("ppm_n", 0);
+        prefs.end();
+    }
+    if (isnan(driftPpm_)) driftSamples_ = 0;
+    if (driftSamples_ == 0) driftPpm_ = 0;
+
+    uint32_t now = (uint32_t)time(nullptr);
+    if (now >= kValidEpoch) {
+        bool synced = rtcSyncedMagic == RTC_SYNCED_MAGIC && lastSyncEpoch_ && lastSyncEpoch_ <= now;
+        quality_ = synced ? TIME_SYNCED : TIME_RESTORED;
+        if (quality_ == TIME_SYNCED && error_ms(age_sec(now)) > maxErrorMs_) quality_ = TIME_STALE;
+    } else if (known >= kValidEpoch) {
+        rtcSyncedMagic = 0;
+        struct timeval tv = { (time_t)known, 0 };
+        settimeofday(&tv, nullptr);
+        quality_ = TIME_RESTORED;
+        now = known;
+    }
+    persistedAt_ = now;
+
+    sntp_set_time_sync_notification_cb(on_sync);
+    sntp_set_sync_interval(syncIntervalMs_);
+    start_sntp();
+}
+
+void TimeSync::set_lan_server(const char* lanServer) {
+    if (strcmp(lan_, lanServer) == 0) return;
+    // Hentikan dulu: lwIP bisa sedang membaca nama server lama.
+    sntp_stop();
+    strlcpy(lan_, lanServer, sizeof(lan_));
+    start_sntp();
+}
+
+void TimeSync::start_sntp() {
+    // configTime() menghentikan SNTP yang sedang jalan lalu memulai ulang;
+    // lwIP pindah ke server berikutnya bila server pertama tidak menjawab.
+    if (lan_[0]) {
+        configTime(gmtOffsetSec_, dstOffsetSec_, lan_, pool_);
+    } else {
+        configTime(gmtOffsetSec_, dstOffsetSec_, pool_);
+    }
+}
+
+void TimeSync::on_sync(struct timeval* tv) {
+    uint32_t at = millis();
+    portENTER_CRITICAL(&syncMux);
+    syncEpochMs = (int64_t)tv->tv_sec * 1000 + tv->tv_usec / 1000;
+    syncAtMs = at;
+    syncPending = true;
+    portEXIT_CRITICAL(&syncMux);
+}
+
+bool TimeSync::loop() {
+    TimeQuality before = quality_;
+    bool pending = false;
+    int64_t epochMs = 0;
+    uint32_t atMs = 0;
+    portENTER_CRITICAL(&syncMux);
+    if (syncPending) {
+        pending = true;
+        epochMs = syncEpochMs;
+        atMs = syncAtMs;
+        syncPending = false;
+    }
+    portEXIT_CRITICAL(&syncMux);
+    if (pending) handle_sync(epochMs, atMs);
+
+    uint32_t now = (uint32_t)time(nullptr);
+    if (quality_ == TIME_SYNCED && error_ms(age_sec(now)) > maxErrorMs_) quality_ = TIME_STALE;
+    if (quality_ != TIME_UNSET && now - persistedAt_ >= persistSec_) persist(now);
+    return quality_ != before;
+}
+
+// Perkiraan jam lokal = hasil NTP terakhir + millis() sejak itu. Selisihnya
+// dengan hasil NTP sekarang adalah drift kristal selama selang tersebut.
+void TimeSync::handle_sync(int64_t epochMs, uint32_t atMs) {
+    if (epochMs < (int64_t)kValidEpoch * 1000) return;
+    lastOffsetMs_ = 0;
+    if (syncedThisBoot_) {
+        uint32_t spanMs = atMs - lastSyncAtMs_;
+        int64_t offset = epochMs - (lastSyncEpochMs_ + spanMs);
+        lastOffsetMs_ = (int32_t)constrain(offset, (int64_t)INT32_MIN, (int64_t)INT32_MAX);
+        if (spanMs >= DRIFT_MIN_SPAN_MS && spanMs <= DRIFT_MAX_SPAN_MS) {
+            float ppm = -(float)offset * 1e6f / (float)spanMs;
+            if (fabsf(ppm) <= DRIFT_MAX_PPM) {
+                driftPpm_ = driftSamples_ ? driftPpm_ + (ppm - driftPpm_) * DRIFT_ALPHA : ppm;
+                if (driftSamples_ < 0xFFFF) driftSamples_++;
+            }
+        }
+    }
+    bool first = !syncedThisBoot_;
+    syncedThisBoot_ = true;
+    lastSyncEpochMs_ = epochMs;
+    lastSyncAtMs_ = atMs;
+    lastSyncEpoch_ = (uint32_t)(epochMs / 1000);
+    syncs_++;
+    quality_ = TIME_SYNCED;
+    rtcSyncedMagic = RTC_SYNCED_MAGIC;
+    // Batas bawah di NVS langsung diperbarui pada sinkron pertama; sisanya
+    // mengikuti jadwal persistSec_.
+    if (first) persist(lastSyncEpoch_);
+}
+
+uint32_t TimeSync::age_sec(uint32_t now) const {
+    if (syncedThisBoot_) return (millis() - lastSyncAtMs_) / 1000UL;
+    return lastSyncEpoch_ && now > lastSyncEpoch_ ? now - lastSyncEpoch_ : 0;
+}
+
+uint32_t TimeSync::error_ms(uint32_t ageSec) const {
+    float ppm = driftSamples_ ? fabsf(driftPpm_) + DRIFT_MARGIN_PPM : assumedPpm_;
+    // ppm * 1e-6 * detik * 1000 ms
+    float ms = SYNC_BASE_ERROR_MS + ppm * (float)ageSec / 1000.0f;
+    return ms >= 4.0e9f ? 0xFFFFFFFFUL : (uint32_t)ms;
+}
+
+void TimeSync::persist(uint32_t now) {
+    persistedAt_ = now;
+    Preferences prefs;
+    if (!prefs.begin(TIME_NVS_NAMESPACE, false)) return;
+    prefs.putUInt("known", now);
+    prefs.putUInt("sync", lastSyncEpoch_);
+    prefs.putFloat("ppm", driftPpm_);
+    prefs.putUInt("ppm_n", driftSamples_);
+    prefs.end();
+}
+
+TimeSyncStatus TimeSync::status() const {
+    TimeSyncStatus s = {};
+    s.quality = quality_;
+    s.syncs = syncs_;
+    if (quality_ == TIME_SYNCED || quality_ == TIME_STALE) {
+        s.ageSec = age_sec((uint32_t)time(nullptr));
+        s.errorMs = error_ms(s.ageSec);
+    }
+    s.lastOffsetMs = lastOffsetMs_;
+    s.driftPpm = driftPpm_;
+    s.driftSamples = driftSamples_;
+    return s;
+}
+
+const char* TimeSync::quality_name(TimeQuality quality) {
+    switch (quality) {
+        case TIME_RESTORED: return "restored";
+        case TIME_SYNCED: return "synced";
+        case TIME_STALE: return "stale";
+        default: return "unset";
+    }
+}
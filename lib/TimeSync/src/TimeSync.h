@@ -0,0 +1,97 @@
+// lib/TimeSync/src/TimeSync.h
+#pragma once
+
+// ==========================================================
+// ==      SINKRON WAKTU SNTP DI LATAR BELAKANG + DRIFT     ==
+// ==========================================================
+// SNTP milik lwIP sudah berjalan sendiri setelah configTime(); yang dulu
+// memblokir hanyalah loop menunggu getLocalTime(). TimeSync tidak pernah
+// menunggu: begin() memulihkan jam lalu menyalakan SNTP, loop() (dari
+// network_task) mengolah hasil sinkron yang dicatat callback SNTP.
+//
+// Tiap sinkron dibandingkan dengan perkiraan jam lokal sejak sinkron
+// sebelumnya (millis() dan jam sistem sama-sama dari kristal 40 MHz),
+// sehingga selisihnya adalah drift kristal. Dari drift itu galat jam saat
+// NTP tidak terjangkau diperkirakan; trusted() hanya benar selama galat
+// masih di bawah batas.
+//
+// NVS namespace "jamur-time": waktu terakhir yang diketahui, epoch sinkron
+// terakhir dan estimasi drift. Setelah power-on jam dipulihkan dari sana
+// sebagai batas bawah (TIME_RESTORED, tidak dipercaya). Setelah soft reset
+// (OTA, ESP.restart) jam RTC ESP32 tetap berjalan, jadi status sinkron
+// sebelumnya masih berlaku, asalkan penanda di RTC_NOINIT_ATTR menunjukkan
+// jam pernah disinkron NTP sejak power-on (bukan hanya dipulihkan dari NVS).
+
+#include <Arduino.h>
+
+enum TimeQuality : uint8_t {
+    TIME_UNSET,                    // jam masih menghitung dari 1970
+    TIME_RESTORED,                 // dari NVS: tertinggal selama perangkat mati
+    TIME_SYNCED,                   // sinkron NTP, perkiraan galat di bawah batas
+    TIME_STALE                     // pernah sinkron, tetapi galat sudah melewati batas
+};
+
+struct TimeSyncStatus {
+    TimeQuality quality;
+    uint32_t syncs;                // sinkron sukses sejak boot
+    uint32_t ageSec;               // detik sejak sinkron terakhir; 0 = belum pernah
+    int32_t lastOffsetMs;          // NTP - perkiraan jam lokal pada sinkron terakhir
+    float driftPpm;                // positif = jam lokal lebih cepat dari NTP
+    uint16_t driftSamples;
+    uint32_t errorMs;              // perkiraan galat jam saat ini; 0 = belum pernah
+};
+
+class TimeSync {
+public:
+    static const size_t kMaxServer = 40;
+    // 2022-01-01: jam di bawah ini pasti belum pernah diset.
+    static const uint32_t kValidEpoch = 1640995200UL;
+
+    // maxErrorMs: batas galat agar trusted(). assumedPpm: drift yang dipakai
+    // sebelum ada pengukuran. persistSec: jarak minimum tulis NVS.
+    TimeSync(uint32_t maxErrorMs, float assumedPpm, uint32_t syncIntervalMs, uint32_t persistSec)
+        : maxErrorMs_(maxErrorMs), assumedPpm_(assumedPpm), syncIntervalMs_(syncIntervalMs), persistSec_(persistSec) {}
+
+    // Memulihkan jam dari RTC/NVS lalu menyalakan SNTP. lanServer (boleh
+    // kosong) dicoba lebih dulu, poolServer sebagai cadangan.
+    void begin(long gmtOffsetSec, int dstOffsetSec, const char* lanServer, const char* poolServer);
+    // Ganti server LAN saat berjalan; SNTP dinyalakan ulang hanya bila berubah.
+    void set_lan_server(const char* lanServer);
+    // Mengembalikan true bila quality() berubah.
+    bool loop();
+
+    TimeQuality quality() const { return quality_; }
+    bool trusted() const { return quality_ == TIME_SYNCED; }
+    TimeSyncStatus status() const;
+    const char* lan_server() const { return lan_; }
+
+    static const char* quality_name(TimeQuality quality);
+
+private:
+    static void on_sync(struct timeval* tv);
+    void start_sntp();
+    void handle_sync(int64_t epochMs, uint32_t atMs);
+    uint32_t error_ms(uint32_t ageSec) const;
+    uint32_t age_sec(uint32_t now) const;
+    void persist(uint32_t now);
+
+    uint32_t maxErrorMs_;
+    float assumedPpm_;
+    uint32_t syncIntervalMs_;
+    uint32_t persistSec_;
+    long gmtOffsetSec_ = 0;
+    int dstOffsetSec_ = 0;
+    // lwIP hanya menyimpan pointer nama server, jadi salinannya tinggal di sini.
+    char lan_[kMaxServer] = {0};
+    char pool_[kMaxServer] = {0};
+    volatile TimeQuality quality_ = TIME_UNSET;
+    uint32_t syncs_ = 0;
+    uint32_t lastSyncEpoch_ = 0;   // dari NVS, berlaku lintas soft reset
+    bool syncedThisBoot_ = false;
+    int64_t lastSyncEpochMs_ = 0;
+    uint32_t lastSyncAtMs_ = 0;    // millis() saat sinkron terakhir
+    int32_t lastOffsetMs_ = 0;
+    float driftPpm_ = 0;
+    uint16_t driftSamples_ = 0;
+    uint32_t persistedAt_ = 0;     // epoch tulis NVS terakhir
+};
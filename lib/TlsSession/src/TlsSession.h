@@ -0,0 +1,88 @@
+// lib/TlsSession/src/TlsSession.h
+#pragma once
+
+// ==========================================================
+// ==      RESUMPTION SESI TLS UNTUK WiFiClientSecure       ==
+// ==========================================================
+// TlsSessionClient menyimpan sesi mbedTLS (ticket atau session ID) setelah
+// handshake penuh dan memakainya lagi pada connect berikutnya ke host yang
+// sama, sehingga reconnect cukup handshake singkat tanpa verifikasi X.509
+// dan tanpa pertukaran kunci publik. Bila server menolak sesi, mbedTLS
+// otomatis jatuh ke handshake penuh.
+//
+// Sesi berisi master secret. Persistensi NVS (nvsKey != nullptr) berarti
+// rahasia itu tersimpan di flash; matikan bila flash tidak terenkripsi dan
+// perangkat mudah diakses fisik.
+
+#include <Arduino.h>
+#include <WiFiClientSecure.h>
+
+struct TlsSessionStats {
+    uint32_t full;
+    uint32_t resumed;
+    uint32_t failed;
+    uint32_t full_ms_total;
+    uint32_t resumed_ms_total;
+    uint32_t last_full_ms;
+    uint32_t last_resumed_ms;
+};
+
+class TlsSessionCache {
+public:
+    // Serialisasi sesi mbedTLS ikut memuat sertifikat peer (~1.5 kB untuk HiveMQ).
+    static const size_t kMaxSession = 2560;
+    static const size_t kMaxHost = 64;
+
+    // nvsKey (<= 12 karakter) = nama slot di namespace "jamur-tls"; nullptr = hanya RAM.
+    TlsSessionCache(const char* nvsKey, uint32_t lifetimeSec) : nvsKey_(nvsKey), lifetimeSec_(lifetimeSec) {}
+
+    // Memuat sesi dari NVS (bila dipakai). Selama jam masih di belakang
+    // waktu simpan (belum sinkron NTP) valid_for() menolak sesi itu.
+    void begin();
+    bool valid_for(const char* host) const;
+    const uint8_t* data() const { return data_; }
+    size_t length() const { return length_; }
+    // full=true: sesi baru dari handshake penuh, umur dihitung ulang dan disimpan
+    // ke NVS. full=false: hanya salinan RAM diperbarui (mis. ticket baru setelah
+    // resume) tanpa memperpanjang umur sesi.
+    void store(const char* host, const uint8_t* data, size_t length, bool full);
+    void clear();
+
+    void record(bool resumed, uint32_t ms);
+    void record_failure() { stats_.failed++; }
+    const TlsSessionStats& stats() const { return stats_; }
+
+private:
+    struct Header {
+        char host[kMaxHost];
+        uint32_t savedAt;
+        uint16_t length;
+    };
+
+    void save_nvs();
+
+    const char* nvsKey_;
+    uint32_t lifetimeSec_;
+    char host_[kMaxHost] = {0};
+    uint32_t savedAt_ = 0;
+    uint16_t length_ = 0;
+    uint8_t data_[kMaxSession];
+    TlsSessionStats stats_ = {};
+};
+
+class TlsSessionClient : public WiFiClientSecure {
+public:
+    TlsSessionClient() {}
+    explicit TlsSessionClient(TlsSessionCache* cache) : cache_(cache) {}
+
+    void setSessionCache(TlsSessionCache* cache) { cache_ = cache; }
+    TlsSessionCache* sessionCache() const { return cache_; }
+
+    using WiFiClientSecure::connect;
+    // Tanpa cache, atau dengan mode autentikasi selain CA/insecure, jatuh ke
+    // WiFiClientSecure::connect biasa.
+    int connect(const char* host, uint16_t port) override;
+
+private:
+    TlsSessionCache* cache_ = nullptr;
+};
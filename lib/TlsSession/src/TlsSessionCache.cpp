@@ -0,0 +1,83 @@
+// lib/TlsSession/src/TlsSessionCache.cpp
+#include "TlsSession.h"
+
+#include <Preferences.h>
+#include <time.h>
+
+static const char* TLS_NVS_NAMESPACE = "jamur-tls";
+
+void TlsSessionCache::begin() {
+    if (!nvsKey_) return;
+    Preferences prefs;
+    if (!prefs.begin(TLS_NVS_NAMESPACE, true)) return;
+    char dataKey[16];
+    snprintf(dataKey, sizeof(dataKey), "%s_d", nvsKey_);
+    Header header;
+    if (prefs.getBytes(nvsKey_, &header, sizeof(header)) == sizeof(header) &&
+        header.length > 0 && header.length <= kMaxSession &&
+        prefs.getBytes(dataKey, data_, header.length) == header.length) {
+        memcpy(host_, header.host, kMaxHost);
+        host_[kMaxHost - 1] = '\0';
+        savedAt_ = header.savedAt;
+        length_ = header.length;
+    }
+    prefs.end();
+}
+
+bool TlsSessionCache::valid_for(const char* host) const {
+    if (length_ == 0 || strcmp(host, host_) != 0) return false;
+    uint32_t now = (uint32_t)time(nullptr);
+    return now >= savedAt_ && now - savedAt_ < lifetimeSec_;
+}
+
+void TlsSessionCache::store(const char* host, const uint8_t* data, size_t length, bool full) {
+    if (length == 0 || length > kMaxSession) return;
+    if (!full && strcmp(host, host_) != 0) return;
+    strlcpy(host_, host, sizeof(host_));
+    memcpy(data_, data, length);
+    length_ = (uint16_t)length;
+    if (!full) return;
+    savedAt_ = (uint32_t)time(nullptr);
+    save_nvs();
+}
+
+void TlsSessionCache::clear() {
+    if (length_ == 0) return;
+    length_ = 0;
+    host_[0] = '\0';
+    save_nvs();
+}
+
+void TlsSessionCache::record(bool resumed, uint32_t ms) {
+    if (resumed) {
+        stats_.resumed++;
+        stats_.resumed_ms_total += ms;
+        stats_.last_resumed_ms = ms;
+    } else {
+        stats_.full++;
+        stats_.full_ms_total += ms;
+        stats_.last_full_ms = ms;
+    }
+}
+
+// Dipanggil setelah handshake penuh atau saat sesi dibuang, jadi penulisan
+// flash sebanding dengan jumlah handshake mahal, bukan jumlah reconnect.
+void TlsSessionCache::save_nvs() {
+    if (!nvsKey_) return;
+    Preferences prefs;
+    if (!prefs.begin(TLS_NVS_NAMESPACE, false)) return;
+    char dataKey[16];
+    snprintf(dataKey, sizeof(dataKey), "%s_d", nvsKey_);
+    if (length_ == 0) {
+        prefs.remove(nvsKey_);
+        prefs.remove(dataKey);
+    } else {
+        Header header = {};
+        memcpy(header.host, host_, kMaxHost);
+        header.savedAt = savedAt_;
+        header.length = length_;
+        prefs.putBytes(dataKey, data_, length_);
+        prefs.putBytes(nvsKey_, &header, sizeof(header));
+    }
+    prefs.end();
+}
@@ -0,0 +1,177 @@
+// lib/TlsSession/src/TlsSessionClient.cpp
+#include "TlsSession.h"
+
+#if defined(ESP32)
+
+// WiFiClientSecure milik Arduino-ESP32 tidak punya titik sisip antara
+// mbedtls_ssl_setup() dan handshake, jadi jalur start_ssl_client() ditiru di
+// sini (hanya mode CA dan insecure yang dipakai firmware). Setelah tersambung
+// semua field sslclient terisi seperti aslinya, sehingga read/write/stop
+// tetap memakai implementasi WiFiClientSecure.
+
+#include <WiFi.h>
+#include <ssl_client.h>
+#include <errno.h>
+#include <lwip/sockets.h>
+#include <mbedtls/net_sockets.h>
+#include <mbedtls/ssl.h>
+#include <mbedtls/version.h>
+
+#ifndef MBEDTLS_PRIVATE
+#define MBEDTLS_PRIVATE(member) member
+#endif
+
+static const char* TLS_DRBG_PERS = "jamur-tls";
+static const size_t TLS_MASTER_LEN = 48;
+
+static int open_socket(const IPAddress& ip, uint16_t port, int timeoutMs) {
+    int fd = lwip_socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    if (fd < 0) return -1;
+
+    struct sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = (uint32_t)ip;
+    addr.sin_port = htons(port);
+
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+    int res = lwip_connect(fd, (struct sockaddr*)&addr, sizeof(addr));
+    if (res < 0 && errno != EINPROGRESS) {
+        close(fd);
+        return -1;
+    }
+
+    fd_set fdset;
+    FD_ZERO(&fdset);
+    FD_SET(fd, &fdset);
+    struct timeval tv = { timeoutMs / 1000, (timeoutMs % 1000) * 1000 };
+    int sockErr = 0;
+    socklen_t errLen = sizeof(sockErr);
+    if (select(fd + 1, nullptr, &fdset, nullptr, &tv) <= 0 ||
+        getsockopt(fd, SOL_SOCKET, SO_ERROR, &sockErr, &errLen) < 0 || sockErr != 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+int TlsSessionClient::connect(const char* host, uint16_t port) {
+    if (!cache_ || (_CA_cert == nullptr && !_use_insecure)) return WiFiClientSecure::connect(host, port);
+
+    stop();
+    IPAddress ip;
+    if (!WiFi.hostByName(host, ip)) {
+        cache_->record_failure();
+        return 0;
+    }
+
+    uint32_t start = millis();
+    sslclient_context* ctx = &*sslclient;
+    ssl_init(ctx);
+    ctx->socket = open_socket(ip, port, _timeout);
+
+    int ret = ctx->socket < 0 ? -1 : 0;
+    if (ret == 0) {
+        mbedtls_entropy_init(&ctx->entropy_ctx);
+        ret = mbedtls_ctr_drbg_seed(&ctx->drbg_ctx, mbedtls_entropy_func, &ctx->entropy_ctx,
+                                    (const unsigned char*)TLS_DRBG_PERS, strlen(TLS_DRBG_PERS));
+    }
+    if (ret == 0) {
+        ret = mbedtls_ssl_config_defaults(&ctx->ssl_conf, MBEDTLS_SSL_IS_CLIENT, MBEDTLS_SSL_TRANSPORT_STREAM,
+                                          MBEDTLS_SSL_PRESET_DEFAULT);
+    }
+    if (ret == 0 && _CA_cert != nullptr) {
+        mbedtls_x509_crt_init(&ctx->ca_cert);
+        ret = mbedtls_x509_crt_parse(&ctx->ca_cert, (const unsigned char*)_CA_cert, strlen(_CA_cert) + 1);
+        mbedtls_ssl_conf_ca_chain(&ctx->ssl_conf, &ctx->ca_cert, nullptr);
+        mbedtls_ssl_conf_authmode(&ctx->ssl_conf, MBEDTLS_SSL_VERIFY_REQUIRED);
+    } else if (ret == 0) {
+        mbedtls_ssl_conf_authmode(&ctx->ssl_conf, MBEDTLS_SSL_VERIFY_NONE);
+    }
+    if (ret == 0) {
+#if defined(MBEDTLS_SSL_SESSION_TICKETS)
+        mbedtls_ssl_conf_session_tickets(&ctx->ssl_conf, MBEDTLS_SSL_SESSION_TICKETS_ENABLED);
+#endif
+        mbedtls_ssl_conf_rng(&ctx->ssl_conf, mbedtls_ctr_drbg_random, &ctx->drbg_ctx);
+        ret = mbedtls_ssl_setup(&ctx->ssl_ctx, &ctx->ssl_conf);
+    }
+    if (ret == 0) ret = mbedtls_ssl_set_hostname(&ctx->ssl_ctx, host);
+
+    // Sesi tersimpan ditawarkan ke server; bila ditolak mbedTLS otomatis
+    // melanjutkan dengan handshake penuh.
+    unsigned char cachedMaster[TLS_MASTER_LEN];
+    bool offered = false;
+    if (ret == 0 && cache_->valid_for(host)) {
+        mbedtls_ssl_session session;
+        mbedtls_ssl_session_init(&session);
+        if (mbedtls_ssl_session_load(&session, cache_->data(), cache_->length()) == 0 &&
+            mbedtls_ssl_set_session(&ctx->ssl_ctx, &session) == 0) {
+            memcpy(cachedMaster, session.MBEDTLS_PRIVATE(master), TLS_MASTER_LEN);
+            offered = true;
+        } else {
+            cache_->clear();
+        }
+        mbedtls_ssl_session_free(&session);
+    }
+
+    if (ret == 0) {
+        mbedtls_ssl_set_bio(&ctx->ssl_ctx, &ctx->socket, mbedtls_net_send, mbedtls_net_recv, nullptr);
+        unsigned long handshakeStart = millis();
+        while ((ret = mbedtls_ssl_handshake(&ctx->ssl_ctx)) != 0) {
+            if (ret != MBEDTLS_ERR_SSL_WANT_READ && ret != MBEDTLS_ERR_SSL_WANT_WRITE) break;
+            if (millis() - handshakeStart > ctx->handshake_timeout) {
+                ret = MBEDTLS_ERR_SSL_TIMEOUT;
+                break;
+            }
+            vTaskDelay(2);
+        }
+    }
+    if (ret == 0 && _CA_cert != nullptr && mbedtls_ssl_get_verify_result(&ctx->ssl_ctx) != 0) {
+        ret = MBEDTLS_ERR_X509_CERT_VERIFY_FAILED;
+        cache_->clear();
+    }
+    if (ret != 0) {
+        _lastError = ret;
+        stop();
+        cache_->record_failure();
+        return 0;
+    }
+
+    // Resume berhasil bila master secret tidak berubah dari sesi yang ditawarkan.
+    const mbedtls_ssl_session* active = ctx->ssl_ctx.MBEDTLS_PRIVATE(session);
+    bool resumed = offered && active && memcmp(active->MBEDTLS_PRIVATE(master), cachedMaster, TLS_MASTER_LEN) == 0;
+    cache_->record(resumed, millis() - start);
+
+    mbedtls_ssl_session session;
+    mbedtls_ssl_session_init(&session);
+    uint8_t* buf = (uint8_t*)malloc(TlsSessionCache::kMaxSession);
+    size_t len = 0;
+    if (buf && mbedtls_ssl_get_session(&ctx->ssl_ctx, &session) == 0 &&
+        mbedtls_ssl_session_save(&session, buf, TlsSessionCache::kMaxSession, &len) == 0) {
+        cache_->store(host, buf, len, !resumed);
+    }
+    free(buf);
+    mbedtls_ssl_session_free(&session);
+
+    _connected = true;
+    return 1;
+}
+
+#else
+
+// [env:native]: WiFiClientSecure tiruan menyediakan sim_handshake() dengan
+// biaya handshake penuh atau singkat; isi sesi cukup nama host.
+int TlsSessionClient::connect(const char* host, uint16_t port) {
+    if (!cache_) return WiFiClientSecure::connect(host, port);
+
+    bool offered = cache_->valid_for(host);
+    uint32_t start = millis();
+    if (!sim_handshake(host, port, offered)) {
+        cache_->record_failure();
+        return 0;
+    }
+    cache_->record(offered, millis() - start);
+    cache_->store(host, (const uint8_t*)host, strlen(host) + 1, !offered);
+    return 1;
+}
+
+#endif
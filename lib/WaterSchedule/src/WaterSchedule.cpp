@@ -0,0 +1,98 @@
+// lib/WaterSchedule/src/WaterSchedule.cpp
+#include "WaterSchedule.h"
+
+#include <algorithm>
+
+static const int64_t DAY_SEC = 86400;
+static const int64_t WEEK_SEC = 7 * DAY_SEC;
+// Jam mundur lebih dari ini (koreksi NTP besar) berarti slot dicari ulang.
+static const int64_t BACKWARD_JUMP_SEC = 60;
+
+bool WaterSchedule::valid(const ScheduleEntry& entry) {
+    return entry.minute < 24 * 60 && entry.duration_s > 0 && entry.duration_s <= kMaxDurationSec &&
+           (entry.days & kAllDays) != 0 && (entry.days & ~kAllDays) == 0;
+}
+
+bool WaterSchedule::set(const ScheduleEntry* entries, uint8_t count) {
+    if (count > kMaxEntries) return false;
+    for (uint8_t i = 0; i < count; i++) {
+        if (!valid(entries[i])) return false;
+    }
+    memcpy(entries_, entries, count * sizeof(ScheduleEntry));
+    count_ = count;
+
+    slotCount_ = 0;
+    for (uint8_t i = 0; i < count_; i++) {
+        for (uint8_t day = 0; day < 7; day++) {
+            if (!(entries_[i].days & (1 << day))) continue;
+            slots_[slotCount_++] = { (uint16_t)(day * 24 * 60 + entries_[i].minute), i };
+        }
+    }
+    // Entri ganda di menit yang sama tetap dua slot; yang pertama dijalankan,
+    // yang kedua tergabung sebagai missed karena pompa masih menyala.
+    std::stable_sort(slots_, slots_ + slotCount_,
+                     [](const Slot& a, const Slot& b) { return a.weekMinute < b.weekMinute; });
+    cursor_ = 0;
+    nextAt_ = 0;
+    return true;
+}
+
+// Cari slot pertama pada atau setelah localNow (binary search); hanya saat
+// arm pertama, setelah set() dan saat jam melompat.
+void WaterSchedule::rearm(int64_t localNow) {
+    nextAt_ = 0;
+    if (slotCount_ == 0) return;
+    int64_t day = localNow >= 0 ? localNow / DAY_SEC : (localNow - DAY_SEC + 1) / DAY_SEC;
+    // 1 Januari 1970 adalah Kamis (tm_wday 4).
+    int64_t weekday = ((day + 4) % 7 + 7) % 7;
+    weekStart_ = (day - weekday) * DAY_SEC;
+    int64_t intoWeek = localNow - weekStart_;
+    uint16_t minute = (uint16_t)((intoWeek + 59) / 60);
+    const Slot* it = std::lower_bound(slots_, slots_ + slotCount_, minute,
+                                      [](const Slot& s, uint16_t m) { return s.weekMinute < m; });
+    cursor_ = (uint16_t)(it - slots_);
+    if (cursor_ == slotCount_) {
+        cursor_ = 0;
+        weekStart_ += WEEK_SEC;
+    }
+    nextAt_ = weekStart_ + (int64_t)slots_[cursor_].weekMinute * 60;
+}
+
+void WaterSchedule::advance() {
+    if (++cursor_ == slotCount_) {
+        cursor_ = 0;
+        weekStart_ += WEEK_SEC;
+    }
+    nextAt_ = weekStart_ + (int64_t)slots_[cursor_].weekMinute * 60;
+}
+
+int WaterSchedule::poll(int64_t localNow, uint32_t catchupSec, uint16_t* missed) {
+    if (missed) *missed = 0;
+    if (slotCount_ == 0) return -1;
+    if (nextAt_ == 0) {
+        // Arm pertama sejak boot ikut melihat ke belakang: jam yang baru
+        // dipercaya beberapa menit setelah slot tetap menjalankan slot itu.
+        rearm(booted_ ? localNow : localNow - catchupSec);
+        booted_ = true;
+    } else if (localNow + BACKWARD_JUMP_SEC < lastNow_ || nextAt_ - localNow > WEEK_SEC) {
+        rearm(localNow);
+    }
+    lastNow_ = localNow;
+    if (localNow < nextAt_) return -1;
+
+    uint16_t skipped = 0;
+    // Telat melebihi batas (stall panjang atau jam melompat maju): slot lama
+    // dilewati, lanjut dari awal jendela catch-up.
+    if (localNow - nextAt_ > (int64_t)catchupSec) {
+        skipped++;
+        rearm(localNow - catchupSec);
+    }
+    int fired = -1;
+    while (nextAt_ <= localNow) {
+        if (fired >= 0) skipped++;
+        fired = slots_[cursor_].entry;
+        advance();
+    }
+    if (missed) *missed = skipped;
+    return fired;
+}
@@ -0,0 +1,65 @@
+// lib/WaterSchedule/src/WaterSchedule.h
+#pragma once
+
+// ==========================================================
+// ==        JADWAL SIRAM PER MENIT, TABEL TERKOMPILASI     ==
+// ==========================================================
+// Tiap entri: menit dalam hari, durasi siram dan mask hari (bit 0 = Minggu,
+// sama dengan tm_wday). set() mengembangkan entri menjadi slot menit-dalam-
+// minggu yang terurut, lalu poll() cukup membandingkan jam sekarang dengan
+// waktu slot berikutnya; slot hanya maju saat jatuh tempo.
+//
+// Semua waktu berupa "epoch lokal" (epoch UTC + offset zona waktu), jadi
+// modul ini tidak bergantung pada TZ atau localtime_r().
+//
+// Slot yang lewat saat loop tertahan (stall) tetap dijalankan bila telatnya
+// masih <= catchupSec; beberapa slot yang terlewat sekaligus digabung menjadi
+// satu siraman (slot terbaru), sisanya dihitung sebagai missed.
+
+#include <Arduino.h>
+
+struct ScheduleEntry {
+    uint16_t minute;               // 0..1439 sejak 00:00 waktu lokal
+    uint16_t duration_s;
+    uint8_t days;                  // bit 0 = Minggu ... bit 6 = Sabtu
+};
+
+class WaterSchedule {
+public:
+    static const uint8_t kMaxEntries = 32;
+    static const uint8_t kAllDays = 0x7F;
+    static const uint16_t kMaxDurationSec = 600;
+
+    // Validasi lalu kompilasi ulang; false (tabel lama tetap) bila ada entri
+    // tidak valid. poll() berikutnya mencari slot mulai dari jam saat itu.
+    bool set(const ScheduleEntry* entries, uint8_t count);
+    uint8_t count() const { return count_; }
+    const ScheduleEntry& at(uint8_t i) const { return entries_[i]; }
+    static bool valid(const ScheduleEntry& entry);
+
+    // Indeks entri yang harus disiram sekarang, atau -1. missed = slot yang
+    // dilewati (digabung atau terlambat melebihi catchupSec).
+    int poll(int64_t localNow, uint32_t catchupSec, uint16_t* missed);
+    // Epoch lokal slot berikutnya; 0 bila belum di-arm atau tabel kosong.
+    int64_t next_fire() const { return nextAt_; }
+    uint8_t next_entry() const { return slotCount_ ? slots_[cursor_].entry : 0; }
+
+private:
+    struct Slot {
+        uint16_t weekMinute;       // 0..10079 sejak Minggu 00:00
+        uint8_t entry;
+    };
+
+    void rearm(int64_t localNow);
+    void advance();
+
+    ScheduleEntry entries_[kMaxEntries] = {};
+    uint8_t count_ = 0;
+    Slot slots_[kMaxEntries * 7];
+    uint16_t slotCount_ = 0;
+    uint16_t cursor_ = 0;
+    int64_t weekStart_ = 0;        // epoch lokal Minggu 00:00 milik slot cursor_
+    int64_t nextAt_ = 0;
+    int64_t lastNow_ = 0;
+    bool booted_ = false;          // sudah pernah di-arm sejak boot
+};
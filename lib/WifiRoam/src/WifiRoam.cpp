@@ -0,0 +1,226 @@
+// lib/WifiRoam/src/WifiRoam.cpp
+#include "WifiRoam.h"
+
+#include <Preferences.h>
+
+static const char* WIFI_NVS_NAMESPACE = "jamur-wifi";
+static const char* WIFI_NVS_KEY = "creds";
+
+// ---------------- CREDENTIAL STORE ------------------------
+
+void WifiCredentialStore::begin() {
+    count_ = 0;
+    Preferences prefs;
+    if (!prefs.begin(WIFI_NVS_NAMESPACE, true)) return;
+    size_t len = prefs.getBytesLength(WIFI_NVS_KEY);
+    if (len > 0 && len % sizeof(WifiCredential) == 0 && len <= sizeof(creds_)) {
+        prefs.getBytes(WIFI_NVS_KEY, creds_, len);
+        count_ = len / sizeof(WifiCredential);
+        for (uint8_t i = 0; i < count_; i++) {
+            creds_[i].ssid[sizeof(creds_[i].ssid) - 1] = '\0';
+            creds_[i].pass[sizeof(creds_[i].pass) - 1] = '\0';
+        }
+    }
+    prefs.end();
+}
+
+int WifiCredentialStore::find(const char* ssid) const {
+    for (uint8_t i = 0; i < count_; i++) {
+        if (strcmp(creds_[i].ssid, ssid) == 0) return i;
+    }
+    return -1;
+}
+
+int WifiCredentialStore::add(const char* ssid, const char* pass) {
+    if (!ssid || !ssid[0] || strlen(ssid) >= sizeof(creds_[0].ssid) || strlen(pass) >= sizeof(creds_[0].pass)) return -1;
+    int index = find(ssid);
+    if (index >= 0) {
+        if (strcmp(creds_[index].pass, pass) == 0) return index;
+    } else {
+        index = count_ < kMax ? count_++ : kMax - 1;
+        creds_[index] = {};
+        strlcpy(creds_[index].ssid, ssid, sizeof(creds_[index].ssid));
+    }
+    strlcpy(creds_[index].pass, pass, sizeof(creds_[index].pass));
+    save();
+    return index;
+}
+
+bool WifiCredentialStore::remove(const char* ssid) {
+    int index = find(ssid);
+    if (index < 0) return false;
+    for (uint8_t i = index; i + 1 < count_; i++) creds_[i] = creds_[i + 1];
+    count_--;
+    save();
+    return true;
+}
+
+void WifiCredentialStore::clear() {
+    count_ = 0;
+    save();
+}
+
+void WifiCredentialStore::remember(uint8_t index, const uint8_t* bssid, uint8_t channel) {
+    if (index >= count_) return;
+    WifiCredential cred = creds_[index];
+    bool changed = index != 0 || cred.channel != channel || memcmp(cred.bssid, bssid, sizeof(cred.bssid)) != 0;
+    if (!changed) return;
+    memcpy(cred.bssid, bssid, sizeof(cred.bssid));
+    cred.channel = channel;
+    for (uint8_t i = index; i > 0; i--) creds_[i] = creds_[i - 1];
+    creds_[0] = cred;
+    save();
+}
+
+void WifiCredentialStore::save() {
+    Preferences prefs;
+    if (!prefs.begin(WIFI_NVS_NAMESPACE, false)) return;
+    if (count_ == 0) {
+        prefs.remove(WIFI_NVS_KEY);
+    } else {
+        prefs.putBytes(WIFI_NVS_KEY, creds_, count_ * sizeof(WifiCredential));
+    }
+    prefs.end();
+}
+
+// ---------------- ROAMER ----------------------------------
+
+void WifiRoamer::start() {
+    startedAt_ = millis();
+    attempts_ = 0;
+    candidateCount_ = 0;
+    nextCandidate_ = 0;
+    if (store_.count() == 0) {
+        state_ = ROAM_FAILED;
+        stats_.failed++;
+        return;
+    }
+    const WifiCredential& first = store_.at(0);
+    if (first.channel != 0) {
+        begin_connect(0, first.bssid, first.channel);
+        state_ = ROAM_FAST;
+        return;
+    }
+    state_ = ROAM_SCAN;
+    WiFi.disconnect();
+    if (WiFi.scanNetworks(true) == WIFI_SCAN_FAILED) collect_candidates(0);
+}
+
+WifiRoamState WifiRoamer::poll() {
+    switch (state_) {
+        case ROAM_IDLE:
+        case ROAM_CONNECTED:
+        case ROAM_FAILED:
+            return state_;
+
+        case ROAM_FAST: {
+            wl_status_t status = WiFi.status();
+            if (status == WL_CONNECTED) return finish(true);
+            bool failed = status == WL_NO_SSID_AVAIL || status == WL_CONNECT_FAILED;
+            if (!failed && millis() - attemptAt_ < fastTimeoutMs_) return state_;
+            // Petunjuk basi: lanjut ke scan penuh semua kredensial.
+            stats_.stale++;
+            state_ = ROAM_SCAN;
+            WiFi.disconnect();
+            if (WiFi.scanNetworks(true) == WIFI_SCAN_FAILED) collect_candidates(0);
+            return state_;
+        }
+
+        case ROAM_SCAN: {
+            int16_t found = WiFi.scanComplete();
+            if (found == WIFI_SCAN_RUNNING) return state_;
+            collect_candidates(found > 0 ? found : 0);
+            return state_;
+        }
+
+        case ROAM_TRY: {
+            wl_status_t status = WiFi.status();
+            if (status == WL_CONNECTED) return finish(false);
+            bool failed = status == WL_NO_SSID_AVAIL || status == WL_CONNECT_FAILED;
+            if (!failed && millis() - attemptAt_ < tryTimeoutMs_) return state_;
+            if (!try_next()) {
+                WiFi.disconnect();
+                state_ = ROAM_FAILED;
+                stats_.failed++;
+            }
+            return state_;
+        }
+    }
+    return state_;
+}
+
+void WifiRoamer::begin_connect(uint8_t cred, const uint8_t* bssid, uint8_t channel) {
+    const WifiCredential& c = store_.at(cred);
+    current_ = cred;
+    attempts_++;
+    attemptAt_ = millis();
+    WiFi.disconnect();
+    if (channel != 0) {
+        WiFi.begin(c.ssid, c.pass, channel, bssid);
+    } else {
+        WiFi.begin(c.ssid, c.pass);
+    }
+}
+
+// Satu kandidat per BSSID yang SSID-nya tersimpan, urut RSSI menurun. Bila
+// tidak satu pun terlihat (scan gagal, SSID tersembunyi), semua kredensial
+// dicoba dengan connect biasa sesuai urutan tersimpan.
+void WifiRoamer::collect_candidates(int16_t found) {
+    candidateCount_ = 0;
+    for (int16_t i = 0; i < found; i++) {
+        int cred = store_.find(WiFi.SSID(i).c_str());
+        if (cred < 0) continue;
+        int8_t rssi = (int8_t)WiFi.RSSI(i);
+        uint8_t pos = candidateCount_;
+        if (candidateCount_ < kMaxCandidates) {
+            candidateCount_++;
+        } else if (candidates_[kMaxCandidates - 1].rssi < rssi) {
+            pos = kMaxCandidates - 1;
+        } else {
+            continue;
+        }
+        for (; pos > 0 && candidates_[pos - 1].rssi < rssi; pos--) candidates_[pos] = candidates_[pos - 1];
+        Candidate& c = candidates_[pos];
+        c.cred = (uint8_t)cred;
+        memcpy(c.bssid, WiFi.BSSID(i), sizeof(c.bssid));
+        c.channel = (uint8_t)WiFi.channel(i);
+        c.rssi = rssi;
+    }
+    WiFi.scanDelete();
+    if (candidateCount_ == 0) {
+        for (uint8_t i = 0; i < store_.count() && i < kMaxCandidates; i++) {
+            candidates_[candidateCount_++] = { i, {0}, 0, 0 };
+        }
+    }
+    nextCandidate_ = 0;
+    state_ = ROAM_TRY;
+    if (!try_next()) {
+        state_ = ROAM_FAILED;
+        stats_.failed++;
+    }
+}
+
+bool WifiRoamer::try_next() {
+    if (nextCandidate_ >= candidateCount_) return false;
+    const Candidate& c = candidates_[nextCandidate_++];
+    begin_connect(c.cred, c.bssid, c.channel);
+    return true;
+}
+
+WifiRoamState WifiRoamer::finish(bool fast) {
+    state_ = ROAM_CONNECTED;
+    if (fast) {
+        stats_.fast++;
+    } else {
+        stats_.ranked++;
+    }
+    last_.fast = fast;
+    last_.ms = millis() - startedAt_;
+    last_.attempts = attempts_;
+    strlcpy(last_.ssid, store_.at(current_).ssid, sizeof(last_.ssid));
+    memcpy(last_.bssid, WiFi.BSSID(), sizeof(last_.bssid));
+    last_.channel = (uint8_t)WiFi.channel();
+    last_.rssi = (int8_t)WiFi.RSSI();
+    store_.remember(current_, last_.bssid, last_.channel);
+    return state_;
+}
@@ -0,0 +1,111 @@
+// lib/WifiRoam/src/WifiRoam.h
+#pragma once
+
+// ==========================================================
+// ==     DAFTAR KREDENSIAL WIFI & RECONNECT TERARAH        ==
+// ==========================================================
+// WifiCredentialStore menyimpan beberapa SSID/password di NVS (namespace
+// "jamur-wifi"), diurutkan dari yang terakhir berhasil, beserta BSSID dan
+// channel AP-nya. WifiRoamer memakai petunjuk itu untuk connect terarah:
+// tanpa scan semua channel, asosiasi biasanya selesai < 1 detik. Bila AP
+// itu hilang, satu scan async mengurutkan kandidat dari semua kredensial
+// menurut RSSI lalu mencobanya satu per satu, masing-masing terarah.
+//
+// Tidak ada yang memblokir: start() lalu poll() berulang sampai state
+// ROAM_CONNECTED atau ROAM_FAILED.
+
+#include <Arduino.h>
+#include <WiFi.h>
+
+struct WifiCredential {
+    char ssid[33];
+    char pass[65];
+    uint8_t bssid[6];
+    uint8_t channel;               // 0 = belum ada petunjuk AP
+};
+
+class WifiCredentialStore {
+public:
+    static const uint8_t kMax = 5;
+
+    void begin();
+    uint8_t count() const { return count_; }
+    const WifiCredential& at(uint8_t i) const { return creds_[i]; }
+    int find(const char* ssid) const;
+    // SSID baru ditambahkan di belakang (menggantikan entri terakhir bila
+    // penuh); SSID lama hanya diperbarui passwordnya. Mengembalikan indeks.
+    int add(const char* ssid, const char* pass);
+    bool remove(const char* ssid);
+    void clear();
+    // AP yang baru berhasil pindah ke urutan pertama beserta petunjuknya.
+    // NVS hanya ditulis bila urutan, BSSID atau channel berubah.
+    void remember(uint8_t index, const uint8_t* bssid, uint8_t channel);
+
+private:
+    void save();
+
+    WifiCredential creds_[kMax] = {};
+    uint8_t count_ = 0;
+};
+
+enum WifiRoamState : uint8_t { ROAM_IDLE, ROAM_FAST, ROAM_SCAN, ROAM_TRY, ROAM_CONNECTED, ROAM_FAILED };
+
+struct WifiRoamResult {
+    bool fast;                     // tersambung lewat petunjuk tersimpan, tanpa scan
+    uint32_t ms;                   // start() sampai WL_CONNECTED
+    uint8_t attempts;              // jumlah WiFi.begin()
+    char ssid[33];
+    uint8_t bssid[6];
+    uint8_t channel;
+    int8_t rssi;
+};
+
+struct WifiRoamStats {
+    uint32_t fast;                 // sukses lewat connect terarah dari petunjuk
+    uint32_t ranked;               // sukses setelah scan + urutan RSSI
+    uint32_t failed;               // semua kandidat gagal
+    uint32_t stale;                // petunjuk gagal (AP mati/pindah channel)
+};
+
+class WifiRoamer {
+public:
+    static const uint8_t kMaxCandidates = 8;
+
+    WifiRoamer(WifiCredentialStore& store, uint32_t fastTimeoutMs, uint32_t tryTimeoutMs)
+        : store_(store), fastTimeoutMs_(fastTimeoutMs), tryTimeoutMs_(tryTimeoutMs) {}
+
+    void start();
+    WifiRoamState poll();
+    WifiRoamState state() const { return state_; }
+    bool busy() const { return state_ == ROAM_FAST || state_ == ROAM_SCAN || state_ == ROAM_TRY; }
+    // Hasil connect terakhir yang berhasil.
+    const WifiRoamResult& last() const { return last_; }
+    const WifiRoamStats& stats() const { return stats_; }
+
+private:
+    struct Candidate {
+        uint8_t cred;
+        uint8_t bssid[6];
+        uint8_t channel;           // 0 = tidak terlihat saat scan, connect biasa
+        int8_t rssi;
+    };
+
+    void begin_connect(uint8_t cred, const uint8_t* bssid, uint8_t channel);
+    void collect_candidates(int16_t found);
+    bool try_next();
+    WifiRoamState finish(bool fast);
+
+    WifiCredentialStore& store_;
+    uint32_t fastTimeoutMs_;
+    uint32_t tryTimeoutMs_;
+    WifiRoamState state_ = ROAM_IDLE;
+    unsigned long startedAt_ = 0;
+    unsigned long attemptAt_ = 0;
+    uint8_t attempts_ = 0;
+    uint8_t current_ = 0;          // indeks kredensial yang sedang dicoba
+    Candidate candidates_[kMaxCandidates];
+    uint8_t candidateCount_ = 0;
+    uint8_t nextCandidate_ = 0;
+    WifiRoamResult last_ = {};
+    WifiRoamStats stats_ = {};
+};
@@ -0,0 +1,127 @@
+// lib/WireCodec/src/WireCodec.cpp
+#include "WireCodec.h"
+
+#include <string.h>
+
+const char* wire_format_name(WireFormat format) {
+    return format == WIRE_FORMAT_MSGPACK ? "msgpack" : "json";
+}
+
+bool wire_format_parse(const char* name, WireFormat& out) {
+    if (!name) return false;
+    if (strcmp(name, "json") == 0) {
+        out = WIRE_FORMAT_JSON;
+        return true;
+    }
+    if (strcmp(name, "msgpack") == 0) {
+        out = WIRE_FORMAT_MSGPACK;
+        return true;
+    }
+    return false;
+}
+
+// ---------------- MSGPACK WRITER --------------------------
+
+void MsgPackWriter::put(uint8_t b) {
+    if (pos_ >= size_) {
+        overflow_ = true;
+        return;
+    }
+    buf_[pos_++] = b;
+}
+
+void MsgPackWriter::put_be(uint32_t v, uint8_t bytes) {
+    for (int shift = (bytes - 1) * 8; shift >= 0; shift -= 8) put((uint8_t)(v >> shift));
+}
+
+void MsgPackWriter::array(uint8_t count) {
+    if (count < 16) {
+        put(0x90 | count);
+    } else {
+        put(0xdc);
+        put_be(count, 2);
+    }
+}
+
+void MsgPackWriter::str(const char* s) {
+    size_t len = s ? strlen(s) : 0;
+    if (len > 0xffff) len = 0xffff;
+    if (len < 32) {
+        put(0xa0 | (uint8_t)len);
+    } else if (len < 256) {
+        put(0xd9);
+        put((uint8_t)len);
+    } else {
+        put(0xda);
+        put_be((uint32_t)len, 2);
+    }
+    if (pos_ + len > size_) {
+        overflow_ = true;
+        return;
+    }
+    memcpy(buf_ + pos_, s, len);
+    pos_ += len;
+}
+
+void MsgPackWriter::f32(float v) {
+    uint32_t bits;
+    memcpy(&bits, &v, sizeof(bits));
+    put(0xca);
+    put_be(bits, 4);
+}
+
+void MsgPackWriter::uint(uint32_t v) {
+    if (v < 0x80) {
+        put((uint8_t)v);
+    } else if (v <= 0xff) {
+        put(0xcc);
+        put((uint8_t)v);
+    } else if (v <= 0xffff) {
+        put(0xcd);
+        put_be(v, 2);
+    } else {
+        put(0xce);
+        put_be(v, 4);
+    }
+}
+
+void MsgPackWriter::nil() { put(0xc0); }
+
+// ---------------- SKEMA TETAP -----------------------------
+
+size_t wire_encode_telemetry(uint8_t* buf, size_t size, uint32_t ts, float temperature, float humidity) {
+    MsgPackWriter w(buf, size);
+    w.array(3);
+    w.uint(ts);
+    w.f32(temperature);
+    w.f32(humidity);
+    return w.length();
+}
+
+size_t wire_encode_speedtest(uint8_t* buf, size_t size, float ping_ms, float download_mbps, float upload_mbps,
+                             float lat, float lon) {
+    MsgPackWriter w(buf, size);
+    w.array(5);
+    w.f32(ping_ms);
+    w.f32(download_mbps);
+    w.f32(upload_mbps);
+    w.f32(lat);
+    w.f32(lon);
+    return w.length();
+}
+
+size_t wire_encode_notification(uint8_t* buf, size_t size, const char* type, const char* message,
+                                float humidity, float temperature) {
+    MsgPackWriter w(buf, size);
+    w.array(4);
+    w.str(type);
+    w.str(message);
+    if (humidity >= 0 && temperature >= 0) {
+        w.f32(humidity);
+        w.f32(temperature);
+    } else {
+        w.nil();
+        w.nil();
+    }
+    return w.length();
+}
@@ -0,0 +1,59 @@
+// lib/WireCodec/src/WireCodec.h
+#pragma once
+
+// ==========================================================
+// ==     FORMAT BINER (MESSAGEPACK) UNTUK TOPIK jamur/bin ==
+// ==========================================================
+// Skema tetap berbasis posisi (array MessagePack), ditulis langsung ke
+// buffer milik pemanggil tanpa JsonDocument dan tanpa heap. Dekoder di
+// server cukup memakai pustaka MessagePack standar.
+//
+//   jamur/bin/telemetry      [ts:uint, temperature:f32, humidity:f32]
+//   jamur/bin/speedtest      [ping_ms:f32, download_mbps:f32, upload_mbps:f32, lat:f32, lon:f32]
+//   jamur/bin/notifications  [type:str, message:str, humidity:f32|nil, temperature:f32|nil]
+//
+// Config (jamur/bin/config/get & jamur/bin/config/set) memakai map dengan
+// kunci yang sama seperti versi JSON, di-(de)serialisasi oleh ArduinoJson.
+
+#include <stdint.h>
+#include <stddef.h>
+
+enum WireFormat : uint8_t {
+    WIRE_FORMAT_JSON = 0,
+    WIRE_FORMAT_MSGPACK = 1,
+};
+
+const char* wire_format_name(WireFormat format);
+// Mengembalikan false bila nama tidak dikenal (out tidak diubah).
+bool wire_format_parse(const char* name, WireFormat& out);
+
+class MsgPackWriter {
+public:
+    MsgPackWriter(uint8_t* buf, size_t size) : buf_(buf), size_(size) {}
+
+    void array(uint8_t count);
+    void str(const char* s);
+    void f32(float v);
+    void uint(uint32_t v);
+    void nil();
+
+    // 0 bila buffer tidak cukup.
+    size_t length() const { return overflow_ ? 0 : pos_; }
+
+private:
+    void put(uint8_t b);
+    void put_be(uint32_t v, uint8_t bytes);
+
+    uint8_t* buf_;
+    size_t size_;
+    size_t pos_ = 0;
+    bool overflow_ = false;
+};
+
+size_t wire_encode_telemetry(uint8_t* buf, size_t size, uint32_t ts, float temperature, float humidity);
+size_t wire_encode_speedtest(uint8_t* buf, size_t size, float ping_ms, float download_mbps, float upload_mbps,
+                             float lat, float lon);
+// Bila humidity atau temperature < 0 keduanya ditulis nil, sama seperti JSON yang
+// menghilangkan kedua kunci tersebut.
+size_t wire_encode_notification(uint8_t* buf, size_t size, const char* type, const char* message,
+                                float humidity, float temperature);
@@ -0,0 +1,79 @@
+(function () {
+var form = document.getElementById("form");
+var list = document.getElementById("nets");
+var box = document.getElementById("status");
+var button = form.querySelector("button");
+function show(text, cls) {
+box.hidden = false;
+box.className = cls;
+box.textContent = text;
+}
+function bars(rssi) {
+return rssi >= -55 ? "▂▄▆█" : rssi >= -67 ? "▂▄▆" : rssi >= -78 ? "▂▄" : "▂";
+}
+function json(r) {
+return r.json();
+}
+function render(data) {
+list.textContent = "";
+data.networks.forEach(function (n) {
+var b = document.createElement("button");
+b.type = "button";
+b.className = "net";
+b.textContent = (n.auth ? "🔒 " : "") + n.ssid + " " + bars(n.rssi) + " ch" + n.ch;
+b.onclick = function () {
+form.ssid.value = n.ssid;
+form.pass.value = "";
+form.pass.focus();
+};
+list.appendChild(b);
+});
+if (!data.networks.length) {
+list.textContent = data.scanning ? "Memindai jaringan..." : "Tidak ada jaringan ditemukan.";
+}
+}
+function load(refresh) {
+fetch(refresh ? "/networks?refresh=1" : "/networks").then(json).then(function (data) {
+render(data);
+if (data.scanning) setTimeout(load, 1500);
+}).catch(function () {
+setTimeout(load, 3000);
+});
+}
+function poll() {
+fetch("/status").then(json).then(function (s) {
+if (s.state === "testing") {
+show("Menghubungkan ke " + s.ssid + "...", "info");
+setTimeout(poll, 1000);
+} else if (s.state === "connected") {
+show("Terhubung ke " + s.ssid + " (IP " + s.ip + "). Portal segera ditutup dan perangkat mulai beroperasi.", "success");
+} else {
+button.disabled = false;
+show(s.message || "Koneksi gagal.", "error");
+}
+}).catch(function () {
+setTimeout(poll, 1000);
+});
+}
+form.onsubmit = function (e) {
+e.preventDefault();
+button.disabled = true;
+fetch("/connect", { method: "POST", body: new URLSearchParams(new FormData(form)) }).then(json).then(function (res) {
+if (res.ok) {
+poll();
+} else {
+button.disabled = false;
+show(res.message, "error");
+}
+}).catch(function () {
+button.disabled = false;
+show("Portal tidak merespons, coba lagi.", "error");
+});
+};
+document.getElementById("rescan").onclick = function (e) {
+e.preventDefault();
+list.textContent = "Memindai jaringan...";
+load(true);
+};
+load(false);
+})();
@@ -10,78 +10,202 @@
 #include <PubSubClient.h>
 #include <LiquidCrystal_I2C.h>
 #include <Preferences.h>
-#include <DHT.h>
 #include "time.h"
 #include <ArduinoJson.h>
 #include <HTTPClient.h>
 #include <Update.h>
 #include <WiFiClient.h>
+#include <atomic>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <freertos/queue.h>
+#include <freertos/semphr.h>
+#include <mbedtls/sha256.h>
+#include <esp_ota_ops.h>
+#include <esp_timer.h>
+#include <DeltaPatch.h>
 
 #include "config.h"
 #include "functions.h"
+#include "portal_assets.h"
 
 // =================================================================
 //   GLOBAL OBJECTS & VARIABLES
 // =================================================================
 
 WebServer server(80);
-WiFiClientSecure espClient;
+// Cache sesi TLS per tujuan; OTA hanya di RAM karena jarang dan sekali jalan.
+TlsSessionCache mqttTlsCache(TLS_SESSION_PERSIST ? "mqtt" : nullptr, TLS_SESSION_LIFETIME_SEC);
+TlsSessionCache supabaseTlsCache(TLS_SESSION_PERSIST ? "supabase" : nullptr, TLS_SESSION_LIFETIME_SEC);
+TlsSessionCache otaTlsCache(nullptr, TLS_SESSION_LIFETIME_SEC);
+TlsSessionClient espClient(&mqttTlsCache);
+TlsSessionClient supabaseClient(&supabaseTlsCache);
+TlsSessionClient otaClient(&otaTlsCache);
 PubSubClient mqttClient(espClient);
-DHT dht(DHT_PIN, DHT_TYPE);
 LiquidCrystal_I2C lcd(LCD_ADDRESS, LCD_COLS, LCD_ROWS);
 Preferences preferences;
 
 DeviceConfig config;
-AppState currentState = STATE_BOOTING;
+std::atomic<AppState> currentState(STATE_BOOTING);
 
 // Sensor & Control Variables
-float currentHumidity = 0.0;
-float currentTemperature = 0.0;
-bool isPumpOn = false;
+// Sampler dan filter dimiliki control_task; network_task hanya membaca statistik.
+// primarySensor = sensor I2C yang terdeteksi saat boot, atau dhtSampler.
+DhtSampler dhtSampler(DHT_PIN, DHT_TYPE, DHT_RMT_CHANNEL, DHT_SAMPLE_INTERVAL_MS);
+Sensor* primarySensor = &dhtSampler;
+// Dipegang LCD dan sensor I2C selama transaksi; menggantikan mutex LCD.
+I2cBus i2cBus;
+// config_set "sensor" menaikkan flag ini, control_task menerapkan interval baru.
+std::atomic<bool> sampleRateChanged(true);
+SensorFilter humidityFilter(0.0f, 100.0f, DHT_MAX_JUMP_RH, DHT_EMA_ALPHA);
+SensorFilter temperatureFilter(-20.0f, 60.0f, DHT_MAX_JUMP_C, DHT_EMA_ALPHA);
+unsigned long lastSensorAcceptTime = 0;
+bool sensorHealthy = true;
+// Ditulis hanya oleh control_task, dibaca task lain tanpa lock.
+std::atomic<float> currentHumidity(0.0f);
+std::atomic<float> currentTemperature(0.0f);
+std::atomic<bool> isPumpOn(false);
+std::atomic<unsigned long> pumpStopTime(0);
+// Relay tiap pulsa dijatuhkan one-shot esp_timer pada deadline-nya, lepas
+// dari jadwal control_task. Dicatat dengan micros() 32-bit (0 = belum).
+esp_timer_handle_t pumpCutoffTimer = nullptr;
+std::atomic<uint32_t> pumpCutoffUs(0);
+PumpTiming pumpTiming;
 int pumpCountdownSeconds = 0;
-unsigned long pumpStopTime = 0;
 
 // Timing Variables
 unsigned long lastLogicCheckTime = 0;
 unsigned long lastWifiSignalPublishTime = 0;
 unsigned long lastPeriodicNotifTime = 0;
-unsigned long lastSpeedtestTime = 0;
 unsigned long lastWifiReconnectTime = 0;
-unsigned long lastMqttRetryTime = 0;
 unsigned long lastOkDebounceTime = 0;
 unsigned long btnOkPressTime = 0;
 
 // Button & UI Variables
 bool okButtonLongPress = false;
 bool okButtonPressed = false;
-int lastScheduledHour = -1;
 
 // Notification & Email Variables
-enum NotifState { NOTIF_NORMAL, NOTIF_WARNING, NOTIF_CRITICAL };
-NotifState lastNotifState = NOTIF_NORMAL;
+// Zona kelembapan terakhir yang dinotifikasikan; dimiliki control_task.
+HumidityControl humidityControl;
+// Riwayat dan model mode prediktif; dimiliki control_task.
+MistPredictor mistPredictor;
 FirmwareInfo newFirmware;
+FirmwareRollout firmwareRollout;
+
+// Task Variables
+TaskHandle_t controlTaskHandle = nullptr;
+TaskHandle_t networkTaskHandle = nullptr;
+QueueHandle_t pumpCommandQueue = nullptr;
+QueueHandle_t netEventQueue = nullptr;
+SemaphoreHandle_t configMutex = nullptr;
+// Menjaga wifiCredentials/wifiRoamer antara network_task dan perintah serial.
+SemaphoreHandle_t wifiMutex = nullptr;
+std::atomic<uint32_t> netEventsDropped(0);
+
+// Metrics Variables
+// Satu histogram per tahap, diisi oleh task pemiliknya; mux hanya menjaga
+// record() terhadap snapshot/reset dari network_task.
+const char* const METRIC_STAGE_NAMES[STAGE_COUNT] = {
+    "ui_loop", "display", "control", "main_logic", "wifi", "mqtt_dns", "mqtt_tls",
+    "mqtt_connack", "mqtt_subscribe", "mqtt_loop", "net_event", "net_logic", "speedtest", "email"
+};
+LatencyHistogram stageHistograms[STAGE_COUNT];
+const int TLS_TARGET_COUNT = 3;
+const char* const TLS_TARGET_NAMES[TLS_TARGET_COUNT] = { "mqtt", "supabase", "ota" };
+const TlsSessionCache* const TLS_TARGET_CACHES[TLS_TARGET_COUNT] = { &mqttTlsCache, &supabaseTlsCache, &otaTlsCache };
+portMUX_TYPE metricsMux = portMUX_INITIALIZER_UNLOCKED;
+uint32_t metricsCpuMhz = 240;
+unsigned long lastMetricsPublishTime = 0;
+unsigned long metricsWindowStart = 0;
 
 // Network Variables
+std::atomic<bool> mqttConnected(false);
+MqttLink mqttLink;
 char mqttClientId[MQTT_CLIENT_ID_LENGTH];
 const unsigned long WIFI_RECONNECT_INTERVAL = WIFI_RECONNECT_DELAY;
+WifiCredentialStore wifiCredentials;
+WifiRoamer wifiRoamer(wifiCredentials, WIFI_FAST_CONNECT_TIMEOUT_MS, WIFI_CANDIDATE_TIMEOUT_MS);
+// Diolah network_task; control_task hanya membaca trusted().
+TimeSync timeSync(TIME_MAX_ERROR_MS, TIME_DRIFT_ASSUMED_PPM, TIME_SYNC_INTERVAL_MS, TIME_PERSIST_INTERVAL_S);
+// Hasil kompilasi config.schedules; dijaga configMutex bersama config.
+WaterSchedule waterSchedule;
+// Dimiliki control_task; network_task hanya membaca pemakaian dan statistik.
+PumpEngine pumpEngine;
+// Slot dipasangkan ke config.zones lewat nama oleh sync_zones(); dimiliki
+// control_task, network_task dan perintah serial hanya membaca statistik dan
+// status pompa dengan configMutex dipegang. config_set menaikkan zonesChanged.
+ZoneRuntime zoneRuntime[ZONE_MAX];
+uint8_t zoneCursor = 0;
+std::atomic<bool> zonesChanged(true);
+
+// Portal Variables
+// Hanya disentuh loop() (handler WebServer dan portal_poll()).
+PortalNetwork portalNetworks[PORTAL_SCAN_MAX];
+uint8_t portalNetworkCount = 0;
+bool portalScanRunning = false;
+unsigned long portalScanAt = 0;
+PortalConnect portalConnect;
+unsigned long portalHandoffAt = 0;
+
+// Speedtest Task Variables
+TaskHandle_t speedtestTaskHandle = nullptr;
+QueueHandle_t speedtestResultQueue = nullptr;
+std::atomic<bool> speedtestCancel(false);
+unsigned long speedtestRunStart = 0;
+uint32_t speedtestRunBytes = 0;
+
+// OTA Pipeline Variables
+TaskHandle_t otaWriterTaskHandle = nullptr;
+QueueHandle_t otaFreeQueue = nullptr;
+QueueHandle_t otaFullQueue = nullptr;
+uint8_t otaBuffers[OTA_BUFFER_COUNT][OTA_BUFFER_SIZE];
+mbedtls_sha256_context otaSha;
+std::atomic<uint32_t> otaFlashed(0);
+std::atomic<bool> otaWriteFailed(false);
+int otaFillIndex = -1;
+uint16_t otaFillLength = 0;
 
 // =================================================================
 //   UTILITY FUNCTIONS
 // =================================================================
 
+void log_wifi_roam() {
+    const WifiRoamResult& r = wifiRoamer.last();
+    Serial.printf("WiFi tersambung ke %s (%02X:%02X:%02X:%02X:%02X:%02X, ch %u, %d dBm) dalam %lu ms, %s, %u percobaan.\n",
+                  r.ssid, r.bssid[0], r.bssid[1], r.bssid[2], r.bssid[3], r.bssid[4], r.bssid[5], r.channel, r.rssi,
+                  (unsigned long)r.ms, r.fast ? "terarah" : "scan", r.attempts);
+}
+
+// Putus pertama langsung dicoba ulang lewat wifiRoamer (connect terarah
+// dulu); jeda WIFI_RECONNECT_INTERVAL hanya setelah semua kandidat gagal.
 void check_and_reconnect_wifi() {
-    if (WiFi.status() != WL_CONNECTED && millis() - lastWifiReconnectTime > WIFI_RECONNECT_INTERVAL) {
+    xSemaphoreTake(wifiMutex, portMAX_DELAY);
+    if (wifiRoamer.busy()) {
+        WifiRoamState state = wifiRoamer.poll();
+        if (state == ROAM_CONNECTED) log_wifi_roam();
+        if (state == ROAM_FAILED) Serial.println("Reconnect WiFi gagal, semua kandidat sudah dicoba.");
+    } else if (WiFi.status() != WL_CONNECTED &&
+               (wifiRoamer.state() != ROAM_FAILED || millis() - lastWifiReconnectTime > WIFI_RECONNECT_INTERVAL)) {
         Serial.println("WiFi terputus! Mencoba reconnect...");
         lcd_show_message("WiFi Terputus!", "Reconnect...");
-        WiFi.disconnect();
-        WiFi.begin(WIFI_SSID, WIFI_PASSWORD);
+        wifiRoamer.start();
         lastWifiReconnectTime = millis();
     }
+    xSemaphoreGive(wifiMutex);
 }
 
-bool publish_with_retry(const char* topic, const char* payload, bool retained, int retry, int delayMs) {
+// Dicetak network_task setiap kualitas jam berubah (sinkron, basi, ...).
+void log_time_sync() {
+    TimeSyncStatus t = timeSync.status();
+    Serial.printf("Waktu %s: %lu sinkron, koreksi terakhir %ld ms, drift %.2f ppm (%u sampel), galat ~%lu ms.\n",
+                  TimeSync::quality_name(t.quality), (unsigned long)t.syncs, (long)t.lastOffsetMs, t.driftPpm,
+                  t.driftSamples, (unsigned long)t.errorMs);
+}
+
+bool publish_with_retry(const char* topic, const uint8_t* payload, size_t length, bool retained, int retry, int delayMs) {
     for (int i = 0; i < retry; ++i) {
-        if (mqttClient.publish(topic, payload, retained)) {
+        if (mqttClient.publish(topic, payload, length, retained)) {
             return true;
         }
         delay(delayMs);
@@ -89,7 +213,29 @@ bool publish_with_retry(const char* topic, const char* payload, bool retained, i
     return false;
 }
 
+bool publish_with_retry(const char* topic, const char* payload, bool retained, int retry, int delayMs) {
+    return publish_with_retry(topic, (const uint8_t*)payload, strlen(payload), retained, retry, delayMs);
+}
+
+// Aman dipanggil dari task mana pun: hanya menitipkan ke network_task.
 void send_notification(const char* type, const char* message, float humidity, float temperature) {
+    NetEvent event = {};
+    event.type = NET_EVT_NOTIFICATION;
+    event.record.humidity = humidity;
+    event.record.temperature = temperature;
+    strlcpy(event.kind, type, sizeof(event.kind));
+    strlcpy(event.text, message, sizeof(event.text));
+    post_net_event(event);
+}
+
+// Hanya dari network_task.
+void publish_notification(const char* type, const char* message, float humidity, float temperature) {
+    if (config.wire_format == WIRE_FORMAT_MSGPACK) {
+        uint8_t bin[NOTIF_PAYLOAD_SIZE];
+        size_t len = wire_encode_notification(bin, sizeof(bin), type, message, humidity, temperature);
+        if (len) publish_with_retry(TOPICS.notification_bin, bin, len, false, NOTIF_RETRY_COUNT, NOTIF_RETRY_DELAY_MS);
+        return;
+    }
     char notifPayload[NOTIF_PAYLOAD_SIZE];
     if (humidity >= 0 && temperature >= 0) {
         snprintf(notifPayload, NOTIF_PAYLOAD_SIZE,
@@ -113,11 +259,36 @@ public:
         prefs.begin("jamur-config", true);
         cfg.humidity_critical = prefs.getFloat("h_crit", 80.0);
         cfg.humidity_warning = prefs.getFloat("h_warn", 85.0);
-        cfg.schedule_count = prefs.getBytes("schedules", cfg.schedule_hours, sizeof(cfg.schedule_hours)) / sizeof(int);
-        if (cfg.schedule_count == 0) {
-            int default_schedule[] = {7, 12, 17};
-            memcpy(cfg.schedule_hours, default_schedule, sizeof(default_schedule));
-            cfg.schedule_count = sizeof(default_schedule) / sizeof(int);
+        cfg.schedule_count = 0;
+        size_t schedLen = prefs.getBytesLength("sched");
+        if (schedLen > 0 && schedLen % sizeof(ScheduleEntry) == 0 && schedLen <= sizeof(cfg.schedules)) {
+            prefs.getBytes("sched", cfg.schedules, schedLen);
+            cfg.schedule_count = schedLen / sizeof(ScheduleEntry);
+        } else {
+            // Format lama: jam bulat (int[5]) atau default, durasi PUMP_DURATION_MS tiap hari.
+            int hours[5] = {7, 12, 17};
+            size_t count = prefs.getBytes("schedules", hours, sizeof(hours)) / sizeof(int);
+            if (count == 0) count = 3;
+            for (size_t i = 0; i < count; i++) {
+                cfg.schedules[cfg.schedule_count++] = { (uint16_t)(hours[i] * 60), PUMP_DURATION_MS / 1000, WaterSchedule::kAllDays };
+            }
+        }
+        cfg.pump = { PUMP_DURATION_MS / 1000, PUMP_PER_PCT_DEFAULT_S, PUMP_MAX_DEFAULT_S,
+                     PUMP_PULSE_DEFAULT_S, PUMP_SOAK_DEFAULT_S, 0 };
+        if (prefs.getBytesLength("pump") == sizeof(cfg.pump)) prefs.getBytes("pump", &cfg.pump, sizeof(cfg.pump));
+        cfg.control = { CONTROL_HYSTERESIS_DEFAULT, CONTROL_DWELL_DEFAULT_S, CONTROL_FALL_RATE_DEFAULT };
+        if (prefs.getBytesLength("ctrl") == sizeof(cfg.control)) prefs.getBytes("ctrl", &cfg.control, sizeof(cfg.control));
+        cfg.mist = { 0, MIST_SETPOINT_DEFAULT, MIST_BAND_DEFAULT, MIST_HORIZON_DEFAULT_S };
+        if (prefs.getBytesLength("mist") == sizeof(cfg.mist)) prefs.getBytes("mist", &cfg.mist, sizeof(cfg.mist));
+        cfg.telemetry_batch_sec = prefs.getUInt("tlm_batch", TELEMETRY_BATCH_DEFAULT_SEC);
+        cfg.wire_format = prefs.getUChar("wire_fmt", WIRE_FORMAT_JSON) == WIRE_FORMAT_MSGPACK ? WIRE_FORMAT_MSGPACK : WIRE_FORMAT_JSON;
+        strlcpy(cfg.ntp_server, prefs.getString("ntp", NTP_SERVER_LAN).c_str(), sizeof(cfg.ntp_server));
+        cfg.sample_ms = prefs.getUInt("sample_ms", 0);
+        cfg.zone_count = 0;
+        size_t zoneLen = prefs.getBytesLength("zones");
+        if (zoneLen > 0 && zoneLen % sizeof(ZoneConfig) == 0 && zoneLen <= sizeof(cfg.zones)) {
+            prefs.getBytes("zones", cfg.zones, zoneLen);
+            cfg.zone_count = zoneLen / sizeof(ZoneConfig);
         }
         prefs.end();
     }
@@ -127,19 +298,215 @@ public:
         prefs.begin("jamur-config", false);
         prefs.putFloat("h_crit", cfg.humidity_critical);
         prefs.putFloat("h_warn", cfg.humidity_warning);
-        prefs.putBytes("schedules", cfg.schedule_hours, sizeof(int) * cfg.schedule_count);
+        prefs.putBytes("sched", cfg.schedules, sizeof(ScheduleEntry) * cfg.schedule_count);
+        prefs.remove("schedules");
+        prefs.putBytes("pump", &cfg.pump, sizeof(cfg.pump));
+        prefs.putBytes("ctrl", &cfg.control, sizeof(cfg.control));
+        prefs.putBytes("mist", &cfg.mist, sizeof(cfg.mist));
+        prefs.putUInt("tlm_batch", cfg.telemetry_batch_sec);
+        prefs.putUChar("wire_fmt", cfg.wire_format);
+        prefs.putString("ntp", cfg.ntp_server);
+        prefs.putUInt("sample_ms", cfg.sample_ms);
+        // putBytes() menolak panjang 0, jadi tabel kosong = key dihapus.
+        if (cfg.zone_count) {
+            prefs.putBytes("zones", cfg.zones, sizeof(ZoneConfig) * cfg.zone_count);
+        } else {
+            prefs.remove("zones");
+        }
         prefs.end();
     }
 };
 
 ConfigStorage configStorage;
 
+// =================================================================
+//   TELEMETRY BUFFER CLASS
+// =================================================================
+
+// Ring buffer pembacaan yang belum terkirim. Urutan replay: halaman NVS
+// (paling tua) lebih dulu, lalu isi RAM. Halaman NVS bertahan saat reboot.
+class TelemetryBuffer {
+public:
+    void begin() {
+#if TELEMETRY_SPILL_ENABLED
+        Preferences prefs;
+        prefs.begin("jamur-tlm", true);
+        pageHead = prefs.getUInt("head", 0) % TELEMETRY_SPILL_PAGES;
+        pageCount = prefs.getUInt("count", 0);
+        dropped = prefs.getUInt("dropped", 0);
+        prefs.end();
+        if (pageCount > TELEMETRY_SPILL_PAGES) pageCount = 0;
+#endif
+    }
+    
+    void push(const TelemetryRecord& record) {
+        if (ramCount == TELEMETRY_BUFFER_LEN) {
+#if TELEMETRY_SPILL_ENABLED
+            spill_oldest_page();
+#else
+            ramTail = (ramTail + 1) % TELEMETRY_BUFFER_LEN;
+            ramCount--;
+            dropped++;
+#endif
+        }
+        ram[(ramTail + ramCount) % TELEMETRY_BUFFER_LEN] = record;
+        ramCount++;
+    }
+    
+    // Salin maksimal maxCount record tertua tanpa menghapusnya.
+    size_t peek(TelemetryRecord* out, size_t maxCount) {
+#if TELEMETRY_SPILL_ENABLED
+        if (stagedCount == 0 && pageCount > 0) load_oldest_page();
+        if (stagedCount > 0) {
+            size_t n = min(maxCount, (size_t)(stagedCount - stagedPos));
+            memcpy(out, &staged[stagedPos], n * sizeof(TelemetryRecord));
+            return n;
+        }
+#endif
+        size_t n = min(maxCount, (size_t)ramCount);
+        for (size_t i = 0; i < n; i++) out[i] = ram[(ramTail + i) % TELEMETRY_BUFFER_LEN];
+        return n;
+    }
+    
+    // Hapus count record yang sudah berhasil dipublish (hasil peek terakhir).
+    void pop(size_t count) {
+        replayed += count;
+#if TELEMETRY_SPILL_ENABLED
+        if (stagedCount > 0) {
+            stagedPos += count;
+            if (stagedPos >= stagedCount) {
+                stagedCount = stagedPos = 0;
+                drop_oldest_page();
+            }
+            return;
+        }
+#endif
+        ramTail = (ramTail + count) % TELEMETRY_BUFFER_LEN;
+        ramCount -= count;
+    }
+    
+    bool empty() const {
+#if TELEMETRY_SPILL_ENABLED
+        if (pageCount > 0) return false;
+#endif
+        return ramCount == 0;
+    }
+    
+    TelemetryBufferStats stats() const {
+        TelemetryBufferStats st;
+        st.ram_depth = ramCount;
+#if TELEMETRY_SPILL_ENABLED
+        st.flash_depth = pageCount * TELEMETRY_SPILL_PAGE_LEN - stagedPos;
+#else
+        st.flash_depth = 0;
+#endif
+        st.dropped = dropped;
+        st.replayed = replayed;
+        return st;
+    }
+
+private:
+    TelemetryRecord ram[TELEMETRY_BUFFER_LEN];
+    uint16_t ramTail = 0;
+    uint16_t ramCount = 0;
+    uint32_t dropped = 0;
+    uint32_t replayed = 0;
+#if TELEMETRY_SPILL_ENABLED
+    uint32_t pageHead = 0;
+    uint32_t pageCount = 0;
+    TelemetryRecord staged[TELEMETRY_SPILL_PAGE_LEN];
+    uint16_t stagedCount = 0;
+    uint16_t stagedPos = 0;
+    
+    static void page_key(char* key, size_t size, uint32_t index) {
+        snprintf(key, size, "p%u", (unsigned)(index % TELEMETRY_SPILL_PAGES));
+    }
+    
+    void spill_oldest_page() {
+        TelemetryRecord page[TELEMETRY_SPILL_PAGE_LEN];
+        for (int i = 0; i < TELEMETRY_SPILL_PAGE_LEN; i++) page[i] = ram[(ramTail + i) % TELEMETRY_BUFFER_LEN];
+        ramTail = (ramTail + TELEMETRY_SPILL_PAGE_LEN) % TELEMETRY_BUFFER_LEN;
+        ramCount -= TELEMETRY_SPILL_PAGE_LEN;
+        
+        if (pageCount == TELEMETRY_SPILL_PAGES) {
+            // Halaman tertua sedang di-stage untuk replay: buang juga salinannya.
+            if (stagedCount > 0) {
+                dropped += stagedCount - stagedPos;
+                stagedCount = stagedPos = 0;
+            } else {
+                dropped += TELEMETRY_SPILL_PAGE_LEN;
+            }
+            pageHead = (pageHead + 1) % TELEMETRY_SPILL_PAGES;
+            pageCount--;
+        }
+        
+        char key[8];
+        page_key(key, sizeof(key), pageHead + pageCount);
+        Preferences prefs;
+        prefs.begin("jamur-tlm", false);
+        if (prefs.putBytes(key, page, sizeof(page)) == sizeof(page)) {
+            pageCount++;
+        } else {
+            dropped += TELEMETRY_SPILL_PAGE_LEN;
+        }
+        save_index(prefs);
+        prefs.end();
+    }
+    
+    void load_oldest_page() {
+        char key[8];
+        page_key(key, sizeof(key), pageHead);
+        Preferences prefs;
+        prefs.begin("jamur-tlm", true);
+        size_t len = prefs.getBytes(key, staged, sizeof(staged));
+        prefs.end();
+        stagedCount = len / sizeof(TelemetryRecord);
+        stagedPos = 0;
+        if (stagedCount == 0) drop_oldest_page();
+    }
+    
+    void drop_oldest_page() {
+        char key[8];
+        page_key(key, sizeof(key), pageHead);
+        pageHead = (pageHead + 1) % TELEMETRY_SPILL_PAGES;
+        pageCount--;
+        Preferences prefs;
+        prefs.begin("jamur-tlm", false);
+        prefs.remove(key);
+        save_index(prefs);
+        prefs.end();
+    }
+    
+    void save_index(Preferences& prefs) {
+        prefs.putUInt("head", pageHead);
+        prefs.putUInt("count", pageCount);
+        prefs.putUInt("dropped", dropped);
+    }
+#endif
+};
+
+TelemetryBuffer telemetryBuffer;
+unsigned long lastTelemetryReplayTime = 0;
+
+// Akumulator mode batch: sampel mentah + ringkasan, dikirim sekali per jendela.
+struct TelemetryBatch {
+    TelemetryRecord samples[TELEMETRY_BATCH_MAX_SAMPLES];
+    uint16_t count;
+    unsigned long startMillis;
+    long rssiSum;
+    int rssiMin;
+    uint16_t pumpOnSamples;
+};
+
+TelemetryBatch telemetryBatch;
+
 // =================================================================
 //   FUNCTION DECLARATIONS
 // =================================================================
 
 // Initialization Functions
 void init_hardware();
+void init_primary_sensor();
 void load_config();
 void save_config();
 void init_storage_and_wifi();
@@ -151,10 +518,22 @@ void loop();
 
 // State Management Functions
 void handle_connecting_state();
-void handle_normal_operation();
 void start_ap_mode();
 void handle_web_root();
 void handle_web_save();
+void handle_web_style();
+void handle_web_script();
+void handle_web_networks();
+void handle_web_connect();
+void handle_web_status();
+const char* portal_validate(const String& ssid, const String& pass);
+void portal_send_json(int code, const JsonDocument& doc);
+void portal_scan_start();
+void portal_scan_poll();
+void portal_connect_poll();
+void portal_poll();
+void send_portal_page(int code, const GzipAsset& asset, const char* const values[], const char* cacheControl);
+void portal_write(void* ctx, const uint8_t* data, size_t len);
 
 // Display Functions
 void display_boot_screen();
@@ -167,30 +546,116 @@ void display_menu_info();
 // Input Functions
 void check_buttons();
 
+// Task Functions
+void control_task(void* param);
+void network_task(void* param);
+void start_control_task();
+void start_network_task();
+bool request_pump(PumpCommandType type, const char* reason);
+bool post_net_event(const NetEvent& event);
+void handle_net_event(const NetEvent& event);
+void handle_network_logic();
+
+// Metrics Functions
+StageStamp stage_begin();
+uint32_t stage_end(MetricStage stage, const StageStamp& start);
+void publish_metrics();
+void dump_metrics();
+void handle_wifi_command(const char* args);
+void check_serial_commands();
+
 // Control Logic Functions
 void handle_main_logic();
+void handle_sensor_sample();
+void apply_sample_rate();
+void report_sensor_health(bool healthy);
 void run_humidity_control_logic(float humidity);
-void run_scheduled_control(float humidity);
-void turn_pump_on(const char* reason);
+void run_scheduled_control(float humidity, bool timeTrusted);
+bool parse_schedule_entry(JsonVariantConst value, ScheduleEntry& entry);
+void append_schedule_json(JsonArray out, const ScheduleEntry* entries, uint8_t count);
+uint32_t turn_pump_on(const char* reason, uint32_t durationMs);
 void turn_pump_off();
+void service_pump();
+void init_pump_cutoff_timer();
+void pump_cutoff_callback(void* arg);
+void pump_relay_on(uint32_t requestedMs);
+void pump_relay_off();
+float pump_budget_liters(const PumpProfile& profile);
+bool parse_pump_profile(JsonVariantConst value, PumpProfile& profile);
+bool parse_control_tuning(JsonVariantConst value, ControlTuning& tuning);
+bool parse_mist_tuning(JsonVariantConst value, MistTuning& tuning);
+void save_pump_usage();
 void publish_pump_countdown(int seconds);
 void update_pump_countdown();
 
+// Zone Functions
+void sync_zones();
+const ZoneConfig* zone_config(const ZoneRuntime& zone);
+void zone_install(uint8_t index, const ZoneConfig& cfg);
+void zone_uninstall(uint8_t index);
+void poll_zones();
+uint32_t zones_until_next(uint32_t nowMs);
+void handle_zone_sample(uint8_t index);
+void run_zone_logic(uint8_t index);
+bool zone_pump_on(uint8_t index, const char* reason, uint32_t durationMs);
+void zone_pump_off(uint8_t index);
+void zone_cutoff_callback(void* arg);
+bool zone_pin_usable(int pin);
+bool parse_zone_config(JsonVariantConst value, ZoneConfig& zone);
+bool zone_table_valid(const ZoneConfig* zones, uint8_t count);
+
 // Communication Functions
+void check_and_reconnect_wifi();
+void log_wifi_roam();
+void log_time_sync();
 void try_reconnect_mqtt();
+void mqtt_link_init();
+void mqtt_link_fail(const char* phase);
+void mqtt_link_schedule_retry();
+void on_mqtt_connected();
 void mqtt_callback(char* topic, byte* payload, unsigned int length);
-void handle_config_update(byte* payload, unsigned int length);
-void publish_telemetry();
+void handle_config_update(byte* payload, unsigned int length, WireFormat format);
+void publish_notification(const char* type, const char* message, float humidity, float temperature);
+void publish_telemetry(const TelemetryRecord& record);
+void publish_zone_telemetry(uint8_t index, const char* name, const TelemetryRecord& record);
+void buffer_telemetry(const TelemetryRecord& record);
+void replay_telemetry_backlog();
+void add_telemetry_batch_sample(const TelemetryRecord& record);
+void publish_telemetry_batch();
 void publish_wifi_signal();
 void publish_config();
 void publish_current_version();
 void publish_firmware_status(const char* status);
 void publish_firmware_update_progress(const char* stage, int progress, const char* message);
-void trigger_email_notification(const NotificationData& data);
+bool trigger_email_notification(const EmailJob& job);
+bool queue_email_notification(const NotificationData& data);
+void email_task(void* param);
+void start_email_task();
 void check_for_firmware_update();
 
+// Firmware Rollout Functions
+uint32_t client_id_hash();
+const String& rollout_id(const FirmwareInfo& info);
+void schedule_firmware_update(const FirmwareInfo& info, JsonVariantConst rollout, bool force);
+void check_firmware_rollout();
+void handle_rollout_report(byte* payload, unsigned int length);
+void halt_firmware_rollout(const String& version, bool announce);
+uint8_t rollout_attempts(const String& version);
+void record_rollout_attempt(const String& version);
+
 // OTA Update Functions
-void perform_ota_update(String url);
+void perform_ota_update(String url, String sha256, String patchUrl, String patchFrom);
+bool ota_fetch(const String& url, DeltaPatcher* patcher, const char*& failMsg);
+void ota_writer_task(void* param);
+void start_ota_writer_task();
+uint8_t* ota_fill_space(size_t& space);
+void ota_fill_commit(size_t length);
+void ota_fill_flush();
+bool ota_emit(const uint8_t* data, size_t length);
+uint32_t ota_wait_flushed();
+void ota_reset_image();
+bool parse_sha256_hex(const char* hex, uint8_t out[32]);
+long parse_content_range_start(const String& value);
 void handle_ota_error(const char* lcdMsg, const char* logMsg, int code);
 
 // Utility Functions
@@ -201,7 +666,13 @@ void publish_speedtest(float ping_ms, float download_mbps, float upload_mbps);
 float speedtest_ping_ms(const char* host, uint16_t port, uint8_t count);
 float speedtest_download_mbps(const char* url, size_t test_size);
 float speedtest_upload_mbps(const char* url, size_t test_size);
-void run_and_publish_speedtest();
+bool speedtest_cancelled();
+bool speedtest_should_abort();
+void run_speedtest(SpeedtestResult& result);
+void speedtest_task(void* param);
+void start_speedtest_task();
+void cancel_speedtest();
+void poll_speedtest_result();
 
 // =================================================================
 //   FUNCTION IMPLEMENTATIONS
@@ -215,19 +686,47 @@ void init_hardware() {
     Serial.println("Inisialisasi hardware...");
     pinMode(PUMP_RELAY_PIN, OUTPUT);
     digitalWrite(PUMP_RELAY_PIN, LOW);
+    init_pump_cutoff_timer();
     pinMode(BTN_UP_PIN, INPUT_PULLUP);
     pinMode(BTN_DOWN_PIN, INPUT_PULLUP);
     pinMode(BTN_OK_PIN, INPUT_PULLUP);
     pinMode(BTN_BACK_PIN, INPUT_PULLUP);
-    dht.begin();
+    i2cBus.begin(I2C_SDA_PIN, I2C_SCL_PIN, I2C_CLOCK_HZ);
+    init_primary_sensor();
+    configMutex = xSemaphoreCreateMutex();
+    wifiMutex = xSemaphoreCreateMutex();
     lcd.init();
     lcd.backlight();
     display_boot_screen();
 }
 
+// Sensor I2C di bus LCD lebih disukai; DHT_PIN hanya dipasang bila tidak
+// ada yang menjawab, sehingga kanal RMT-nya tetap bebas.
+void init_primary_sensor() {
+#if SENSOR_I2C_AUTODETECT
+    I2cSensor* found = I2cSensor::detect(i2cBus, SENSOR_I2C_INTERVAL_MS);
+    if (found) {
+        primarySensor = found;
+        Serial.printf("[SENSOR] %s terdeteksi di 0x%02X, DHT tidak dipakai.\n", found->name(), found->address());
+        return;
+    }
+#endif
+    if (!dhtSampler.begin()) Serial.println("[DHT] Inisialisasi RMT gagal, sensor tidak dibaca.");
+}
+
 void load_config() {
     Serial.println("Memuat konfigurasi...");
     configStorage.load(config);
+    if (!waterSchedule.set(config.schedules, config.schedule_count)) {
+        Serial.println("Jadwal tersimpan tidak valid, jadwal dikosongkan.");
+        config.schedule_count = 0;
+        waterSchedule.set(config.schedules, 0);
+    }
+    // Pemakaian air hari terakhir; direset saat jam tepercaya menunjukkan hari lain.
+    Preferences prefs;
+    prefs.begin("jamur-pump", true);
+    pumpEngine.restore(prefs.getInt("day", -1), prefs.getUInt("used_ms", 0));
+    prefs.end();
     Serial.println("Konfigurasi dimuat.");
 }
 
@@ -241,6 +740,9 @@ void init_storage_and_wifi() {
     Serial.println("Inisialisasi penyimpanan dan WiFi...");
     preferences.begin("jamur-app", false);
     WiFi.mode(WIFI_AP_STA);
+    // Reconnect diatur wifiRoamer; auto-reconnect driver akan berebut radio.
+    WiFi.setAutoReconnect(false);
+    wifiCredentials.begin();
     
     String mac = WiFi.macAddress();
     mac.replace(":", "");
@@ -260,6 +762,7 @@ void init_storage_and_wifi() {
             preferences.clear();
             preferences.end();
             preferences.begin("jamur-app", false);
+            wifiCredentials.clear();
         }
         
         String stored_ssid = preferences.getString("wifi_ssid", "");
@@ -306,23 +809,31 @@ void init_storage_and_wifi() {
         }
     }
     preferences.end();
+    // SSID utama selalu ada di daftar roaming; urutan yang ada tidak berubah.
+    if (currentState == STATE_CONNECTING) wifiCredentials.add(WIFI_SSID, WIFI_PASSWORD);
 }
 
+// Tidak menunggu NTP: sinkron berjalan di latar belakang dan selama jam
+// belum dipercaya hanya jadwal penyiraman yang ditahan.
 void init_mqtt() {
-    Serial.println("Sinkronisasi waktu NTP...");
-    configTime(GMT_OFFSET_SEC, DAYLIGHT_OFFSET_SEC, NTP_SERVER);
-    struct tm timeinfo;
-    while (!getLocalTime(&timeinfo) || timeinfo.tm_year < (2022 - 1900)) {
-        Serial.println("Gagal mendapatkan waktu, retry 1 detik...");
-        delay(NTP_RETRY_DELAY);
-    }
-    Serial.println("Waktu tersinkron.");
+    timeSync.begin(GMT_OFFSET_SEC, DAYLIGHT_OFFSET_SEC, config.ntp_server, NTP_SERVER);
+    Serial.printf("Waktu: %s, SNTP berjalan (%s%s%s).\n", TimeSync::quality_name(timeSync.quality()),
+                  config.ntp_server, config.ntp_server[0] ? ", " : "", NTP_SERVER);
     
     Serial.println("Setup koneksi TLS...");
+    // Sesi tersimpan dengan jam di depan jam sekarang (belum sinkron)
+    // dianggap kedaluwarsa; connect pertama cukup handshake penuh.
+    mqttTlsCache.begin();
+    supabaseTlsCache.begin();
+    Serial.printf("Sesi TLS tersimpan: mqtt=%s supabase=%s\n",
+                  mqttTlsCache.valid_for(MQTT_BROKER) ? "ada" : "tidak", supabaseTlsCache.length() ? "ada" : "tidak");
     espClient.setCACert(HIVE_MQ_ROOT_CA);
+    espClient.setHandshakeTimeout(MQTT_TLS_HANDSHAKE_TIMEOUT_S);
     mqttClient.setServer(MQTT_BROKER, MQTT_PORT);
     mqttClient.setKeepAlive(MQTT_KEEP_ALIVE_SEC);
+    mqttClient.setBufferSize(MQTT_BUFFER_SIZE);
     mqttClient.setCallback(mqtt_callback);
+    mqtt_link_init();
 }
 
 // =================================================================
@@ -337,62 +848,82 @@ void setup() {
     
     init_hardware();
     load_config();
+    telemetryBuffer.begin();
+    metricsCpuMhz = ESP.getCpuFreqMHz();
+    // Cutoff pompa dan perintah tombol harus jalan di semua state, termasuk mode AP.
+    start_control_task();
     init_storage_and_wifi();
     
     pumpCountdownSeconds = 0;
 }
 
+// loop() kini hanya UI: tombol, LCD, portal AP dan proses koneksi awal.
+// Sensor/pompa ada di control_task, MQTT di network_task.
 void loop() {
+    StageStamp loopStart = stage_begin();
     check_buttons();
-    
-    static unsigned long lastCountdownMillis = 0;
-    unsigned long now = millis();
-    if (now - lastCountdownMillis >= 1000 || lastCountdownMillis == 0) {
-        update_pump_countdown();
-        lastCountdownMillis = now;
-    }
+    check_serial_commands();
     
     switch (currentState) {
         case STATE_AP_MODE:
             server.handleClient();
+            portal_poll();
             break;
         case STATE_CONNECTING:
             handle_connecting_state();
             break;
         case STATE_NORMAL_OPERATION:
-            check_and_reconnect_wifi();
-            try_reconnect_mqtt();
-            mqttClient.loop();
-            handle_main_logic();
             display_normal_info();
             break;
         case STATE_MENU_INFO:
-            break;
         case STATE_UPDATING:
-            delay(1000);
             break;
     }
+    stage_end(STAGE_UI_LOOP, loopStart);
 }
 
 // =================================================================
 //   STATE MANAGEMENT FUNCTIONS
 // =================================================================
 
+// Dipanggil tiap loop(); tombol dan LCD tetap responsif selama wifiRoamer
+// mencoba petunjuk AP terakhir lalu kandidat hasil scan.
 void handle_connecting_state() {
-    display_connecting_wifi();
-    Serial.printf("Mencoba koneksi ke WiFi: %s\n", WIFI_SSID);
-    WiFi.begin(WIFI_SSID, WIFI_PASSWORD);
+    static bool started = false;
+    static unsigned long lastDotAt = 0;
+    
+    if (!started) {
+        started = true;
+        lastDotAt = millis();
+        display_connecting_wifi();
+        // Dari portal AP, STA sudah tersambung dengan kredensial yang baru diuji.
+        if (WiFi.status() != WL_CONNECTED) {
+            Serial.printf("Mencoba koneksi WiFi (%u kredensial tersimpan)...\n", wifiCredentials.count());
+            wifiRoamer.start();
+        }
+    }
     
-    for (int attempt = 0; attempt < WIFI_CONNECT_ATTEMPTS && WiFi.status() != WL_CONNECTED; attempt++) {
-        delay(WIFI_CONNECT_DELAY);
-        Serial.print(".");
+    if (WiFi.status() != WL_CONNECTED) {
+        wifiRoamer.poll();
+        if (wifiRoamer.busy()) {
+            if (millis() - lastDotAt >= WIFI_CONNECT_DELAY) {
+                lastDotAt = millis();
+                Serial.print(".");
+            }
+            return;
+        }
     }
+    started = false;
     
     if (WiFi.status() == WL_CONNECTED) {
         Serial.println("\nWiFi terhubung!");
+        if (wifiRoamer.state() == ROAM_CONNECTED) log_wifi_roam();
         Serial.printf("IP Address: %s\n", WiFi.localIP().toString().c_str());
         init_mqtt();
+        start_email_task();
+        start_speedtest_task();
         currentState = STATE_NORMAL_OPERATION;
+        start_network_task();
     } else {
         Serial.printf("\nKoneksi WiFi gagal. Status: %d\n", WiFi.status());
         Serial.println("Masuk ke mode AP untuk konfigurasi WiFi...");
@@ -402,47 +933,10 @@ void handle_connecting_state() {
     }
 }
 
-void handle_normal_operation() {
-    if (!mqttClient.connected() && millis() - lastMqttRetryTime > MQTT_RETRY_INTERVAL) {
-        lastMqttRetryTime = millis();
-        Serial.print("Mencoba koneksi MQTT (TLS)...");
-        
-        if (mqttClient.connect(
-                mqttClientId,
-                MQTT_USER,
-                MQTT_PASSWORD,
-                TOPICS.status,
-                1,
-                true,
-                "{\"state\":\"offline\"}"
-            )) {
-            Serial.println("terhubung!");
-            mqttClient.publish(TOPICS.status, "{\"state\":\"online\"}", true);
-            mqttClient.subscribe(TOPICS.pump_control);
-            mqttClient.subscribe(TOPICS.config_set);
-            mqttClient.subscribe(TOPICS.system_update);
-            publish_config();
-            publish_current_version();
-            
-            publish_pump_countdown(pumpCountdownSeconds);
-            mqttClient.publish(TOPICS.pump_control, isPumpOn ? "ON" : "OFF", true);
-            
-            Serial.println("Berlangganan topik MQTT sukses.");
-        } else {
-            Serial.printf("gagal, rc=%d. ", mqttClient.state());
-            char error_buf[100];
-            espClient.lastError(error_buf, sizeof(error_buf));
-            Serial.printf("Keterangan: %s\n", error_buf);
-        }
-    }
-    
-    mqttClient.loop();
-    handle_main_logic();
-    display_normal_info();
-}
-
 void start_ap_mode() {
     Serial.println("Mode Access Point (AP)...");
+    // STA berhenti mencoba SSID lama supaya scan portal tidak bentrok.
+    WiFi.disconnect();
     WiFi.softAP(AP_SSID, AP_PASSWORD);
     IPAddress IP = WiFi.softAPIP();
     display_ap_info(IP);
@@ -450,60 +944,65 @@ void start_ap_mode() {
     
     server.on("/", HTTP_GET, handle_web_root);
     server.on("/save", HTTP_POST, handle_web_save);
+    server.on("/portal.css", HTTP_GET, handle_web_style);
+    server.on("/portal.js", HTTP_GET, handle_web_script);
+    server.on("/networks", HTTP_GET, handle_web_networks);
+    server.on("/connect", HTTP_POST, handle_web_connect);
+    server.on("/status", HTTP_GET, handle_web_status);
     server.begin();
     Serial.println("Web server dimulai.");
+    // Hasil scan pertama biasanya sudah siap saat browser membuka portal.
+    portal_scan_start();
+}
+
+// Halaman portal berasal dari portal/* yang dikompres saat build
+// (tools/build_portal.py -> include/portal_assets.h). Body dikirim sebagai
+// gzip dari flash per potongan; SSID dan pesan error disisipkan ter-escape
+// oleh GzipTemplate tanpa membangun String.
+void send_portal_page(int code, const GzipAsset& asset, const char* const values[], const char* cacheControl) {
+    server.sendHeader("Content-Encoding", "gzip");
+    server.sendHeader("Cache-Control", cacheControl);
+    server.setContentLength(GzipTemplate::length(asset, values));
+    server.send(code, asset.contentType, "");
+    GzipTemplate::write(asset, values, portal_write, nullptr);
+}
+
+void portal_write(void* ctx, const uint8_t* data, size_t len) {
+    (void)ctx;
+    server.sendContent((const char*)data, len);
 }
 
 void handle_web_root() {
-    String html = "<html><head><title>Jamur IoT Setup</title>";
-    html += "<meta name='viewport' content='width=device-width, initial-scale=1'></head>";
-    html += "<style>body{font-family: Arial, sans-serif; text-align: center; margin: 20px; background-color: #f4f4f4;}";
-    html += "div{background: white; padding: 20px; border-radius: 8px; box-shadow: 0 2px 4px rgba(0,0,0,0.1); margin-bottom: 20px;}";
-    html += "input{width: calc(100% - 22px); padding: 10px; margin-bottom: 10px; border-radius: 4px; border: 1px solid #ccc;}";
-    html += "button{padding: 10px 20px; background-color: #007bff; color: white; border: none; border-radius: 4px; cursor: pointer; margin: 5px;}";
-    html += ".info{background-color: #e7f3ff; border-left: 4px solid #007bff; padding: 10px; margin: 10px 0; text-align: left;}";
-    html += ".warning{background-color: #fff3cd; border-left: 4px solid #ffc107; padding: 10px; margin: 10px 0; text-align: left;}</style>";
-    html += "<body><div><h1>🌱 Konfigurasi WiFi Jamur IoT</h1>";
-    html += "<div class='info'><strong>Info:</strong> Perangkat tidak dapat terhubung ke WiFi yang tersimpan. Silakan masukkan kredensial WiFi yang benar.</div>";
-    html += "<form action='/save' method='post'>";
-    html += "<input type='text' name='ssid' placeholder='Nama WiFi (SSID)' required><br>";
-    html += "<input type='password' name='pass' placeholder='Password WiFi'><br>";
-    html += "<button type='submit'>💾 Simpan & Reboot</button>";
-    html += "</form>";
-    html += "<div class='warning'><strong>Catatan:</strong> Setelah menyimpan, perangkat akan restart dan mencoba terhubung ke WiFi baru.</div>";
-    html += "</div></body></html>";
-    server.send(200, "text/html", html);
+    const char* values[PORTAL_FIELD_COUNT] = {};
+    values[PORTAL_FIELD_SSID] = WIFI_SSID;
+    send_portal_page(200, PORTAL_INDEX, values, "no-store");
+}
+
+void handle_web_style() {
+    send_portal_page(200, PORTAL_STYLE, nullptr, "max-age=86400");
+}
+
+void handle_web_script() {
+    send_portal_page(200, PORTAL_SCRIPT, nullptr, "max-age=86400");
+}
+
+const char* portal_validate(const String& ssid, const String& pass) {
+    if (ssid.length() == 0) return "SSID tidak boleh kosong.";
+    if (ssid.length() > 32) return "SSID terlalu panjang (maks 32 karakter).";
+    if (pass.length() > 64) return "Password terlalu panjang (maks 64 karakter).";
+    return nullptr;
 }
 
+// Jalur tanpa JavaScript: simpan langsung lalu restart seperti sebelumnya.
+// Portal dengan JavaScript memakai /connect yang menguji kredensial dulu.
 void handle_web_save() {
     String new_ssid = server.arg("ssid");
     String new_pass = server.arg("pass");
-    String errorHtml = "<html><head><title>Error - Jamur IoT</title>";
-    errorHtml += "<meta name='viewport' content='width=device-width, initial-scale=1'></head>";
-    errorHtml += "<style>body{font-family: Arial, sans-serif; text-align: center; margin: 20px; background-color: #f4f4f4;}";
-    errorHtml += "div{background: white; padding: 20px; border-radius: 8px; box-shadow: 0 2px 4px rgba(0,0,0,0.1);}";
-    errorHtml += ".error{background-color: #f8d7da; border-left: 4px solid #dc3545; padding: 10px; margin: 10px 0; text-align: left;}";
-    errorHtml += "button{padding: 10px 20px; background-color: #007bff; color: white; border: none; border-radius: 4px; cursor: pointer;}</style>";
-    
-    if (new_ssid.length() == 0) {
-        errorHtml += "<body><div><h1>❌ Gagal!</h1>";
-        errorHtml += "<div class='error'><strong>Error:</strong> SSID tidak boleh kosong.</div>";
-        errorHtml += "<button onclick='history.back()'>← Kembali</button></div></body></html>";
-        server.send(400, "text/html", errorHtml);
-        return;
-    }
-    if (new_ssid.length() > 32) {
-        errorHtml += "<body><div><h1>❌ Gagal!</h1>";
-        errorHtml += "<div class='error'><strong>Error:</strong> SSID terlalu panjang (maks 32 karakter).</div>";
-        errorHtml += "<button onclick='history.back()'>← Kembali</button></div></body></html>";
-        server.send(400, "text/html", errorHtml);
-        return;
-    }
-    if (new_pass.length() > 64) {
-        errorHtml += "<body><div><h1>❌ Gagal!</h1>";
-        errorHtml += "<div class='error'><strong>Error:</strong> Password terlalu panjang (maks 64 karakter).</div>";
-        errorHtml += "<button onclick='history.back()'>← Kembali</button></div></body></html>";
-        server.send(400, "text/html", errorHtml);
+    const char* values[PORTAL_FIELD_COUNT] = {};
+    
+    values[PORTAL_FIELD_MESSAGE] = portal_validate(new_ssid, new_pass);
+    if (values[PORTAL_FIELD_MESSAGE]) {
+        send_portal_page(400, PORTAL_ERROR, values, "no-store");
         return;
     }
     lcd_show_message("Menyimpan Data..", "");
@@ -514,20 +1013,199 @@ void handle_web_save() {
     prefs.putBool("ota_done", true); // Tandai sudah pernah OTA
     prefs.end();
     Serial.printf("Kredensial baru disimpan: SSID=%s\n", new_ssid.c_str());
-    String successHtml = "<html><head><title>Berhasil - Jamur IoT</title>";
-    successHtml += "<meta name='viewport' content='width=device-width, initial-scale=1'></head>";
-    successHtml += "<style>body{font-family: Arial, sans-serif; text-align: center; margin: 20px; background-color: #f4f4f4;}";
-    successHtml += "div{background: white; padding: 20px; border-radius: 8px; box-shadow: 0 2px 4px rgba(0,0,0,0.1);}";
-    successHtml += ".success{background-color: #d4edda; border-left: 4px solid #28a745; padding: 10px; margin: 10px 0; text-align: left;}</style>";
-    successHtml += "<body><div><h1>✅ Data Tersimpan!</h1>";
-    successHtml += "<div class='success'><strong>Berhasil:</strong> Kredensial WiFi baru telah disimpan.</div>";
-    successHtml += "<p>Perangkat akan restart dalam 5 detik dan mencoba terhubung ke WiFi baru.</p>";
-    successHtml += "<p><small>SSID: " + new_ssid + "</small></p>";
-    successHtml += "</div></body></html>";
-    server.send(200, "text/html", successHtml);
+    values[PORTAL_FIELD_SSID] = new_ssid.c_str();
+    send_portal_page(200, PORTAL_SAVED, values, "no-store");
     pause_and_restart(ERROR_RESTART_DELAY);
 }
 
+void portal_send_json(int code, const JsonDocument& doc) {
+    char body[PORTAL_JSON_SIZE];
+    serializeJson(doc, body);
+    server.sendHeader("Cache-Control", "no-store");
+    server.send(code, "application/json", body);
+}
+
+// Hasil scan di-cache; browser yang meminta daftar basi memicu scan baru
+// dan menerima cache lama dengan "scanning":true sampai scan selesai.
+void handle_web_networks() {
+    bool stale = portalScanAt == 0 || millis() - portalScanAt > PORTAL_SCAN_MAX_AGE_MS;
+    if (stale || server.hasArg("refresh")) portal_scan_start();
+    
+    JsonDocument doc;
+    doc["scanning"] = portalScanRunning;
+    doc["age_s"] = portalScanAt ? (long)((millis() - portalScanAt) / 1000) : -1L;
+    JsonArray networks = doc["networks"].to<JsonArray>();
+    for (uint8_t i = 0; i < portalNetworkCount; i++) {
+        JsonObject net = networks.add<JsonObject>();
+        net["ssid"] = portalNetworks[i].ssid;
+        net["rssi"] = portalNetworks[i].rssi;
+        net["ch"] = portalNetworks[i].channel;
+        net["auth"] = portalNetworks[i].auth;
+    }
+    portal_send_json(200, doc);
+}
+
+// Hanya memulai uji koneksi; hasilnya dibaca browser lewat /status.
+void handle_web_connect() {
+    String new_ssid = server.arg("ssid");
+    String new_pass = server.arg("pass");
+    JsonDocument doc;
+    const char* error = portal_validate(new_ssid, new_pass);
+    if (!error && portalConnect.state == PORTAL_CONNECT_OK) error = "Perangkat sudah terhubung.";
+    if (error) {
+        doc["ok"] = false;
+        doc["message"] = error;
+        portal_send_json(400, doc);
+        return;
+    }
+    
+    if (portalConnect.state == PORTAL_CONNECT_TESTING) WiFi.disconnect();
+    portalConnect = {};
+    portalConnect.state = PORTAL_CONNECT_TESTING;
+    strlcpy(portalConnect.ssid, new_ssid.c_str(), sizeof(portalConnect.ssid));
+    strlcpy(portalConnect.pass, new_pass.c_str(), sizeof(portalConnect.pass));
+    portalConnect.startedAt = millis();
+    Serial.printf("Portal: uji koneksi ke SSID=%s\n", portalConnect.ssid);
+    lcd_show_message("Uji WiFi:", portalConnect.ssid);
+    
+    doc["ok"] = true;
+    portal_send_json(202, doc);
+}
+
+void handle_web_status() {
+    static const char* const stateNames[] = { "idle", "testing", "connected", "failed" };
+    JsonDocument doc;
+    doc["state"] = stateNames[portalConnect.state];
+    doc["ssid"] = portalConnect.ssid;
+    if (portalConnect.state == PORTAL_CONNECT_OK) doc["ip"] = WiFi.localIP().toString();
+    if (portalConnect.message[0]) doc["message"] = portalConnect.message;
+    portal_send_json(200, doc);
+}
+
+void portal_scan_start() {
+    if (portalScanRunning || portalConnect.state == PORTAL_CONNECT_TESTING) return;
+    // async: scanNetworks() langsung kembali, hasil diambil portal_scan_poll().
+    if (WiFi.scanNetworks(true) == WIFI_SCAN_FAILED) {
+        Serial.println("Portal: scan WiFi gagal dimulai.");
+        return;
+    }
+    portalScanRunning = true;
+}
+
+// Mengisi cache terurut dari RSSI terkuat. AP mesh/repeater dengan SSID sama
+// cukup tampil sekali; SSID tersembunyi dilewati.
+void portal_scan_poll() {
+    if (!portalScanRunning) return;
+    int16_t found = WiFi.scanComplete();
+    if (found == WIFI_SCAN_RUNNING) return;
+    portalScanRunning = false;
+    if (found < 0) {
+        Serial.println("Portal: scan WiFi gagal, cache lama dipakai.");
+        return;
+    }
+    
+    portalNetworkCount = 0;
+    for (int16_t i = 0; i < found; i++) {
+        String ssid = WiFi.SSID(i);
+        int8_t rssi = WiFi.RSSI(i);
+        if (ssid.length() == 0 || ssid.length() > 32) continue;
+        
+        uint8_t pos = 0;
+        while (pos < portalNetworkCount && strcmp(portalNetworks[pos].ssid, ssid.c_str()) != 0) pos++;
+        if (pos < portalNetworkCount) {
+            if (portalNetworks[pos].rssi >= rssi) continue;
+        } else if (portalNetworkCount < PORTAL_SCAN_MAX) {
+            portalNetworkCount++;
+        } else {
+            pos = PORTAL_SCAN_MAX - 1;
+            if (portalNetworks[pos].rssi >= rssi) continue;
+        }
+        strlcpy(portalNetworks[pos].ssid, ssid.c_str(), sizeof(portalNetworks[pos].ssid));
+        portalNetworks[pos].rssi = rssi;
+        portalNetworks[pos].channel = WiFi.channel(i);
+        portalNetworks[pos].auth = WiFi.encryptionType(i);
+        for (; pos > 0 && portalNetworks[pos - 1].rssi < portalNetworks[pos].rssi; pos--) {
+            std::swap(portalNetworks[pos - 1], portalNetworks[pos]);
+        }
+    }
+    WiFi.scanDelete();
+    portalScanAt = millis();
+    Serial.printf("Portal: scan WiFi selesai, %d AP, %u jaringan.\n", found, portalNetworkCount);
+}
+
+// Kredensial disimpan hanya setelah WL_CONNECTED. Setelah PORTAL_HANDOFF_MS
+// AP dimatikan dan perangkat lanjut lewat STATE_CONNECTING tanpa restart.
+void portal_connect_poll() {
+    switch (portalConnect.state) {
+        case PORTAL_CONNECT_IDLE:
+        case PORTAL_CONNECT_FAILED:
+            return;
+        
+        case PORTAL_CONNECT_OK:
+            if (millis() - portalHandoffAt < PORTAL_HANDOFF_MS) return;
+            Serial.println("Portal ditutup, lanjut ke operasi normal.");
+            server.stop();
+            WiFi.softAPdisconnect(true);
+            portalConnect = {};
+            currentState = STATE_CONNECTING;
+            return;
+        
+        case PORTAL_CONNECT_TESTING:
+            break;
+    }
+    
+    // Radio tidak bisa scan dan asosiasi bersamaan.
+    if (!portalConnect.begun) {
+        if (portalScanRunning) return;
+        WiFi.begin(portalConnect.ssid, portalConnect.pass);
+        portalConnect.begun = true;
+        portalConnect.startedAt = millis();
+        return;
+    }
+    
+    wl_status_t status = WiFi.status();
+    if (status == WL_CONNECTED) {
+        Preferences prefs;
+        prefs.begin("jamur-app", false);
+        prefs.putString("wifi_ssid", portalConnect.ssid);
+        prefs.putString("wifi_pass", portalConnect.pass);
+        prefs.putBool("ota_done", true);
+        prefs.end();
+        strlcpy(WIFI_SSID, portalConnect.ssid, sizeof(WIFI_SSID));
+        strlcpy(WIFI_PASSWORD, portalConnect.pass, sizeof(WIFI_PASSWORD));
+        int index = wifiCredentials.add(portalConnect.ssid, portalConnect.pass);
+        if (index >= 0) wifiCredentials.remember(index, WiFi.BSSID(), WiFi.channel());
+        Serial.printf("Portal: terhubung ke %s (%s), kredensial disimpan.\n",
+                      portalConnect.ssid, WiFi.localIP().toString().c_str());
+        lcd_show_message("WiFi Tersimpan!", portalConnect.ssid);
+        portalConnect.state = PORTAL_CONNECT_OK;
+        portalHandoffAt = millis();
+        return;
+    }
+    
+    const char* reason = nullptr;
+    if (status == WL_NO_SSID_AVAIL) {
+        reason = "Jaringan tidak ditemukan, pastikan router dalam jangkauan.";
+    } else if (status == WL_CONNECT_FAILED) {
+        reason = "Koneksi ditolak router, periksa password.";
+    } else if (millis() - portalConnect.startedAt > PORTAL_CONNECT_TIMEOUT_MS) {
+        // Password salah di ESP32 sering hanya terlihat sebagai timeout.
+        reason = "Tidak tersambung dalam batas waktu, periksa password.";
+    }
+    if (!reason) return;
+    
+    WiFi.disconnect();
+    Serial.printf("Portal: koneksi ke %s gagal (status %d).\n", portalConnect.ssid, status);
+    lcd_show_message("WiFi Gagal!", "Cek portal AP");
+    portalConnect.state = PORTAL_CONNECT_FAILED;
+    portalConnect.message = reason;
+}
+
+void portal_poll() {
+    portal_scan_poll();
+    portal_connect_poll();
+}
+
 // =================================================================
 //   DISPLAY FUNCTIONS
 // =================================================================
@@ -568,17 +1246,21 @@ void display_normal_info() {
     lastDisplayTime = millis();
     okButtonPressed = false;
     
+    StageStamp start = stage_begin();
+    i2cBus.take(portMAX_DELAY);
     lcd.clear();
     lcd.setCursor(0, 0);
     char line1[LCD_LINE_LENGTH];
-    snprintf(line1, LCD_LINE_LENGTH, "H:%.1f%% T:%.1fC", currentHumidity, currentTemperature);
+    snprintf(line1, LCD_LINE_LENGTH, "H:%.1f%% T:%.1fC", currentHumidity.load(), currentTemperature.load());
     lcd.print(line1);
     
     lcd.setCursor(0, 1);
     char line2[LCD_LINE_LENGTH];
     const char* pumpStatusStr = isPumpOn ? "ON " : "OFF";
-    snprintf(line2, LCD_LINE_LENGTH, "P:%s MQTT:%s", pumpStatusStr, mqttClient.connected() ? "OK" : "ERR");
+    snprintf(line2, LCD_LINE_LENGTH, "P:%s MQTT:%s", pumpStatusStr, mqttConnected.load() ? "OK" : "ERR");
     lcd.print(line2);
+    i2cBus.give();
+    stage_end(STAGE_DISPLAY, start);
 }
 
 void display_menu_info() {
@@ -598,7 +1280,7 @@ void check_buttons() {
                 btnOkPressTime = millis();
             } else if (millis() - btnOkPressTime > LONG_PRESS_MS && !okButtonLongPress) {
                 Serial.println("Tombol OK ditekan lama -> Siram Manual");
-                turn_pump_on("manual_fisik");
+                request_pump(PUMP_CMD_ON, "manual_fisik");
                 okButtonLongPress = true;
             }
         }
@@ -627,227 +1309,1515 @@ void check_buttons() {
     }
 }
 
+// Dipanggil dari control_task: hanya sensor dan keputusan pompa, semua
+// publish dititipkan ke network_task lewat netEventQueue.
+// Nilai yang dipakai adalah keluaran filter; frame DHT yang gagal sesekali
+// tidak lagi melewatkan tick, hanya sensor yang diam > DHT_STALE_MS.
 void handle_main_logic() {
-    if (millis() - lastLogicCheckTime >= LOGIC_CHECK_INTERVAL_MS) {
-        lastLogicCheckTime = millis();
-        currentHumidity = dht.readHumidity();
-        currentTemperature = dht.readTemperature();
-        
-        if (isnan(currentHumidity) || isnan(currentTemperature)) return;
-        
-        publish_telemetry();
-        run_humidity_control_logic(currentHumidity);
-        run_scheduled_control(currentHumidity);
-    }
+    if (millis() - lastLogicCheckTime < LOGIC_CHECK_INTERVAL_MS) return;
+    lastLogicCheckTime = millis();
     
-    if (millis() - lastWifiSignalPublishTime >= WIFI_SIGNAL_PUBLISH_INTERVAL_MS) {
-        lastWifiSignalPublishTime = millis();
-        publish_wifi_signal();
+    StageStamp start = stage_begin();
+    bool stale = millis() - lastSensorAcceptTime >= DHT_STALE_MS;
+    report_sensor_health(!stale);
+    if (stale || !humidityFilter.ready() || !temperatureFilter.ready()) {
+        stage_end(STAGE_MAIN_LOGIC, start);
+        return;
     }
+    float humidity = humidityFilter.value();
+    float temperature = temperatureFilter.value();
+    currentHumidity = humidity;
+    currentTemperature = temperature;
     
-    if (isPumpOn && millis() >= pumpStopTime) {
-        turn_pump_off();
-    }
+    NetEvent event = {};
+    event.type = NET_EVT_TELEMETRY;
+    event.record = { (uint32_t)time(nullptr), humidity, temperature };
+    post_net_event(event);
     
-    if (millis() - lastPeriodicNotifTime >= NOTIF_PERIODIC_INTERVAL_MS) {
-        lastPeriodicNotifTime = millis();
-        char msg[PERIODIC_MSG_SIZE];
-        snprintf(msg, PERIODIC_MSG_SIZE, "Periodic status: H=%.1f%%, T=%.1fC, Pump=%s", currentHumidity, currentTemperature, isPumpOn ? "ON" : "OFF");
-        send_notification("info", msg, currentHumidity, currentTemperature);
+    // Budget air harian mengikuti hari lokal; tanpa jam tepercaya hari tidak berganti.
+    bool timeTrusted = timeSync.trusted();
+    int64_t localNow = (int64_t)time(nullptr) + GMT_OFFSET_SEC + DAYLIGHT_OFFSET_SEC;
+    if (timeTrusted && pumpEngine.roll_day((int32_t)(localNow / 86400))) {
+        Serial.println("[POMPA] Hari baru, pemakaian air direset.");
     }
     
-    long rssi = WiFi.RSSI();
-    if ((millis() - lastSpeedtestTime >= SPEEDTEST_INTERVAL_MS) || (rssi < SPEEDTEST_RSSI_THRESHOLD)) {
-        lastSpeedtestTime = millis();
-        run_and_publish_speedtest();
-    }
+    xSemaphoreTake(configMutex, portMAX_DELAY);
+    run_humidity_control_logic(humidity);
+    run_scheduled_control(humidity, timeTrusted);
+    xSemaphoreGive(configMutex);
+    stage_end(STAGE_MAIN_LOGIC, start);
 }
 
-// =================================================================
-//   EMAIL NOTIFICATION VARIABLES
-// =================================================================
+// Pembacaan baru dari primarySensor; hanya mengisi filter.
+void handle_sensor_sample() {
+    const SensorReading& reading = primarySensor->last();
+    if (reading.status != SENSOR_OK) return;
+    if (humidityFilter.push(reading.humidity)) lastSensorAcceptTime = millis();
+    temperatureFilter.push(reading.temperature);
+}
 
-unsigned long lastEmailSent_firmware = 0;
-unsigned long lastEmailSent_warning = 0;
-unsigned long lastEmailSent_critical = 0;
-unsigned long lastEmailSent_normal = 0;
+// "sample_ms" 0 = interval bawaan jenis sensor; di bawah min_interval()
+// dinaikkan oleh set_interval().
+void apply_sample_rate() {
+    xSemaphoreTake(configMutex, portMAX_DELAY);
+    uint32_t requested = config.sample_ms;
+    xSemaphoreGive(configMutex);
+    if (requested == 0) requested = primarySensor == &dhtSampler ? DHT_SAMPLE_INTERVAL_MS : SENSOR_I2C_INTERVAL_MS;
+    primarySensor->set_interval(requested);
+    Serial.printf("[SENSOR] %s dibaca tiap %lu ms.\n", primarySensor->name(), (unsigned long)primarySensor->interval());
+}
 
-bool can_send_email(unsigned long& lastSent, unsigned long minInterval) {
-    unsigned long now = millis();
-    if (now < lastSent) lastSent = 0;
-    if (now - lastSent >= minInterval) {
-        lastSent = now;
-        return true;
+// Notifikasi hanya saat status berubah, seperti zona humidityControl.
+void report_sensor_health(bool healthy) {
+    if (healthy == sensorHealthy) return;
+    sensorHealthy = healthy;
+    const SensorStats& s = primarySensor->stats();
+    Serial.printf("[SENSOR] %s %s: ok=%lu timeout=%lu checksum=%lu outlier=%lu/%lu beruntun=%u\n",
+                  primarySensor->name(), healthy ? "pulih" : "tidak merespons", (unsigned long)s.ok,
+                  (unsigned long)s.timeouts, (unsigned long)s.checksum, (unsigned long)humidityFilter.rejected(),
+                  (unsigned long)temperatureFilter.rejected(), s.consecutive);
+    if (healthy) {
+        send_notification("info", "Humidity sensor recovered, automatic control resumed.", -1, -1);
+    } else {
+        send_notification("warning", "Humidity sensor not responding, automatic control paused.", -1, -1);
     }
-    return false;
 }
 
-void run_humidity_control_logic(float humidity) {
-    if (humidity < config.humidity_critical) {
-        turn_pump_on("auto_critical");
-        if (lastNotifState != NOTIF_CRITICAL) {
-            send_notification("warning", "Humidity below critical threshold! Pump turned ON.", humidity, currentTemperature);
-            
-            NotificationData data;
-            data.type = "critical_alert";
-            data.message = "Kelembapan di bawah ambang batas kritis!";
-            data.humidity = humidity;
-            data.temperature = currentTemperature;
-            
-            if (can_send_email(lastEmailSent_critical, EMAIL_MIN_INTERVAL_ALERT_MS)) {
-                trigger_email_notification(data);
-            } else {
-                Serial.println("[EMAIL] Critical alert diabaikan (rate limit).");
-            }
-            lastNotifState = NOTIF_CRITICAL;
-        }
-    } else if (humidity < config.humidity_warning) {
-        if (lastNotifState != NOTIF_WARNING) {
-            send_notification("warning", "Warning: Humidity approaching lower limit.", humidity, currentTemperature);
-            
-            NotificationData data;
-            data.type = "warning";
-            data.message = "Kelembapan mendekati ambang batas.";
-            data.humidity = humidity;
-            data.temperature = currentTemperature;
-            
-            if (can_send_email(lastEmailSent_warning, EMAIL_MIN_INTERVAL_ALERT_MS)) {
-                trigger_email_notification(data);
+// =================================================================
+//   TASK FUNCTIONS
+// =================================================================
+// control_task (core 1, prioritas tinggi) memiliki relay, sensor dan cutoff
+// pompa. network_task (core 0) memiliki WiFi, mqttClient, buffer telemetri
+// dan OTA. Keduanya hanya berbagi atomics dan dua queue, sehingga latency
+// cutoff pompa tidak lagi bergantung pada handshake TLS atau HTTP.
+//
+// Akhir tiap pulsa dijatuhkan timer cutoff walau task ini tertahan
+// (configMutex). Tunggu antrian dipendekkan sampai transisi berikutnya di
+// pumpEngine atau tahap sensor berikutnya, sehingga pulsa setelah jeda
+// rendam, sinyal start DHT dan pengambilan hasil konversi I2C tepat waktu.
+// Dari zona rak hanya sampler di kursor rotasi yang ikut dihitung.
+
+void control_task(void* param) {
+    (void)param;
+    PumpCommand cmd;
+    for (;;) {
+        unsigned long now = millis();
+        uint32_t waitMs = min<uint32_t>(CONTROL_TASK_PERIOD_MS,
+                                        min(pumpEngine.until_next(now), primarySensor->until_next(now)));
+        waitMs = min(waitMs, zones_until_next(now));
+        bool received = xQueueReceive(pumpCommandQueue, &cmd, pdMS_TO_TICKS(waitMs)) == pdTRUE;
+        StageStamp start = stage_begin();
+        if (received) {
+            if (cmd.type == PUMP_CMD_ON) {
+                xSemaphoreTake(configMutex, portMAX_DELAY);
+                turn_pump_on(cmd.reason, config.pump.base_s * 1000UL);
+                xSemaphoreGive(configMutex);
             } else {
-                Serial.println("[EMAIL] Warning alert diabaikan (rate limit).");
+                turn_pump_off();
             }
-            lastNotifState = NOTIF_WARNING;
         }
-    } else {
-        if (lastNotifState != NOTIF_NORMAL) {
-            send_notification("info", "Humidity back to normal.", humidity, currentTemperature);
-            
-            NotificationData data;
-            data.type = "info";
-            data.message = "Kondisi kelembapan kembali normal.";
-            data.humidity = humidity;
-            data.temperature = currentTemperature;
-            
-            if (can_send_email(lastEmailSent_normal, EMAIL_MIN_INTERVAL_ALERT_MS)) {
-                trigger_email_notification(data);
-            } else {
-                Serial.println("[EMAIL] Normal info diabaikan (rate limit).");
-            }
-            lastNotifState = NOTIF_NORMAL;
+        
+        if (zonesChanged.exchange(false)) sync_zones();
+        if (sampleRateChanged.exchange(false)) apply_sample_rate();
+        service_pump();
+        if (primarySensor->poll(millis())) handle_sensor_sample();
+        poll_zones();
+        
+        AppState state = currentState;
+        if (state == STATE_NORMAL_OPERATION || state == STATE_MENU_INFO) {
+            handle_main_logic();
         }
+        stage_end(STAGE_CONTROL, start);
     }
 }
 
-void run_scheduled_control(float humidity) {
-    struct tm timeinfo;
-    if (!getLocalTime(&timeinfo)) return;
-    
-    int currentHour = timeinfo.tm_hour;
-    if (currentHour != lastScheduledHour) {
-        for (int i = 0; i < config.schedule_count; i++) {
-            if (currentHour == config.schedule_hours[i]) {
-                if (humidity >= config.humidity_critical) {
-                    turn_pump_on("scheduled");
-                    send_notification("info", "Scheduled watering executed.", humidity, currentTemperature);
-                } else {
-                    char msg[SCHEDULE_MSG_SIZE];
-                    snprintf(msg, SCHEDULE_MSG_SIZE, "Scheduled watering at %d:00 skipped, humidity critical (%.1f%%).", currentHour, humidity);
-                    send_notification("info", msg, humidity, currentTemperature);
-                }
-                lastScheduledHour = currentHour;
-                break;
-            }
+void network_task(void* param) {
+    (void)param;
+    NetEvent event;
+    for (;;) {
+        StageStamp start = stage_begin();
+        check_and_reconnect_wifi();
+        stage_end(STAGE_WIFI, start);
+        
+        try_reconnect_mqtt();
+        
+        start = stage_begin();
+        mqttClient.loop();
+        mqttConnected = mqttClient.connected();
+        stage_end(STAGE_MQTT_LOOP, start);
+        
+        if (xQueueReceive(netEventQueue, &event, pdMS_TO_TICKS(NETWORK_TASK_PERIOD_MS)) == pdTRUE) {
+            do {
+                start = stage_begin();
+                handle_net_event(event);
+                stage_end(STAGE_NET_EVENT, start);
+            } while (xQueueReceive(netEventQueue, &event, 0) == pdTRUE);
         }
+        
+        start = stage_begin();
+        handle_network_logic();
+        if (timeSync.loop()) log_time_sync();
+        stage_end(STAGE_NET_LOGIC, start);
     }
 }
 
-void turn_pump_on(const char* reason) {
-    if (isPumpOn) return;
-    
-    isPumpOn = true;
-    pumpStopTime = millis() + PUMP_DURATION_MS;
-    pumpCountdownSeconds = (PUMP_DURATION_MS + 999) / 1000;
-    
-    digitalWrite(PUMP_RELAY_PIN, HIGH);
-    mqttClient.publish(TOPICS.status, "{\"state\":\"pumping\"}");
-    
-    publish_pump_countdown(pumpCountdownSeconds);
-    
-    char msg[PUMP_MSG_SIZE];
-    snprintf(msg, PUMP_MSG_SIZE, "Pump turned ON (%s).", reason);
-    send_notification("info", msg, currentHumidity, currentTemperature);
+void start_control_task() {
+    if (controlTaskHandle) return;
+    pumpCommandQueue = xQueueCreate(PUMP_COMMAND_QUEUE_LEN, sizeof(PumpCommand));
+    netEventQueue = xQueueCreate(NET_EVENT_QUEUE_LEN, sizeof(NetEvent));
+    xTaskCreatePinnedToCore(control_task, "control", CONTROL_TASK_STACK, nullptr,
+                            CONTROL_TASK_PRIORITY, &controlTaskHandle, CONTROL_TASK_CORE);
 }
 
-void turn_pump_off() {
-    if (!isPumpOn) return;
-    
-    isPumpOn = false;
-    digitalWrite(PUMP_RELAY_PIN, LOW);
-    
-    mqttClient.publish(TOPICS.status, "{\"state\":\"idle\"}");
-    mqttClient.publish(TOPICS.pump_control, "OFF", true);
-    
-    pumpCountdownSeconds = 0;
-    publish_pump_countdown(0);
-    
-    send_notification("info", "Pump turned OFF.", currentHumidity, currentTemperature);
+void start_network_task() {
+    if (networkTaskHandle) return;
+    xTaskCreatePinnedToCore(network_task, "network", NETWORK_TASK_STACK, nullptr,
+                            NETWORK_TASK_PRIORITY, &networkTaskHandle, NETWORK_TASK_CORE);
 }
 
-// =================================================================
-//   COMMUNICATION FUNCTIONS
-// =================================================================
+bool request_pump(PumpCommandType type, const char* reason) {
+    PumpCommand cmd = {};
+    cmd.type = type;
+    strlcpy(cmd.reason, reason, sizeof(cmd.reason));
+    if (xQueueSend(pumpCommandQueue, &cmd, 0) != pdTRUE) {
+        Serial.println("[POMPA] Antrian perintah penuh, perintah diabaikan.");
+        return false;
+    }
+    return true;
+}
 
-void try_reconnect_mqtt() {
-    if (!mqttClient.connected() && millis() - lastMqttRetryTime > MQTT_RETRY_INTERVAL) {
-        lastMqttRetryTime = millis();
-        Serial.print("Mencoba koneksi MQTT (TLS)...");
-        
-        if (mqttClient.connect(
-                mqttClientId,
+// Tidak pernah menunggu: control_task tidak boleh tertahan oleh jaringan.
+bool post_net_event(const NetEvent& event) {
+    if (!netEventQueue || xQueueSend(netEventQueue, &event, 0) != pdTRUE) {
+        netEventsDropped++;
+        return false;
+    }
+    return true;
+}
+
+void handle_net_event(const NetEvent& event) {
+    switch (event.type) {
+        case NET_EVT_TELEMETRY:
+            publish_telemetry(event.record);
+            break;
+        case NET_EVT_ZONE_TELEMETRY:
+            publish_zone_telemetry(event.zone, event.text, event.record);
+            break;
+        case NET_EVT_NOTIFICATION:
+            publish_notification(event.kind, event.text, event.record.humidity, event.record.temperature);
+            break;
+        case NET_EVT_PUMP_STARTED: {
+            mqttClient.publish(TOPICS.status, "{\"state\":\"pumping\"}");
+            pumpCountdownSeconds = (event.duration_ms + 999) / 1000;
+            publish_pump_countdown(pumpCountdownSeconds);
+            char msg[PUMP_MSG_SIZE];
+            snprintf(msg, PUMP_MSG_SIZE, "Pump turned ON (%.100s).", event.text);
+            publish_notification("info", msg, event.record.humidity, event.record.temperature);
+            break;
+        }
+        case NET_EVT_PUMP_STOPPED: {
+            mqttClient.publish(TOPICS.status, "{\"state\":\"idle\"}");
+            mqttClient.publish(TOPICS.pump_control, "OFF", true);
+            pumpCountdownSeconds = 0;
+            publish_pump_countdown(0);
+            save_pump_usage();
+            char msg[PUMP_MSG_SIZE];
+            snprintf(msg, PUMP_MSG_SIZE, "Pump turned OFF (%.1f L today).",
+                     pumpEngine.used_ms() / 60000.0f * PUMP_FLOW_ML_PER_MIN / 1000.0f);
+            publish_notification("info", msg, event.record.humidity, event.record.temperature);
+            break;
+        }
+    }
+}
+
+void handle_network_logic() {
+    static unsigned long lastCountdownMillis = 0;
+    if (millis() - lastCountdownMillis >= 1000) {
+        update_pump_countdown();
+        lastCountdownMillis = millis();
+    }
+    
+    if (config.telemetry_batch_sec == 0 && millis() - lastWifiSignalPublishTime >= WIFI_SIGNAL_PUBLISH_INTERVAL_MS) {
+        lastWifiSignalPublishTime = millis();
+        publish_wifi_signal();
+    }
+    
+    if (config.telemetry_batch_sec == 0 && millis() - lastPeriodicNotifTime >= NOTIF_PERIODIC_INTERVAL_MS) {
+        lastPeriodicNotifTime = millis();
+        float humidity = currentHumidity;
+        float temperature = currentTemperature;
+        char msg[PERIODIC_MSG_SIZE];
+        snprintf(msg, PERIODIC_MSG_SIZE, "Periodic status: H=%.1f%%, T=%.1fC, Pump=%s", humidity, temperature, isPumpOn ? "ON" : "OFF");
+        publish_notification("info", msg, humidity, temperature);
+    }
+    
+    replay_telemetry_backlog();
+    poll_speedtest_result();
+    check_firmware_rollout();
+    
+    if (millis() - lastMetricsPublishTime >= METRICS_PUBLISH_INTERVAL_MS) {
+        lastMetricsPublishTime = millis();
+        publish_metrics();
+    }
+    
+    static uint32_t lastDropped = 0;
+    uint32_t dropped = netEventsDropped;
+    if (dropped != lastDropped) {
+        Serial.printf("[TASK] %u event jaringan dibuang (antrian penuh).\n", (unsigned)(dropped - lastDropped));
+        lastDropped = dropped;
+    }
+}
+
+// =================================================================
+//   METRICS FUNCTIONS
+// =================================================================
+// CCOUNT milik core yang sedang berjalan; semua task yang diukur di-pin ke
+// satu core, jadi selisih siklus dalam satu tahap selalu konsisten.
+
+StageStamp stage_begin() {
+    return { ESP.getCycleCount(), (uint32_t)millis() };
+}
+
+uint32_t stage_end(MetricStage stage, const StageStamp& start) {
+    uint32_t elapsedMs = (uint32_t)millis() - start.ms;
+    uint32_t us = elapsedMs < METRICS_CYCLE_WRAP_GUARD_MS
+        ? (ESP.getCycleCount() - start.cycles) / metricsCpuMhz
+        : elapsedMs * 1000UL;
+    portENTER_CRITICAL(&metricsMux);
+    stageHistograms[stage].record(us);
+    portEXIT_CRITICAL(&metricsMux);
+    return us;
+}
+
+// Satu jendela per publish; histogram di-snapshot satu per satu agar stack
+// network_task tidak perlu menampung semuanya. Jendela yang gagal terkirim
+// dibuang, sama seperti wifi_signal.
+void publish_metrics() {
+    unsigned long now = millis();
+    char payload[METRICS_PAYLOAD_SIZE];
+    size_t size = sizeof(payload);
+    int len = snprintf(payload, size, "{\"window_s\":%lu,\"unit\":\"us\",\"stages\":{",
+                       (now - metricsWindowStart) / 1000UL);
+    metricsWindowStart = now;
+    
+    for (int i = 0; i < STAGE_COUNT; i++) {
+        portENTER_CRITICAL(&metricsMux);
+        LatencyHistogram h = stageHistograms[i];
+        stageHistograms[i].reset();
+        portEXIT_CRITICAL(&metricsMux);
+        if (len < (int)size) {
+            len += snprintf(payload + len, size - len, "%s\"%s\":[%lu,%lu,%lu,%lu]", i ? "," : "",
+                            METRIC_STAGE_NAMES[i], (unsigned long)h.count(), (unsigned long)h.percentile(50),
+                            (unsigned long)h.percentile(99), (unsigned long)h.max());
+        }
+    }
+    if (len < (int)size) {
+        len += snprintf(payload + len, size - len, "},\"mqtt\":{\"attempts\":%lu,\"connects\":%lu,\"failures\":%lu},\"tls\":{",
+                        (unsigned long)mqttLink.attempts, (unsigned long)mqttLink.connects,
+                        (unsigned long)mqttLink.failures);
+    }
+    for (int i = 0; i < TLS_TARGET_COUNT; i++) {
+        if (len >= (int)size) break;
+        // [penuh, resume, gagal, rata2 ms penuh, rata2 ms resume], kumulatif sejak boot.
+        const TlsSessionStats& t = TLS_TARGET_CACHES[i]->stats();
+        len += snprintf(payload + len, size - len, "%s\"%s\":[%lu,%lu,%lu,%lu,%lu]", i ? "," : "", TLS_TARGET_NAMES[i],
+                        (unsigned long)t.full, (unsigned long)t.resumed, (unsigned long)t.failed,
+                        (unsigned long)(t.full ? t.full_ms_total / t.full : 0),
+                        (unsigned long)(t.resumed ? t.resumed_ms_total / t.resumed : 0));
+    }
+    if (len < (int)size) {
+        // [terarah, lewat scan, petunjuk basi, gagal, ms reconnect terakhir], kumulatif sejak boot.
+        const WifiRoamStats& w = wifiRoamer.stats();
+        len += snprintf(payload + len, size - len, "},\"wifi\":[%lu,%lu,%lu,%lu,%lu]",
+                        (unsigned long)w.fast, (unsigned long)w.ranked, (unsigned long)w.stale,
+                        (unsigned long)w.failed, (unsigned long)wifiRoamer.last().ms);
+    }
+    if (len < (int)size) {
+        // Model jam; age_s dan err_ms 0 bila belum pernah sinkron.
+        TimeSyncStatus t = timeSync.status();
+        len += snprintf(payload + len, size - len, ",\"time\":{\"q\":\"%s\",\"syncs\":%lu,\"age_s\":%lu,"
+                        "\"offset_ms\":%ld,\"drift_ppm\":%.2f,\"err_ms\":%lu}",
+                        TimeSync::quality_name(t.quality), (unsigned long)t.syncs, (unsigned long)t.ageSec,
+                        (long)t.lastOffsetMs, t.driftPpm, (unsigned long)t.errorMs);
+    }
+    if (len < (int)size) {
+        // [program, pulsa, detik on hari ini, dipangkas budget, ditolak budget,
+        //  overrun relay terburuk sejak boot (us)].
+        const PumpStats& p = pumpEngine.stats();
+        len += snprintf(payload + len, size - len, ",\"pump\":[%lu,%lu,%lu,%lu,%lu,%lu]",
+                        (unsigned long)p.programs, (unsigned long)p.pulses, (unsigned long)(pumpEngine.used_ms() / 1000),
+                        (unsigned long)p.trimmed, (unsigned long)p.denied, (unsigned long)pumpTiming.worstOverrunUs);
+    }
+    if (len < (int)size) {
+        // [jenis, ok, timeout, checksum, outlier %RH, outlier C, ditunda bus I2C], kumulatif sejak boot.
+        const SensorStats& d = primarySensor->stats();
+        len += snprintf(payload + len, size - len, ",\"sensor\":[\"%s\",%lu,%lu,%lu,%lu,%lu,%lu]",
+                        primarySensor->name(), (unsigned long)d.ok, (unsigned long)d.timeouts,
+                        (unsigned long)d.checksum, (unsigned long)humidityFilter.rejected(),
+                        (unsigned long)temperatureFilter.rejected(), (unsigned long)d.deferred);
+    }
+    if (len < (int)size) {
+        // [pergantian zona, ditahan dwell, pemicu laju turun], kumulatif sejak boot.
+        const ControlStats& c = humidityControl.stats();
+        len += snprintf(payload + len, size - len, ",\"ctrl\":[%lu,%lu,%lu]",
+                        (unsigned long)c.changes, (unsigned long)c.held, (unsigned long)c.early);
+    }
+    if (len < (int)size) {
+        // [fit model, kejadian siram terukur, pulsa prediktif, gain x1000 (%RH/detik, 0 = belum)].
+        const MistStats& m = mistPredictor.stats();
+        float gain = mistPredictor.gain();
+        len += snprintf(payload + len, size - len, ",\"mist\":[%lu,%lu,%lu,%lu]",
+                        (unsigned long)m.fits, (unsigned long)m.events, (unsigned long)m.plans,
+                        (unsigned long)(isnan(gain) ? 0 : lroundf(gain * 1000.0f)));
+    }
+    // Per zona rak aktif: [frame ok, frame gagal, siraman, detik on], kumulatif sejak zona dipasang.
+    if (len < (int)size) len += snprintf(payload + len, size - len, ",\"zones\":{");
+    xSemaphoreTake(configMutex, portMAX_DELAY);
+    for (int i = 0, n = 0; i < ZONE_MAX && len < (int)size; i++) {
+        const ZoneRuntime& zone = zoneRuntime[i];
+        if (!zone.active) continue;
+        const SensorStats& d = zone.sampler->stats();
+        len += snprintf(payload + len, size - len, "%s\"%s\":[%lu,%lu,%lu,%lu]", n++ ? "," : "", zone.name,
+                        (unsigned long)d.ok, (unsigned long)(d.timeouts + d.checksum), (unsigned long)zone.pumps,
+                        (unsigned long)(zone.pumpMs / 1000));
+    }
+    xSemaphoreGive(configMutex);
+    if (len < (int)size) len += snprintf(payload + len, size - len, "}}");
+    if (len >= (int)size) {
+        Serial.println("[METRICS] Payload terlalu besar, cek METRICS_PAYLOAD_SIZE.");
+        return;
+    }
+    if (mqttClient.connected()) mqttClient.publish(TOPICS.metrics, payload);
+}
+
+// Dump jendela berjalan tanpa mereset (dipicu perintah serial "metrics").
+void dump_metrics() {
+    Serial.printf("[METRICS] Jendela %lu s, satuan us\n", (millis() - metricsWindowStart) / 1000UL);
+    Serial.println("  tahap              n        p50        p99        max       mean");
+    for (int i = 0; i < STAGE_COUNT; i++) {
+        portENTER_CRITICAL(&metricsMux);
+        LatencyHistogram h = stageHistograms[i];
+        portEXIT_CRITICAL(&metricsMux);
+        Serial.printf("  %-12s %8lu %10lu %10lu %10lu %10lu\n", METRIC_STAGE_NAMES[i], (unsigned long)h.count(),
+                      (unsigned long)h.percentile(50), (unsigned long)h.percentile(99),
+                      (unsigned long)h.max(), (unsigned long)h.mean());
+    }
+    Serial.println("  tls (kumulatif)  penuh   resume    gagal  rata2_ms_penuh rata2_ms_resume");
+    for (int i = 0; i < TLS_TARGET_COUNT; i++) {
+        const TlsSessionStats& t = TLS_TARGET_CACHES[i]->stats();
+        Serial.printf("  %-12s %8lu %8lu %8lu %9lu %9lu\n", TLS_TARGET_NAMES[i], (unsigned long)t.full,
+                      (unsigned long)t.resumed, (unsigned long)t.failed,
+                      (unsigned long)(t.full ? t.full_ms_total / t.full : 0),
+                      (unsigned long)(t.resumed ? t.resumed_ms_total / t.resumed : 0));
+    }
+    const SensorStats& d = primarySensor->stats();
+    Serial.printf("  sensor %s tiap %lu ms ok=%lu timeout=%lu checksum=%lu outlier=%lu/%lu beruntun=%u\n",
+                  primarySensor->name(), (unsigned long)primarySensor->interval(), (unsigned long)d.ok,
+                  (unsigned long)d.timeouts, (unsigned long)d.checksum, (unsigned long)humidityFilter.rejected(),
+                  (unsigned long)temperatureFilter.rejected(), d.consecutive);
+    Serial.printf("  i2c ditunda=%lu rebutan=%lu error=%lu\n", (unsigned long)d.deferred,
+                  (unsigned long)i2cBus.contended(), (unsigned long)i2cBus.errors());
+    const ControlStats& c = humidityControl.stats();
+    Serial.printf("  kontrol zona=%u ganti=%lu ditahan=%lu laju=%lu (%.2f %%RH/menit)\n", humidityControl.zone(),
+                  (unsigned long)c.changes, (unsigned long)c.held, (unsigned long)c.early, humidityControl.rate());
+    const MistStats& m = mistPredictor.stats();
+    Serial.printf("  prediktif fit=%lu siram=%lu pulsa=%lu gain=%.3f %%RH/s laju=%.3f %%RH/menit\n",
+                  (unsigned long)m.fits, (unsigned long)m.events, (unsigned long)m.plans, mistPredictor.gain(),
+                  mistPredictor.trend(currentHumidity, currentTemperature));
+    xSemaphoreTake(configMutex, portMAX_DELAY);
+    for (int i = 0; i < ZONE_MAX; i++) {
+        const ZoneRuntime& zone = zoneRuntime[i];
+        if (!zone.active) continue;
+        const SensorStats& d = zone.sampler->stats();
+        Serial.printf("  zona %-10s H=%.1f%% kontrol=%u ok=%lu gagal=%lu siram=%lu on=%lu s pompa=%s\n", zone.name,
+                      zone.humidity.value(), zone.control.zone(), (unsigned long)d.ok,
+                      (unsigned long)(d.timeouts + d.checksum), (unsigned long)zone.pumps,
+                      (unsigned long)(zone.pumpMs / 1000), zone.pumpOn ? "ON" : "OFF");
+    }
+    xSemaphoreGive(configMutex);
+    log_time_sync();
+}
+
+// "wifi" menampilkan daftar roaming, "wifi add <ssid> <password>" (password
+// = kata terakhir, "-" untuk jaringan terbuka), "wifi del <ssid>".
+void handle_wifi_command(const char* args) {
+    while (*args == ' ') args++;
+    bool modify = strncmp(args, "add ", 4) == 0 || strncmp(args, "del ", 4) == 0;
+    xSemaphoreTake(wifiMutex, portMAX_DELAY);
+    if (modify && wifiRoamer.busy()) {
+        Serial.println("[WIFI] Reconnect sedang berjalan, coba lagi.");
+    } else if (strncmp(args, "add ", 4) == 0) {
+        const char* ssid = args + 4;
+        const char* space = strrchr(ssid, ' ');
+        size_t ssidLen = space ? (size_t)(space - ssid) : 0;
+        char name[33];
+        if (ssidLen == 0 || ssidLen >= sizeof(name)) {
+            Serial.println("[WIFI] Format: wifi add <ssid> <password|->");
+        } else {
+            memcpy(name, ssid, ssidLen);
+            name[ssidLen] = '\0';
+            const char* pass = strcmp(space + 1, "-") == 0 ? "" : space + 1;
+            int index = wifiCredentials.add(name, pass);
+            if (index < 0) {
+                Serial.println("[WIFI] Password terlalu panjang (maks 64 karakter).");
+            } else {
+                Serial.printf("[WIFI] %s disimpan (%u/%u).\n", name, wifiCredentials.count(), WifiCredentialStore::kMax);
+            }
+        }
+    } else if (strncmp(args, "del ", 4) == 0) {
+        Serial.printf(wifiCredentials.remove(args + 4) ? "[WIFI] %s dihapus.\n" : "[WIFI] %s tidak ada di daftar.\n", args + 4);
+    } else if (args[0]) {
+        Serial.println("[WIFI] Perintah: wifi | wifi add <ssid> <password|-> | wifi del <ssid>");
+    } else {
+        Serial.printf("[WIFI] %u kredensial, urut prioritas:\n", wifiCredentials.count());
+        for (uint8_t i = 0; i < wifiCredentials.count(); i++) {
+            const WifiCredential& c = wifiCredentials.at(i);
+            if (c.channel) {
+                Serial.printf("  %u. %-32s %02X:%02X:%02X:%02X:%02X:%02X ch %u\n", i + 1, c.ssid, c.bssid[0], c.bssid[1],
+                              c.bssid[2], c.bssid[3], c.bssid[4], c.bssid[5], c.channel);
+            } else {
+                Serial.printf("  %u. %-32s belum pernah tersambung\n", i + 1, c.ssid);
+            }
+        }
+        const WifiRoamStats& w = wifiRoamer.stats();
+        Serial.printf("[WIFI] terarah=%lu scan=%lu basi=%lu gagal=%lu, reconnect terakhir %lu ms\n",
+                      (unsigned long)w.fast, (unsigned long)w.ranked, (unsigned long)w.stale, (unsigned long)w.failed,
+                      (unsigned long)wifiRoamer.last().ms);
+    }
+    xSemaphoreGive(wifiMutex);
+}
+
+void check_serial_commands() {
+    static char line[SERIAL_COMMAND_SIZE];
+    static size_t lineLen = 0;
+    while (Serial.available() > 0) {
+        int c = Serial.read();
+        if (c < 0) break;
+        if (c == '\r') continue;
+        if (c != '\n') {
+            if (lineLen < sizeof(line) - 1) line[lineLen++] = (char)c;
+            continue;
+        }
+        line[lineLen] = '\0';
+        lineLen = 0;
+        if (strcmp(line, "metrics") == 0) {
+            dump_metrics();
+        } else if (strncmp(line, "wifi", 4) == 0 && (line[4] == '\0' || line[4] == ' ')) {
+            handle_wifi_command(line + 4);
+        } else if (line[0]) {
+            Serial.printf("Perintah serial tidak dikenal: %s\n", line);
+        }
+    }
+}
+
+// =================================================================
+//   EMAIL NOTIFICATION VARIABLES
+// =================================================================
+
+unsigned long lastEmailSent_firmware = 0;
+unsigned long lastEmailSent_warning = 0;
+unsigned long lastEmailSent_critical = 0;
+unsigned long lastEmailSent_normal = 0;
+
+// Antrian email: slot tetap, satu slot per tipe (duplikat digabung), dikuras
+// oleh email_task sehingga handshake TLS ke Supabase tidak menahan kontrol.
+struct EmailSlot {
+    bool used;
+    bool updated;           // isi diganti setelah diambil email_task
+    uint8_t attempts;
+    uint32_t seq;
+    EmailJob job;
+};
+
+EmailSlot emailSlots[EMAIL_QUEUE_LEN];
+uint32_t emailSeq = 0;
+SemaphoreHandle_t emailQueueMutex = nullptr;
+TaskHandle_t emailTaskHandle = nullptr;
+
+bool can_send_email(unsigned long& lastSent, unsigned long minInterval) {
+    unsigned long now = millis();
+    if (now < lastSent) lastSent = 0;
+    if (now - lastSent >= minInterval) {
+        lastSent = now;
+        return true;
+    }
+    return false;
+}
+
+bool queue_email_notification(const NotificationData& data) {
+    if (!emailQueueMutex || xSemaphoreTake(emailQueueMutex, pdMS_TO_TICKS(10)) != pdTRUE) {
+        Serial.printf("[EMAIL] Antrian belum siap, %s diabaikan.\n", data.type);
+        return false;
+    }
+    
+    EmailSlot* slot = nullptr;
+    bool coalesced = false;
+    for (int i = 0; i < EMAIL_QUEUE_LEN; i++) {
+        if (emailSlots[i].used && strcmp(emailSlots[i].job.type, data.type) == 0) {
+            slot = &emailSlots[i];
+            coalesced = true;
+            break;
+        }
+        if (!emailSlots[i].used && !slot) slot = &emailSlots[i];
+    }
+    
+    if (slot) {
+        EmailJob& job = slot->job;
+        strlcpy(job.type, data.type, sizeof(job.type));
+        strlcpy(job.message, data.message, sizeof(job.message));
+        job.humidity = data.humidity;
+        job.temperature = data.temperature;
+        strlcpy(job.version, data.version.c_str(), sizeof(job.version));
+        strlcpy(job.release_notes, data.release_notes.c_str(), sizeof(job.release_notes));
+        slot->attempts = 0;
+        // Slot yang digabung mempertahankan seq (dan urutannya) agar
+        // email_queue_finish untuk pengiriman yang sedang berjalan tetap
+        // menemukannya.
+        if (coalesced) {
+            slot->updated = true;
+        } else {
+            slot->used = true;
+            slot->updated = false;
+            slot->seq = ++emailSeq;
+        }
+    }
+    xSemaphoreGive(emailQueueMutex);
+    
+    if (!slot) {
+        Serial.printf("[EMAIL] Antrian penuh, %s diabaikan.\n", data.type);
+        return false;
+    }
+    if (coalesced) Serial.printf("[EMAIL] %s digabung dengan antrian yang belum terkirim.\n", data.type);
+    xTaskNotifyGive(emailTaskHandle);
+    return true;
+}
+
+// Ambil salinan slot tertua; slot baru dilepas setelah terkirim agar tipe
+// yang sama yang datang selama pengiriman tetap digabung, bukan dobel.
+// Bila isinya diganti selama pengiriman, slot tidak dilepas dan isi
+// terbaru dikirim sekali lagi.
+bool email_queue_peek_oldest(EmailJob& job, uint32_t& seq) {
+    xSemaphoreTake(emailQueueMutex, portMAX_DELAY);
+    int oldest = -1;
+    for (int i = 0; i < EMAIL_QUEUE_LEN; i++) {
+        if (emailSlots[i].used && (oldest < 0 || emailSlots[i].seq < emailSlots[oldest].seq)) oldest = i;
+    }
+    if (oldest >= 0) {
+        job = emailSlots[oldest].job;
+        seq = emailSlots[oldest].seq;
+        emailSlots[oldest].updated = false;
+    }
+    xSemaphoreGive(emailQueueMutex);
+    return oldest >= 0;
+}
+
+bool email_queue_finish(uint32_t seq, bool sent) {
+    bool keep = false;
+    xSemaphoreTake(emailQueueMutex, portMAX_DELAY);
+    for (int i = 0; i < EMAIL_QUEUE_LEN; i++) {
+        EmailSlot& slot = emailSlots[i];
+        if (!slot.used || slot.seq != seq) continue;
+        // Yang terkirim isi lama; isi terbaru langsung menyusul.
+        if (sent && slot.updated) break;
+        if (sent || ++slot.attempts >= EMAIL_MAX_ATTEMPTS) {
+            if (!sent) Serial.printf("[EMAIL] %s dibuang setelah %d percobaan.\n", slot.job.type, EMAIL_MAX_ATTEMPTS);
+            slot.used = false;
+        } else {
+            keep = true;
+        }
+        break;
+    }
+    xSemaphoreGive(emailQueueMutex);
+    return keep;
+}
+
+void email_task(void* param) {
+    (void)param;
+    for (;;) {
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(EMAIL_RETRY_DELAY_MS));
+        EmailJob job;
+        uint32_t seq;
+        while (email_queue_peek_oldest(job, seq)) {
+            if (WiFi.status() != WL_CONNECTED) break;
+            StageStamp start = stage_begin();
+            bool sent = trigger_email_notification(job);
+            stage_end(STAGE_EMAIL, start);
+            if (email_queue_finish(seq, sent)) break;
+        }
+    }
+}
+
+void start_email_task() {
+    if (emailTaskHandle) return;
+    // Sama seperti http.begin(url) sebelumnya: tanpa CA untuk Supabase.
+    supabaseClient.setInsecure();
+    emailQueueMutex = xSemaphoreCreateMutex();
+    xTaskCreatePinnedToCore(email_task, "email", EMAIL_TASK_STACK, nullptr,
+                            EMAIL_TASK_PRIORITY, &emailTaskHandle, EMAIL_TASK_CORE);
+}
+
+// Pompa mengikuti state humidityControl (ambang + hysteresis), notifikasi
+// dan email mengikuti zona yang sudah melewati dwell, sehingga kelembapan
+// yang berayun di sekitar ambang tidak mengirim notifikasi berulang-ulang.
+// Mode prediktif menggantikan pemicu laju turun; ambang kritis tetap
+// menjadi pengaman bila model belum siap atau meleset.
+void run_humidity_control_logic(float humidity) {
+    unsigned long now = millis();
+    HumidityZone zone = humidityControl.update(humidity, now, config.humidity_critical,
+                                               config.humidity_warning, config.control);
+    mistPredictor.observe(now, humidity, currentTemperature);
+    if (humidityControl.demand()) {
+        turn_pump_on("auto_critical", PumpEngine::plan_ms(config.pump, config.humidity_critical - humidity));
+    } else if (config.mist.enabled) {
+        uint32_t pulseMs = mistPredictor.plan(now, humidity, currentTemperature, config.mist, MIST_MIN_PULSE_MS,
+                                              config.pump.max_s * 1000UL, config.pump.base_s * 1000UL);
+        if (pulseMs) turn_pump_on("auto_predict", pulseMs);
+    } else if (humidityControl.early() && !isPumpOn) {
+        Serial.printf("[KONTROL] Kelembapan turun %.1f %%RH/menit, pompa dinyalakan lebih awal.\n",
+                      -humidityControl.rate());
+        turn_pump_on("auto_rate", PumpEngine::plan_ms(config.pump, 0));
+    }
+    if (!humidityControl.changed()) return;
+    
+    if (zone == ZONE_CRITICAL) {
+        send_notification("warning", "Humidity below critical threshold! Pump turned ON.", humidity, currentTemperature);
+        
+        NotificationData data;
+        data.type = "critical_alert";
+        data.message = "Kelembapan di bawah ambang batas kritis!";
+        data.humidity = humidity;
+        data.temperature = currentTemperature;
+        
+        if (can_send_email(lastEmailSent_critical, EMAIL_MIN_INTERVAL_ALERT_MS)) {
+            queue_email_notification(data);
+        } else {
+            Serial.println("[EMAIL] Critical alert diabaikan (rate limit).");
+        }
+    } else if (zone == ZONE_WARNING) {
+        send_notification("warning", "Warning: Humidity approaching lower limit.", humidity, currentTemperature);
+        
+        NotificationData data;
+        data.type = "warning";
+        data.message = "Kelembapan mendekati ambang batas.";
+        data.humidity = humidity;
+        data.temperature = currentTemperature;
+        
+        if (can_send_email(lastEmailSent_warning, EMAIL_MIN_INTERVAL_ALERT_MS)) {
+            queue_email_notification(data);
+        } else {
+            Serial.println("[EMAIL] Warning alert diabaikan (rate limit).");
+        }
+    } else {
+        send_notification("info", "Humidity back to normal.", humidity, currentTemperature);
+        
+        NotificationData data;
+        data.type = "info";
+        data.message = "Kondisi kelembapan kembali normal.";
+        data.humidity = humidity;
+        data.temperature = currentTemperature;
+        
+        if (can_send_email(lastEmailSent_normal, EMAIL_MIN_INTERVAL_ALERT_MS)) {
+            queue_email_notification(data);
+        } else {
+            Serial.println("[EMAIL] Normal info diabaikan (rate limit).");
+        }
+    }
+}
+
+// Jam hasil pemulihan NVS atau yang terlalu lama tanpa NTP bisa meleset
+// berjam-jam; lebih baik jadwal dilewati daripada menyiram di jam yang
+// salah. Kontrol kelembapan tidak bergantung jam.
+//
+// Tiap tick hanya satu perbandingan dengan slot berikutnya di waterSchedule.
+// Slot yang lewat saat control_task tertahan tetap disiram bila telatnya
+// <= SCHEDULE_CATCHUP_SEC.
+void run_scheduled_control(float humidity, bool timeTrusted) {
+    if (!timeTrusted) return;
+    int64_t localNow = (int64_t)time(nullptr) + GMT_OFFSET_SEC + DAYLIGHT_OFFSET_SEC;
+    uint16_t missed = 0;
+    int index = waterSchedule.poll(localNow, SCHEDULE_CATCHUP_SEC, &missed);
+    if (missed) Serial.printf("[JADWAL] %u slot terlewat (digabung atau telat > %lu detik).\n", missed, SCHEDULE_CATCHUP_SEC);
+    if (index < 0) return;
+    
+    const ScheduleEntry& entry = waterSchedule.at(index);
+    char msg[SCHEDULE_MSG_SIZE];
+    if (humidity >= config.humidity_critical) {
+        bool wasOn = isPumpOn;
+        uint32_t grantedMs = turn_pump_on("scheduled", entry.duration_s * 1000UL);
+        if (grantedMs > 0) {
+            snprintf(msg, SCHEDULE_MSG_SIZE, "Scheduled watering at %02u:%02u executed (%lu s).",
+                     entry.minute / 60, entry.minute % 60, (unsigned long)(grantedMs / 1000));
+        } else {
+            snprintf(msg, SCHEDULE_MSG_SIZE, "Scheduled watering at %02u:%02u skipped (%s).",
+                     entry.minute / 60, entry.minute % 60, wasOn ? "pump already ON" : "daily budget used up");
+        }
+    } else {
+        snprintf(msg, SCHEDULE_MSG_SIZE, "Scheduled watering at %02u:%02u skipped, humidity critical (%.1f%%).",
+                 entry.minute / 60, entry.minute % 60, humidity);
+    }
+    send_notification("info", msg, humidity, currentTemperature);
+}
+
+// Bentuk yang diterima config_set: angka jam (format lama, 0..23) atau
+// {"at": "HH:MM", "dur": detik, "days": mask}; bit 0 mask = Minggu.
+bool parse_schedule_entry(JsonVariantConst value, ScheduleEntry& entry) {
+    entry = { 0, PUMP_DURATION_MS / 1000, WaterSchedule::kAllDays };
+    if (value.is<int>()) {
+        int hour = value.as<int>();
+        if (hour < 0 || hour > 23) return false;
+        entry.minute = hour * 60;
+        return true;
+    }
+    if (!value.is<JsonObjectConst>()) return false;
+    unsigned hour = 0, minute = 0;
+    const char* at = value["at"] | "";
+    if (sscanf(at, "%u:%u", &hour, &minute) != 2 || hour > 23 || minute > 59) return false;
+    entry.minute = hour * 60 + minute;
+    int duration = value["dur"] | (int)entry.duration_s;
+    int days = value["days"] | (int)entry.days;
+    if (duration <= 0 || duration > WaterSchedule::kMaxDurationSec || days <= 0 || days > WaterSchedule::kAllDays) return false;
+    entry.duration_s = duration;
+    entry.days = days;
+    return true;
+}
+
+// Kebalikan parse_schedule_entry. Durasi dan hari hanya dikirim bila bukan
+// default, agar config_get dengan banyak entri tetap muat di CONFIG_BUFFER_SIZE.
+void append_schedule_json(JsonArray out, const ScheduleEntry* entries, uint8_t count) {
+    for (uint8_t i = 0; i < count; i++) {
+        const ScheduleEntry& entry = entries[i];
+        JsonObject item = out.add<JsonObject>();
+        char at[8];
+        snprintf(at, sizeof(at), "%02u:%02u", entry.minute / 60, entry.minute % 60);
+        item["at"] = at;
+        if (entry.duration_s != PUMP_DURATION_MS / 1000) item["dur"] = entry.duration_s;
+        if (entry.days != WaterSchedule::kAllDays) item["days"] = entry.days;
+    }
+}
+
+float pump_budget_liters(const PumpProfile& profile) {
+    return profile.budget_ms / 60000.0f * PUMP_FLOW_ML_PER_MIN / 1000.0f;
+}
+
+// {"base", "per_pct", "max", "pulse", "soak"} dalam detik dan "budget_l"
+// dalam liter per hari (0 = tanpa batas). Kunci yang tidak dikirim
+// mempertahankan nilai lama; profil tidak berubah bila ada yang tidak valid.
+bool parse_pump_profile(JsonVariantConst value, PumpProfile& profile) {
+    if (!value.is<JsonObjectConst>()) return false;
+    int base = value["base"] | (int)profile.base_s;
+    int perPct = value["per_pct"] | (int)profile.per_pct_s;
+    int maxS = value["max"] | (int)profile.max_s;
+    int pulse = value["pulse"] | (int)profile.pulse_s;
+    int soak = value["soak"] | (int)profile.soak_s;
+    float budget = value["budget_l"] | pump_budget_liters(profile);
+    if (base <= 0 || maxS < base || maxS > PUMP_PROFILE_MAX_S || perPct < 0 || perPct > PUMP_PER_PCT_MAX_S ||
+        pulse < 0 || pulse > maxS || soak < 0 || soak > PUMP_PROFILE_MAX_S ||
+        budget < 0 || budget > PUMP_MAX_BUDGET_L) {
+        return false;
+    }
+    profile = { (uint16_t)base, (uint16_t)perPct, (uint16_t)maxS, (uint16_t)pulse, (uint16_t)soak,
+                (uint32_t)(budget * 1000.0f / PUMP_FLOW_ML_PER_MIN * 60000.0f) };
+    return true;
+}
+
+// {"hyst" %RH, "dwell" detik, "fall_rate" %RH/menit (0 = mati)}. Kunci yang
+// tidak dikirim mempertahankan nilai lama; {0, 0, 0} = ambang tanpa
+// hysteresis seperti firmware lama.
+bool parse_control_tuning(JsonVariantConst value, ControlTuning& tuning) {
+    if (!value.is<JsonObjectConst>()) return false;
+    float hyst = value["hyst"] | tuning.hysteresis;
+    int dwell = value["dwell"] | (int)tuning.dwell_s;
+    float fallRate = value["fall_rate"] | tuning.fall_rate;
+    if (!(hyst >= 0 && hyst <= CONTROL_HYSTERESIS_MAX) || dwell < 0 || dwell > CONTROL_DWELL_MAX_S ||
+        !(fallRate >= 0 && fallRate <= CONTROL_FALL_RATE_MAX)) {
+        return false;
+    }
+    tuning = { hyst, (uint16_t)dwell, fallRate };
+    return true;
+}
+
+// {"on", "setpoint" %RH, "band" %RH, "horizon" detik}; kunci yang tidak
+// dikirim mempertahankan nilai lama.
+bool parse_mist_tuning(JsonVariantConst value, MistTuning& tuning) {
+    if (!value.is<JsonObjectConst>()) return false;
+    bool enabled = value["on"] | (tuning.enabled != 0);
+    float setpoint = value["setpoint"] | tuning.setpoint;
+    float band = value["band"] | tuning.band;
+    int horizon = value["horizon"] | (int)tuning.horizon_s;
+    if (!(setpoint > 0 && setpoint < 100) || !(band > 0 && band <= MIST_BAND_MAX) ||
+        horizon < 0 || horizon > MIST_HORIZON_MAX_S) {
+        return false;
+    }
+    tuning = { (uint8_t)enabled, setpoint, band, (uint16_t)horizon };
+    return true;
+}
+
+// Dari network_task setiap program selesai; control_task tidak boleh
+// tertahan tulis flash.
+void save_pump_usage() {
+    Preferences prefs;
+    prefs.begin("jamur-pump", false);
+    prefs.putInt("day", pumpEngine.day());
+    prefs.putUInt("used_ms", pumpEngine.used_ms());
+    prefs.end();
+}
+
+// Hanya dari control_task dengan configMutex dipegang (config.pump); task
+// lain memakai request_pump(). durationMs = total on-time, dipecah menjadi
+// pulsa menurut profil. Mengembalikan on-time yang disetujui budget harian.
+uint32_t turn_pump_on(const char* reason, uint32_t durationMs) {
+    if (isPumpOn) return 0;
+    
+    unsigned long now = millis();
+    uint32_t grantedMs = pumpEngine.start(config.pump, durationMs, now);
+    if (grantedMs == 0) {
+        static int32_t deniedDay = INT32_MIN;
+        if (deniedDay != pumpEngine.day()) {
+            deniedDay = pumpEngine.day();
+            send_notification("warning", "Daily water budget used up, pump not started.", currentHumidity, currentTemperature);
+        }
+        Serial.printf("[POMPA] %s ditolak: budget air hari ini habis.\n", reason);
+        return 0;
+    }
+    if (grantedMs < durationMs) {
+        Serial.printf("[POMPA] %s dipangkas ke %lu ms (sisa budget).\n", reason, (unsigned long)grantedMs);
+    }
+    
+    uint32_t programMs = pumpEngine.remaining_ms(now);
+    pumpStopTime = now + programMs;
+    isPumpOn = true;
+    uint32_t worst = pumpTiming.worstOverrunUs;
+    pumpTiming = {};
+    pumpTiming.worstOverrunUs = worst;
+    pump_relay_on(pumpEngine.until_next(now));
+    
+    NetEvent event = {};
+    event.type = NET_EVT_PUMP_STARTED;
+    event.record = { (uint32_t)time(nullptr), currentHumidity, currentTemperature };
+    strlcpy(event.text, reason, sizeof(event.text));
+    event.duration_ms = programMs;
+    post_net_event(event);
+    return grantedMs;
+}
+
+// Transisi pulsa/rendam yang jatuh tempo; program selesai = pompa OFF.
+// Akhir pulsa biasanya sudah dijatuhkan timer, di sini hanya dicatat.
+void service_pump() {
+    if (!isPumpOn) return;
+    unsigned long now = millis();
+    if (pumpEngine.update(now)) {
+        if (pumpEngine.relay()) {
+            pump_relay_on(pumpEngine.until_next(now));
+        } else {
+            pump_relay_off();
+        }
+    }
+    if (!pumpEngine.active()) turn_pump_off();
+}
+
+void turn_pump_off() {
+    if (!isPumpOn) return;
+    
+    pumpEngine.stop(millis());
+    pump_relay_off();
+    isPumpOn = false;
+    Serial.printf("[POMPA] OFF: on %lu ms dari %lu ms diminta, overrun maks %lu us, %u pulsa dipotong timer.\n",
+                  (unsigned long)pumpTiming.actualMs, (unsigned long)pumpTiming.requestedMs,
+                  (unsigned long)pumpTiming.maxOverrunUs, pumpTiming.timerCutoffs);
+    
+    NetEvent event = {};
+    event.type = NET_EVT_PUMP_STOPPED;
+    event.record = { (uint32_t)time(nullptr), currentHumidity, currentTemperature };
+    post_net_event(event);
+}
+
+void init_pump_cutoff_timer() {
+    esp_timer_create_args_t args = {};
+    args.callback = pump_cutoff_callback;
+    args.name = "pump_cutoff";
+    if (esp_timer_create(&args, &pumpCutoffTimer) != ESP_OK) {
+        Serial.println("[POMPA] Timer cutoff gagal dibuat, cutoff hanya dari control_task.");
+        pumpCutoffTimer = nullptr;
+    }
+}
+
+// Konteks task esp_timer (prioritas di atas semua task firmware): hanya
+// menjatuhkan relay dan mencatat waktunya, tanpa lock dan tanpa log.
+void pump_cutoff_callback(void* arg) {
+    (void)arg;
+    digitalWrite(PUMP_RELAY_PIN, LOW);
+    uint32_t now = (uint32_t)esp_timer_get_time();
+    pumpCutoffUs = now ? now : 1;
+}
+
+void pump_relay_on(uint32_t requestedMs) {
+    pumpCutoffUs = 0;
+    pumpTiming.pulseStartUs = (uint32_t)micros();
+    pumpTiming.pulseRequestedMs = requestedMs;
+    digitalWrite(PUMP_RELAY_PIN, HIGH);
+    if (pumpCutoffTimer) esp_timer_start_once(pumpCutoffTimer, (uint64_t)requestedMs * 1000ULL);
+    mistPredictor.pump_started(millis());
+}
+
+// Selisih 32-bit aman terhadap wraparound micros() selama pulsa < 71 menit.
+void pump_relay_off() {
+    if (pumpCutoffTimer) esp_timer_stop(pumpCutoffTimer);
+    digitalWrite(PUMP_RELAY_PIN, LOW);
+    if (pumpTiming.pulseRequestedMs == 0) return;
+    
+    uint32_t cutoffUs = pumpCutoffUs;
+    if (cutoffUs) pumpTiming.timerCutoffs++;
+    uint32_t actualUs = (cutoffUs ? cutoffUs : (uint32_t)micros()) - pumpTiming.pulseStartUs;
+    uint32_t requestedUs = pumpTiming.pulseRequestedMs * 1000UL;
+    pumpTiming.requestedMs += pumpTiming.pulseRequestedMs;
+    pumpTiming.actualMs += actualUs / 1000;
+    mistPredictor.pump_stopped(actualUs / 1000, millis());
+    if (actualUs > requestedUs) {
+        uint32_t overrun = actualUs - requestedUs;
+        if (overrun > pumpTiming.maxOverrunUs) pumpTiming.maxOverrunUs = overrun;
+        if (overrun > pumpTiming.worstOverrunUs) pumpTiming.worstOverrunUs = overrun;
+    }
+    pumpTiming.pulseRequestedMs = 0;
+}
+
+// =================================================================
+//   ZONE FUNCTIONS
+// =================================================================
+// Zona rak memakai HumidityControl dan ambang sendiri, tetapi hysteresis,
+// dwell dan laju turun ikut config.control. Tiap zona satu program siram
+// sederhana (pump_s, tanpa pulsa/rendam dan di luar budget zona utama);
+// relay dijatuhkan one-shot esp_timer seperti pompa utama.
+
+// Dipanggil control_task sekali saat start dan tiap kali tabel zona diganti.
+// Slot dipasangkan ke zona lewat nama. Slot yang zonanya dihapus atau pin/
+// tipe sensornya diganti dilepas lebih dulu (pompa mati, sampler dan timer
+// dihapus) agar pin dan kanal RMT-nya bebas, lalu zona yang belum punya slot
+// dipasang di slot kosong dengan pin baru.
+void sync_zones() {
+    xSemaphoreTake(configMutex, portMAX_DELAY);
+    for (uint8_t i = 0; i < ZONE_MAX; i++) {
+        ZoneRuntime& zone = zoneRuntime[i];
+        if (!zone.sampler || zone_config(zone)) continue;
+        bool removed = true;
+        for (uint8_t c = 0; c < config.zone_count; c++) {
+            if (strcmp(config.zones[c].name, zone.name) == 0) removed = false;
+        }
+        Serial.printf(removed ? "[ZONA] %s dinonaktifkan.\n" : "[ZONA] %s: pin/tipe sensor diganti, dipasang ulang.\n",
+                      zone.name);
+        zone_uninstall(i);
+    }
+    for (uint8_t c = 0; c < config.zone_count; c++) {
+        ZoneConfig& cfg = config.zones[c];
+        int slot = -1;
+        for (uint8_t i = 0; i < ZONE_MAX && slot < 0; i++) {
+            if (zoneRuntime[i].sampler && strcmp(zoneRuntime[i].name, cfg.name) == 0) slot = i;
+        }
+        // Nama unik dan slot lepas sudah dibebaskan, jadi slot kosong selalu ada.
+        for (uint8_t i = 0; i < ZONE_MAX && slot < 0; i++) {
+            if (!zoneRuntime[i].sampler) {
+                slot = i;
+                zone_install(i, cfg);
+            }
+        }
+        ZoneRuntime& zone = zoneRuntime[slot];
+        if (!zone.schedule.set(cfg.schedules, cfg.schedule_count)) {
+            Serial.printf("Jadwal zona %s tidak valid, dikosongkan.\n", cfg.name);
+            cfg.schedule_count = 0;
+            zone.schedule.set(cfg.schedules, 0);
+        }
+        if (!zone.installed || zone.active) continue;
+        
+        zone.humidity.reset();
+        zone.temperature.reset();
+        zone.control.reset();
+        zone.lastAcceptTime = millis();
+        zone.healthy = true;
+        zone.active = true;
+        Serial.printf("[ZONA] %s aktif: DHT%u pin %u, relay pin %u.\n", zone.name, zone.dhtType, zone.dhtPin,
+                      zone.relayPin);
+    }
+    xSemaphoreGive(configMutex);
+}
+
+// Config milik slot: nama sama dan pin/tipe sama dengan hardware yang
+// terpasang. nullptr selama tabel baru belum dipasang sync_zones(), sehingga
+// config baru tidak pernah dijalankan di hardware lama. configMutex dipegang.
+const ZoneConfig* zone_config(const ZoneRuntime& zone) {
+    for (uint8_t i = 0; i < config.zone_count; i++) {
+        const ZoneConfig& cfg = config.zones[i];
+        if (strcmp(cfg.name, zone.name) != 0) continue;
+        bool same = zone.dhtPin == cfg.dht_pin && zone.dhtType == cfg.dht_type && zone.relayPin == cfg.relay_pin;
+        return same ? &cfg : nullptr;
+    }
+    return nullptr;
+}
+
+// Statistik sampler dan siraman dimulai dari nol tiap kali slot dipasang.
+void zone_install(uint8_t index, const ZoneConfig& cfg) {
+    ZoneRuntime& zone = zoneRuntime[index];
+    strlcpy(zone.name, cfg.name, sizeof(zone.name));
+    zone.dhtPin = cfg.dht_pin;
+    zone.dhtType = cfg.dht_type;
+    zone.relayPin = cfg.relay_pin;
+    zone.pumps = 0;
+    zone.pumpMs = 0;
+    pinMode(zone.relayPin, OUTPUT);
+    digitalWrite(zone.relayPin, LOW);
+    esp_timer_create_args_t args = {};
+    args.callback = zone_cutoff_callback;
+    args.arg = (void*)(uintptr_t)index;
+    args.name = "zone_cutoff";
+    if (esp_timer_create(&args, &zone.cutoffTimer) != ESP_OK) zone.cutoffTimer = nullptr;
+    zone.sampler = new DhtSampler(cfg.dht_pin, cfg.dht_type, ZONE_RMT_CHANNEL_BASE + index, DHT_SAMPLE_INTERVAL_MS);
+    zone.installed = zone.sampler->begin();
+    if (!zone.installed) Serial.printf("[ZONA] %s: inisialisasi RMT gagal, zona tidak dibaca.\n", cfg.name);
+}
+
+// Relay lama dibiarkan LOW; pin sensor dikembalikan ke input oleh DhtSampler.
+void zone_uninstall(uint8_t index) {
+    ZoneRuntime& zone = zoneRuntime[index];
+    zone_pump_off(index);
+    zone.active = false;
+    if (zone.cutoffTimer) {
+        esp_timer_stop(zone.cutoffTimer);
+        esp_timer_delete(zone.cutoffTimer);
+        zone.cutoffTimer = nullptr;
+    }
+    delete zone.sampler;
+    zone.sampler = nullptr;
+    zone.installed = false;
+}
+
+// Rotasi: hanya sampler zona di kursor yang dijalankan, kursor pindah setelah
+// pembacaannya selesai. Satu frame rak direkam pada satu waktu dan biaya
+// tiap iterasi control_task tidak bertambah dengan jumlah zona.
+void poll_zones() {
+    ZoneRuntime& zone = zoneRuntime[zoneCursor];
+    if (zone.active) {
+        if (!zone.sampler->poll(millis())) return;
+        handle_zone_sample(zoneCursor);
+    }
+    for (uint8_t step = 1; step <= ZONE_MAX; step++) {
+        uint8_t next = (zoneCursor + step) % ZONE_MAX;
+        if (zoneRuntime[next].active) {
+            zoneCursor = next;
+            return;
+        }
+    }
+}
+
+uint32_t zones_until_next(uint32_t nowMs) {
+    const ZoneRuntime& zone = zoneRuntime[zoneCursor];
+    return zone.active ? zone.sampler->until_next(nowMs) : UINT32_MAX;
+}
+
+// Frame baru zona di kursor. Pompa yang sudah dijatuhkan timer dicatat di
+// sini, paling lambat satu putaran rotasi setelah cutoff.
+void handle_zone_sample(uint8_t index) {
+    ZoneRuntime& zone = zoneRuntime[index];
+    if (zone.pumpOn && (zone.cutoffUs || (uint32_t)micros() - zone.pulseStartUs >= zone.pulseRequestedMs * 1000UL)) {
+        zone_pump_off(index);
+    }
+    const SensorReading& reading = zone.sampler->last();
+    if (reading.status == SENSOR_OK) {
+        if (zone.humidity.push(reading.humidity)) zone.lastAcceptTime = millis();
+        zone.temperature.push(reading.temperature);
+    }
+    
+    AppState state = currentState;
+    if (state != STATE_NORMAL_OPERATION && state != STATE_MENU_INFO) return;
+    if (millis() - zone.lastLogicTime < LOGIC_CHECK_INTERVAL_MS) return;
+    zone.lastLogicTime = millis();
+    run_zone_logic(index);
+}
+
+// Sama dengan handle_main_logic() + run_humidity_control_logic() +
+// run_scheduled_control() zona utama, dengan notifikasi berawalan nama zona
+// dan tanpa email.
+void run_zone_logic(uint8_t index) {
+    ZoneRuntime& zone = zoneRuntime[index];
+    unsigned long now = millis();
+    char msg[SCHEDULE_MSG_SIZE];
+    bool healthy = now - zone.lastAcceptTime < DHT_STALE_MS;
+    if (healthy != zone.healthy) {
+        zone.healthy = healthy;
+        const SensorStats& s = zone.sampler->stats();
+        Serial.printf("[ZONA] %s: sensor %s (ok=%lu timeout=%lu checksum=%lu).\n", zone.name,
+                      healthy ? "pulih" : "tidak merespons", (unsigned long)s.ok, (unsigned long)s.timeouts,
+                      (unsigned long)s.checksum);
+        snprintf(msg, sizeof(msg), healthy ? "[%s] Humidity sensor recovered, automatic control resumed."
+                                           : "[%s] Humidity sensor not responding, automatic control paused.", zone.name);
+        send_notification(healthy ? "info" : "warning", msg, -1, -1);
+    }
+    if (!healthy || !zone.humidity.ready() || !zone.temperature.ready()) return;
+    float humidity = zone.humidity.value();
+    float temperature = zone.temperature.value();
+    
+    NetEvent event = {};
+    event.type = NET_EVT_ZONE_TELEMETRY;
+    event.zone = index;
+    strlcpy(event.text, zone.name, sizeof(event.text));
+    event.record = { (uint32_t)time(nullptr), humidity, temperature };
+    post_net_event(event);
+    
+    xSemaphoreTake(configMutex, portMAX_DELAY);
+    const ZoneConfig* found = zone_config(zone);
+    if (!found) {
+        xSemaphoreGive(configMutex);
+        return;
+    }
+    const ZoneConfig& cfg = *found;
+    HumidityZone level = zone.control.update(humidity, now, cfg.humidity_critical, cfg.humidity_warning, config.control);
+    bool soaked = !zone.pumpOn && (zone.pumps == 0 || now - zone.pumpStoppedAt >= ZONE_SOAK_MS);
+    if (soaked && zone.control.demand()) {
+        zone_pump_on(index, "auto_critical", cfg.pump_s * 1000UL);
+    } else if (soaked && zone.control.early()) {
+        zone_pump_on(index, "auto_rate", cfg.pump_s * 1000UL);
+    }
+    if (zone.control.changed()) {
+        if (level == ZONE_CRITICAL) {
+            snprintf(msg, sizeof(msg), "[%s] Humidity below critical threshold! Pump turned ON.", zone.name);
+        } else if (level == ZONE_WARNING) {
+            snprintf(msg, sizeof(msg), "[%s] Warning: Humidity approaching lower limit.", zone.name);
+        } else {
+            snprintf(msg, sizeof(msg), "[%s] Humidity back to normal.", zone.name);
+        }
+        send_notification(level == ZONE_NORMAL ? "info" : "warning", msg, humidity, temperature);
+    }
+    
+    if (timeSync.trusted()) {
+        int64_t localNow = (int64_t)time(nullptr) + GMT_OFFSET_SEC + DAYLIGHT_OFFSET_SEC;
+        uint16_t missed = 0;
+        int entryIndex = zone.schedule.poll(localNow, SCHEDULE_CATCHUP_SEC, &missed);
+        if (missed) Serial.printf("[JADWAL] %s: %u slot terlewat.\n", zone.name, missed);
+        if (entryIndex >= 0) {
+            const ScheduleEntry& entry = zone.schedule.at(entryIndex);
+            if (humidity >= cfg.humidity_critical && zone_pump_on(index, "scheduled", entry.duration_s * 1000UL)) {
+                snprintf(msg, sizeof(msg), "[%s] Scheduled watering at %02u:%02u executed (%u s).", zone.name,
+                         entry.minute / 60, entry.minute % 60, entry.duration_s);
+            } else {
+                snprintf(msg, sizeof(msg), "[%s] Scheduled watering at %02u:%02u skipped (%.1f%%, pump %s).", zone.name,
+                         entry.minute / 60, entry.minute % 60, humidity, zone.pumpOn ? "ON" : "OFF");
+            }
+            send_notification("info", msg, humidity, temperature);
+        }
+    }
+    xSemaphoreGive(configMutex);
+}
+
+bool zone_pump_on(uint8_t index, const char* reason, uint32_t durationMs) {
+    ZoneRuntime& zone = zoneRuntime[index];
+    if (zone.pumpOn || durationMs == 0) return false;
+    zone.cutoffUs = 0;
+    zone.pulseStartUs = (uint32_t)micros();
+    zone.pulseRequestedMs = durationMs;
+    digitalWrite(zone.relayPin, HIGH);
+    if (zone.cutoffTimer) esp_timer_start_once(zone.cutoffTimer, (uint64_t)durationMs * 1000ULL);
+    zone.pumpOn = true;
+    zone.pumps++;
+    Serial.printf("[ZONA] %s: pompa ON (%s, %lu ms).\n", zone.name, reason, (unsigned long)durationMs);
+    char msg[PUMP_MSG_SIZE];
+    snprintf(msg, PUMP_MSG_SIZE, "[%s] Pump turned ON (%s).", zone.name, reason);
+    send_notification("info", msg, zone.humidity.value(), zone.temperature.value());
+    return true;
+}
+
+void zone_pump_off(uint8_t index) {
+    ZoneRuntime& zone = zoneRuntime[index];
+    if (!zone.pumpOn) return;
+    if (zone.cutoffTimer) esp_timer_stop(zone.cutoffTimer);
+    digitalWrite(zone.relayPin, LOW);
+    uint32_t cutoffUs = zone.cutoffUs;
+    uint32_t actualMs = ((cutoffUs ? cutoffUs : (uint32_t)micros()) - zone.pulseStartUs) / 1000;
+    zone.pumpMs += actualMs;
+    zone.pumpOn = false;
+    zone.pumpStoppedAt = millis();
+    Serial.printf("[ZONA] %s: pompa OFF, on %lu ms dari %lu ms diminta.\n", zone.name, (unsigned long)actualMs,
+                  (unsigned long)zone.pulseRequestedMs);
+    char msg[PUMP_MSG_SIZE];
+    snprintf(msg, PUMP_MSG_SIZE, "[%s] Pump turned OFF.", zone.name);
+    send_notification("info", msg, zone.humidity.value(), zone.temperature.value());
+}
+
+// Konteks task esp_timer, seperti pump_cutoff_callback(); arg = indeks slot.
+void zone_cutoff_callback(void* arg) {
+    ZoneRuntime& zone = zoneRuntime[(uintptr_t)arg];
+    digitalWrite(zone.relayPin, LOW);
+    uint32_t now = (uint32_t)esp_timer_get_time();
+    zone.cutoffUs = now ? now : 1;
+}
+
+// GPIO yang bisa jadi input open-drain DHT maupun output relay dan tidak
+// dipakai papan ini (lihat I2C_SDA_PIN di config.h).
+bool zone_pin_usable(int pin) {
+    static const int reserved[] = {
+        0, 1, 2, 3, 12, 15, DHT_PIN, PUMP_RELAY_PIN, BTN_UP_PIN, BTN_DOWN_PIN, BTN_OK_PIN, BTN_BACK_PIN,
+        I2C_SDA_PIN, I2C_SCL_PIN
+    };
+    if (pin < 0 || pin > 33 || (pin >= 6 && pin <= 11)) return false;
+    for (int used : reserved) {
+        if (pin == used) return false;
+    }
+    return true;
+}
+
+// {"name", "dht_pin", "dht_type", "relay", "h_crit", "h_warn", "pump_s",
+// "schedules": [...]}; field yang tidak dikirim tetap dari zone. Nama hanya
+// huruf, angka, '-' dan '_' karena menjadi segmen topik MQTT.
+bool parse_zone_config(JsonVariantConst value, ZoneConfig& zone) {
+    if (!value.is<JsonObjectConst>()) return false;
+    const char* name = value["name"] | zone.name;
+    size_t nameLen = strlen(name);
+    if (nameLen == 0 || nameLen >= sizeof(zone.name)) return false;
+    for (const char* p = name; *p; p++) {
+        if (!isalnum((unsigned char)*p) && *p != '-' && *p != '_') return false;
+    }
+    int dhtPin = value["dht_pin"] | (int)zone.dht_pin;
+    int dhtType = value["dht_type"] | (int)zone.dht_type;
+    int relayPin = value["relay"] | (int)zone.relay_pin;
+    float critical = value["h_crit"] | zone.humidity_critical;
+    float warning = value["h_warn"] | zone.humidity_warning;
+    int pumpS = value["pump_s"] | (int)zone.pump_s;
+    if (!zone_pin_usable(dhtPin) || !zone_pin_usable(relayPin) || dhtPin == relayPin) return false;
+    if (dhtType != 11 && dhtType != 22) return false;
+    if (critical < 0 || warning > 100 || critical > warning) return false;
+    if (pumpS <= 0 || pumpS > WaterSchedule::kMaxDurationSec) return false;
+    
+    ScheduleEntry schedules[ZONE_MAX_SCHEDULES];
+    uint8_t scheduleCount = zone.schedule_count;
+    memcpy(schedules, zone.schedules, sizeof(schedules));
+    if (value["schedules"].is<JsonArrayConst>()) {
+        JsonArrayConst list = value["schedules"].as<JsonArrayConst>();
+        if (list.size() > ZONE_MAX_SCHEDULES) return false;
+        for (scheduleCount = 0; scheduleCount < list.size(); scheduleCount++) {
+            if (!parse_schedule_entry(list[scheduleCount], schedules[scheduleCount])) return false;
+        }
+    }
+    
+    strlcpy(zone.name, name, sizeof(zone.name));
+    zone.dht_pin = dhtPin;
+    zone.dht_type = dhtType;
+    zone.relay_pin = relayPin;
+    zone.humidity_critical = critical;
+    zone.humidity_warning = warning;
+    zone.pump_s = pumpS;
+    memcpy(zone.schedules, schedules, sizeof(schedules));
+    zone.schedule_count = scheduleCount;
+    return true;
+}
+
+// Nama dan pin tidak boleh dipakai dua kali di seluruh tabel.
+bool zone_table_valid(const ZoneConfig* zones, uint8_t count) {
+    for (uint8_t i = 0; i < count; i++) {
+        for (uint8_t j = i + 1; j < count; j++) {
+            const ZoneConfig& a = zones[i];
+            const ZoneConfig& b = zones[j];
+            if (strcmp(a.name, b.name) == 0) return false;
+            if (a.dht_pin == b.dht_pin || a.dht_pin == b.relay_pin ||
+                a.relay_pin == b.dht_pin || a.relay_pin == b.relay_pin) return false;
+        }
+    }
+    return true;
+}
+
+// =================================================================
+//   COMMUNICATION FUNCTIONS
+// =================================================================
+
+// Satu tahap per panggilan: DNS, TLS (TCP + handshake di WiFiClientSecure),
+// CONNECT/CONNACK, lalu satu SUBSCRIBE per panggilan. Tiap tahap tetap
+// memblokir selama durasinya sendiri, tetapi di antaranya network_task
+// kembali melayani antrian event dan buffer telemetri.
+void try_reconnect_mqtt() {
+    static const char* const subscriptions[] = {
+        TOPICS.pump_control, TOPICS.config_set, TOPICS.config_set_bin,
+        TOPICS.system_update, TOPICS.firmware_new, TOPICS.rollout_report, TOPICS.rollout_halt
+    };
+    const uint8_t subscriptionCount = sizeof(subscriptions) / sizeof(subscriptions[0]);
+    
+    switch (mqttLink.state) {
+        case LINK_UP:
+            if (mqttClient.connected()) return;
+            Serial.printf("Koneksi MQTT terputus (rc=%d).\n", mqttClient.state());
+            mqttLink.failures = 0;
+            mqtt_link_schedule_retry();
+            return;
+        
+        case LINK_BACKOFF:
+            if ((long)(millis() - mqttLink.nextAttemptAt) < 0) return;
+            // fallthrough
+        case LINK_IDLE:
+            // Menunggu WiFi tidak dihitung sebagai kegagalan.
+            if (WiFi.status() != WL_CONNECTED) return;
+            mqttLink.attempts++;
+            mqttLink.state = LINK_DNS;
+            Serial.printf("Mencoba koneksi MQTT (TLS), percobaan %lu...\n", (unsigned long)mqttLink.attempts);
+            return;
+        
+        case LINK_DNS: {
+            StageStamp start = stage_begin();
+            IPAddress brokerIp;
+            bool ok = WiFi.hostByName(MQTT_BROKER, brokerIp) == 1;
+            mqttLink.phaseMs[LINK_DNS] = stage_end(STAGE_MQTT_DNS, start) / 1000;
+            if (!ok) {
+                mqtt_link_fail("dns");
+                return;
+            }
+            mqttLink.state = LINK_TLS;
+            return;
+        }
+        
+        case LINK_TLS: {
+            StageStamp start = stage_begin();
+            // Nama host (bukan IP) agar SNI dan verifikasi sertifikat tetap
+            // jalan; hasil DNS tahap sebelumnya sudah ada di cache lwIP.
+            bool ok = espClient.connect(MQTT_BROKER, MQTT_PORT) == 1;
+            mqttLink.phaseMs[LINK_TLS] = stage_end(STAGE_MQTT_TLS, start) / 1000;
+            if (!ok) {
+                char error_buf[100];
+                espClient.lastError(error_buf, sizeof(error_buf));
+                Serial.printf("Keterangan: %s\n", error_buf);
+                mqtt_link_fail("tls");
+                return;
+            }
+            mqttLink.state = LINK_CONNECT;
+            return;
+        }
+        
+        case LINK_CONNECT: {
+            StageStamp start = stage_begin();
+            // Socket sudah tersambung, PubSubClient hanya mengirim CONNECT.
+            bool ok = mqttClient.connect(
+                mqttClientId,
                 MQTT_USER,
                 MQTT_PASSWORD,
                 TOPICS.status,
                 1,
                 true,
                 "{\"state\":\"offline\"}"
-            )) {
-            Serial.println("terhubung!");
-            mqttClient.publish(TOPICS.status, "{\"state\":\"online\"}", true);
-            mqttClient.subscribe(TOPICS.pump_control);
-            mqttClient.subscribe(TOPICS.config_set);
-            mqttClient.subscribe(TOPICS.system_update);
-            mqttClient.subscribe(TOPICS.firmware_new);
-            publish_config();
-            publish_current_version();
-            
-            publish_pump_countdown(pumpCountdownSeconds);
-            mqttClient.publish(TOPICS.pump_control, isPumpOn ? "ON" : "OFF", true);
-            
-            Serial.println("Berlangganan topik MQTT sukses.");
-        } else {
-            Serial.printf("gagal, rc=%d. ", mqttClient.state());
-            char error_buf[100];
-            espClient.lastError(error_buf, sizeof(error_buf));
-            Serial.printf("Keterangan: %s\n", error_buf);
+            );
+            mqttLink.phaseMs[LINK_CONNECT] = stage_end(STAGE_MQTT_CONNACK, start) / 1000;
+            if (!ok) {
+                mqtt_link_fail("connect");
+                return;
+            }
+            mqttLink.subscribeIndex = 0;
+            mqttLink.phaseMs[LINK_SUBSCRIBE] = 0;
+            mqttLink.state = LINK_SUBSCRIBE;
+            return;
+        }
+        
+        case LINK_SUBSCRIBE: {
+            StageStamp start = stage_begin();
+            bool ok = mqttClient.subscribe(subscriptions[mqttLink.subscribeIndex]);
+            mqttLink.phaseMs[LINK_SUBSCRIBE] += stage_end(STAGE_MQTT_SUBSCRIBE, start) / 1000;
+            if (!ok) {
+                mqtt_link_fail("subscribe");
+                return;
+            }
+            if (++mqttLink.subscribeIndex < subscriptionCount) return;
+            mqttLink.state = LINK_UP;
+            mqttLink.failures = 0;
+            mqttLink.connects++;
+            on_mqtt_connected();
+            return;
         }
     }
 }
 
+void on_mqtt_connected() {
+    Serial.printf("MQTT terhubung (percobaan %lu): dns=%lu tls=%lu connect=%lu subscribe=%lu ms\n",
+                  (unsigned long)mqttLink.attempts, (unsigned long)mqttLink.phaseMs[LINK_DNS],
+                  (unsigned long)mqttLink.phaseMs[LINK_TLS], (unsigned long)mqttLink.phaseMs[LINK_CONNECT],
+                  (unsigned long)mqttLink.phaseMs[LINK_SUBSCRIBE]);
+    mqttClient.publish(TOPICS.status, "{\"state\":\"online\"}", true);
+    publish_config();
+    publish_current_version();
+    
+    publish_pump_countdown(pumpCountdownSeconds);
+    mqttClient.publish(TOPICS.pump_control, isPumpOn ? "ON" : "OFF", true);
+}
+
+// Seed jitter dari hash mqttClientId: tiap perangkat punya urutan jeda
+// sendiri, sehingga armada tidak reconnect serentak saat broker kembali.
+void mqtt_link_init() {
+    mqttLink = {};
+    uint32_t hash = client_id_hash();
+    mqttLink.jitterState = hash ? hash : 1;
+}
+
+// FNV-1a dari mqttClientId: stabil per perangkat, dipakai untuk jitter
+// reconnect dan cohort rollout firmware.
+uint32_t client_id_hash() {
+    uint32_t hash = 2166136261UL;
+    for (const char* p = mqttClientId; *p; p++) {
+        hash ^= (uint8_t)*p;
+        hash *= 16777619UL;
+    }
+    return hash;
+}
+
+void mqtt_link_fail(const char* phase) {
+    Serial.printf("MQTT gagal pada tahap %s (rc=%d).\n", phase, mqttClient.state());
+    mqttLink.failures++;
+    mqtt_link_schedule_retry();
+}
+
+// Backoff eksponensial dengan "equal jitter": separuh jeda tetap, separuh
+// acak, dibatasi MQTT_BACKOFF_MAX_MS.
+void mqtt_link_schedule_retry() {
+    espClient.stop();
+    uint32_t shift = mqttLink.failures > 0 ? mqttLink.failures - 1 : 0;
+    uint32_t backoff = MQTT_BACKOFF_MAX_MS;
+    if (shift < 16 && (MQTT_BACKOFF_BASE_MS << shift) < MQTT_BACKOFF_MAX_MS) {
+        backoff = MQTT_BACKOFF_BASE_MS << shift;
+    }
+    uint32_t x = mqttLink.jitterState;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    mqttLink.jitterState = x;
+    uint32_t delayMs = backoff / 2 + x % (backoff / 2 + 1);
+    
+    mqttLink.nextAttemptAt = millis() + delayMs;
+    mqttLink.state = LINK_BACKOFF;
+    Serial.printf("Reconnect MQTT dalam %lu ms.\n", (unsigned long)delayMs);
+}
+
 void mqtt_callback(char* topic, byte* payload, unsigned int length) {
+    if (strcmp(topic, TOPICS.config_set_bin) == 0) {
+        Serial.printf("Pesan diterima [%s]: %u byte MessagePack\n", topic, length);
+        handle_config_update(payload, length, WIRE_FORMAT_MSGPACK);
+        return;
+    }
     payload[length] = '\0'; 
     Serial.printf("Pesan diterima [%s]: %s\n", topic, (char*)payload);
     
     if (strcmp(topic, TOPICS.pump_control) == 0 && strcmp((char*)payload, "ON") == 0) {
-        turn_pump_on("manual_mqtt");
+        request_pump(PUMP_CMD_ON, "manual_mqtt");
     } else if (strcmp(topic, TOPICS.config_set) == 0) {
-        handle_config_update(payload, length);
+        handle_config_update(payload, length, WIRE_FORMAT_JSON);
     } else if (strcmp(topic, TOPICS.system_update) == 0) {
         JsonDocument doc;
         deserializeJson(doc, payload, length);
         if (!doc["command"].isNull() && doc["command"] == "FIRMWARE_UPDATE") {
-            String url = doc["url"];
-            if (url.length() > 0) {
-                perform_ota_update(url);
+            FirmwareInfo info;
+            info.url = doc["url"] | "";
+            info.version = doc["version"] | "";
+            // Versi, digest dan patch dari perintah, atau dari pengumuman new_available untuk URL yang sama.
+            info.sha256 = doc["sha256"] | "";
+            info.patch_url = doc["patch_url"] | "";
+            info.patch_from = doc["patch_from"] | "";
+            if (info.url == newFirmware.url) {
+                if (info.version.length() == 0) info.version = newFirmware.version;
+                if (info.sha256.length() == 0) info.sha256 = newFirmware.sha256;
+                if (info.patch_url.length() == 0) {
+                    info.patch_url = newFirmware.patch_url;
+                    info.patch_from = newFirmware.patch_from;
+                }
+            }
+            if (info.url.length() > 0) {
+                schedule_firmware_update(info, doc["rollout"], doc["force"] | false);
             }
         }
     } else if (strcmp(topic, TOPICS.firmware_new) == 0) {
@@ -857,49 +2827,335 @@ void mqtt_callback(char* topic, byte* payload, unsigned int length) {
             newFirmware.version = doc["version"].as<String>();
             newFirmware.release_notes = doc["release_notes"] | "";
             newFirmware.url = doc["url"] | "";
+            newFirmware.sha256 = doc["sha256"] | "";
+            newFirmware.patch_url = doc["patch_url"] | "";
+            newFirmware.patch_from = doc["patch_from"] | "";
             check_for_firmware_update();
+            // Pengumuman dengan objek "rollout" sekaligus memulai update bertahap.
+            if (!doc["rollout"].isNull() && newFirmware.url.length() > 0) {
+                schedule_firmware_update(newFirmware, doc["rollout"], false);
+            }
+        }
+    } else if (strcmp(topic, TOPICS.rollout_report) == 0) {
+        handle_rollout_report(payload, length);
+    } else if (strcmp(topic, TOPICS.rollout_halt) == 0) {
+        JsonDocument doc;
+        deserializeJson(doc, payload, length);
+        String version = doc["version"] | "";
+        if (version.length() > 0) halt_firmware_rollout(version, false);
+    }
+}
+
+void handle_config_update(byte* payload, unsigned int length, WireFormat format) {
+    JsonDocument doc;
+    DeserializationError error = format == WIRE_FORMAT_MSGPACK
+        ? deserializeMsgPack(doc, payload, length)
+        : deserializeJson(doc, payload, length);
+    if (error) {
+        Serial.printf("deserializeJson() gagal: %s\n", error.c_str());
+        return;
+    }
+    Serial.println("Menerima pembaruan konfigurasi dari MQTT.");
+    bool flushBatch = false;
+    bool ntpChanged = false;
+    xSemaphoreTake(configMutex, portMAX_DELAY);
+    config.humidity_critical = doc["h_crit"] | config.humidity_critical;
+    config.humidity_warning = doc["h_warn"] | config.humidity_warning;
+    
+    if (doc["schedules"].is<JsonArray>()) {
+        JsonArray newSchedules = doc["schedules"].as<JsonArray>();
+        uint8_t validCount = 0;
+        for (size_t i = 0; i < newSchedules.size(); i++) {
+            if (validCount >= WaterSchedule::kMaxEntries) {
+                Serial.printf("Jadwal lebih dari %u entri, sisanya diabaikan.\n", WaterSchedule::kMaxEntries);
+                break;
+            }
+            if (parse_schedule_entry(newSchedules[i], config.schedules[validCount])) {
+                validCount++;
+            } else {
+                Serial.printf("Jadwal #%u tidak valid (abaikan)\n", (unsigned)i);
+            }
+        }
+        config.schedule_count = validCount;
+        waterSchedule.set(config.schedules, validCount);
+        Serial.printf("Jadwal: %u entri, %s.\n", validCount, validCount ? "dikompilasi ulang" : "kosong");
+    }
+    
+    if (!doc["telemetry_batch"].isNull()) {
+        int window = doc["telemetry_batch"];
+        if (window <= 0) {
+            window = 0;
+        } else {
+            window = constrain(window, TELEMETRY_BATCH_MIN_SEC, TELEMETRY_BATCH_MAX_SEC);
+        }
+        if (window != config.telemetry_batch_sec) {
+            // Sisa batch dikirim dengan jendela lama sebelum berganti mode.
+            flushBatch = telemetryBatch.count > 0;
+            config.telemetry_batch_sec = window;
+            Serial.printf("Mode telemetri: %s (%d detik)\n", window ? "batch" : "live", window);
+        }
+    }
+    
+    if (!doc["ntp"].isNull()) {
+        const char* requested = doc["ntp"] | "";
+        if (strlen(requested) < sizeof(config.ntp_server)) {
+            strlcpy(config.ntp_server, requested, sizeof(config.ntp_server));
+            ntpChanged = true;
+            Serial.printf("Server NTP LAN: %s\n", requested[0] ? requested : "(tidak ada)");
+        } else {
+            Serial.println("Nama server NTP terlalu panjang (abaikan).");
+        }
+    }
+    
+    if (!doc["pump"].isNull()) {
+        if (parse_pump_profile(doc["pump"], config.pump)) {
+            Serial.printf("Profil pompa: %u s + %u s/%%RH (maks %u s), pulsa %u/%u s, budget %lu s/hari.\n",
+                          config.pump.base_s, config.pump.per_pct_s, config.pump.max_s, config.pump.pulse_s,
+                          config.pump.soak_s, (unsigned long)(config.pump.budget_ms / 1000));
+        } else {
+            Serial.println("Profil pompa tidak valid (abaikan).");
+        }
+    }
+    
+    if (!doc["control"].isNull()) {
+        if (parse_control_tuning(doc["control"], config.control)) {
+            Serial.printf("Kontrol: hysteresis %.1f %%RH, dwell %u s, laju turun %.1f %%RH/menit.\n",
+                          config.control.hysteresis, config.control.dwell_s, config.control.fall_rate);
+        } else {
+            Serial.println("Parameter kontrol tidak valid (abaikan).");
+        }
+    }
+    
+    if (!doc["predict"].isNull()) {
+        if (parse_mist_tuning(doc["predict"], config.mist)) {
+            Serial.printf("Mode prediktif: %s, setpoint %.1f +- %.1f %%RH, horizon %u s.\n",
+                          config.mist.enabled ? "aktif" : "mati", config.mist.setpoint, config.mist.band,
+                          config.mist.horizon_s);
+        } else {
+            Serial.println("Parameter prediktif tidak valid (abaikan).");
         }
     }
-}
-
-void handle_config_update(byte* payload, unsigned int length) {
-    JsonDocument doc;
-    DeserializationError error = deserializeJson(doc, payload, length);
-    if (error) {
-        Serial.printf("deserializeJson() gagal: %s\n", error.c_str());
-        return;
+    
+    if (!doc["sensor"]["sample_ms"].isNull()) {
+        int sampleMs = doc["sensor"]["sample_ms"];
+        if (sampleMs >= 0 && sampleMs <= SENSOR_SAMPLE_MAX_MS) {
+            config.sample_ms = sampleMs;
+            sampleRateChanged = true;
+        } else {
+            Serial.printf("sample_ms di luar 0-%u (abaikan).\n", SENSOR_SAMPLE_MAX_MS);
+        }
     }
-    Serial.println("Menerima pembaruan konfigurasi dari MQTT.");
-    config.humidity_critical = doc["h_crit"] | config.humidity_critical;
-    config.humidity_warning = doc["h_warn"] | config.humidity_warning;
     
-    if (doc["schedules"].is<JsonArray>()) {
-        JsonArray newSchedules = doc["schedules"].as<JsonArray>();
-        int validCount = 0;
-        for (int i = 0; i < newSchedules.size() && validCount < 5; i++) {
-            int jam = newSchedules[i];
-            if (jam >= 0 && jam <= 23) {
-                config.schedule_hours[validCount++] = jam;
-            } else {
-                Serial.printf("Jadwal jam tidak valid: %d (abaikan)\n", jam);
+    // Seluruh tabel diganti sekaligus dan ditolak utuh bila satu entri tidak
+    // valid. Entri dengan nama yang sudah ada cukup mengirim field yang berubah.
+    if (doc["zones"].is<JsonArray>()) {
+        JsonArray list = doc["zones"].as<JsonArray>();
+        ZoneConfig zones[ZONE_MAX];
+        uint8_t count = 0;
+        bool valid = list.size() <= ZONE_MAX;
+        for (size_t i = 0; valid && i < list.size(); i++) {
+            const char* name = list[i]["name"] | "";
+            ZoneConfig& zone = zones[count];
+            zone = {};
+            zone.dht_type = DHT_TYPE;
+            zone.humidity_critical = config.humidity_critical;
+            zone.humidity_warning = config.humidity_warning;
+            zone.pump_s = ZONE_PUMP_DEFAULT_S;
+            for (uint8_t j = 0; j < config.zone_count; j++) {
+                if (strcmp(config.zones[j].name, name) == 0) zone = config.zones[j];
             }
+            valid = parse_zone_config(list[i], zone);
+            if (!valid) Serial.printf("Zona #%u tidak valid.\n", (unsigned)i);
+            count++;
+        }
+        if (valid && zone_table_valid(zones, count)) {
+            memcpy(config.zones, zones, sizeof(ZoneConfig) * count);
+            config.zone_count = count;
+            zonesChanged = true;
+            Serial.printf("Zona rak: %u zona.\n", count);
+        } else {
+            Serial.printf("Tabel zona tidak valid (maks %u zona, nama/pin unik) (abaikan).\n", ZONE_MAX);
+        }
+    }
+    
+    if (!doc["wire_format"].isNull()) {
+        WireFormat requested;
+        if (wire_format_parse(doc["wire_format"] | "", requested)) {
+            config.wire_format = requested;
+            Serial.printf("Format wire: %s\n", wire_format_name(requested));
+        } else {
+            Serial.println("Format wire tidak dikenal (abaikan).");
         }
-        config.schedule_count = validCount;
     }
+    xSemaphoreGive(configMutex);
+    
+    if (flushBatch) publish_telemetry_batch();
+    if (ntpChanged) timeSync.set_lan_server(config.ntp_server);
     save_config();
     publish_config();
 }
 
-void publish_telemetry() {
+void publish_telemetry(const TelemetryRecord& record) {
+    if (config.telemetry_batch_sec > 0) {
+        add_telemetry_batch_sample(record);
+        return;
+    }
+    if (config.wire_format == WIRE_FORMAT_MSGPACK && mqttClient.connected() && telemetryBuffer.empty()) {
+        uint8_t bin[BIN_PAYLOAD_SIZE];
+        size_t len = wire_encode_telemetry(bin, sizeof(bin), record.timestamp, record.temperature, record.humidity);
+        if (!len || !mqttClient.publish(TOPICS.telemetry_bin, bin, len)) buffer_telemetry(record);
+        return;
+    }
+    // Selama backlog belum habis, pembacaan baru ikut antre agar urutan terjaga.
+    if (!mqttClient.connected() || !telemetryBuffer.empty()) {
+        buffer_telemetry(record);
+        return;
+    }
+    char payload[TELEMETRY_PAYLOAD_SIZE];
+    snprintf(payload, TELEMETRY_PAYLOAD_SIZE, "{\"temperature\":%.2f, \"humidity\":%.2f}", record.temperature, record.humidity);
+    if (!mqttClient.publish(TOPICS.telemetry, payload)) buffer_telemetry(record);
+}
+
+// Zona rak hanya live: buffer store-and-forward dan mode batch milik zona
+// utama, pembacaan zona saat broker terputus dibuang. Pembacaan dari slot
+// yang sudah dipasang ulang untuk zona lain juga dibuang.
+void publish_zone_telemetry(uint8_t index, const char* name, const TelemetryRecord& record) {
+    if (index >= ZONE_MAX || !mqttClient.connected()) return;
+    xSemaphoreTake(configMutex, portMAX_DELAY);
+    bool current = zoneRuntime[index].active && strcmp(zoneRuntime[index].name, name) == 0;
+    bool pumpOn = zoneRuntime[index].pumpOn;
+    xSemaphoreGive(configMutex);
+    if (!current) return;
+    char topic[ZONE_TOPIC_SIZE];
+    if (config.wire_format == WIRE_FORMAT_MSGPACK) {
+        snprintf(topic, sizeof(topic), TOPICS.zone_telemetry_bin, name);
+        uint8_t bin[BIN_PAYLOAD_SIZE];
+        size_t len = wire_encode_telemetry(bin, sizeof(bin), record.timestamp, record.temperature, record.humidity);
+        if (len) mqttClient.publish(topic, bin, len);
+        return;
+    }
+    snprintf(topic, sizeof(topic), TOPICS.zone_telemetry, name);
     char payload[TELEMETRY_PAYLOAD_SIZE];
-    snprintf(payload, TELEMETRY_PAYLOAD_SIZE, "{\"temperature\":%.2f, \"humidity\":%.2f}", currentTemperature, currentHumidity);
-    mqttClient.publish(TOPICS.telemetry, payload);
+    snprintf(payload, TELEMETRY_PAYLOAD_SIZE, "{\"temperature\":%.2f, \"humidity\":%.2f, \"pump\":\"%s\"}",
+             record.temperature, record.humidity, pumpOn ? "ON" : "OFF");
+    mqttClient.publish(topic, payload);
+}
+
+void add_telemetry_batch_sample(const TelemetryRecord& record) {
+    TelemetryBatch& b = telemetryBatch;
+    if (b.count == 0) {
+        b.startMillis = millis();
+        b.rssiSum = 0;
+        b.rssiMin = 0;
+        b.pumpOnSamples = 0;
+    }
+    int rssi = WiFi.RSSI();
+    b.samples[b.count++] = record;
+    b.rssiSum += rssi;
+    if (b.count == 1 || rssi < b.rssiMin) b.rssiMin = rssi;
+    if (isPumpOn) b.pumpOnSamples++;
+    
+    if (b.count >= TELEMETRY_BATCH_MAX_SAMPLES ||
+        millis() - b.startMillis >= (unsigned long)config.telemetry_batch_sec * 1000UL) {
+        publish_telemetry_batch();
+    }
+}
+
+// Format: ringkasan min/max/mean + array nilai (1 desimal) berurutan dengan
+// stempel waktu awal dan interval, agar tetap muat di buffer MQTT.
+void publish_telemetry_batch() {
+    TelemetryBatch& b = telemetryBatch;
+    if (b.count == 0) return;
+    
+    float hMin = b.samples[0].humidity, hMax = hMin, hSum = 0;
+    float tMin = b.samples[0].temperature, tMax = tMin, tSum = 0;
+    for (int i = 0; i < b.count; i++) {
+        const TelemetryRecord& r = b.samples[i];
+        hMin = min(hMin, r.humidity); hMax = max(hMax, r.humidity); hSum += r.humidity;
+        tMin = min(tMin, r.temperature); tMax = max(tMax, r.temperature); tSum += r.temperature;
+    }
+    
+    char payload[TELEMETRY_BATCH_PAYLOAD_SIZE_MAX];
+    size_t size = sizeof(payload);
+    int len = snprintf(payload, size,
+        "{\"ts\":%lu,\"interval\":%d,\"n\":%d,"
+        "\"humidity\":{\"min\":%.1f,\"max\":%.1f,\"mean\":%.2f},"
+        "\"temperature\":{\"min\":%.1f,\"max\":%.1f,\"mean\":%.2f},"
+        "\"rssi\":{\"min\":%d,\"mean\":%ld},\"pump_on_samples\":%d,\"pump\":\"%s\",\"h\":[",
+        (unsigned long)b.samples[0].timestamp, LOGIC_CHECK_INTERVAL_MS / 1000, b.count,
+        hMin, hMax, hSum / b.count, tMin, tMax, tSum / b.count,
+        b.rssiMin, b.rssiSum / b.count, b.pumpOnSamples, isPumpOn ? "ON" : "OFF");
+    for (int i = 0; i < b.count && len < (int)size; i++) {
+        len += snprintf(payload + len, size - len, "%s%.1f", i ? "," : "", b.samples[i].humidity);
+    }
+    if (len < (int)size) len += snprintf(payload + len, size - len, "],\"t\":[");
+    for (int i = 0; i < b.count && len < (int)size; i++) {
+        len += snprintf(payload + len, size - len, "%s%.1f", i ? "," : "", b.samples[i].temperature);
+    }
+    if (len < (int)size) len += snprintf(payload + len, size - len, "]}");
+    
+    bool sent = len < (int)size && mqttClient.connected() && mqttClient.publish(TOPICS.telemetry_batch, payload);
+    if (!sent) {
+        // Sampel mentah masuk store-and-forward, ringkasan bisa dihitung ulang di server.
+        for (int i = 0; i < b.count; i++) buffer_telemetry(b.samples[i]);
+    }
+    b.count = 0;
 }
 
+void buffer_telemetry(const TelemetryRecord& record) {
+    telemetryBuffer.push(record);
+}
+
+void replay_telemetry_backlog() {
+    if (telemetryBuffer.empty() || !mqttClient.connected()) return;
+    if (millis() - lastTelemetryReplayTime < TELEMETRY_REPLAY_INTERVAL_MS) return;
+    lastTelemetryReplayTime = millis();
+    
+    TelemetryRecord batch[TELEMETRY_REPLAY_BATCH];
+    size_t count = telemetryBuffer.peek(batch, TELEMETRY_REPLAY_BATCH);
+    if (count == 0) return;
+    
+    TelemetryBufferStats st = telemetryBuffer.stats();
+    char payload[TELEMETRY_BATCH_PAYLOAD_SIZE];
+    int len = snprintf(payload, sizeof(payload), "{\"depth\":%u,\"dropped\":%u,\"records\":[",
+                       (unsigned)(st.ram_depth + st.flash_depth), (unsigned)st.dropped);
+    for (size_t i = 0; i < count && len < (int)sizeof(payload); i++) {
+        len += snprintf(payload + len, sizeof(payload) - len, "%s{\"ts\":%lu,\"temperature\":%.2f,\"humidity\":%.2f}",
+                        i ? "," : "", (unsigned long)batch[i].timestamp, batch[i].temperature, batch[i].humidity);
+    }
+    if (len < (int)sizeof(payload)) len += snprintf(payload + len, sizeof(payload) - len, "]}");
+    if (len >= (int)sizeof(payload)) {
+        Serial.println("[TELEMETRI] Payload backlog terlalu besar, cek TELEMETRY_REPLAY_BATCH.");
+        return;
+    }
+    
+    if (!mqttClient.publish(TOPICS.telemetry_backlog, payload)) return;
+    telemetryBuffer.pop(count);
+    
+    if (telemetryBuffer.empty()) {
+        st = telemetryBuffer.stats();
+        Serial.printf("[TELEMETRI] Backlog terkirim: %u record direplay, %u dibuang.\n",
+                      (unsigned)st.replayed, (unsigned)st.dropped);
+    }
+}
+
+// AP yang sedang dipakai plus durasi reconnect terakhir dari wifiRoamer.
 void publish_wifi_signal() {
-    long rssi = WiFi.RSSI();
+    JsonDocument doc;
+    doc["rssi"] = WiFi.RSSI();
+    doc["ssid"] = WiFi.SSID();
+    const uint8_t* b = WiFi.BSSID();
+    char bssid[18];
+    snprintf(bssid, sizeof(bssid), "%02X:%02X:%02X:%02X:%02X:%02X", b[0], b[1], b[2], b[3], b[4], b[5]);
+    doc["bssid"] = bssid;
+    doc["ch"] = WiFi.channel();
+    const WifiRoamResult& roam = wifiRoamer.last();
+    if (roam.ssid[0]) {
+        doc["connect_ms"] = roam.ms;
+        doc["fast"] = roam.fast;
+    }
     char payload[WIFI_SIGNAL_PAYLOAD_SIZE];
-    snprintf(payload, WIFI_SIGNAL_PAYLOAD_SIZE, "{\"rssi\":%ld}", rssi);
+    serializeJson(doc, payload);
     mqttClient.publish(TOPICS.wifi_signal, payload, true);
 }
 
@@ -907,13 +3163,53 @@ void publish_config() {
     JsonDocument doc;
     doc["h_crit"] = config.humidity_critical;
     doc["h_warn"] = config.humidity_warning;
-    JsonArray schedules = doc["schedules"].to<JsonArray>();
-    for (int i = 0; i < config.schedule_count; i++) {
-        schedules.add(config.schedule_hours[i]);
+    append_schedule_json(doc["schedules"].to<JsonArray>(), config.schedules, config.schedule_count);
+    JsonObject pump = doc["pump"].to<JsonObject>();
+    pump["base"] = config.pump.base_s;
+    pump["per_pct"] = config.pump.per_pct_s;
+    pump["max"] = config.pump.max_s;
+    pump["pulse"] = config.pump.pulse_s;
+    pump["soak"] = config.pump.soak_s;
+    pump["budget_l"] = roundf(pump_budget_liters(config.pump) * 10.0f) / 10.0f;
+    JsonObject control = doc["control"].to<JsonObject>();
+    control["hyst"] = config.control.hysteresis;
+    control["dwell"] = config.control.dwell_s;
+    control["fall_rate"] = config.control.fall_rate;
+    JsonObject predict = doc["predict"].to<JsonObject>();
+    predict["on"] = config.mist.enabled != 0;
+    predict["setpoint"] = config.mist.setpoint;
+    predict["band"] = config.mist.band;
+    predict["horizon"] = config.mist.horizon_s;
+    JsonArray zones = doc["zones"].to<JsonArray>();
+    for (int i = 0; i < config.zone_count; i++) {
+        const ZoneConfig& zone = config.zones[i];
+        JsonObject item = zones.add<JsonObject>();
+        item["name"] = zone.name;
+        item["dht_pin"] = zone.dht_pin;
+        item["dht_type"] = zone.dht_type;
+        item["relay"] = zone.relay_pin;
+        item["h_crit"] = zone.humidity_critical;
+        item["h_warn"] = zone.humidity_warning;
+        item["pump_s"] = zone.pump_s;
+        append_schedule_json(item["schedules"].to<JsonArray>(), zone.schedules, zone.schedule_count);
     }
+    doc["telemetry_batch"] = config.telemetry_batch_sec;
+    doc["wire_format"] = wire_format_name(config.wire_format);
+    doc["ntp"] = config.ntp_server;
+    JsonObject sensor = doc["sensor"].to<JsonObject>();
+    sensor["type"] = primarySensor->name();
+    sensor["sample_ms"] = config.sample_ms;
+    // Format yang didukung firmware ini; server memilih lewat config_set.
+    JsonArray formats = doc["wire_formats"].to<JsonArray>();
+    formats.add(wire_format_name(WIRE_FORMAT_JSON));
+    formats.add(wire_format_name(WIRE_FORMAT_MSGPACK));
     char buffer[CONFIG_BUFFER_SIZE];
     serializeJson(doc, buffer);
     mqttClient.publish(TOPICS.config_get, buffer, true);
+    if (config.wire_format == WIRE_FORMAT_MSGPACK) {
+        size_t len = serializeMsgPack(doc, buffer, sizeof(buffer));
+        mqttClient.publish(TOPICS.config_get_bin, (const uint8_t*)buffer, len, true);
+    }
 }
 
 void publish_current_version() {
@@ -932,6 +3228,18 @@ void publish_firmware_status(const char* status) {
     char payload[FIRMWARE_STATUS_PAYLOAD_SIZE];
     serializeJson(doc, payload);
     mqttClient.publish(TOPICS.firmware_current, payload, true);
+    
+    // Laporan gagal ikut dihitung perangkat lain untuk auto-halt rollout.
+    if (strcmp(status, "failed") == 0 && firmwareRollout.target.url.length() > 0) {
+        JsonDocument report;
+        report["id"] = mqttClientId;
+        report["version"] = rollout_id(firmwareRollout.target);
+        report["from"] = FIRMWARE_VERSION;
+        report["status"] = status;
+        char reportPayload[ROLLOUT_PAYLOAD_SIZE];
+        serializeJson(report, reportPayload);
+        mqttClient.publish(TOPICS.rollout_report, reportPayload, false);
+    }
 }
 
 void publish_firmware_update_progress(const char* stage, int progress, const char* message) {
@@ -944,36 +3252,40 @@ void publish_firmware_update_progress(const char* stage, int progress, const cha
     mqttClient.publish(TOPICS.firmware_update, payload, true);
 }
 
-void trigger_email_notification(const NotificationData& data) {
+bool trigger_email_notification(const EmailJob& job) {
     if (WiFi.status() != WL_CONNECTED) {
         Serial.println("Tidak bisa kirim email, WiFi tidak terhubung.");
-        return;
+        return false;
     }
     HTTPClient http;
-    String functionUrl = String(SUPABASE_URL) + "/functions/v1/send-email-notification";
-    Serial.printf("Memicu notifikasi email tipe: %s\n", data.type);
-    http.begin(functionUrl);
+    char functionUrl[EMAIL_URL_SIZE];
+    snprintf(functionUrl, sizeof(functionUrl), "%s/functions/v1/send-email-notification", SUPABASE_URL);
+    Serial.printf("Memicu notifikasi email tipe: %s\n", job.type);
+    http.setTimeout(EMAIL_HTTP_TIMEOUT_MS);
+    http.begin(supabaseClient, functionUrl);
     http.addHeader("Content-Type", "application/json");
     http.addHeader("Authorization", "Bearer " + String(SUPABASE_KEY));
     
     JsonDocument doc;
-    doc["type"] = data.type;
-    doc["message"] = data.message;
-    if (data.humidity >= 0) doc["humidity"] = data.humidity;
-    if (data.temperature >= 0) doc["temperature"] = data.temperature;
-    if (data.version.length() > 0) doc["version"] = data.version;
-    if (data.release_notes.length() > 0) doc["release_notes"] = data.release_notes;
-    
-    String jsonPayload;
-    serializeJson(doc, jsonPayload);
-    int httpCode = http.POST(jsonPayload);
-    
-    if (httpCode >= 200 && httpCode < 300) {
+    doc["type"] = job.type;
+    doc["message"] = job.message;
+    if (job.humidity >= 0) doc["humidity"] = job.humidity;
+    if (job.temperature >= 0) doc["temperature"] = job.temperature;
+    if (job.version[0]) doc["version"] = job.version;
+    if (job.release_notes[0]) doc["release_notes"] = job.release_notes;
+    
+    char jsonPayload[EMAIL_PAYLOAD_SIZE];
+    size_t len = serializeJson(doc, jsonPayload, sizeof(jsonPayload));
+    int httpCode = http.POST((uint8_t*)jsonPayload, len);
+    
+    bool ok = httpCode >= 200 && httpCode < 300;
+    if (ok) {
         Serial.printf("[HTTP] Notifikasi email berhasil dikirim, Kode: %d\n", httpCode);
     } else {
         Serial.printf("[HTTP] Pengiriman gagal, error: %s\n", http.errorToString(httpCode).c_str());
     }
     http.end();
+    return ok;
 }
 
 void check_for_firmware_update() {
@@ -987,15 +3299,151 @@ void check_for_firmware_update() {
         data.release_notes = newFirmware.release_notes;
         
         if (can_send_email(lastEmailSent_firmware, EMAIL_MIN_INTERVAL_FIRMWARE_MS)) {
-            trigger_email_notification(data);
+            queue_email_notification(data);
         } else {
             Serial.println("[EMAIL] Firmware update diabaikan (rate limit).");
         }
-        newFirmware.version = ""; 
     }
 }
 
 
+// =================================================================
+//   FIRMWARE ROLLOUT FUNCTIONS
+// =================================================================
+// Satu retained message sampai ke seluruh armada sekaligus. Agar bucket
+// storage dan broker tidak diserbu, tiap perangkat menunggu gilirannya
+// sendiri (cohort + jeda acak) dan berhenti bila armada melaporkan gagal.
+
+// Versi menjadi kunci rollout; perintah lama tanpa versi memakai URL.
+const String& rollout_id(const FirmwareInfo& info) {
+    return info.version.length() > 0 ? info.version : info.url;
+}
+
+void schedule_firmware_update(const FirmwareInfo& info, JsonVariantConst rollout, bool force) {
+    const String& id = rollout_id(info);
+    if (info.version == FIRMWARE_VERSION) {
+        Serial.printf("[ROLLOUT] Versi %s sudah berjalan, update dilewati.\n", FIRMWARE_VERSION);
+        return;
+    }
+    if (force) {
+        Serial.printf("[ROLLOUT] Update %s dipaksa, tanpa menunggu giliran.\n", id.c_str());
+        firmwareRollout.target = info;
+        firmwareRollout.pending = false;
+        perform_ota_update(info.url, info.sha256, info.patch_url, info.patch_from);
+        return;
+    }
+    if (id == firmwareRollout.haltedVersion) {
+        Serial.printf("[ROLLOUT] Rollout %s sudah dihentikan, update dilewati.\n", id.c_str());
+        return;
+    }
+    uint8_t attempts = rollout_attempts(id);
+    if (attempts >= ROLLOUT_MAX_ATTEMPTS) {
+        Serial.printf("[ROLLOUT] %s sudah dicoba %u kali, menunggu versi lain.\n", id.c_str(), attempts);
+        return;
+    }
+    
+    uint8_t cohort = client_id_hash() % ROLLOUT_COHORTS;
+    uint32_t percent = rollout["percent"] | 100;
+    if (cohort * 100UL >= percent * ROLLOUT_COHORTS) {
+        Serial.printf("[ROLLOUT] Cohort %u di luar rollout %lu%% untuk %s.\n", cohort, (unsigned long)percent, id.c_str());
+        return;
+    }
+    // Retained message yang datang lagi setelah reconnect tidak mengocok ulang giliran.
+    if (firmwareRollout.pending && rollout_id(firmwareRollout.target) == id) {
+        firmwareRollout.target = info;
+        return;
+    }
+    
+    uint32_t rampS = rollout["ramp_s"] | 0;
+    uint32_t windowS = rollout["window_s"] | ROLLOUT_DEFAULT_WINDOW_S;
+    uint64_t delayMs = (uint64_t)rampS * 1000ULL * cohort / ROLLOUT_COHORTS;
+    if (windowS > 0) delayMs += esp_random() % ((uint64_t)windowS * 1000ULL);
+    
+    firmwareRollout.target = info;
+    firmwareRollout.cohort = cohort;
+    firmwareRollout.pending = true;
+    firmwareRollout.dueAt = millis() + (unsigned long)delayMs;
+    Serial.printf("[ROLLOUT] Update %s dijadwalkan: cohort %u/%u, mulai dalam %lu detik.\n",
+                  id.c_str(), cohort, ROLLOUT_COHORTS, (unsigned long)(delayMs / 1000));
+}
+
+void check_firmware_rollout() {
+    if (!firmwareRollout.pending || !mqttConnected) return;
+    if ((long)(millis() - firmwareRollout.dueAt) < 0) return;
+    
+    firmwareRollout.pending = false;
+    const FirmwareInfo& target = firmwareRollout.target;
+    record_rollout_attempt(rollout_id(target));
+    Serial.printf("[ROLLOUT] Giliran cohort %u, mulai update %s.\n", firmwareRollout.cohort, rollout_id(target).c_str());
+    perform_ota_update(target.url, target.sha256, target.patch_url, target.patch_from);
+}
+
+void handle_rollout_report(byte* payload, unsigned int length) {
+    JsonDocument doc;
+    if (deserializeJson(doc, payload, length)) return;
+    String version = doc["version"] | "";
+    const char* status = doc["status"] | "";
+    const char* id = doc["id"] | "";
+    if (version.length() == 0 || strcmp(status, "failed") != 0) return;
+    // Satu perangkat yang gagal berulang (retry, pesan ganda) dihitung sekali;
+    // laporan tanpa id tidak bisa dibedakan dan diabaikan.
+    if (!id[0] || strlen(id) >= MQTT_CLIENT_ID_LENGTH) return;
+    
+    FirmwareRollout& r = firmwareRollout;
+    if (version != r.reportVersion) {
+        r.reportVersion = version;
+        r.failureReports = 0;
+    }
+    for (uint16_t i = 0; i < r.failureReports; i++) {
+        if (strcmp(r.reporters[i], id) == 0) return;
+    }
+    if (r.failureReports >= ROLLOUT_HALT_FAILURES) return;
+    strlcpy(r.reporters[r.failureReports++], id, MQTT_CLIENT_ID_LENGTH);
+    Serial.printf("[ROLLOUT] Laporan gagal %u/%u untuk %s (%s).\n", r.failureReports, ROLLOUT_HALT_FAILURES,
+                  version.c_str(), id);
+    if (r.failureReports >= ROLLOUT_HALT_FAILURES && version != r.haltedVersion) {
+        halt_firmware_rollout(version, true);
+    }
+}
+
+// announce = perangkat ini yang mencapai ambang: tandai halt sebagai retained
+// message agar perangkat yang baru online juga berhenti.
+void halt_firmware_rollout(const String& version, bool announce) {
+    if (version == firmwareRollout.haltedVersion) return;
+    firmwareRollout.haltedVersion = version;
+    if (firmwareRollout.pending && rollout_id(firmwareRollout.target) == version) {
+        firmwareRollout.pending = false;
+    }
+    Serial.printf("[ROLLOUT] Rollout %s dihentikan.\n", version.c_str());
+    if (!announce) return;
+    
+    JsonDocument doc;
+    doc["version"] = version;
+    doc["failures"] = firmwareRollout.failureReports;
+    char payload[ROLLOUT_PAYLOAD_SIZE];
+    serializeJson(doc, payload);
+    mqttClient.publish(TOPICS.rollout_halt, payload, true);
+    publish_notification("warning", "Rollout firmware dihentikan: terlalu banyak perangkat gagal update.");
+}
+
+uint8_t rollout_attempts(const String& version) {
+    Preferences prefs;
+    prefs.begin("jamur-ota", true);
+    uint8_t attempts = prefs.getString("try_ver", "") == version ? prefs.getUChar("try_cnt", 0) : 0;
+    prefs.end();
+    return attempts;
+}
+
+void record_rollout_attempt(const String& version) {
+    uint8_t attempts = rollout_attempts(version) + 1;
+    Preferences prefs;
+    prefs.begin("jamur-ota", false);
+    prefs.putString("try_ver", version);
+    prefs.putUChar("try_cnt", attempts);
+    prefs.end();
+}
+
+
 
 // =================================================================
 //   CONTROL LOGIC FUNCTIONS
@@ -1007,27 +3455,21 @@ void publish_pump_countdown(int seconds) {
     mqttClient.publish(TOPICS.pump_countdown, payload, true);
 }
 
+// Hanya publish; cutoff relay ada di timer cutoff/control_task dan reset ke
+// 0 dikirim lewat NET_EVT_PUMP_STOPPED.
 void update_pump_countdown() {
-    if (!isPumpOn) {
-        if (pumpCountdownSeconds != 0) {
-            pumpCountdownSeconds = 0;
-            publish_pump_countdown(0);
-        }
-        return;
-    }
+    if (!isPumpOn) return;
     
-    unsigned long now = millis();
-    if (now >= pumpStopTime) {
-        turn_pump_off();
-        return;
-    }
+    // Selisih bertanda: tetap benar saat millis() wrap (~49 hari).
+    long msLeft = (long)(pumpStopTime - millis());
+    if (msLeft <= 0) return;
     
-    int secondsLeft = (int)((pumpStopTime - now) / 1000);
-    if (secondsLeft < 0) secondsLeft = 0;
+    int secondsLeft = (int)(msLeft / 1000);
     
     if (secondsLeft != pumpCountdownSeconds) {
         pumpCountdownSeconds = secondsLeft;
-        publish_pump_countdown(pumpCountdownSeconds);
+        // Mode batch: dashboard menghitung mundur sendiri dari nilai awal.
+        if (config.telemetry_batch_sec == 0) publish_pump_countdown(pumpCountdownSeconds);
     }
 }
 
@@ -1036,6 +3478,13 @@ void publish_online_status() {
 }
 
 void publish_speedtest(float ping_ms, float download_mbps, float upload_mbps) {
+    if (config.wire_format == WIRE_FORMAT_MSGPACK) {
+        uint8_t bin[BIN_PAYLOAD_SIZE];
+        size_t len = wire_encode_speedtest(bin, sizeof(bin), ping_ms, download_mbps, upload_mbps,
+                                           DEVICE_LATITUDE, DEVICE_LONGITUDE);
+        if (len) mqttClient.publish(TOPICS.speedtest_bin, bin, len, true);
+        return;
+    }
     char payload[196];
     snprintf(payload, sizeof(payload),
         "{\"ping_ms\":%.2f,\"download_mbps\":%.2f,\"upload_mbps\":%.2f,\"lat\":%.6f,\"lon\":%.6f}",
@@ -1055,130 +3504,423 @@ void handle_ota_error(const char* lcdMsg, const char* logMsg, int code) {
         Serial.println(logMsg);
     publish_firmware_status("failed");
     publish_firmware_update_progress("error", 0, lcdMsg);
-    send_notification("error", lcdMsg);
+    publish_notification("error", lcdMsg);
     pause_and_restart(ERROR_RESTART_DELAY);
 }
 
-void perform_ota_update(String url) {
-    int retry = 0;
-    bool success = false;
+// Buffer OTA berpindah tangan lewat dua antrian: otaFreeQueue berisi indeks
+// kosong untuk network_task, otaFullQueue berisi potongan untuk ota_writer.
+// Selama satu buffer ditulis ke flash, buffer lain sudah diisi dari stream.
+void ota_writer_task(void* param) {
+    (void)param;
+    OtaChunk chunk;
+    for (;;) {
+        if (xQueueReceive(otaFullQueue, &chunk, portMAX_DELAY) != pdTRUE) continue;
+        uint8_t* data = otaBuffers[chunk.index];
+        if (!otaWriteFailed) {
+            if (Update.write(data, chunk.length) == chunk.length) {
+                mbedtls_sha256_update(&otaSha, data, chunk.length);
+                otaFlashed += chunk.length;
+            } else {
+                otaWriteFailed = true;
+            }
+        }
+        xQueueSend(otaFreeQueue, &chunk.index, portMAX_DELAY);
+    }
+}
+
+void start_ota_writer_task() {
+    if (otaWriterTaskHandle) return;
+    otaFreeQueue = xQueueCreate(OTA_BUFFER_COUNT, sizeof(uint8_t));
+    otaFullQueue = xQueueCreate(OTA_BUFFER_COUNT, sizeof(OtaChunk));
+    for (uint8_t i = 0; i < OTA_BUFFER_COUNT; i++) xQueueSend(otaFreeQueue, &i, 0);
+    xTaskCreatePinnedToCore(ota_writer_task, "ota_writer", OTA_WRITER_TASK_STACK, nullptr,
+                            OTA_WRITER_TASK_PRIORITY, &otaWriterTaskHandle, OTA_WRITER_TASK_CORE);
+}
 
-    while (retry < OTA_MAX_RETRY && !success) {
-        HTTPClient http;
-        http.setTimeout(OTA_HTTP_TIMEOUT_MS);
-        http.begin(url);
-        int httpCode = http.GET();
+// Buffer yang sedang diisi network_task (-1 = belum ada). Image penuh dibaca
+// langsung ke sini; pada patch delta, keluaran DeltaPatcher yang disalin.
+uint8_t* ota_fill_space(size_t& space) {
+    if (otaFillIndex < 0) {
+        uint8_t index;
+        xQueueReceive(otaFreeQueue, &index, portMAX_DELAY);
+        otaFillIndex = index;
+        otaFillLength = 0;
+    }
+    space = OTA_BUFFER_SIZE - otaFillLength;
+    return otaBuffers[otaFillIndex] + otaFillLength;
+}
 
-        if (httpCode != HTTP_CODE_OK) {
-            Serial.printf("OTA HTTP GET gagal (percobaan %d), code: %d\n", retry+1, httpCode);
-            http.end();
-            retry++;
-            delay(2000);
-            continue;
-        }
+void ota_fill_commit(size_t length) {
+    otaFillLength += length;
+    if (otaFillLength == OTA_BUFFER_SIZE) ota_fill_flush();
+}
 
-        int contentLength = http.getSize();
-        if (contentLength <= 0) {
-            Serial.println("Content length tidak diketahui.");
-            http.end();
-            retry++;
-            delay(2000);
-            continue;
-        }
+void ota_fill_flush() {
+    if (otaFillIndex < 0) return;
+    OtaChunk chunk = { (uint8_t)otaFillIndex, otaFillLength };
+    if (otaFillLength > 0) {
+        xQueueSend(otaFullQueue, &chunk, portMAX_DELAY);
+    } else {
+        xQueueSend(otaFreeQueue, &chunk.index, portMAX_DELAY);
+    }
+    otaFillIndex = -1;
+    otaFillLength = 0;
+}
+
+bool ota_emit(const uint8_t* data, size_t length) {
+    while (length > 0 && !otaWriteFailed) {
+        size_t space;
+        uint8_t* dst = ota_fill_space(space);
+        size_t n = length < space ? length : space;
+        memcpy(dst, data, n);
+        ota_fill_commit(n);
+        data += n;
+        length -= n;
+    }
+    return !otaWriteFailed;
+}
+
+// Menunggu semua buffer kembali dari ota_writer. Hasilnya jumlah byte image
+// yang benar-benar sudah di flash.
+uint32_t ota_wait_flushed() {
+    ota_fill_flush();
+    while (uxQueueMessagesWaiting(otaFreeQueue) < OTA_BUFFER_COUNT) {
+        vTaskDelay(pdMS_TO_TICKS(5));
+    }
+    return otaFlashed;
+}
+
+void ota_reset_image() {
+    ota_wait_flushed();
+    Update.abort();
+    otaFlashed = 0;
+    otaWriteFailed = false;
+    mbedtls_sha256_starts(&otaSha, 0);
+}
+
+bool parse_sha256_hex(const char* hex, uint8_t out[32]) {
+    if (strlen(hex) != 64) return false;
+    for (int i = 0; i < 64; i++) {
+        char c = hex[i];
+        uint8_t nibble;
+        if (c >= '0' && c <= '9') nibble = c - '0';
+        else if (c >= 'a' && c <= 'f') nibble = c - 'a' + 10;
+        else if (c >= 'A' && c <= 'F') nibble = c - 'A' + 10;
+        else return false;
+        out[i / 2] = (i % 2) ? (out[i / 2] << 4) | nibble : nibble;
+    }
+    return true;
+}
+
+// "bytes 1024-2047/4096" -> 1024; -1 bila format tidak dikenal.
+long parse_content_range_start(const String& value) {
+    if (!value.startsWith("bytes ")) return -1;
+    const char* p = value.c_str() + 6;
+    if (*p < '0' || *p > '9') return -1;
+    return atol(p);
+}
 
-        if ((uint32_t)ESP.getFreeSketchSpace() < (uint32_t)contentLength) {
+// Patch delta diterapkan terhadap partisi app yang sedang berjalan; hasilnya
+// masuk pipeline buffer yang sama dengan image penuh.
+class OtaDeltaSink : public DeltaSink {
+public:
+    bool begin(const DeltaHeader& header) override {
+        running = esp_ota_get_running_partition();
+        if (!running || header.old_size > running->size) {
+            Serial.println("[OTA] Patch untuk image yang lebih besar dari partisi aktif.");
+            return false;
+        }
+        // Base patch harus sama persis dengan firmware yang sedang berjalan.
+        mbedtls_sha256_context sha;
+        mbedtls_sha256_init(&sha);
+        mbedtls_sha256_starts(&sha, 0);
+        uint8_t buf[256];
+        bool ok = true;
+        for (uint32_t offset = 0; ok && offset < header.old_size; offset += sizeof(buf)) {
+            size_t n = header.old_size - offset < sizeof(buf) ? header.old_size - offset : sizeof(buf);
+            ok = esp_partition_read(running, offset, buf, n) == ESP_OK;
+            if (ok) mbedtls_sha256_update(&sha, buf, n);
+        }
+        uint8_t digest[32];
+        mbedtls_sha256_finish(&sha, digest);
+        mbedtls_sha256_free(&sha);
+        if (!ok || memcmp(digest, header.old_sha256, sizeof(digest)) != 0) return false;
+        if ((uint32_t)ESP.getFreeSketchSpace() < header.new_size || !Update.begin(header.new_size)) {
             Serial.println("Tidak cukup ruang untuk update.");
-            http.end();
-            break;
+            return false;
         }
+        Serial.printf("[OTA] Patch delta: %lu -> %lu byte.\n", (unsigned long)header.old_size,
+                      (unsigned long)header.new_size);
+        return true;
+    }
+    
+    bool read_old(uint32_t offset, uint8_t* buf, size_t len) override {
+        return esp_partition_read(running, offset, buf, len) == ESP_OK;
+    }
+    
+    bool write(const uint8_t* data, size_t len) override { return ota_emit(data, len); }
 
-        if (!Update.begin(contentLength)) {
-            Serial.println("Memori tidak cukup untuk update.");
-            http.end();
-            retry++;
-            delay(2000);
-            continue;
-        }
+private:
+    const esp_partition_t* running = nullptr;
+};
 
-        WiFiClient& stream = http.getStream();
-        size_t written = 0;
-        uint8_t buff[OTA_BUFFER_SIZE];
-        int lastPercent = 0;
-        unsigned long lastProgressTime = millis();
-        bool streamError = false;
-
-        while (written < (size_t)contentLength) {
-            size_t toRead = OTA_BUFFER_SIZE;
-            if ((contentLength - written) < toRead) toRead = contentLength - written;
-            int bytesRead = stream.readBytes(buff, toRead);
-            if (bytesRead <= 0) {
-                Serial.println("Gagal membaca stream data, coba ulang...");
-                Update.abort();
+// Mengunduh url ke partisi OTA, sebagai image penuh (patcher == nullptr)
+// atau sebagai patch delta. Percobaan ulang melanjutkan dengan Range dari
+// jumlah byte sumber yang sudah diterima; keadaan patcher dan buffer isi
+// tetap sinkron dengan offset itu. true = seluruh image sudah di flash.
+bool ota_fetch(const String& url, DeltaPatcher* patcher, const char*& failMsg) {
+    static uint8_t patchBuf[OTA_PATCH_READ_SIZE];
+    // Percobaan ulang ke host yang sama cukup handshake singkat.
+    bool https = url.startsWith("https://");
+    otaClient.setInsecure();
+    const char* responseHeaders[] = { "Content-Range" };
+    uint32_t total = 0;   // 0 = unduhan sumber ini belum dimulai
+    uint32_t consumed = 0;   // byte sumber yang sudah masuk pipeline / patcher
+    uint32_t furthest = 0;   // offset terjauh yang pernah dicapai, untuk menilai kemajuan
+    int failures = 0;
+    int lastPercent = -1;
+    unsigned long lastProgressTime = 0;
+    failMsg = "OTA gagal setelah beberapa percobaan.";
+    
+    while (failures < OTA_MAX_RETRY) {
+        if (otaWriteFailed) {
+            Serial.println("Gagal menulis data ke flash, image diulang dari awal...");
+            ota_reset_image();
+            if (patcher) patcher->reset();
+            total = 0;
+            consumed = 0;
+            failures++;
+        }
+        if (total > 0 && consumed == total) {
+            uint32_t flashed = ota_wait_flushed();
+            if (otaWriteFailed) continue;
+            if (patcher && !patcher->finished()) {
+                failMsg = "OTA gagal: patch delta terpotong.";
+                return false;
+            }
+            return patcher || flashed == total;
+        }
+        
+        HTTPClient http;
+        http.setTimeout(OTA_HTTP_TIMEOUT_MS);
+        if (https) {
+            http.begin(otaClient, url);
+        } else {
+            http.begin(url);
+        }
+        http.collectHeaders(responseHeaders, 1);
+        if (total > 0 && consumed > 0) {
+            char range[32];
+            snprintf(range, sizeof(range), "bytes=%lu-", (unsigned long)consumed);
+            http.addHeader("Range", range);
+        }
+        int httpCode = http.GET();
+        
+        if (httpCode == HTTP_CODE_PARTIAL_CONTENT && total > 0 &&
+            parse_content_range_start(http.header("Content-Range")) == (long)consumed) {
+            Serial.printf("[OTA] Melanjutkan dari byte %lu/%lu.\n", (unsigned long)consumed, (unsigned long)total);
+        } else if (httpCode == HTTP_CODE_OK) {
+            if (total > 0) {
+                Serial.println("[OTA] Server tidak melayani Range, image diulang dari awal.");
+                ota_reset_image();
+                if (patcher) patcher->reset();
+                total = 0;
+            }
+            consumed = 0;
+            int contentLength = http.getSize();
+            if (contentLength <= 0) {
+                Serial.println("Content length tidak diketahui.");
                 http.end();
-                retry++;
-                delay(2000);
-                streamError = true;
-                break;
+                failures++;
+                delay(OTA_RETRY_DELAY_MS);
+                continue;
             }
-            if (Update.write(buff, bytesRead) != bytesRead) {
-                Serial.println("Gagal menulis data ke flash, coba ulang...");
-                Update.abort();
+            // Patch delta memanggil Update.begin() sendiri setelah header terbaca.
+            if (!patcher && (uint32_t)ESP.getFreeSketchSpace() < (uint32_t)contentLength) {
+                Serial.println("Tidak cukup ruang untuk update.");
                 http.end();
-                retry++;
-                delay(2000);
-                streamError = true;
-                break;
+                failMsg = "OTA gagal: ruang flash tidak cukup.";
+                return false;
+            }
+            if (!patcher && !Update.begin(contentLength)) {
+                Serial.println("Memori tidak cukup untuk update.");
+                http.end();
+                failures++;
+                delay(OTA_RETRY_DELAY_MS);
+                continue;
+            }
+            total = contentLength;
+        } else {
+            Serial.printf("OTA HTTP GET gagal (percobaan %d), code: %d\n", failures + 1, httpCode);
+            // 206 dengan offset lain atau 416: bagian yang sudah di flash tidak bisa dipakai.
+            if (httpCode == HTTP_CODE_PARTIAL_CONTENT || httpCode == HTTP_CODE_RANGE_NOT_SATISFIABLE) {
+                ota_reset_image();
+                if (patcher) patcher->reset();
+                total = 0;
+                consumed = 0;
+            }
+            http.end();
+            failures++;
+            delay(OTA_RETRY_DELAY_MS);
+            continue;
+        }
+        
+        WiFiClient& stream = http.getStream();
+        uint32_t start = consumed;
+        while (consumed < total && !otaWriteFailed) {
+            size_t want = total - consumed;
+            int bytesRead;
+            if (patcher) {
+                bytesRead = stream.readBytes(patchBuf, want < sizeof(patchBuf) ? want : sizeof(patchBuf));
+                if (bytesRead > 0 && !patcher->feed(patchBuf, bytesRead) && !otaWriteFailed) {
+                    Serial.printf("[OTA] Patch ditolak pada potongan mulai byte %lu: %s\n", (unsigned long)consumed, patcher->error());
+                    http.end();
+                    failMsg = "OTA gagal: patch delta tidak bisa diterapkan.";
+                    return false;
+                }
+            } else {
+                size_t space;
+                uint8_t* dst = ota_fill_space(space);
+                bytesRead = stream.readBytes(dst, want < space ? want : space);
+                if (bytesRead > 0) ota_fill_commit(bytesRead);
             }
-            written += bytesRead;
-            int percent = (int)(100.0 * written / contentLength);
+            if (bytesRead <= 0) break;
+            consumed += bytesRead;
+            int percent = (int)(100.0 * consumed / total);
             if (percent != lastPercent && millis() - lastProgressTime > 200) {
-                publish_firmware_update_progress("downloading", percent, "Downloading...");
+                publish_firmware_update_progress("downloading", percent,
+                                                 patcher ? "Downloading patch..." : "Downloading...");
                 lastPercent = percent;
                 lastProgressTime = millis();
             }
         }
+        http.end();
+        if (consumed == total || otaWriteFailed) continue;
+        
+        Serial.printf("Stream terputus di byte %lu/%lu (%lu byte baru), dilanjutkan dengan Range...\n",
+                      (unsigned long)consumed, (unsigned long)total, (unsigned long)(consumed - start));
+        // Percobaan yang melampaui offset terjauh tidak dihitung gagal; unduhan
+        // ulang dari awal (server tanpa Range) tetap dihitung.
+        if (consumed > furthest) {
+            furthest = consumed;
+            failures = 0;
+        } else {
+            failures++;
+        }
+        delay(OTA_RETRY_DELAY_MS);
+    }
+    return false;
+}
 
-        if (!streamError && written == (size_t)contentLength && Update.end() && Update.isFinished()) {
+void perform_ota_update(String url, String sha256, String patchUrl, String patchFrom) {
+    uint8_t expectedDigest[32];
+    bool verifyDigest = sha256.length() > 0;
+    const char* rejectMsg = nullptr;
+    if (verifyDigest && !parse_sha256_hex(sha256.c_str(), expectedDigest)) {
+        rejectMsg = "OTA ditolak: sha256 bukan hex 64 karakter.";
+    }
+#if OTA_REQUIRE_SHA256
+    if (!verifyDigest) rejectMsg = "OTA ditolak: sha256 tidak tersedia.";
+#endif
+    if (rejectMsg) {
+        Serial.println(rejectMsg);
+        publish_firmware_status("failed");
+        publish_firmware_update_progress("error", 0, rejectMsg);
+        publish_notification("error", rejectMsg);
+        return;
+    }
+    if (!verifyDigest) Serial.println("[OTA] Peringatan: sha256 tidak tersedia, image tidak diverifikasi.");
+    // Baru dibatalkan setelah permintaan diterima: semua jalur sesudah ini
+    // berakhir dengan restart, jadi speedtestCancel tidak perlu dikembalikan.
+    cancel_speedtest();
+    
+    // Hasil patch hanya bisa dipercaya lewat digest image akhir, jadi delta
+    // butuh sha256. Patch untuk versi lain langsung dilewati.
+    bool useDelta = OTA_DELTA_ENABLED && verifyDigest && patchUrl.length() > 0 &&
+                    (patchFrom.length() == 0 || patchFrom == FIRMWARE_VERSION);
+    
+    start_ota_writer_task();
+    mbedtls_sha256_init(&otaSha);
+    OtaDeltaSink deltaSink;
+    DeltaPatcher patcher(deltaSink);
+    unsigned long started = millis();
+    const char* failMsg = "OTA gagal setelah beberapa percobaan.";
+    
+    for (int pass = useDelta ? 0 : 1; pass < 2; pass++) {
+        bool delta = pass == 0;
+        ota_reset_image();
+        patcher.reset();
+        if (delta) Serial.printf("[OTA] Mengunduh patch delta dari versi %s.\n", FIRMWARE_VERSION);
+        if (!ota_fetch(delta ? patchUrl : url, delta ? &patcher : nullptr, failMsg)) {
+            if (delta) Serial.printf("[OTA] %s Beralih ke image penuh.\n", failMsg);
+            continue;
+        }
+        
+        publish_firmware_update_progress("verifying", 100, "Verifikasi SHA-256...");
+        uint8_t digest[32];
+        mbedtls_sha256_finish(&otaSha, digest);
+        char digestHex[65];
+        for (int i = 0; i < 32; i++) snprintf(digestHex + i * 2, 3, "%02x", digest[i]);
+        Serial.printf("[OTA] %lu byte dalam %lu ms (%s), SHA-256 %s\n", (unsigned long)otaFlashed,
+                      millis() - started, delta ? "delta" : "penuh", digestHex);
+        
+        if (verifyDigest && memcmp(digest, expectedDigest, sizeof(digest)) != 0) {
+            failMsg = "OTA gagal: SHA-256 image tidak cocok.";
+            if (delta) Serial.printf("[OTA] %s Beralih ke image penuh.\n", failMsg);
+            continue;
+        }
+        mbedtls_sha256_free(&otaSha);
+        if (Update.end() && Update.isFinished()) {
             Serial.println("Update successful! Restarting...");
             lcd_show_message("Update Success!", "Restarting...");
             publish_firmware_status("updated");
             publish_firmware_update_progress("finished", 100, "Update selesai, restart...");
-            send_notification("info", "Firmware updated successfully.");
-            http.end();
+            publish_notification("info", "Firmware updated successfully.");
             delay(2000);
             ESP.restart();
-            success = true;
-        } else if (!streamError) {
-            Serial.println("Update gagal menyelesaikan proses, coba ulang...");
-            Update.abort();
-            http.end();
-            retry++;
-            delay(2000);
         }
+        failMsg = "OTA gagal menyelesaikan proses.";
+        break;
     }
+    Update.abort();
     
-    if (!success) {
-        lcd_show_message("OTA Gagal!", "Cek WiFi/Server");
-        Serial.println("OTA gagal setelah beberapa percobaan.");
-        publish_firmware_status("failed");
-        publish_firmware_update_progress("error", 0, "OTA gagal setelah beberapa percobaan.");
-        send_notification("error", "OTA gagal setelah beberapa percobaan.");
-        delay(10000);
-        ESP.restart();
-    }
+    lcd_show_message("OTA Gagal!", "Cek WiFi/Server");
+    Serial.println(failMsg);
+    publish_firmware_status("failed");
+    publish_firmware_update_progress("error", 0, failMsg);
+    publish_notification("error", failMsg);
+    delay(10000);
+    ESP.restart();
 }
 
 
 // =================================================================
 //   SPEEDTEST FUNCTIONS
 // =================================================================
+// Speedtest berjalan di task prioritas rendah pada core 0 agar download /
+// upload HTTP tidak pernah menahan network_task (MQTT keepalive, telemetri).
+// Hasil dikirim lewat queue dan dipublish dari network_task, karena
+// PubSubClient tidak thread-safe.
+
+// Pembatalan dari luar: perintah cancel, state berubah, atau WiFi putus.
+// Hasilnya dibuang tanpa menambah backoff.
+bool speedtest_cancelled() {
+    return speedtestCancel.load()
+        || currentState != STATE_NORMAL_OPERATION
+        || WiFi.status() != WL_CONNECTED;
+}
+
+bool speedtest_should_abort() {
+    return speedtest_cancelled() || millis() - speedtestRunStart >= SPEEDTEST_TIME_BUDGET_MS;
+}
 
 float speedtest_ping_ms(const char* host, uint16_t port, uint8_t count) {
     WiFiClient client;
     unsigned long total = 0;
     int success = 0;
     
-    for (uint8_t i = 0; i < count; i++) {
+    for (uint8_t i = 0; i < count && !speedtest_should_abort(); i++) {
         unsigned long start = millis();
         if (client.connect(host, port)) {
             unsigned long elapsed = millis() - start;
@@ -1192,8 +3934,9 @@ float speedtest_ping_ms(const char* host, uint16_t port, uint8_t count) {
 }
 
 float speedtest_download_mbps(const char* url, size_t test_size) {
+    if (speedtest_should_abort()) return -1.0f;
     HTTPClient http;
-    http.setTimeout(OTA_HTTP_TIMEOUT_MS);
+    http.setTimeout(SPEEDTEST_HTTP_TIMEOUT_MS);
     http.begin(url);
     unsigned long start = millis();
     int httpCode = http.GET();
@@ -1202,12 +3945,19 @@ float speedtest_download_mbps(const char* url, size_t test_size) {
     if (httpCode == HTTP_CODE_OK) {
         WiFiClient* stream = http.getStreamPtr();
         size_t total = 0;
+        size_t sinceYield = 0;
         uint8_t buf[256];
-        while (total < test_size) {
+        while (total < test_size && !speedtest_should_abort()) {
             int len = stream->read(buf, sizeof(buf));
             if (len <= 0) break;
             total += len;
+            sinceYield += len;
+            if (sinceYield >= SPEEDTEST_YIELD_EVERY_BYTES) {
+                sinceYield = 0;
+                vTaskDelay(pdMS_TO_TICKS(SPEEDTEST_YIELD_MS));
+            }
         }
+        speedtestRunBytes += total;
         unsigned long elapsed = millis() - start;
         if (elapsed > 0 && total > 0) {
             mbps = (total * 8.0f / 1000000.0f) / (elapsed / 1000.0f);
@@ -1218,8 +3968,9 @@ float speedtest_download_mbps(const char* url, size_t test_size) {
 }
 
 float speedtest_upload_mbps(const char* url, size_t test_size) {
+    if (speedtest_should_abort()) return -1.0f;
     HTTPClient http;
-    http.setTimeout(OTA_HTTP_TIMEOUT_MS);
+    http.setTimeout(SPEEDTEST_HTTP_TIMEOUT_MS);
     http.begin(url);
     char* payload = new char[test_size + 1];
     memset(payload, 'A', test_size);
@@ -1231,18 +3982,91 @@ float speedtest_upload_mbps(const char* url, size_t test_size) {
     
     if (httpCode > 0 && elapsed > 0) {
         mbps = (test_size * 8.0f / 1000000.0f) / (elapsed / 1000.0f);
+        speedtestRunBytes += test_size;
     }
     http.end();
     delete[] payload;
     return mbps;
 }
 
-void run_and_publish_speedtest() {
-    float ping = speedtest_ping_ms("8.8.8.8", 53, 4);
-    float download = speedtest_download_mbps(SPEEDTEST_DOWNLOAD_URL, SPEEDTEST_DOWNLOAD_SIZE);
-    float upload = speedtest_upload_mbps(SPEEDTEST_UPLOAD_URL, SPEEDTEST_UPLOAD_SIZE);
-    publish_speedtest(ping, download, upload);
-    Serial.printf("Speedtest: ping=%.2f ms, download=%.2f Mbps, upload=%.2f Mbps\n", ping, download, upload);
+void run_speedtest(SpeedtestResult& result) {
+    speedtestRunStart = millis();
+    speedtestRunBytes = 0;
+    result.ping_ms = speedtest_ping_ms("8.8.8.8", 53, 4);
+    result.download_mbps = speedtest_download_mbps(SPEEDTEST_DOWNLOAD_URL, SPEEDTEST_DOWNLOAD_SIZE);
+    result.upload_mbps = speedtest_upload_mbps(SPEEDTEST_UPLOAD_URL, SPEEDTEST_UPLOAD_SIZE);
+    result.duration_ms = millis() - speedtestRunStart;
+    result.bytes = speedtestRunBytes;
+    // Kehabisan SPEEDTEST_TIME_BUDGET_MS bukan pembatalan: hasil parsial
+    // tetap dipublish dan dihitung gagal untuk backoff.
+    result.cancelled = speedtest_cancelled();
+    result.timed_out = !result.cancelled && result.duration_ms >= SPEEDTEST_TIME_BUDGET_MS;
+}
+
+void speedtest_task(void* param) {
+    (void)param;
+    unsigned long lastRun = millis();
+    unsigned long budgetWindowStart = millis();
+    uint32_t budgetBytesUsed = 0;
+    int failures = 0;
+    
+    for (;;) {
+        vTaskDelay(pdMS_TO_TICKS(SPEEDTEST_POLL_MS));
+        if (speedtestCancel.load()) continue;
+        if (currentState != STATE_NORMAL_OPERATION || WiFi.status() != WL_CONNECTED) continue;
+        
+        // Sinyal lemah boleh memicu lebih sering, tapi tetap berjarak dan
+        // tetap kena backoff eksponensial saat percobaan terus gagal.
+        unsigned long interval = (WiFi.RSSI() < SPEEDTEST_RSSI_THRESHOLD) ? SPEEDTEST_WEAK_RSSI_INTERVAL_MS : SPEEDTEST_INTERVAL_MS;
+        for (int i = 0; i < failures && interval < SPEEDTEST_BACKOFF_MAX_MS; i++) interval *= 2;
+        if (interval > SPEEDTEST_BACKOFF_MAX_MS) interval = SPEEDTEST_BACKOFF_MAX_MS;
+        if (millis() - lastRun < interval) continue;
+        
+        if (millis() - budgetWindowStart >= 24UL * 60 * 60 * 1000) {
+            budgetWindowStart = millis();
+            budgetBytesUsed = 0;
+        }
+        if (budgetBytesUsed >= SPEEDTEST_DAILY_BYTE_BUDGET) continue;
+        
+        lastRun = millis();
+        SpeedtestResult result;
+        StageStamp start = stage_begin();
+        run_speedtest(result);
+        stage_end(STAGE_SPEEDTEST, start);
+        budgetBytesUsed += result.bytes;
+        
+        if (result.cancelled) {
+            Serial.printf("[SPEEDTEST] Dibatalkan setelah %lu ms.\n", (unsigned long)result.duration_ms);
+        } else if (result.timed_out || (result.ping_ms < 0 && result.download_mbps < 0)) {
+            failures++;
+            Serial.printf("[SPEEDTEST] Gagal (%d kali berturut-turut%s), backoff.\n",
+                          failures, result.timed_out ? ", waktu habis" : "");
+        } else {
+            failures = 0;
+        }
+        xQueueSend(speedtestResultQueue, &result, 0);
+    }
+}
+
+void start_speedtest_task() {
+    if (speedtestTaskHandle) return;
+    speedtestResultQueue = xQueueCreate(SPEEDTEST_RESULT_QUEUE_LEN, sizeof(SpeedtestResult));
+    xTaskCreatePinnedToCore(speedtest_task, "speedtest", SPEEDTEST_TASK_STACK, nullptr,
+                            SPEEDTEST_TASK_PRIORITY, &speedtestTaskHandle, SPEEDTEST_TASK_CORE);
+}
+
+void cancel_speedtest() {
+    speedtestCancel.store(true);
+}
+
+void poll_speedtest_result() {
+    if (!speedtestResultQueue) return;
+    SpeedtestResult result;
+    if (xQueueReceive(speedtestResultQueue, &result, 0) != pdTRUE) return;
+    if (result.cancelled) return;
+    publish_speedtest(result.ping_ms, result.download_mbps, result.upload_mbps);
+    Serial.printf("Speedtest: ping=%.2f ms, download=%.2f Mbps, upload=%.2f Mbps (%lu ms)\n",
+                  result.ping_ms, result.download_mbps, result.upload_mbps, (unsigned long)result.duration_ms);
 }
 
 // =================================================================
@@ -1250,11 +4074,13 @@ void run_and_publish_speedtest() {
 // =================================================================
 
 void lcd_show_message(const char* line1, const char* line2) {
+    i2cBus.take(portMAX_DELAY);
     lcd.clear();
     lcd.setCursor(0, 0);
     lcd.print(line1);
     lcd.setCursor(0, 1);
     lcd.print(line2);
+    i2cBus.give();
 }
 
 void pause_and_restart(unsigned long ms) {
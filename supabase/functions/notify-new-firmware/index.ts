@@ -15,6 +15,12 @@ interface WebhookRecord {
   version: string;
   file_url: string;
   release_notes?: string;
+  sha256?: string;
+  patch_url?: string;
+  patch_from?: string;
+  // Rollout bertahap, mis. {"percent": 10, "window_s": 1800}; tanpa kolom ini
+  // perangkat hanya mengirim email dan menunggu perintah update.
+  rollout?: { percent?: number; ramp_s?: number; window_s?: number };
 }
 
 interface WebhookPayload {
@@ -48,6 +54,11 @@ serve(async (req: Request): Promise<Response> => {
           version: record.version,
           release_notes: record.release_notes || "Tidak ada catatan rilis.",
           url: record.file_url,
+          // Kolom opsional: perangkat memverifikasi image dengan sha256 dan
+          // memakai patch delta bila versinya sama dengan patch_from.
+          ...(record.sha256 ? { sha256: record.sha256 } : {}),
+          ...(record.patch_url ? { patch_url: record.patch_url, patch_from: record.patch_from } : {}),
+          ...(record.rollout ? { rollout: record.rollout } : {}),
         });
 
         // Publish pesan dengan flag 'retained' agar frontend selalu mendapat notif terakhir
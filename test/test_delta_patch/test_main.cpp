@@ -0,0 +1,252 @@
+// test/test_delta_patch/test_main.cpp
+// pio test -e native -f test_delta_patch
+//
+// DeltaPatcher terhadap fixture kecil yang dibuat tools/jamur_delta.py:
+//
+//   cd test/test_delta_patch
+//   python3 ../../tools/jamur_delta.py diff old.bin new.bin patch.jdp
+//
+// Patch berisi COPY maju dan mundur serta DATA. Selain bolak-balik dengan
+// potongan acak, patch rusak, terpotong dan base yang salah harus ditolak
+// (atau tidak pernah selesai) tanpa menghasilkan image baru.
+
+#include <DeltaPatch.h>
+#include <mbedtls/sha256.h>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <string>
+#include <unity.h>
+#include <vector>
+
+namespace {
+
+typedef std::vector<uint8_t> Bytes;
+
+Bytes oldImage, newImage, patch;
+
+// Sink seperti OtaDeltaSink di src/main.cpp: base dicek ukuran dan sha256,
+// image lama dibaca dari memori, hasil ditampung di out.
+class VectorSink : public DeltaSink {
+public:
+    explicit VectorSink(const Bytes& base) : base_(base) {}
+
+    bool begin(const DeltaHeader& header) override {
+        began = true;
+        if (header.old_size != base_.size()) return false;
+        uint8_t digest[32];
+        mbedtls_sha256_context sha;
+        mbedtls_sha256_init(&sha);
+        mbedtls_sha256_starts(&sha, 0);
+        mbedtls_sha256_update(&sha, base_.data(), base_.size());
+        mbedtls_sha256_finish(&sha, digest);
+        mbedtls_sha256_free(&sha);
+        return memcmp(digest, header.old_sha256, sizeof(digest)) == 0;
+    }
+    bool read_old(uint32_t offset, uint8_t* buf, size_t len) override {
+        if ((size_t)offset + len > base_.size()) return false;
+        memcpy(buf, base_.data() + offset, len);
+        return true;
+    }
+    bool write(const uint8_t* data, size_t len) override {
+        out.insert(out.end(), data, data + len);
+        return true;
+    }
+
+    bool began = false;
+    Bytes out;
+
+private:
+    const Bytes& base_;
+};
+
+// File fixture dicari di samping file tes ini, lalu relatif ke root proyek.
+bool read_fixture(const char* name, Bytes& out) {
+    std::string path = __FILE__;
+    path = path.substr(0, path.find_last_of("/\\") + 1) + name;
+    FILE* f = fopen(path.c_str(), "rb");
+    if (!f) f = fopen((std::string("test/test_delta_patch/") + name).c_str(), "rb");
+    if (!f) return false;
+    out.clear();
+    uint8_t buf[512];
+    size_t n;
+    while ((n = fread(buf, 1, sizeof(buf), f)) > 0) out.insert(out.end(), buf, buf + n);
+    fclose(f);
+    return !out.empty();
+}
+
+// Potongan tetap (chunk > 0) atau acak 1..maxChunk dari rng; berhenti saat
+// feed() gagal seperti ota_fetch.
+void apply(DeltaPatcher& patcher, const Bytes& data, size_t chunk, std::mt19937* rng = nullptr,
+           size_t maxChunk = 0) {
+    size_t pos = 0;
+    while (pos < data.size()) {
+        size_t n = rng ? 1 + (*rng)() % maxChunk : chunk;
+        if (n > data.size() - pos) n = data.size() - pos;
+        if (!patcher.feed(data.data() + pos, n)) return;
+        pos += n;
+    }
+}
+
+void put_varint(Bytes& out, uint32_t value) {
+    while (value >= 0x80) {
+        out.push_back((uint8_t)(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back((uint8_t)value);
+}
+
+// Header patch asli (base cocok dengan old.bin) diikuti op buatan tangan.
+Bytes with_ops(std::initializer_list<uint8_t> ops) {
+    Bytes out(patch.begin(), patch.begin() + DeltaPatcher::kHeaderSize);
+    out.insert(out.end(), ops.begin(), ops.end());
+    return out;
+}
+
+} // namespace
+
+void setUp() {}
+void tearDown() {}
+
+void test_fixtures_present() {
+    TEST_ASSERT_TRUE_MESSAGE(read_fixture("old.bin", oldImage), "old.bin tidak terbaca");
+    TEST_ASSERT_TRUE_MESSAGE(read_fixture("new.bin", newImage), "new.bin tidak terbaca");
+    TEST_ASSERT_TRUE_MESSAGE(read_fixture("patch.jdp", patch), "patch.jdp tidak terbaca");
+    TEST_ASSERT_TRUE(patch.size() > DeltaPatcher::kHeaderSize);
+    TEST_ASSERT_EQUAL_MEMORY("JDP1", patch.data(), 4);
+}
+
+void test_whole_patch_reproduces_new_image() {
+    VectorSink sink(oldImage);
+    DeltaPatcher patcher(sink);
+    TEST_ASSERT_TRUE(patcher.feed(patch.data(), patch.size()));
+    TEST_ASSERT_TRUE(patcher.finished());
+    TEST_ASSERT_EQUAL_UINT32(newImage.size(), patcher.produced());
+    TEST_ASSERT_EQUAL_UINT32(oldImage.size(), patcher.header().old_size);
+    TEST_ASSERT_TRUE(sink.out == newImage);
+}
+
+void test_byte_by_byte_and_random_chunks() {
+    VectorSink sink(oldImage);
+    DeltaPatcher patcher(sink);
+    apply(patcher, patch, 1);
+    TEST_ASSERT_TRUE(patcher.finished());
+    TEST_ASSERT_TRUE(sink.out == newImage);
+
+    std::mt19937 rng(12345);
+    for (int round = 0; round < 200; round++) {
+        sink.out.clear();
+        patcher.reset();
+        apply(patcher, patch, 0, &rng, round < 100 ? 7 : 97);
+        TEST_ASSERT_FALSE_MESSAGE(patcher.failed(), patcher.error());
+        TEST_ASSERT_TRUE(patcher.finished());
+        TEST_ASSERT_TRUE(sink.out == newImage);
+    }
+}
+
+void test_truncated_patch_never_finishes() {
+    for (size_t cut = 0; cut < patch.size(); cut++) {
+        VectorSink sink(oldImage);
+        DeltaPatcher patcher(sink);
+        TEST_ASSERT_TRUE(patcher.feed(patch.data(), cut));
+        TEST_ASSERT_FALSE(patcher.failed());
+        TEST_ASSERT_FALSE(patcher.finished());
+        TEST_ASSERT_TRUE(patcher.produced() < newImage.size());
+    }
+}
+
+void test_trailing_bytes_rejected() {
+    Bytes longer = patch;
+    longer.push_back(0x00);
+    VectorSink sink(oldImage);
+    DeltaPatcher patcher(sink);
+    TEST_ASSERT_FALSE(patcher.feed(longer.data(), longer.size()));
+    TEST_ASSERT_TRUE(patcher.failed());
+    TEST_ASSERT_NOT_NULL(patcher.error());
+}
+
+void test_wrong_base_rejected_before_writing() {
+    // Ukuran sama, satu byte berbeda: hanya sha256 yang membedakan.
+    Bytes tampered = oldImage;
+    tampered[tampered.size() / 2] ^= 0x01;
+    VectorSink sameSize(tampered);
+    DeltaPatcher patcher(sameSize);
+    TEST_ASSERT_FALSE(patcher.feed(patch.data(), patch.size()));
+    TEST_ASSERT_TRUE(sameSize.began);
+    TEST_ASSERT_TRUE(patcher.failed());
+    TEST_ASSERT_TRUE(sameSize.out.empty());
+
+    // Image baru sebagai base (ukuran berbeda), misalnya patch diterapkan dua kali.
+    VectorSink otherSize(newImage);
+    DeltaPatcher second(otherSize);
+    TEST_ASSERT_FALSE(second.feed(patch.data(), patch.size()));
+    TEST_ASSERT_TRUE(second.failed());
+    TEST_ASSERT_TRUE(otherSize.out.empty());
+}
+
+void test_bad_magic_rejected() {
+    Bytes bad = patch;
+    bad[3] = '0';
+    VectorSink sink(oldImage);
+    DeltaPatcher patcher(sink);
+    TEST_ASSERT_FALSE(patcher.feed(bad.data(), bad.size()));
+    TEST_ASSERT_FALSE(sink.began);
+    TEST_ASSERT_TRUE(patcher.failed());
+}
+
+void test_malformed_ops_rejected() {
+    Bytes copyPastOld = with_ops({ 0x01 });
+    put_varint(copyPastOld, (uint32_t)oldImage.size() * 2);   // zigzag +old_size
+    put_varint(copyPastOld, 1);
+    Bytes copyPastNew = with_ops({ 0x01, 0x00 });
+    put_varint(copyPastNew, (uint32_t)newImage.size() + 1);
+    Bytes dataPastNew = with_ops({ 0x02 });
+    put_varint(dataPastNew, (uint32_t)newImage.size() + 1);
+    Bytes longVarint = with_ops({ 0x02, 0x80, 0x80, 0x80, 0x80, 0x80, 0x01 });
+    Bytes unknownOp = with_ops({ 0x7F });
+
+    const Bytes* cases[] = { &copyPastOld, &copyPastNew, &dataPastNew, &longVarint, &unknownOp };
+    for (const Bytes* bad : cases) {
+        VectorSink sink(oldImage);
+        DeltaPatcher patcher(sink);
+        apply(patcher, *bad, 1);
+        TEST_ASSERT_TRUE(patcher.failed());
+        TEST_ASSERT_NOT_NULL(patcher.error());
+        // Setelah gagal, feed() berikutnya tetap ditolak.
+        TEST_ASSERT_FALSE(patcher.feed(patch.data(), 1));
+    }
+}
+
+void test_corrupt_byte_never_yields_new_image() {
+    // Tiap byte setelah magic dibalik satu per satu, dikirim dalam potongan
+    // acak: hasilnya harus gagal, belum selesai, atau berbeda dari image baru.
+    std::mt19937 rng(777);
+    for (size_t at = 4; at < patch.size(); at++) {
+        Bytes bad = patch;
+        bad[at] ^= 0xFF;
+        VectorSink sink(oldImage);
+        DeltaPatcher patcher(sink);
+        apply(patcher, bad, 0, &rng, 64);
+        bool accepted = !patcher.failed() && patcher.finished() && sink.out == newImage;
+        if (accepted) printf("  byte %zu rusak tetap menghasilkan image baru\n", at);
+        TEST_ASSERT_FALSE(accepted);
+    }
+}
+
+int main(int argc, char** argv) {
+    (void)argc;
+    (void)argv;
+    UNITY_BEGIN();
+    RUN_TEST(test_fixtures_present);
+    // Tes lain memakai isi fixture; tanpa fixture cukup satu kegagalan di atas.
+    if (oldImage.empty() || newImage.empty() || patch.size() <= DeltaPatcher::kHeaderSize) return UNITY_END();
+    RUN_TEST(test_whole_patch_reproduces_new_image);
+    RUN_TEST(test_byte_by_byte_and_random_chunks);
+    RUN_TEST(test_truncated_patch_never_finishes);
+    RUN_TEST(test_trailing_bytes_rejected);
+    RUN_TEST(test_wrong_base_rejected_before_writing);
+    RUN_TEST(test_bad_magic_rejected);
+    RUN_TEST(test_malformed_ops_rejected);
+    RUN_TEST(test_corrupt_byte_never_yields_new_image);
+    return UNITY_END();
+}
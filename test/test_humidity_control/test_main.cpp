@@ -0,0 +1,286 @@
+// test/test_humidity_control/test_main.cpp
+// pio test -e native -f test_humidity_control
+//
+// Hysteresis classify(), dwell yang menahan notifikasi tanpa menahan pompa,
+// pemicu laju turun early(), dan replay trace DHT11 (trace_dht11.csv) dengan
+// batas waktu nyala pompa dan jumlah notifikasi.
+
+#include <Arduino.h>
+#include <HumidityControl.h>
+#include <SensorFilter.h>
+#include <cstdio>
+#include <string>
+#include <unity.h>
+#include <vector>
+
+namespace {
+
+const float kCritical = 80.0f;
+const float kWarning = 85.0f;
+const ControlTuning kPlain = { 0.0f, 0, 0.0f };
+const ControlTuning kDefault = { 2.0f, 60, 0.5f };   // CONTROL_*_DEFAULT di config.h
+// Selang pengambilan riwayat di HumidityControl.
+const uint32_t kHistoryStepMs = HumidityControl::kRateWindowMs / (HumidityControl::kHistory - 1);
+
+struct TraceRow {
+    uint32_t ms;
+    float humidity;
+};
+
+struct ReplayResult {
+    uint32_t notifications;
+    uint32_t pumpStarts;
+    uint32_t pumpOnSec;
+    uint32_t early;
+    uint32_t held;
+};
+
+// File fixture dicari di samping file tes ini, lalu relatif ke root proyek.
+FILE* open_fixture(const char* name) {
+    std::string path = __FILE__;
+    path = path.substr(0, path.find_last_of("/\\") + 1) + name;
+    FILE* f = fopen(path.c_str(), "r");
+    if (!f) f = fopen((std::string("test/test_humidity_control/") + name).c_str(), "r");
+    return f;
+}
+
+std::vector<TraceRow> load_trace(const char* name) {
+    std::vector<TraceRow> rows;
+    FILE* f = open_fixture(name);
+    if (!f) return rows;
+    char line[128];
+    while (fgets(line, sizeof(line), f)) {
+        double t;
+        float h, c;
+        if (sscanf(line, "%lf,%f,%f", &t, &h, &c) == 3) rows.push_back({ (uint32_t)(t * 1000.0), h });
+    }
+    fclose(f);
+    return rows;
+}
+
+// Sama seperti firmware: sampel lewat SensorFilter (DHT_MAX_JUMP_RH,
+// DHT_EMA_ALPHA), siram 30 s saat demand() atau early(), tidak ditumpuk
+// selama pompa masih menyala. Trace tanpa pompa, jadi kelembapan tidak
+// ikut naik.
+ReplayResult replay(const std::vector<TraceRow>& rows, const ControlTuning& tuning) {
+    const uint32_t kPumpMs = 30000;
+    SensorFilter filter(0.0f, 100.0f, 8.0f, 0.5f);
+    HumidityControl control;
+    ReplayResult r = {};
+    uint32_t pumpUntil = 0;
+    uint32_t lastMs = 0;
+    bool pump = false;
+    for (const TraceRow& row : rows) {
+        if (pump) {
+            r.pumpOnSec += (min(row.ms, pumpUntil) - lastMs) / 1000;
+            pump = row.ms < pumpUntil;
+        }
+        lastMs = row.ms;
+        filter.push(row.humidity);
+        control.update(filter.value(), row.ms, kCritical, kWarning, tuning);
+        if (control.changed()) r.notifications++;
+        if (!pump && (control.demand() || control.early())) {
+            pump = true;
+            pumpUntil = row.ms + kPumpMs;
+            r.pumpStarts++;
+        }
+    }
+    r.early = control.stats().early;
+    r.held = control.stats().held;
+    return r;
+}
+
+} // namespace
+
+void setUp() {}
+void tearDown() {}
+
+void test_classify_enters_worse_zone_at_threshold() {
+    TEST_ASSERT_EQUAL(ZONE_NORMAL, HumidityControl::classify(85.0f, ZONE_NORMAL, kCritical, kWarning, 2.0f));
+    TEST_ASSERT_EQUAL(ZONE_WARNING, HumidityControl::classify(84.9f, ZONE_NORMAL, kCritical, kWarning, 2.0f));
+    TEST_ASSERT_EQUAL(ZONE_CRITICAL, HumidityControl::classify(79.9f, ZONE_NORMAL, kCritical, kWarning, 2.0f));
+    TEST_ASSERT_EQUAL(ZONE_CRITICAL, HumidityControl::classify(79.9f, ZONE_WARNING, kCritical, kWarning, 2.0f));
+}
+
+void test_classify_leaves_only_past_hysteresis() {
+    // Kritis: bertahan sampai 80 + 2, lalu warning sampai 85 + 2.
+    TEST_ASSERT_EQUAL(ZONE_CRITICAL, HumidityControl::classify(80.0f, ZONE_CRITICAL, kCritical, kWarning, 2.0f));
+    TEST_ASSERT_EQUAL(ZONE_CRITICAL, HumidityControl::classify(81.9f, ZONE_CRITICAL, kCritical, kWarning, 2.0f));
+    TEST_ASSERT_EQUAL(ZONE_WARNING, HumidityControl::classify(82.0f, ZONE_CRITICAL, kCritical, kWarning, 2.0f));
+    TEST_ASSERT_EQUAL(ZONE_WARNING, HumidityControl::classify(86.9f, ZONE_WARNING, kCritical, kWarning, 2.0f));
+    TEST_ASSERT_EQUAL(ZONE_NORMAL, HumidityControl::classify(87.0f, ZONE_WARNING, kCritical, kWarning, 2.0f));
+    // Lompatan besar langsung ke zona terbaik yang sudah dilewati hysteresis-nya.
+    TEST_ASSERT_EQUAL(ZONE_NORMAL, HumidityControl::classify(90.0f, ZONE_CRITICAL, kCritical, kWarning, 2.0f));
+    // Di dalam pita hysteresis warning, kritis tetap boleh turun ke warning saja.
+    TEST_ASSERT_EQUAL(ZONE_WARNING, HumidityControl::classify(86.0f, ZONE_CRITICAL, kCritical, kWarning, 2.0f));
+}
+
+void test_classify_without_hysteresis_is_plain_threshold() {
+    TEST_ASSERT_EQUAL(ZONE_WARNING, HumidityControl::classify(80.0f, ZONE_CRITICAL, kCritical, kWarning, 0.0f));
+    TEST_ASSERT_EQUAL(ZONE_NORMAL, HumidityControl::classify(85.0f, ZONE_WARNING, kCritical, kWarning, 0.0f));
+    TEST_ASSERT_EQUAL(ZONE_WARNING, HumidityControl::classify(84.0f, ZONE_NORMAL, kCritical, kWarning, 0.0f));
+}
+
+void test_state_swing_inside_band_does_not_flap() {
+    HumidityControl control;
+    const ControlTuning tuning = { 2.0f, 0, 0.0f };
+    control.update(79.0f, 0, kCritical, kWarning, tuning);
+    TEST_ASSERT_EQUAL(ZONE_CRITICAL, control.state());
+    uint32_t changes = control.stats().changes;
+    for (uint32_t i = 1; i <= 20; i++) {
+        control.update(i % 2 ? 81.0f : 80.0f, i * 5000, kCritical, kWarning, tuning);
+        TEST_ASSERT_EQUAL(ZONE_CRITICAL, control.state());
+    }
+    TEST_ASSERT_EQUAL_UINT32(changes, control.stats().changes);
+    control.update(82.0f, 105000, kCritical, kWarning, tuning);
+    TEST_ASSERT_EQUAL(ZONE_WARNING, control.state());
+    TEST_ASSERT_TRUE(control.changed());
+}
+
+void test_dwell_holds_notification_but_not_pump() {
+    HumidityControl control;
+    const ControlTuning tuning = { 2.0f, 60, 0.0f };
+    control.update(90.0f, 0, kCritical, kWarning, tuning);
+    TEST_ASSERT_FALSE(control.changed());
+    TEST_ASSERT_EQUAL(ZONE_NORMAL, control.zone());
+
+    control.update(79.0f, 10000, kCritical, kWarning, tuning);
+    TEST_ASSERT_EQUAL(ZONE_CRITICAL, control.state());
+    TEST_ASSERT_EQUAL(ZONE_NORMAL, control.zone());
+    TEST_ASSERT_FALSE(control.changed());
+    TEST_ASSERT_TRUE(control.demand());
+    TEST_ASSERT_EQUAL_UINT32(1, control.stats().held);
+
+    // Masih ditahan: pompa tetap diminta, notifikasi belum.
+    control.update(79.0f, 50000, kCritical, kWarning, tuning);
+    TEST_ASSERT_FALSE(control.changed());
+    TEST_ASSERT_TRUE(control.demand());
+    TEST_ASSERT_EQUAL_UINT32(1, control.stats().held);
+
+    // Dwell 60 s sejak zona terakhir (boot) sudah lewat.
+    control.update(79.0f, 60000, kCritical, kWarning, tuning);
+    TEST_ASSERT_TRUE(control.changed());
+    TEST_ASSERT_EQUAL(ZONE_CRITICAL, control.zone());
+    TEST_ASSERT_EQUAL_UINT32(1, control.stats().changes);
+}
+
+void test_first_zone_after_boot_skips_dwell() {
+    HumidityControl control;
+    const ControlTuning tuning = { 2.0f, 60, 0.0f };
+    control.update(79.0f, 0, kCritical, kWarning, tuning);
+    TEST_ASSERT_TRUE(control.changed());
+    TEST_ASSERT_EQUAL(ZONE_CRITICAL, control.zone());
+    TEST_ASSERT_EQUAL_UINT32(0, control.stats().held);
+}
+
+void test_dwell_drops_swing_shorter_than_dwell() {
+    HumidityControl control;
+    const ControlTuning tuning = { 0.0f, 60, 0.0f };
+    control.update(90.0f, 0, kCritical, kWarning, tuning);
+    control.update(84.0f, 20000, kCritical, kWarning, tuning);
+    control.update(90.0f, 40000, kCritical, kWarning, tuning);
+    control.update(90.0f, 120000, kCritical, kWarning, tuning);
+    TEST_ASSERT_EQUAL(ZONE_NORMAL, control.zone());
+    TEST_ASSERT_EQUAL_UINT32(0, control.stats().changes);
+    TEST_ASSERT_EQUAL_UINT32(1, control.stats().held);
+}
+
+void test_early_fires_on_falling_slope() {
+    HumidityControl control;
+    bool fired = false;
+    // 84.9 -> turun 1 %RH/menit di zona warning, sampel tiap 5 s.
+    for (uint32_t ms = 0; ms <= 270000; ms += 5000) {
+        float humidity = 84.9f - ms / 60000.0f;
+        control.update(humidity, ms, kCritical, kWarning, kDefault);
+        TEST_ASSERT_EQUAL(ZONE_WARNING, control.state());
+        if (control.early()) {
+            fired = true;
+            TEST_ASSERT_TRUE(control.rate() <= -kDefault.fall_rate);
+        }
+    }
+    TEST_ASSERT_TRUE(fired);
+    TEST_ASSERT_EQUAL_UINT32(1, control.stats().early);
+}
+
+void test_early_needs_half_window_of_history() {
+    HumidityControl control;
+    for (uint32_t ms = 0; ms < HumidityControl::kRateWindowMs / 2; ms += 5000) {
+        control.update(84.9f - ms / 30000.0f, ms, kCritical, kWarning, kDefault);
+        TEST_ASSERT_FALSE(control.early());
+    }
+}
+
+void test_early_quiet_on_dht11_quantization() {
+    HumidityControl control;
+    // Nilai sebenarnya ~82.5 %RH: DHT11 melaporkan 83 dan 82 bergantian
+    // dengan pola acak, lalu satu langkah turun permanen ke 82.
+    uint32_t lfsr = 0xACE1u;
+    uint32_t ms = 0;
+    for (; ms < 20 * 60000; ms += 5000) {
+        lfsr = (lfsr >> 1) ^ (-(lfsr & 1u) & 0xB400u);
+        control.update((lfsr & 1) ? 83.0f : 82.0f, ms, kCritical, kWarning, kDefault);
+        TEST_ASSERT_FALSE(control.early());
+    }
+    for (uint32_t end = ms + 20 * 60000; ms < end; ms += 5000) {
+        control.update(82.0f, ms, kCritical, kWarning, kDefault);
+        TEST_ASSERT_FALSE(control.early());
+    }
+    TEST_ASSERT_EQUAL_UINT32(0, control.stats().early);
+}
+
+void test_early_off_outside_warning_or_when_disabled() {
+    const ControlTuning noRate = { 2.0f, 60, 0.0f };
+    HumidityControl disabled;
+    HumidityControl normal;
+    for (uint32_t ms = 0; ms <= 300000; ms += kHistoryStepMs) {
+        disabled.update(84.9f - ms / 60000.0f, ms, kCritical, kWarning, noRate);
+        normal.update(95.0f - ms / 60000.0f, ms, kCritical, kWarning, kDefault);
+        TEST_ASSERT_FALSE(disabled.early());
+        TEST_ASSERT_FALSE(normal.early());
+    }
+    TEST_ASSERT_TRUE(normal.rate() < -0.9f);
+}
+
+void test_trace_replay_bounds() {
+    std::vector<TraceRow> rows = load_trace("trace_dht11.csv");
+    TEST_ASSERT_TRUE_MESSAGE(rows.size() > 700, "trace_dht11.csv tidak terbaca");
+
+    ReplayResult plain = replay(rows, kPlain);
+    ReplayResult tuned = replay(rows, kDefault);
+    printf("  ambang : notif %u, siram %u (%u s), laju %u\n", plain.notifications, plain.pumpStarts,
+           plain.pumpOnSec, plain.early);
+    printf("  default: notif %u, siram %u (%u s), laju %u, ditahan %u\n", tuned.notifications, tuned.pumpStarts,
+           tuned.pumpOnSec, tuned.early, tuned.held);
+
+    // Ayunan di ambang warning/kritis: tanpa hysteresis notifikasi berulang,
+    // dengan default hanya perubahan zona yang sebenarnya.
+    TEST_ASSERT_GREATER_OR_EQUAL(12, plain.notifications);
+    TEST_ASSERT_LESS_OR_EQUAL(8, tuned.notifications);
+    TEST_ASSERT_GREATER_OR_EQUAL(3, tuned.notifications);
+    TEST_ASSERT_EQUAL_UINT32(0, plain.early);
+    TEST_ASSERT_GREATER_OR_EQUAL(1, tuned.early);
+    // Hysteresis menahan pompa di kritis sampai 82 dan laju turun menyiram
+    // sebelum 80, jadi waktu nyala tidak boleh lebih pendek dari ambang biasa.
+    TEST_ASSERT_GREATER_OR_EQUAL(plain.pumpOnSec, tuned.pumpOnSec);
+    TEST_ASSERT_UINT32_WITHIN(120, 300, plain.pumpOnSec);
+    TEST_ASSERT_UINT32_WITHIN(180, 780, tuned.pumpOnSec);
+}
+
+int main(int argc, char** argv) {
+    (void)argc;
+    (void)argv;
+    UNITY_BEGIN();
+    RUN_TEST(test_classify_enters_worse_zone_at_threshold);
+    RUN_TEST(test_classify_leaves_only_past_hysteresis);
+    RUN_TEST(test_classify_without_hysteresis_is_plain_threshold);
+    RUN_TEST(test_state_swing_inside_band_does_not_flap);
+    RUN_TEST(test_dwell_holds_notification_but_not_pump);
+    RUN_TEST(test_first_zone_after_boot_skips_dwell);
+    RUN_TEST(test_dwell_drops_swing_shorter_than_dwell);
+    RUN_TEST(test_early_fires_on_falling_slope);
+    RUN_TEST(test_early_needs_half_window_of_history);
+    RUN_TEST(test_early_quiet_on_dht11_quantization);
+    RUN_TEST(test_early_off_outside_warning_or_when_disabled);
+    RUN_TEST(test_trace_replay_bounds);
+    return UNITY_END();
+}
@@ -0,0 +1,114 @@
+#!/usr/bin/env python3
+"""Membangun include/portal_assets.h dari file di portal/ (lihat lib/GzipTemplate).
+
+    python3 tools/build_portal.py
+
+Juga dipanggil otomatis oleh PlatformIO (extra_scripts = pre:...) sebelum
+build; header hanya ditulis ulang bila isinya berubah. Penanda {{nama}} di
+file portal menjadi field dinamis PORTAL_FIELD_NAMA.
+"""
+
+import os
+import re
+import sys
+import zlib
+
+PAGES = [
+    # (file, nama aset, content type)
+    ("index.html", "PORTAL_INDEX", "text/html"),
+    ("error.html", "PORTAL_ERROR", "text/html"),
+    ("saved.html", "PORTAL_SAVED", "text/html"),
+    ("style.css", "PORTAL_STYLE", "text/css"),
+    ("portal.js", "PORTAL_SCRIPT", "application/javascript"),
+]
+FIELD = re.compile(r"\{\{([a-z_]+)\}\}")
+
+
+def minify(text):
+    # Baris baru dan spasi awal baris tidak berarti untuk HTML/CSS portal.
+    # portal.js ditulis dengan titik koma lengkap dan tanpa komentar //
+    # agar tetap valid setelah barisnya disambung.
+    return "".join(line.strip() for line in text.splitlines())
+
+
+def deflate_segment(raw):
+    """Deflate mentah yang berakhir byte-aligned dan tanpa blok final."""
+    if not raw:
+        return b""
+    comp = zlib.compressobj(9, zlib.DEFLATED, -15, 9)
+    return comp.compress(raw) + comp.flush(zlib.Z_SYNC_FLUSH)
+
+
+def c_bytes(data):
+    rows = []
+    for i in range(0, len(data), 16):
+        rows.append("    " + ", ".join("0x%02x" % b for b in data[i:i + 16]) + ",")
+    return "\n".join(rows) if rows else "    0x00,"
+
+
+def build(root):
+    fields = []
+    out = []
+    raw_total = gz_total = 0
+    for filename, name, content_type in PAGES:
+        with open(os.path.join(root, "portal", filename), encoding="utf-8") as f:
+            text = minify(f.read())
+        parts = FIELD.split(text)
+        segments, page_fields = parts[0::2], parts[1::2]
+        for field in page_fields:
+            if field not in fields:
+                fields.append(field)
+
+        seg_rows = []
+        for i, seg in enumerate(segments):
+            raw = seg.encode("utf-8")
+            data = deflate_segment(raw)
+            raw_total += len(raw)
+            gz_total += len(data)
+            out.append("static const uint8_t %s_SEG%d[] = {\n%s\n};" % (name, i, c_bytes(data)))
+            seg_rows.append("    { %s_SEG%d, %d, %d, 0x%08xUL }," % (name, i, len(data), len(raw), zlib.crc32(raw)))
+        out.append("static const GzipSegment %s_SEGMENTS[] = {\n%s\n};" % (name, "\n".join(seg_rows)))
+        field_list = ", ".join("PORTAL_FIELD_%s" % f.upper() for f in page_fields) or "0"
+        out.append("static const uint8_t %s_FIELDS[] = { %s };" % (name, field_list))
+        out.append('static const GzipAsset %s = { %s_SEGMENTS, %d, %s_FIELDS, "%s" };\n' % (
+            name, name, len(segments), name, content_type))
+
+    enum = "\n".join("    PORTAL_FIELD_%s," % f.upper() for f in fields)
+    header = [
+        "// include/portal_assets.h",
+        "// DIHASILKAN oleh tools/build_portal.py dari portal/*; jangan diedit manual.",
+        "// Total %d B teks -> %d B deflate." % (raw_total, gz_total),
+        "#pragma once",
+        "",
+        "#include <GzipTemplate.h>",
+        "",
+        "enum PortalField : uint8_t {",
+        enum,
+        "    PORTAL_FIELD_COUNT",
+        "};",
+        "",
+    ]
+    return "\n".join(header + out)
+
+
+def main(root):
+    content = build(root)
+    path = os.path.join(root, "include", "portal_assets.h")
+    try:
+        with open(path, encoding="utf-8") as f:
+            if f.read() == content:
+                return 0
+    except OSError:
+        pass
+    with open(path, "w", encoding="utf-8") as f:
+        f.write(content)
+    print("portal_assets.h diperbarui")
+    return 0
+
+
+try:
+    Import("env")  # noqa: F821 - disediakan SCons saat dipanggil PlatformIO
+    main(env.subst("$PROJECT_DIR"))  # noqa: F821
+except NameError:
+    if __name__ == "__main__":
+        sys.exit(main(os.path.dirname(os.path.dirname(os.path.abspath(__file__)))))
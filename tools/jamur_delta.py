@@ -0,0 +1,188 @@
+#!/usr/bin/env python3
+"""Generator dan penerap patch firmware JDP1 (lihat lib/DeltaPatch/src/DeltaPatch.h).
+
+    python3 tools/jamur_delta.py diff  firmware_lama.bin firmware_baru.bin patch.jdp
+    python3 tools/jamur_delta.py apply firmware_lama.bin patch.jdp hasil.bin
+
+`diff` langsung memverifikasi patch dengan menerapkannya kembali; exit code
+bukan nol bila hasilnya tidak identik byte-per-byte dengan image baru.
+"""
+
+import hashlib
+import struct
+import sys
+
+MAGIC = b"JDP1"
+OP_COPY = 0x01
+OP_DATA = 0x02
+
+# Panjang kunci indeks dan jarak sampling posisi image lama. Match yang
+# lebih panjang dari KEY_LEN + INDEX_STEP - 1 pasti ditemukan.
+KEY_LEN = 16
+INDEX_STEP = 4
+# Match lebih pendek dari ini lebih murah dikirim sebagai DATA.
+MIN_COPY = 12
+MIN_CONTINUE = 8
+
+
+def put_varint(out, value):
+    while value >= 0x80:
+        out.append((value & 0x7F) | 0x80)
+        value >>= 7
+    out.append(value)
+
+
+def get_varint(buf, pos):
+    value = shift = 0
+    while True:
+        b = buf[pos]
+        pos += 1
+        value |= (b & 0x7F) << shift
+        shift += 7
+        if not b & 0x80:
+            return value, pos
+
+
+def zigzag(value):
+    return value * 2 if value >= 0 else -value * 2 - 1
+
+
+def unzigzag(value):
+    return (value >> 1) ^ -(value & 1)
+
+
+def match_forward(old, oi, new, ni):
+    """Panjang prefiks yang sama antara old[oi:] dan new[ni:]."""
+    limit = min(len(old) - oi, len(new) - ni)
+    n = 0
+    step = 256
+    while n < limit:
+        m = min(step, limit - n)
+        if old[oi + n:oi + n + m] == new[ni + n:ni + n + m]:
+            n += m
+            continue
+        if m == 1:
+            break
+        step = max(1, m // 2)
+    return n
+
+
+def build_index(old):
+    index = {}
+    for pos in range(0, len(old) - KEY_LEN + 1, INDEX_STEP):
+        index.setdefault(old[pos:pos + KEY_LEN], pos)
+    return index
+
+
+def diff(old, new):
+    index = build_index(old)
+    out = bytearray(MAGIC)
+    out += struct.pack("<II", len(old), len(new))
+    out += hashlib.sha256(old).digest()
+
+    cursor = 0          # akhir COPY terakhir di image lama
+    literal_start = 0
+    i = 0
+    while i < len(new):
+        src = None
+        length = 0
+        # Kelanjutan blok sebelumnya (perubahan berukuran sama) paling murah.
+        if cursor < len(old):
+            length = match_forward(old, cursor, new, i)
+            if length >= MIN_CONTINUE:
+                src = cursor
+        if src is None:
+            pos = index.get(new[i:i + KEY_LEN])
+            if pos is not None:
+                length = match_forward(old, pos, new, i)
+                if length >= MIN_COPY:
+                    src = pos
+        if src is None:
+            i += 1
+            continue
+
+        # Perpanjang ke belakang, mengambil kembali byte dari literal tertunda.
+        while i > literal_start and src > 0 and new[i - 1] == old[src - 1]:
+            i -= 1
+            src -= 1
+            length += 1
+
+        if i > literal_start:
+            out.append(OP_DATA)
+            put_varint(out, i - literal_start)
+            out += new[literal_start:i]
+        out.append(OP_COPY)
+        put_varint(out, zigzag(src - cursor))
+        put_varint(out, length)
+        cursor = src + length
+        i += length
+        literal_start = i
+
+    if literal_start < len(new):
+        out.append(OP_DATA)
+        put_varint(out, len(new) - literal_start)
+        out += new[literal_start:]
+    return bytes(out)
+
+
+def apply(old, patch):
+    if patch[:4] != MAGIC:
+        raise ValueError("magic bukan JDP1")
+    old_size, new_size = struct.unpack_from("<II", patch, 4)
+    if old_size != len(old) or patch[12:44] != hashlib.sha256(old).digest():
+        raise ValueError("base patch tidak cocok dengan image lama")
+    out = bytearray()
+    cursor = 0
+    pos = 44
+    while len(out) < new_size:
+        op = patch[pos]
+        pos += 1
+        if op == OP_COPY:
+            delta, pos = get_varint(patch, pos)
+            length, pos = get_varint(patch, pos)
+            src = cursor + unzigzag(delta)
+            if src < 0 or src + length > old_size:
+                raise ValueError("COPY di luar image lama")
+            out += old[src:src + length]
+            cursor = src + length
+        elif op == OP_DATA:
+            length, pos = get_varint(patch, pos)
+            out += patch[pos:pos + length]
+            pos += length
+        else:
+            raise ValueError("op tidak dikenal: 0x%02x" % op)
+    if len(out) != new_size or pos != len(patch):
+        raise ValueError("panjang patch tidak konsisten")
+    return bytes(out)
+
+
+def read(path):
+    with open(path, "rb") as f:
+        return f.read()
+
+
+def write(path, data):
+    with open(path, "wb") as f:
+        f.write(data)
+
+
+def main(argv):
+    if len(argv) != 5 or argv[1] not in ("diff", "apply"):
+        sys.stderr.write(__doc__)
+        return 2
+    if argv[1] == "diff":
+        old, new = read(argv[2]), read(argv[3])
+        patch = diff(old, new)
+        if apply(old, patch) != new:
+            sys.stderr.write("Verifikasi gagal: hasil apply berbeda dari image baru.\n")
+            return 1
+        write(argv[4], patch)
+        print("patch %d B untuk image %d B (%.1f%%), sha256 baru %s" % (
+            len(patch), len(new), 100.0 * len(patch) / max(1, len(new)), hashlib.sha256(new).hexdigest()))
+    else:
+        write(argv[4], apply(read(argv[2]), read(argv[3])))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv))